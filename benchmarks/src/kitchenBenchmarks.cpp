@@ -0,0 +1,256 @@
+/**
+ * The benchmarks of the code that runs for every input event or every frame: touch dispatch through the kitchen,
+ * the crossfades of the stove tops, the beat swaps and node drags of a pot, the particles, and the voices of the
+ * pots. Each benchmark sets its objects up outside of the timed loop and reports the items processed, so that the
+ * JSON results compare from release to release whatever the number of iterations. The benchmarks of the paths that
+ * should not allocate also report their allocations per iteration.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "metaphorKitchen.h"
+#include "ofxParticleSystem.h"
+#include "ofxAllocationCounter.h"
+#include <benchmark/benchmark.h>
+
+#define KITCHEN_BENCHMARK_POT_RADIUS 200 ///< The radius in pixels of the pots set up alone.
+#define KITCHEN_BENCHMARK_BPM 120 ///< The tempo of the pots set up alone.
+#define KITCHEN_BENCHMARK_NODE_RADIUS 20 ///< The radius in pixels of the nodes set up alone.
+#define KITCHEN_BENCHMARK_MOVES 8 ///< The number of moves of every touch in the dispatch benchmark.
+#define KITCHEN_BENCHMARK_SWEEP 32 ///< The number of points on each side of the grid swept by the crossfades.
+
+/**
+* \param nLane The audio channel of the node (0 for drums, 1 for bass, 2 for lead).
+* \param pt The position in pixels of the node.
+* \return A node without a sound, so that only the logic of the pot is measured.
+*/
+static ofxCookableNode makeSilentNode(int nLane, ofPoint pt)
+{
+	static const TACTO_LOOPTYPE types[OFX_POT_NUMLANES] = { TACTO_LOOPTYPE_DRUMS, TACTO_LOOPTYPE_BASS, TACTO_LOOPTYPE_LEAD };
+	ofxCookableNode node(ofColor(255), KITCHEN_BENCHMARK_NODE_RADIUS, -1, "", true, types[nLane], 4);
+	node.setOrigin(pt, true);
+	node.setOriginInit(pt, true);
+	node.setRelativeVolume(1.0f);
+	return node;
+}
+
+/**
+* \param state The state of the benchmark, after its timed loop.
+* \param nStartAllocations The number of allocations of the thread before the timed loop.
+*/
+static void setAllocationCounter(benchmark::State& state, uint64_t nStartAllocations)
+{
+	double fNumAllocations = (double)(ofxAllocationCounter::getThreadNumAllocations() - nStartAllocations);
+	state.counters["allocations"] = benchmark::Counter(fNumAllocations, benchmark::Counter::kAvgIterations);
+}
+
+/**
+* \param kitchen The kitchen, set up.
+* \param nNodesPerPot The number of nodes added to every pot, spread over the loops of the configuration.
+*/
+static void fillKitchen(metaphorKitchen& kitchen, int nNodesPerPot)
+{
+	for (int nStove = 0; nStove < 4; nStove++)
+	{
+		for (int i = 0; i < nNodesPerPot; i++)
+		{
+			kitchen.addLoop(nStove, i % max(kitchen.getNumLoops(), 1));
+		}
+	}
+}
+
+/** Touch dispatch through metaphorKitchen: one finger moving in the pot in view, and one swiping the background
+* back and forth, with N nodes in every pot.
+* \param state The state of the benchmark, whose argument is the number of nodes per pot.
+*/
+static void BM_KitchenTouchDispatch(benchmark::State& state)
+{
+	// The clock stands still, so that no beat falls within the timed loop
+	ofxManualClock clock;
+	metaphorKitchen kitchen;
+	kitchen.setup(KITCHEN_VIEWPORT_DEFAULT_WIDTH, KITCHEN_VIEWPORT_DEFAULT_HEIGHT, &clock);
+	fillKitchen(kitchen, state.range(0));
+	ofPoint ptPot = kitchen.getStovetop(stoveInformation::FRONT_RIGHT)->getPot()->getOrigin();
+	ptPot.x /= kitchenViewport::getWidth();
+	ptPot.y /= kitchenViewport::getHeight();
+	ofPoint ptBackground(0.05f, 0.95f);
+
+	uint64_t nStartAllocations = ofxAllocationCounter::getThreadNumAllocations();
+	for (auto _ : state)
+	{
+		kitchen.mouseTouchDown(ptPot.x, ptPot.y, false, 0, 1);
+		kitchen.mouseTouchDown(ptBackground.x, ptBackground.y, false, 0, 2);
+		for (int i = 0; i < KITCHEN_BENCHMARK_MOVES; i++)
+		{
+			// Out and back, so that the drag offset of the kitchen is the same at every iteration
+			float fStep = (i < KITCHEN_BENCHMARK_MOVES / 2 ? i + 1 : KITCHEN_BENCHMARK_MOVES - i - 1) * 0.002f;
+			kitchen.mouseTouchMoved(ptPot.x + fStep, ptPot.y, false, 0, 1);
+			kitchen.mouseTouchMoved(ptBackground.x + fStep, ptBackground.y, false, 0, 2);
+		}
+		kitchen.mouseTouchUp(ptPot.x, ptPot.y, false, 0, 1);
+		kitchen.mouseTouchUp(ptBackground.x, ptBackground.y, false, 0, 2);
+	}
+	setAllocationCounter(state, nStartAllocations);
+	state.SetItemsProcessed(state.iterations() * (4 + 2 * KITCHEN_BENCHMARK_MOVES));
+	kitchen.exit();
+}
+BENCHMARK(BM_KitchenTouchDispatch)->Arg(0)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+
+/** ofxStovetop::getCrossfadeVolume() over a grid of drag offsets, for the four stove tops.
+* \param state The state of the benchmark.
+*/
+static void BM_StovetopCrossfadeVolume(benchmark::State& state)
+{
+	ofxStovetop stovetops[4];
+	for (int i = 0; i < 4; i++)
+	{
+		stovetops[i] = ofxStovetop((stoveInformation::tactoStove)i, ofPoint(0, 0), KITCHEN_BENCHMARK_BPM);
+	}
+	vector<ofPoint> sweep;
+	for (int y = 0; y < KITCHEN_BENCHMARK_SWEEP; y++)
+	{
+		for (int x = 0; x < KITCHEN_BENCHMARK_SWEEP; x++)
+		{
+			sweep.push_back(ofPoint((float)x / (KITCHEN_BENCHMARK_SWEEP - 1), (float)y / (KITCHEN_BENCHMARK_SWEEP - 1)));
+		}
+	}
+
+	for (auto _ : state)
+	{
+		float fSum = 0.0f;
+		for (size_t p = 0; p < sweep.size(); p++)
+		{
+			for (int i = 0; i < 4; i++)
+			{
+				fSum += stovetops[i].getCrossfadeVolume(sweep[p]);
+			}
+		}
+		benchmark::DoNotOptimize(fSum);
+	}
+	state.SetItemsProcessed(state.iterations() * sweep.size() * 4);
+}
+BENCHMARK(BM_StovetopCrossfadeVolume);
+
+/** ofxPot::update() on new beats, with N nodes queued in every audio channel: every beat swaps the playing node of
+* each channel for the next one, and a node is dropped in every channel to keep the queues at N.
+* \param state The state of the benchmark, whose argument is the number of nodes per audio channel.
+*/
+static void BM_PotBeatSwap(benchmark::State& state)
+{
+	ofPoint ptOrigin(kitchenViewport::getWidth() / 2, kitchenViewport::getHeight() / 2);
+	ofxPot pot(0xFFFFFF, KITCHEN_BENCHMARK_POT_RADIUS, ptOrigin, KITCHEN_BENCHMARK_BPM);
+	for (int nLane = 0; nLane < OFX_POT_NUMLANES; nLane++)
+	{
+		for (int i = 0; i < state.range(0); i++)
+		{
+			pot.addCookElement(makeSilentNode(nLane, ptOrigin));
+		}
+	}
+
+	int nBeat = 0;
+	for (auto _ : state)
+	{
+		for (int nLane = 0; nLane < OFX_POT_NUMLANES; nLane++)
+		{
+			pot.addCookElement(makeSilentNode(nLane, ptOrigin));
+		}
+		nBeat = (nBeat + 1) % OFX_POT_NUMSEQUENCERSTEPS;
+		pot.update(nBeat);
+	}
+	state.SetItemsProcessed(state.iterations());
+	pot.exit();
+}
+BENCHMARK(BM_PotBeatSwap)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+
+/** ofxPot::mouseTouchMoved() with N nodes dragged at once by as many touches.
+* \param state The state of the benchmark, whose argument is the number of dragged nodes.
+*/
+static void BM_PotNodeDrag(benchmark::State& state)
+{
+	ofPoint ptOrigin(kitchenViewport::getWidth() / 2, kitchenViewport::getHeight() / 2);
+	ofxPot pot(0xFFFFFF, KITCHEN_BENCHMARK_POT_RADIUS, ptOrigin, KITCHEN_BENCHMARK_BPM);
+	int nNodes = state.range(0);
+	vector<ofPoint> touches;
+	for (int i = 0; i < nNodes; i++)
+	{
+		// The nodes are spread on a ring inside the pot, all in the same channel as in a crowded lane
+		float fAngle = TWO_PI * i / nNodes;
+		ofPoint pt = ptOrigin + ofPoint(cos(fAngle), sin(fAngle)) * (KITCHEN_BENCHMARK_POT_RADIUS * 0.6f);
+		pot.addCookElement(makeSilentNode(0, pt));
+		touches.push_back(pt);
+	}
+	// The nodes are added before any of them is grabbed, as the pot keeps pointers to them
+	for (int i = 0; i < nNodes; i++)
+	{
+		pot.mouseTouchDown(touches[i].x, touches[i].y, true, 0, i);
+	}
+
+	int nStep = 0;
+	for (auto _ : state)
+	{
+		// A small wobble, within the radius of the nodes, so that every move hits its node
+		float fWobble = (nStep++ % 2) ? 1.0f : -1.0f;
+		for (int i = 0; i < nNodes; i++)
+		{
+			pot.mouseTouchMoved(touches[i].x + fWobble, touches[i].y, true, 0, i);
+		}
+	}
+	state.SetItemsProcessed(state.iterations() * nNodes);
+	pot.exit();
+}
+BENCHMARK(BM_PotNodeDrag)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
+
+/** ofxParticleSystem::update() for a number of particles, on one thread and on every core, with the touches of
+* four fingers.
+* \param state The state of the benchmark, whose arguments are the number of particles and of threads (0 for one per core).
+*/
+static void BM_ParticleSystemUpdate(benchmark::State& state)
+{
+	ofxParticleSystem particles;
+	particles.setup(state.range(0), state.range(1));
+	particles.setMode(PARTICLE_MODE_REPEL);
+	vector<ofPoint> contacts;
+	contacts.push_back(ofPoint(200, 200));
+	contacts.push_back(ofPoint(800, 200));
+	contacts.push_back(ofPoint(200, 600));
+	contacts.push_back(ofPoint(800, 600));
+	particles.setContacts(contacts);
+
+	for (auto _ : state)
+	{
+		particles.update();
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+	particles.stop();
+}
+BENCHMARK(BM_ParticleSystemUpdate)
+	->Args({1024, 1})->Args({16384, 1})->Args({131072, 1})
+	->Args({16384, 0})->Args({131072, 0})->Args({262144, 0})
+	->UseRealTime();
+
+/** The update of the voices of the pots, with N nodes in every pot and their sounds loaded: every frame sets the
+* volume of each voice from its pot, as the mixer of the kitchen.
+* \param state The state of the benchmark, whose argument is the number of nodes per pot.
+*/
+static void BM_KitchenVoices(benchmark::State& state)
+{
+	// The clock stands still, so that no beat falls within the timed loop
+	ofxManualClock clock;
+	metaphorKitchen kitchen;
+	kitchen.setup(KITCHEN_VIEWPORT_DEFAULT_WIDTH, KITCHEN_VIEWPORT_DEFAULT_HEIGHT, &clock);
+	fillKitchen(kitchen, state.range(0));
+
+	uint64_t nStartAllocations = ofxAllocationCounter::getThreadNumAllocations();
+	for (auto _ : state)
+	{
+		kitchen.update(1.0f / 60.0f);
+	}
+	setAllocationCounter(state, nStartAllocations);
+	state.SetItemsProcessed(state.iterations() * state.range(0) * 4);
+	kitchen.exit();
+}
+BENCHMARK(BM_KitchenVoices)->Arg(1)->Arg(4)->Arg(16)->Arg(64);
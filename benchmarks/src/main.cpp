@@ -0,0 +1,46 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "kitchenViewport.h"
+#include "ofxProfiler.h"
+#include <benchmark/benchmark.h>
+
+#define KITCHEN_BENCHMARKS_OUT "kitchenBenchmarks.json" ///< The default JSON file of the results, in the working directory.
+
+/**
+* The entry point of the benchmarks, which take the arguments of Google Benchmark.
+* Unless --benchmark_out is given, the results are also written as JSON to KITCHEN_BENCHMARKS_OUT.
+* \param argc The number of arguments.
+* \param argv The arguments.
+*/
+int main(int argc, char* argv[])
+{
+	ofAppNoWindow window;
+	ofSetupOpenGL(&window, KITCHEN_VIEWPORT_DEFAULT_WIDTH, KITCHEN_VIEWPORT_DEFAULT_HEIGHT, OF_WINDOW);
+	// The loops and sounds are those of the application
+	ofSetDataPathRoot("../../bin/data/");
+	ofSetLogLevel(OF_LOG_ERROR);
+	// The ring of the profiler is taken before any benchmark counts allocations
+	ofxProfiler::setThreadName("Benchmarks");
+
+	vector<char*> args(argv, argv + argc);
+	bool bHasOut = false;
+	for (int i = 1; i < argc; i++)
+	{
+		bHasOut |= (string(argv[i]).find("--benchmark_out=") == 0);
+	}
+	string sOut = "--benchmark_out=" KITCHEN_BENCHMARKS_OUT;
+	string sOutFormat = "--benchmark_out_format=json";
+	if (!bHasOut)
+	{
+		args.push_back(&sOut[0]);
+		args.push_back(&sOutFormat[0]);
+	}
+	int nArgs = args.size();
+	benchmark::Initialize(&nArgs, args.data());
+	if (benchmark::ReportUnrecognizedArguments(nArgs, args.data()))
+	{
+		return 1;
+	}
+	benchmark::RunSpecifiedBenchmarks();
+	return 0;
+}
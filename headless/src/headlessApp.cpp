@@ -0,0 +1,131 @@
+#include "headlessApp.h"
+
+/**
+* \param sSessionPath The path of the session file to replay, or an empty string to run without input.
+* \param nNumFrames The number of frames to run, or 0 to run until the end of the session.
+* \param bFast Whether the frames run back to back on a manual clock (true) or at the frame rate (false).
+*/
+headlessApp::headlessApp(string sSessionPath, int nNumFrames, bool bFast) :
+	m_sSessionPath(sSessionPath),
+	m_nNumFrames(max(nNumFrames, 0)),
+	m_bFast(bFast),
+	m_clock(bFast ? (const ofxKitchenClock*)&m_manualClock : ofxKitchenClock::getRealtime()),
+	m_nFrame(0),
+	m_nTotalUpdateUs(0),
+	m_nMaxUpdateUs(0),
+	m_nTotalUpdateAllocations(0),
+	m_nMaxUpdateAllocations(0),
+	m_nTotalDispatchUs(0),
+	m_nNumEvents(0)
+{
+}
+
+//--------------------------------------------------------------
+void headlessApp::setup(){
+	// The loops and sounds are those of the application
+	ofSetDataPathRoot("../../bin/data/");
+	ofSetFrameRate(HEADLESS_FRAME_RATE);
+	ofxAllocationCounter::setStrict(true);
+	// The ring of the profiler is taken now, as its allocation would be a violation in the first scope that is timed
+	ofxProfiler::setThreadName("Headless");
+	ofxBinaryLog::setup();
+
+	m_kitchen.setup(KITCHEN_VIEWPORT_DEFAULT_WIDTH, KITCHEN_VIEWPORT_DEFAULT_HEIGHT, m_clock);
+
+	ofAddListener(m_touchPlayer.recordEvent, this, &headlessApp::replayedTouch);
+	if (m_sSessionPath != "" && m_touchPlayer.load(m_sSessionPath))
+	{
+		m_touchPlayer.start(m_clock->getElapsedTimeMillis(), true);
+		ofLog(OF_LOG_NOTICE, "Replaying " + ofToString(m_touchPlayer.getNumRecords()) + " events from " + m_sSessionPath);
+	}
+	else if (m_nNumFrames == 0)
+	{
+		// Without a session there is no end to wait for
+		m_nNumFrames = HEADLESS_DEFAULT_FRAMES;
+	}
+}
+
+//--------------------------------------------------------------
+void headlessApp::update(){
+	if (m_bFast)
+	{
+		while (!isDone())
+		{
+			m_manualClock.advance(1000000 / HEADLESS_FRAME_RATE);
+			step();
+		}
+	}
+	else
+	{
+		step();
+	}
+
+	if (isDone())
+	{
+		report();
+		ofExit(0);
+	}
+}
+
+//--------------------------------------------------------------
+void headlessApp::exit(){
+	ofRemoveListener(m_touchPlayer.recordEvent, this, &headlessApp::replayedTouch);
+	m_kitchen.exit();
+	ofxBinaryLog::stop();
+}
+
+void headlessApp::step()
+{
+	// The updates are measured on the time of the application, whatever the clock of the kitchen
+	uint64_t nStartUs = ofGetElapsedTimeMicros();
+	m_touchPlayer.update(m_clock->getElapsedTimeMillis());
+	uint64_t nDispatchedUs = ofGetElapsedTimeMicros();
+	uint64_t nStartAllocations = ofxAllocationCounter::getThreadNumAllocations();
+	m_kitchen.update(1.0f / HEADLESS_FRAME_RATE);
+	uint64_t nUpdateUs = ofGetElapsedTimeMicros() - nDispatchedUs;
+	uint64_t nUpdateAllocations = ofxAllocationCounter::getThreadNumAllocations() - nStartAllocations;
+
+	m_nTotalDispatchUs += nDispatchedUs - nStartUs;
+	m_nTotalUpdateUs += nUpdateUs;
+	m_nMaxUpdateUs = max(m_nMaxUpdateUs, nUpdateUs);
+	m_nTotalUpdateAllocations += nUpdateAllocations;
+	m_nMaxUpdateAllocations = max(m_nMaxUpdateAllocations, nUpdateAllocations);
+	m_nFrame++;
+}
+
+/** \return Whether the frames were all run, or the session replayed when the number of frames is 0.
+*/
+bool headlessApp::isDone()
+{
+	return (m_nNumFrames > 0 && m_nFrame >= m_nNumFrames) || (m_nNumFrames == 0 && !m_touchPlayer.isPlaying());
+}
+
+/** \param rec The replayed event.
+*/
+void headlessApp::replayedTouch(tactoTouchRecord& rec)
+{
+	m_nNumEvents++;
+	switch (rec.type)
+	{
+	case TACTO_TOUCH_DOWN:
+		m_kitchen.mouseTouchDown(rec.x, rec.y, rec.fullRange != 0, rec.button, rec.touchId);
+		break;
+	case TACTO_TOUCH_MOVED:
+		m_kitchen.mouseTouchMoved(rec.x, rec.y, rec.fullRange != 0, rec.button, rec.touchId);
+		break;
+	case TACTO_TOUCH_UP:
+		m_kitchen.mouseTouchUp(rec.x, rec.y, rec.fullRange != 0, rec.button, rec.touchId);
+		break;
+	}
+}
+
+void headlessApp::report()
+{
+	int nFrames = max(m_nFrame, 1);
+	ofLog(OF_LOG_NOTICE, "Frames: " + ofToString(m_nFrame) + ", kitchen time " + ofToString(m_clock->getElapsedTimeMillis() / 1000) + " s"
+		+ ", update mean " + ofToString(m_nTotalUpdateUs / nFrames) + " us, max " + ofToString(m_nMaxUpdateUs) + " us"
+		+ ", allocations mean " + ofToString((float)m_nTotalUpdateAllocations / nFrames, 2) + ", max " + ofToString(m_nMaxUpdateAllocations)
+		+ ", violations " + ofToString(ofxAllocationCounter::getNumViolations())
+		+ ", events " + ofToString(m_nNumEvents) + " dispatched in " + ofToString(m_nTotalDispatchUs) + " us"
+		+ ", late beats " + ofToString(m_kitchen.getNumLateBeats()));
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+/**
+ * \class headlessApp
+ *
+ * \brief A runner of the kitchen without a window, that replays a recorded session and measures its updates.
+ *
+ * The kitchen, its stove tops, pots and nodes are compiled from the sources of the application, without the window,
+ * the input devices, the network or the visuals. The runner sets the kitchen up for a view of the size of the window
+ * of the application, replays the touches of a session file into it and steps it by a fixed frame time. It logs the
+ * mean and longest update times, the allocations of the updates and the late beats when it is done, and exits, so
+ * that it runs in scripts and on machines without a display. The allocation-free scopes of the kitchen run in strict
+ * mode, and the allocations within them are reported as violations.
+ *
+ * In fast mode, the kitchen and the replay follow an \link ofxManualClock stepped by a frame at a time, and all the
+ * frames run back to back in the first update: hours of play run in seconds, and the same session always gives the
+ * same beats.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "metaphorKitchen.h"
+#include "ofxTouchRecorder.h"
+#include "ofxKitchenClock.h"
+#include "ofxAllocationCounter.h"
+#include "ofxBinaryLog.h"
+#include "ofxProfiler.h"
+
+#define HEADLESS_DEFAULT_FRAMES 3600 ///< The default number of frames to run, one minute at the frame rate.
+#define HEADLESS_FRAME_RATE 60 ///< The number of updates per second, as the application.
+
+class headlessApp : public ofBaseApp
+{
+public:
+	headlessApp(string sSessionPath, int nNumFrames, bool bFast); ///< Constructor
+
+	void							setup();
+	void							update();
+	void							exit();
+
+private:
+	void							replayedTouch(tactoTouchRecord& rec); ///< Forwards a replayed event to the kitchen.
+	void							step(); ///< Replays the events of a frame and updates the kitchen.
+	bool							isDone(); ///< Returns whether or not the run is over.
+	void							report(); ///< Logs the measures of the run.
+
+	metaphorKitchen					m_kitchen; ///< The kitchen, without a window.
+	ofxTouchPlayer					m_touchPlayer; ///< The player of the session.
+	string							m_sSessionPath; ///< The path of the session file, or an empty string to run without input.
+	int								m_nNumFrames; ///< The number of frames to run, or 0 to run until the end of the session.
+	bool							m_bFast; ///< Whether or not the frames run back to back on the manual clock.
+	ofxManualClock					m_manualClock; ///< The clock stepped by a frame at a time, in fast mode.
+	const ofxKitchenClock*			m_clock; ///< The clock of the kitchen and of the replay.
+	int								m_nFrame; ///< The number of frames run so far.
+	uint64_t						m_nTotalUpdateUs; ///< The total time in microseconds spent updating the kitchen.
+	uint64_t						m_nMaxUpdateUs; ///< The longest update of the kitchen, in microseconds.
+	uint64_t						m_nTotalUpdateAllocations; ///< The number of allocations of the updates of the kitchen.
+	uint64_t						m_nMaxUpdateAllocations; ///< The most allocations of an update of the kitchen.
+	uint64_t						m_nTotalDispatchUs; ///< The total time in microseconds spent dispatching the replayed events.
+	int								m_nNumEvents; ///< The number of replayed events.
+};
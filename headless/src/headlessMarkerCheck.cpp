@@ -0,0 +1,132 @@
+#include "headlessMarkerCheck.h"
+
+/**
+* \param sDirectory The directory of the images and of their markers.txt, relative to the data of the runner.
+* \return The number of images whose markers differ from the listed ones, or -1 if the sequence could not be read.
+*/
+int headlessMarkerCheck::run(const string& sDirectory)
+{
+	ofDirectory dir;
+	dir.allowExt("png");
+	dir.allowExt("jpg");
+	dir.allowExt("bmp");
+	dir.listDir(sDirectory);
+	dir.sort();
+
+	vector< vector<fiducialMarker> > expected;
+	if (dir.size() == 0 || !loadExpected(sDirectory + "/markers.txt", expected))
+	{
+		ofLogError("headlessMarkerCheck", "Could not read the images and markers.txt of " + sDirectory);
+		return -1;
+	}
+	expected.resize(max(expected.size(), dir.size()));
+
+	ofxFiducialFinder finder;
+	ofPixels image;
+	vector<fiducialMarker> found;
+	int nNumFailed = 0;
+	for (size_t i = 0; i < dir.size(); i++)
+	{
+		if (!ofLoadImage(image, dir.getPath(i)))
+		{
+			ofLogError("headlessMarkerCheck", "Could not load " + dir.getPath(i));
+			return -1;
+		}
+		if (image.getNumChannels() != 1)
+		{
+			image.setImageType(OF_IMAGE_GRAYSCALE);
+		}
+		found.clear();
+		finder.findMarkers(image, found);
+
+		// Each listed marker takes the found marker that matches it, so that none is counted twice
+		vector<bool> bMatched(found.size(), false);
+		int nNumMissing = 0;
+		for (size_t e = 0; e < expected[i].size(); e++)
+		{
+			const fiducialMarker& marker = expected[i][e];
+			size_t f = 0;
+			while (f < found.size() && (bMatched[f] || !matches(found[f], marker)))
+			{
+				f++;
+			}
+			if (f == found.size())
+			{
+				ofLogError("headlessMarkerCheck", dir.getPath(i) + ": marker " + ofToString(marker.nId) + " at " + ofToString(marker.x, 4)
+					+ ", " + ofToString(marker.y, 4) + " turned by " + ofToString(marker.fAngle, 4) + " not found");
+				nNumMissing++;
+				continue;
+			}
+			bMatched[f] = true;
+		}
+		int nNumExtra = 0;
+		for (size_t f = 0; f < found.size(); f++)
+		{
+			if (!bMatched[f])
+			{
+				ofLogError("headlessMarkerCheck", dir.getPath(i) + ": unexpected marker " + ofToString(found[f].nId) + " at "
+					+ ofToString(found[f].x, 4) + ", " + ofToString(found[f].y, 4) + " turned by " + ofToString(found[f].fAngle, 4));
+				nNumExtra++;
+			}
+		}
+		if (nNumMissing > 0 || nNumExtra > 0)
+		{
+			nNumFailed++;
+		}
+	}
+
+	ofLog(OF_LOG_NOTICE, "Markers of " + ofToString(dir.size()) + " images checked, " + ofToString(nNumFailed) + " differ from " + sDirectory + "/markers.txt");
+	return nNumFailed;
+}
+
+/**
+* \param sPath The path of the list of markers, relative to the data of the runner.
+* \param expected The vector to fill with the markers of each image.
+* \return Whether or not the list could be read.
+*/
+bool headlessMarkerCheck::loadExpected(const string& sPath, vector< vector<fiducialMarker> >& expected)
+{
+	std::ifstream file(ofToDataPath(sPath).c_str());
+	if (!file.is_open())
+	{
+		return false;
+	}
+
+	string sLine;
+	while (std::getline(file, sLine))
+	{
+		if (sLine.empty() || sLine[0] == '#')
+		{
+			continue;
+		}
+		std::istringstream line(sLine);
+		int nImage;
+		fiducialMarker marker;
+		if (!(line >> nImage >> marker.nId >> marker.x >> marker.y >> marker.fAngle) || nImage < 0)
+		{
+			ofLogError("headlessMarkerCheck", sPath + ": cannot read \"" + sLine + "\"");
+			return false;
+		}
+		marker.fSize = 0.0f;
+		if ((size_t)nImage >= expected.size())
+		{
+			expected.resize(nImage + 1);
+		}
+		expected[nImage].push_back(marker);
+	}
+	return true;
+}
+
+/**
+* \param found The marker found in an image.
+* \param expected The listed marker.
+* \return Whether or not the markers have the same ID, position and rotation, within the tolerances.
+*/
+bool headlessMarkerCheck::matches(const fiducialMarker& found, const fiducialMarker& expected)
+{
+	float fAngleDiff = atan2(sin(found.fAngle - expected.fAngle), cos(found.fAngle - expected.fAngle));
+	return found.nId == expected.nId
+		&& fabs(found.x - expected.x) <= MARKER_CHECK_POSITION_TOLERANCE
+		&& fabs(found.y - expected.y) <= MARKER_CHECK_POSITION_TOLERANCE
+		&& fabs(fAngleDiff) <= MARKER_CHECK_ANGLE_TOLERANCE;
+}
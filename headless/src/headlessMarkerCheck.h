@@ -0,0 +1,35 @@
+#pragma once
+
+/**
+ * \class headlessMarkerCheck
+ *
+ * \brief A check of the fiducial finder against a recorded image sequence, without a window.
+ *
+ * The images of a directory are read in the order of their names, as the camera pipeline replays them, and the
+ * markers found in each are compared with those listed in the markers.txt of the directory: one line per marker,
+ * with the index of the image, the ID, the normalized position and the rotation in radians. Every listed marker
+ * must be found with the same ID, within MARKER_CHECK_POSITION_TOLERANCE of its position and
+ * MARKER_CHECK_ANGLE_TOLERANCE of its rotation, and no other marker may be found.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxFiducialFinder.h"
+
+#define MARKER_CHECK_DEFAULT_DIRECTORY "markers" ///< The sequence checked by default, in the data of the runner.
+#define MARKER_CHECK_POSITION_TOLERANCE 0.01f ///< The largest normalized distance between a found and a listed position.
+#define MARKER_CHECK_ANGLE_TOLERANCE 0.1f ///< The largest difference in radians between a found and a listed rotation.
+
+class headlessMarkerCheck
+{
+public:
+	static int						run(const string& sDirectory); ///< Checks the markers found in the images of a directory.
+
+private:
+	static bool						loadExpected(const string& sPath, vector< vector<fiducialMarker> >& expected); ///< Reads the listed markers of each image.
+	static bool						matches(const fiducialMarker& found, const fiducialMarker& expected); ///< Returns whether or not a found marker is a listed one.
+};
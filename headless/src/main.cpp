@@ -0,0 +1,30 @@
+#include "ofMain.h"
+#include "headlessApp.h"
+#include "headlessMarkerCheck.h"
+#include "ofAppNoWindow.h"
+
+/**
+* The entry point of the headless runner.
+* \param argc The number of arguments.
+* \param argv The arguments: the session file to replay, the number of frames to run (0 or none runs until the end of the session),
+* and "fast" to run the frames back to back on a manual clock. With "markers" and an optional directory instead, the
+* runner checks the fiducial finder against a recorded image sequence.
+* \return 0, or 1 if the markers found differ from the recorded ones.
+*/
+int main(int argc, char* argv[])
+{
+	if (argc > 1 && string(argv[1]) == "markers")
+	{
+		ofAppNoWindow window;
+		ofSetupOpenGL(&window, KITCHEN_VIEWPORT_DEFAULT_WIDTH, KITCHEN_VIEWPORT_DEFAULT_HEIGHT, OF_WINDOW);
+		return headlessMarkerCheck::run((argc > 2) ? argv[2] : MARKER_CHECK_DEFAULT_DIRECTORY) == 0 ? 0 : 1;
+	}
+
+	string sSessionPath = (argc > 1) ? argv[1] : "";
+	int nNumFrames = (argc > 2) ? atoi(argv[2]) : 0;
+	bool bFast = (argc > 3) && string(argv[3]) == "fast";
+
+	ofAppNoWindow window;
+	ofSetupOpenGL(&window, KITCHEN_VIEWPORT_DEFAULT_WIDTH, KITCHEN_VIEWPORT_DEFAULT_HEIGHT, OF_WINDOW);
+	ofRunApp(new headlessApp(sSessionPath, nNumFrames, bFast));
+}
@@ -0,0 +1,88 @@
+#ifndef _KITCHEN_SNAPSHOT
+#define _KITCHEN_SNAPSHOT
+
+/**
+ * \class kitchenSnapshot
+ *
+ * \brief A plain, fixed-size copy of the state of the kitchen at one point in time.
+ *
+ * Positions are in kitchen coordinates, that is in pixels without the drag offset of the kitchen,
+ * so that dragging the kitchen only changes the drag offset of the snapshot. The menu of loops and the points
+ * dragged in the background do not move with the kitchen, and are in pixels on the screen.
+ * The snapshot holds no pointers and never allocates, so it can be copied freely between threads.
+ * Its lists have a fixed size: when one is full, the entries that matter most come first (the playing node of
+ * every channel of a pot, the loops dragged out of the menu), and the number of entries left out is recorded.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#define KITCHEN_SNAPSHOT_NUM_POTS 4
+#define KITCHEN_SNAPSHOT_MAX_NODES 16 ///< The maximum number of nodes recorded per pot.
+#define KITCHEN_SNAPSHOT_MAX_MENU_NODES 32 ///< The maximum number of nodes of the menu of loops recorded.
+#define KITCHEN_SNAPSHOT_MAX_DRAG_POINTS 8 ///< The maximum number of points dragged in the background recorded.
+
+/// The state of a node cooking in a pot.
+struct kitchenNodeState
+{
+	int								nNodeId; ///< The unique ID of the node.
+	int								nLane; ///< The audio channel of the node (0 for drums, 1 for bass, 2 for lead).
+	int								nLoopIndex; ///< The index of the loop in the loop configuration.
+	bool							bPlaying; ///< Whether or not the node is the one playing in its lane.
+	bool							bDragged; ///< Whether or not the node is being dragged.
+	bool							bInPot; ///< Whether or not a dragged node is inside its pot, where its volume and lowpass are shown.
+	float							x; ///< The x coordinate of the node, in kitchen coordinates.
+	float							y; ///< The y coordinate of the node, in kitchen coordinates.
+	float							fLeadX; ///< The x offset in pixels at which a dragged node is drawn, ahead of its measured position.
+	float							fLeadY; ///< The y offset in pixels at which a dragged node is drawn, ahead of its measured position.
+	float							fRadius; ///< The radius in pixels of the node.
+	int								nColor; ///< The colour in hexadecimal values of the node.
+	float							fVolume; ///< The relative volume of the node within the pot.
+	float							fLowpass; ///< The standardized ([0;1] range) cutoff frequency of the lowpass filter.
+	int								nLoopBeats; ///< The number of beats of the stutter-like loop (0 when not looping).
+};
+
+/// The state of a pot and of the nodes cooking in it.
+struct kitchenPotState
+{
+	float							x; ///< The x coordinate of the pot, in kitchen coordinates.
+	float							y; ///< The y coordinate of the pot, in kitchen coordinates.
+	float							fRadius; ///< The radius in pixels of the pot.
+	int								nColor; ///< The colour in hexadecimal values of the pot.
+	float							fFocus; ///< The focus volume of the pot.
+	int								nCurrentBeat; ///< The current beat of the pot's sequencer.
+	float							fInfoX; ///< The x coordinate of the stove top information, in kitchen coordinates.
+	float							fInfoY; ///< The y coordinate of the stove top information, in kitchen coordinates.
+	int								nNumNodes; ///< The number of valid entries in nodes.
+	int								nNumDroppedNodes; ///< The number of queued nodes of the pot left out of nodes.
+	kitchenNodeState				nodes[KITCHEN_SNAPSHOT_MAX_NODES]; ///< The nodes cooking in the pot, the playing node of each channel first.
+};
+
+/// A disc drawn over the kitchen, in pixels on the screen.
+struct kitchenDiscState
+{
+	float							x; ///< The x coordinate of the disc.
+	float							y; ///< The y coordinate of the disc.
+	float							fRadius; ///< The radius in pixels of the disc.
+	int								nColor; ///< The colour in hexadecimal values of the disc.
+};
+
+/// The state of the kitchen.
+struct kitchenSnapshot
+{
+	float							fDragX; ///< The normalized x drag offset of the kitchen.
+	float							fDragY; ///< The normalized y drag offset of the kitchen.
+	float							fDrawnDragX; ///< The normalized x drag offset at which the kitchen is drawn, ahead of the measured swipe.
+	float							fDrawnDragY; ///< The normalized y drag offset at which the kitchen is drawn, ahead of the measured swipe.
+	kitchenPotState					pots[KITCHEN_SNAPSHOT_NUM_POTS]; ///< The pots, indexed by stove top ID.
+	int								nNumMenuNodes; ///< The number of valid entries in menuNodes.
+	int								nNumDroppedMenuNodes; ///< The number of nodes of the menu left out of menuNodes.
+	kitchenDiscState				menuNodes[KITCHEN_SNAPSHOT_MAX_MENU_NODES]; ///< The nodes shown by the menu of loops, then the loops dragged out of it.
+	int								nNumDragPoints; ///< The number of valid entries in dragPoints.
+	int								nNumDroppedDragPoints; ///< The number of points dragged in the background left out of dragPoints.
+	kitchenDiscState				dragPoints[KITCHEN_SNAPSHOT_MAX_DRAG_POINTS]; ///< The points dragged in the background.
+};
+
+#endif
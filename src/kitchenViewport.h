@@ -0,0 +1,37 @@
+#ifndef _KITCHEN_VIEWPORT
+#define _KITCHEN_VIEWPORT
+
+/**
+ * \class kitchenViewport
+ *
+ * \brief The size in pixels of the view of the kitchen, to which its normalized coordinates refer.
+ *
+ * The kitchen, its stove tops and its pots convert between normalized and pixel coordinates with this size rather
+ * than with the size of the window, so that they run without one. metaphorKitchen sets it on setup and on resize:
+ * with a window it is the size of the window, and a headless runner picks any size.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define KITCHEN_VIEWPORT_DEFAULT_WIDTH 1024 ///< The width of the view before the kitchen is set up, as the window of main.cpp.
+#define KITCHEN_VIEWPORT_DEFAULT_HEIGHT 768 ///< The height of the view before the kitchen is set up, as the window of main.cpp.
+
+/// The size of the view of the kitchen.
+class kitchenViewport
+{
+public:
+	static void						setSize(int nWidth, int nHeight) { getWidthRef() = nWidth; getHeightRef() = nHeight; } ///< Sets the size of the view. \param nWidth The width in pixels. \param nHeight The height in pixels.
+	static int						getWidth() { return getWidthRef(); } ///< Returns the width of the view, in place of ofGetWidth(). \return The width in pixels.
+	static int						getHeight() { return getHeightRef(); } ///< Returns the height of the view, in place of ofGetHeight(). \return The height in pixels.
+
+private:
+	static int&						getWidthRef() { static int nWidth = KITCHEN_VIEWPORT_DEFAULT_WIDTH; return nWidth; } ///< Returns the width, created on first use. \return The width in pixels.
+	static int&						getHeightRef() { static int nHeight = KITCHEN_VIEWPORT_DEFAULT_HEIGHT; return nHeight; } ///< Returns the height, created on first use. \return The height in pixels.
+};
+
+#endif
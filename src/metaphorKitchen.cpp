@@ -1,13 +1,21 @@
 #include "metaphorKitchen.h"
 #include "TactosonixHelpers.h"
+#include "ofxProfiler.h"
+#include "ofxAllocationCounter.h"
 #include "assert.h"
 
+static const char* s_sStoveUpdateScopes[4] = { "ofxStovetop::update front right", "ofxStovetop::update front left",
+	"ofxStovetop::update rear left", "ofxStovetop::update rear right" }; ///< The profiled scopes of the updates of the stove tops, by ID.
+static const char* s_sStoveDrawScopes[4] = { "ofxStovetop::draw front right", "ofxStovetop::draw front left",
+	"ofxStovetop::draw rear left", "ofxStovetop::draw rear right" }; ///< The profiled scopes of the drawing of the stove tops, by ID.
+
 // ****************************************************************************************
 /** \param x The x coordinate of the point.
 * \param y The y coordinate of the point.
+* \param nTouchId The ID of the touch (or mouse button) dragging the point.
 */
-draggedBGPoint::draggedBGPoint(float x, float y)
-	: ofPoint(x, y)
+draggedBGPoint::draggedBGPoint(float x, float y, int nTouchId)
+	: ofPoint(x, y), m_nTouchId(nTouchId)
 {
 	m_startingPoint.x = x;
 	m_startingPoint.y = y;
@@ -17,10 +25,11 @@ draggedBGPoint::draggedBGPoint(float x, float y)
 	m_color = 0xFFFFFF;
 }
 
-void draggedBGPoint::draw()
+/** \param batch The batch to which the point is added.
+*/
+void draggedBGPoint::draw(ofxBatchRenderer& batch)
 {
-	ofSetHexColor(m_color);
-	ofCircle(x * ofGetWidth(), y * ofGetHeight(), m_radius);
+	batch.addCircle(x * kitchenViewport::getWidth(), y * kitchenViewport::getHeight(), m_radius, ofColor::fromHex(m_color));
 }
 
 /** \param pt The point of origin of the draggable point.
@@ -75,7 +84,18 @@ ofPoint draggedBGPoint::getDrag(bool incremental)
 // ****************************************************************************************
 void metaphorKitchen::setup()
 {
-	ofBackground(0,0,0);
+	setup(ofGetWidth(), ofGetHeight());
+}
+
+/**
+* \param nWidth The width in pixels of the view of the kitchen.
+* \param nHeight The height in pixels of the view of the kitchen.
+* \param clock The clock of the kitchen, or NULL for the time of the application.
+*/
+void metaphorKitchen::setup(int nWidth, int nHeight, const ofxKitchenClock* clock)
+{
+	kitchenViewport::setSize(nWidth, nHeight);
+	m_clock = (clock != NULL) ? clock : ofxKitchenClock::getRealtime();
 	m_dragOffset.x = 0;
 	m_dragOffset.y = 0;
 	
@@ -88,11 +108,15 @@ void metaphorKitchen::setup()
 	}
 	m_nBPM = m_settings.getAttribute("loops", "bpm", 0);
 	m_settings.pushTag("loops");
+	m_loops.clear();
+	m_menuCategories.clear();
+	m_nOpenCategory = -1;
 
 	// Create menu structure and load loops
 	ofColor coulourMenuNodes(0x5D, 0xB1, 0xDB);
-	ofPoint ptCentre = ofPoint(ofGetWidth()/2, ofGetHeight());
+	ofPoint ptCentre = ofPoint(kitchenViewport::getWidth()/2, kitchenViewport::getHeight());
 	ofxTactoSHPMNode* root = new ofxTactoSHPMNode(ofColor(0x25, 0x85, 0xD9));
+	m_menuRoot = root;
 
 	// ********************************************************************************
 	// LOAD THE STORED LOOPS
@@ -114,8 +138,10 @@ void metaphorKitchen::setup()
 		
 		ofxTactoBeatNode* currDrumLoop = new ofxTactoBeatNode(currColour, currPath, currLifetime, TACTO_LOOPTYPE_DRUMS, currNumBeats);
 		loops1->addChild(currDrumLoop);
+		m_loops.push_back(currDrumLoop);
 	}
 	root->addChild(loops1);
+	m_menuCategories.push_back(loops1);
 	
 	// 2) Loops 2 - Bass
 	ofxTactoSHPMNode* loops2 = new ofxTactoSHPMNode(coulourMenuNodes, TACTO_LOOPTYPE_BASS);
@@ -134,8 +160,10 @@ void metaphorKitchen::setup()
 		
 		ofxTactoBeatNode* currBassLoop = new ofxTactoBeatNode(currColour, currPath, currLifetime, TACTO_LOOPTYPE_BASS, currNumBeats);
 		loops2->addChild(currBassLoop);
+		m_loops.push_back(currBassLoop);
 	}
 	root->addChild(loops2);
+	m_menuCategories.push_back(loops2);
 	
 	// 3) Loops 3 - Horns, Guitar, Banjo, Synth
 	ofxTactoSHPMNode* loops3 = new ofxTactoSHPMNode(coulourMenuNodes, TACTO_LOOPTYPE_LEAD);
@@ -154,56 +182,183 @@ void metaphorKitchen::setup()
 		
 		ofxTactoBeatNode* currLeadLoop = new ofxTactoBeatNode(currColour, currPath, currLifetime, TACTO_LOOPTYPE_LEAD, currNumBeats);
 		loops3->addChild(currLeadLoop );
+		m_loops.push_back(currLeadLoop);
 	}
 	root->addChild(loops3);
+	m_menuCategories.push_back(loops3);
 
 	m_shpmMenu.setup(root, ptCentre, 150);
 	
 	// ********************************************************************************
 	// SETUP THE FOUR STOVE TOPS
 	// ********************************************************************************
-	int nRadius = ofGetHeight()/3;
-	ofPoint ptPotOrigin = ofPoint(ofGetWidth()/2, ofGetHeight()/3);
-	m_stovetops[stoveInformation::FRONT_RIGHT] = ofxStovetop(stoveInformation::FRONT_RIGHT, ptPotOrigin, m_nBPM);
-	ptPotOrigin = ofPoint(- ofGetWidth()/2, ofGetHeight()/3);
-	m_stovetops[stoveInformation::FRONT_LEFT] = ofxStovetop(stoveInformation::FRONT_LEFT, ptPotOrigin, m_nBPM);
-	ptPotOrigin = ofPoint(- ofGetWidth()/2, - ofGetHeight() * 2/3);
-	m_stovetops[stoveInformation::REAR_LEFT] = ofxStovetop(stoveInformation::REAR_LEFT, ptPotOrigin, m_nBPM);
-	ptPotOrigin = ofPoint(ofGetWidth()/2, - ofGetHeight() * 2/3);
-	m_stovetops[stoveInformation::REAR_RIGHT] = ofxStovetop(stoveInformation::REAR_RIGHT, ptPotOrigin, m_nBPM);
+	int nRadius = kitchenViewport::getHeight()/3;
+	ofPoint ptPotOrigin = ofPoint(kitchenViewport::getWidth()/2, kitchenViewport::getHeight()/3);
+	m_stovetops[stoveInformation::FRONT_RIGHT] = ofxStovetop(stoveInformation::FRONT_RIGHT, ptPotOrigin, m_nBPM, m_clock);
+	ptPotOrigin = ofPoint(- kitchenViewport::getWidth()/2, kitchenViewport::getHeight()/3);
+	m_stovetops[stoveInformation::FRONT_LEFT] = ofxStovetop(stoveInformation::FRONT_LEFT, ptPotOrigin, m_nBPM, m_clock);
+	ptPotOrigin = ofPoint(- kitchenViewport::getWidth()/2, - kitchenViewport::getHeight() * 2/3);
+	m_stovetops[stoveInformation::REAR_LEFT] = ofxStovetop(stoveInformation::REAR_LEFT, ptPotOrigin, m_nBPM, m_clock);
+	ptPotOrigin = ofPoint(kitchenViewport::getWidth()/2, - kitchenViewport::getHeight() * 2/3);
+	m_stovetops[stoveInformation::REAR_RIGHT] = ofxStovetop(stoveInformation::REAR_RIGHT, ptPotOrigin, m_nBPM, m_clock);
+
+	m_touchPredictor.clear();
+	for (int i=0; i<4; i++)
+	{
+		m_stovetops[i].getPot()->setTouchPredictor(&m_touchPredictor);
+	}
 
-	m_nTimeOfCreationMs = ofGetElapsedTimeMillis();
+	m_nTimeOfCreationMs = m_clock->getElapsedTimeMillis();
+	m_nLastBeatHandled = 0;
+	m_nLateBeats = 0;
 }
 
 void metaphorKitchen::update()
+{
+	update(ofGetLastFrameTime());
+}
+
+/** \param fElapsedSeconds The time in seconds since the last update.
+*/
+void metaphorKitchen::update(float fElapsedSeconds)
 {	
-	// Figure out the current beat
-	int nPeriodSingleBeatMs = (int)(1000 * 60 / m_nBPM);
+	PROFILER_SCOPE("metaphorKitchen::update");
+	bool bNewBeats[4];
+	{
+		ALLOCATION_FREE_SCOPE("metaphorKitchen::update");
+		// Figure out the current beat
+		int nPeriodSingleBeatMs = (int)(1000 * 60 / m_nBPM);
+
+		int nElapsedMs = (int)m_clock->getElapsedTimeMillis() - m_nTimeOfCreationMs;
+		float fNumBeatsElapsed = (float)nElapsedMs / (float)nPeriodSingleBeatMs;
+		int nNumBeatsElapsed = (int)floor(fNumBeatsElapsed);
+		int nNumBeatsSequencer = nNumBeatsElapsed % OFX_POT_NUMSEQUENCERSTEPS;
+
+		// Keep track of the beats that were skipped or handled too late.
+		// Beats that go by while nothing plays are not heard, however slowly the idle frames come.
+		if (nNumBeatsElapsed != m_nLastBeatHandled && isPlaying())
+		{
+			int nLatenessMs = nElapsedMs - nNumBeatsElapsed * nPeriodSingleBeatMs;
+			if (nNumBeatsElapsed > m_nLastBeatHandled + 1)
+			{
+				// Whole beats went by without an update
+				m_nLateBeats += nNumBeatsElapsed - m_nLastBeatHandled - 1;
+			}
+			if (nLatenessMs > KITCHEN_LATE_BEAT_MS)
+			{
+				m_nLateBeats++;
+			}
+		}
+		m_nLastBeatHandled = nNumBeatsElapsed;
 
-	float fNumBeatsElapsed = ((float)ofGetElapsedTimeMillis() - (float)m_nTimeOfCreationMs) / (float)nPeriodSingleBeatMs;
-	int nNumBeatsElapsed = (int)floor(fNumBeatsElapsed);
-	int nNumBeatsSequencer = nNumBeatsElapsed % OFX_POT_NUMSEQUENCERSTEPS;
-	
+		for (int i=0; i<4; i++)
+		{
+			PROFILER_SCOPE(s_sStoveUpdateScopes[i]);
+			int nPreviousBeat = m_stovetops[i].getPot()->getCurrentBeat();
+			m_stovetops[i].update(nNumBeatsSequencer);
+			bNewBeats[i] = (m_stovetops[i].getPot()->getCurrentBeat() != nPreviousBeat);
+		}
+
+		m_touchPredictor.update(fElapsedSeconds);
+	}
+
+	// The onsets are notified out of the scope, as ofEvent and the listeners may allocate
 	for (int i=0; i<4; i++)
 	{
-		m_stovetops[i].update(nNumBeatsSequencer);
+		if (bNewBeats[i])
+		{
+			notifyOnsets(i);
+		}
+	}
+}
+
+/** \param nStove The ID of the stove top.
+*/
+void metaphorKitchen::notifyOnsets(int nStove)
+{
+	ofxPot* pot = m_stovetops[nStove].getPot();
+	kitchenOnset onset;
+	onset.nStove = nStove;
+	for (int nLane = 0; nLane < OFX_POT_NUMLANES; nLane++)
+	{
+		ofxCookableNode* node = pot->getPlayingNode(nLane);
+		if (node == NULL || !node->getIsPlaying())
+		{
+			continue;
+		}
+		onset.nLane = nLane;
+		onset.ptOrigin = node->getOrigin();
+		onset.color = node->getColor();
+		onset.fStrength = ofClamp(node->getRelativeVolume() * pot->getFocusVolume(), 0.0f, 1.0f);
+		ofNotifyEvent(onsetEvent, onset, this);
 	}
 }
 
 void metaphorKitchen::draw()
 {
-	// Draw the stove position
+	PROFILER_SCOPE("metaphorKitchen::draw");
+	// Rebuild the retained shapes of the stove tops only when they changed
+	bool bStaticShapesDirty = !m_staticShapes.isUploaded();
 	for (int i=0; i<4; i++)
 	{
-		m_stovetops[i].draw();
+		bStaticShapesDirty |= m_stovetops[i].isGeometryDirty();
+	}
+	if (bStaticShapesDirty)
+	{
+		m_staticShapes.clear();
+		for (int i=0; i<4; i++)
+		{
+			m_stovetops[i].addStaticShapes(m_staticShapes);
+			m_stovetops[i].clearGeometryDirty();
+		}
+		// The nodes are drawn over every stove top
+		for (int i=0; i<4; i++)
+		{
+			m_stovetops[i].addNodeShapes(m_staticShapes);
+		}
+		m_staticShapes.upload();
+	}
+	if (!m_unitDisc.isUploaded())
+	{
+		m_unitDisc.setUseColors(false);
+		m_unitDisc.addCircle(0.0f, 0.0f, 1.0f, ofColor(255));
+		m_unitDisc.upload();
+	}
+
+	// Draw the stove position, ahead of the swipe: the drag is a single transform
+	ofPoint ptDrawnOffset = getDrawnDragOffset();
+	ofPushMatrix();
+	ofTranslate(ptDrawnOffset.x * kitchenViewport::getWidth(), ptDrawnOffset.y * kitchenViewport::getHeight());
+	for (int i=0; i<4; i++)
+	{
+		m_stovetops[i].drawDisc(m_unitDisc);
+	}
+	m_staticShapes.draw();
+	ofPopMatrix();
+
+	// The dragged nodes and their feedback already include the measured drag
+	ofPoint ptPrediction = ptDrawnOffset - m_dragOffset;
+	ofPushMatrix();
+	ofTranslate(ptPrediction.x * kitchenViewport::getWidth(), ptPrediction.y * kitchenViewport::getHeight());
+	for (int i=0; i<4; i++)
+	{
+		PROFILER_SCOPE(s_sStoveDrawScopes[i]);
+		m_stovetops[i].drawOverlay(m_batch);
+	}
+	m_batch.flush();
+	ofPopMatrix();
+
+	{
+		PROFILER_SCOPE("ofxTactoSHPM::draw");
+		m_shpmMenu.draw(); // menu
 	}
-	m_shpmMenu.draw(); // menu
 
     // Draw the points being dragged, as well as their parameters
     for (vector<draggedBGPoint>::iterator It = m_draggedBackgroundPoints.begin(); It != m_draggedBackgroundPoints.end(); It++)
     {
-		It->draw();
+		It->draw(m_batch);
     }
+	m_batch.flush();
 }
 
 void metaphorKitchen::exit()
@@ -218,20 +373,7 @@ void metaphorKitchen::exit()
 */
 void metaphorKitchen::keyPressed  (int key)
 {
-	if (key == 's')
-	{
-		// Take screenshot
-		ofImage screenImg;  
-		screenImg.allocate(ofGetWidth(), ofGetHeight(), OF_IMAGE_COLOR);  
-		screenImg.grabScreen(0, 0, ofGetWidth(), ofGetHeight());
-		screenImg.resize(400, 300);
-		std::string strSuffix = ofGetTimestampString();
-		
-#ifdef _DEBUG
-		strSuffix += "_debug";
-#endif
-		screenImg.saveImage("screenshot_" + strSuffix + ".png"); 
-	}
+	// Screenshots are taken by ofApp, without stalling the frame
 }
 
 /**
@@ -270,8 +412,9 @@ void metaphorKitchen::mouseReleased(int x, int y, int button)
 */
 void metaphorKitchen::windowResized(int w, int h)
 {
+	kitchenViewport::setSize(w, h);
 	m_shpmMenu.windowResized(w, h);
-	ofPoint ptPotOrigin = ofPoint(ofGetWidth()/2, ofGetHeight()/3);
+	ofPoint ptPotOrigin = ofPoint(kitchenViewport::getWidth()/2, kitchenViewport::getHeight()/3);
 	m_stovetops[stoveInformation::FRONT_RIGHT].windowResized(w, h);
 	m_stovetops[stoveInformation::FRONT_LEFT].windowResized(w, h);
 	m_stovetops[stoveInformation::REAR_LEFT].windowResized(w, h);
@@ -317,8 +460,32 @@ void metaphorKitchen::touchUp(float x, float y, int touchId)
 */
 void metaphorKitchen::mouseTouchDown(float x, float y, bool fullRange, int button, int touchId)
 {
+	ofPoint ptTouch(fullRange ? x / kitchenViewport::getWidth() : x, fullRange ? y / kitchenViewport::getHeight() : y);
+	m_touchPredictor.touchMeasured(touchId, ptTouch.x, ptTouch.y);
+
+	// The menu does not tell which category it opened, so snapshots show the loops of the last one touched
+	int nTouchedCategory = -1;
+	for (size_t i = 0; i < m_menuCategories.size(); i++)
+	{
+		if (m_menuCategories[i]->isPointInside(ptTouch))
+		{
+			nTouchedCategory = i;
+		}
+	}
+	bool bMenuRootTouched = m_menuRoot->isPointInside(ptTouch);
+
     bool touchedMenuPot = false;
-    touchedMenuPot |= m_shpmMenu.mouseTouchDown(x, y, fullRange, button, touchId); // grabs items within the menu
+	bool bTouchedMenu = m_shpmMenu.mouseTouchDown(x, y, fullRange, button, touchId); // grabs items within the menu
+	touchedMenuPot |= bTouchedMenu;
+	if (nTouchedCategory >= 0)
+	{
+		m_nOpenCategory = nTouchedCategory;
+	}
+	else if (!bTouchedMenu || bMenuRootTouched)
+	{
+		// Nor does it tell when it closes: a touch outside the menu or on its root closes the category
+		m_nOpenCategory = -1;
+	}
 	for (int i=0; i<4; i++)
 	{
 		touchedMenuPot |= m_stovetops[i].mouseTouchDown(x, y, fullRange, button, touchId);
@@ -330,11 +497,11 @@ void metaphorKitchen::mouseTouchDown(float x, float y, bool fullRange, int butto
 		ofPoint ptCompare(x, y);
 		if (fullRange)
 		{
-			ptCompare.x /= ofGetWidth();
-			ptCompare.y /= ofGetHeight();
+			ptCompare.x /= kitchenViewport::getWidth();
+			ptCompare.y /= kitchenViewport::getHeight();
 		}
 
-	    draggedBGPoint ptTmp = draggedBGPoint(ptCompare.x, ptCompare.y);
+	    draggedBGPoint ptTmp = draggedBGPoint(ptCompare.x, ptCompare.y, touchId);
 	    m_draggedBackgroundPoints.push_back(ptTmp);
 	}
 }
@@ -348,6 +515,8 @@ void metaphorKitchen::mouseTouchDown(float x, float y, bool fullRange, int butto
 */
 void metaphorKitchen::mouseTouchMoved(float x, float y, bool fullRange, int button, int touchId)
 {
+	m_touchPredictor.touchMeasured(touchId, fullRange ? x / kitchenViewport::getWidth() : x, fullRange ? y / kitchenViewport::getHeight() : y);
+
     bool touchedMenuPot = false;
     touchedMenuPot |= m_shpmMenu.mouseTouchMoved(x, y, fullRange, button, touchId);
 	for (int i=0; i<4; i++)
@@ -358,8 +527,8 @@ void metaphorKitchen::mouseTouchMoved(float x, float y, bool fullRange, int butt
     ofPoint ptCompare(x, y);
     if (fullRange)
     {
-        ptCompare.x /= ofGetWidth();
-        ptCompare.y /= ofGetHeight();
+        ptCompare.x /= kitchenViewport::getWidth();
+        ptCompare.y /= kitchenViewport::getHeight();
     }
 
 	// We didn't touch the menu or pot, let's move the background points
@@ -380,26 +549,47 @@ void metaphorKitchen::mouseTouchMoved(float x, float y, bool fullRange, int butt
 	if (m_draggedBackgroundPoints.size() == 1)
 	{
 		ofPoint ptDrag = m_draggedBackgroundPoints[0].getDrag(true);
-		m_dragOffset += ptDrag;
+		setDragOffset(m_dragOffset + ptDrag);
+	}
+}
+
+/** \param offset The normalized ([0;1] range) drag offset of the kitchen.
+*/
+void metaphorKitchen::setDragOffset(ofPoint offset)
+{
+	m_dragOffset = offset;
 
-		// Put limits on drag offset (remember we start on the front right stove)
-		m_dragOffset.x = min(m_dragOffset.x, 1.0f);
-		m_dragOffset.x = max(m_dragOffset.x, 0.0f);
-		m_dragOffset.y = min(m_dragOffset.y, 1.0f);
-		m_dragOffset.y = max(m_dragOffset.y, 0.0f);
+	// Put limits on drag offset (remember we start on the front right stove)
+	m_dragOffset.x = min(m_dragOffset.x, 1.0f);
+	m_dragOffset.x = max(m_dragOffset.x, 0.0f);
+	m_dragOffset.y = min(m_dragOffset.y, 1.0f);
+	m_dragOffset.y = max(m_dragOffset.y, 0.0f);
 
-		for (int i=0; i<4; i++)
-		{		
-			if (m_dragOffset.x != 0.0f || m_dragOffset.y != 0.0f)
-			{
-				m_stovetops[i].drag(ofPoint(m_dragOffset.x*ofGetWidth(), m_dragOffset.y*ofGetHeight()));
-				float newVolume = m_stovetops[i].getCrossfadeVolume(ofPoint(m_dragOffset));
-				m_stovetops[i].getPot()->setFocusVolume(newVolume);
-			}
-		}
+	// The elements follow the drag for hit testing and crossfades, while drawing only translates
+	for (int i=0; i<4; i++)
+	{
+		m_stovetops[i].drag(ofPoint(m_dragOffset.x*kitchenViewport::getWidth(), m_dragOffset.y*kitchenViewport::getHeight()));
+		m_stovetops[i].getPot()->setKitchenDragOffset(m_dragOffset);
+		float newVolume = m_stovetops[i].getCrossfadeVolume(ofPoint(m_dragOffset));
+		m_stovetops[i].getPot()->setFocusVolume(newVolume);
 	}
 }
 
+/** \return The normalized drag offset of the kitchen, extrapolated to the next frame while it is swiped with one finger.
+*/
+ofPoint metaphorKitchen::getDrawnDragOffset()
+{
+	// Same conditions and limits as the measured drag in mouseTouchMoved() and setDragOffset()
+	if (m_draggedBackgroundPoints.size() != 1)
+	{
+		return m_dragOffset;
+	}
+	ofPoint offset = m_dragOffset + m_touchPredictor.getOffset(m_draggedBackgroundPoints[0].getTouchId());
+	offset.x = ofClamp(offset.x, 0.0f, 1.0f);
+	offset.y = ofClamp(offset.y, 0.0f, 1.0f);
+	return offset;
+}
+
 /**
 * \param x The x coordinate of the point.
 * \param y The y coordinate of the point.
@@ -418,8 +608,8 @@ void metaphorKitchen::mouseTouchUp(float x, float y, bool fullRange, int button,
     ofPoint ptCompare(x, y);
     if (fullRange)
     {
-        ptCompare.x /= ofGetWidth();
-        ptCompare.y /= ofGetHeight();
+        ptCompare.x /= kitchenViewport::getWidth();
+        ptCompare.y /= kitchenViewport::getHeight();
     }
 
 	vector<ofxTactoBeatNode*>::iterator It = m_shpmMenu.getDraggedNodes()->begin();
@@ -435,31 +625,7 @@ void metaphorKitchen::mouseTouchUp(float x, float y, bool fullRange, int button,
 				if (m_stovetops[i].isPointInPot(x, y, fullRange))
 				{
 					// Drop the current node here
-					// create the node here
-					ofxCookableNode cookNode(currentBeatNode->getColor(), 
-						currentBeatNode->getRadius(), currentBeatNode->getLifeTime(), 
-						currentBeatNode->getFullFilePath(), true, currentBeatNode->getLoopType(),
-						currentBeatNode->getLifeTime());
-					cookNode.setOrigin(currentBeatNode->getOrigin(), true);
-					ofPoint fullRangeOffset = ofPoint(m_dragOffset.x * ofGetWidth(), m_dragOffset.y * ofGetHeight());
-					cookNode.setOriginInit(currentBeatNode->getOrigin() - fullRangeOffset, true);
-					cookNode.setLoopLength(currentBeatNode->getLoopLength());
-					ofxPot* currPot = m_stovetops[i].getPot();
-					
-					// Set volume
-					float fDistFromCenter = sqrtf(pow(currPot->getOrigin().x - ptCompare.x*ofGetWidth() , 2.0f) + pow(currPot->getOrigin().y - ptCompare.y*ofGetHeight(), 2.0f));
-					float fVolume = 1.0f - fDistFromCenter / currPot->getRadius();
-					cookNode.setRelativeVolume(fVolume*1.5f);
-					
-					// Set lowpass
-					float yStart = currPot->getOrigin().y + currPot->getRadius(); // lowest point in the pot
-					float tmp1 = ptCompare.y*ofGetHeight();
-					float fRelHeight = (yStart - tmp1)/(2*currPot->getRadius());
-					cookNode.setLowpass(fRelHeight);
-
-					// Do not set loop length until the node is redropped on the pot.
-
-					m_stovetops[i].addCookElement(cookNode);
+					dropLoop(currentBeatNode, i, currentBeatNode->getOrigin(), ptCompare);
 				}
 			}
 			// We are releasing an item that was was dragged
@@ -483,4 +649,164 @@ void metaphorKitchen::mouseTouchUp(float x, float y, bool fullRange, int button,
             ++It2;
         }
 	}
+
+	m_touchPredictor.touchRemoved(touchId);
+}
+
+
+/**
+* \param beatNode The menu node of the loop.
+* \param nStove The ID of the stove top.
+* \param ptNodeOrigin The point of origin in pixels of the new node, including the dragged offset.
+* \param ptDrop The normalized ([0;1] range) point where the loop is dropped, which sets the volume and the lowpass.
+*/
+void metaphorKitchen::dropLoop(ofxTactoBeatNode* beatNode, int nStove, ofPoint ptNodeOrigin, ofPoint ptDrop)
+{
+	// create the node here
+	ofxCookableNode cookNode(beatNode->getColor(), 
+		beatNode->getRadius(), beatNode->getLifeTime(), 
+		beatNode->getFullFilePath(), true, beatNode->getLoopType(),
+		beatNode->getLifeTime(), m_clock);
+	cookNode.setOrigin(ptNodeOrigin, true);
+	ofPoint fullRangeOffset = ofPoint(m_dragOffset.x * kitchenViewport::getWidth(), m_dragOffset.y * kitchenViewport::getHeight());
+	cookNode.setOriginInit(ptNodeOrigin - fullRangeOffset, true);
+	cookNode.setLoopLength(beatNode->getLoopLength());
+	cookNode.setLoopIndex(std::find(m_loops.begin(), m_loops.end(), beatNode) - m_loops.begin());
+	ofxPot* currPot = m_stovetops[nStove].getPot();
+	
+	// Set volume
+	float fDistFromCenter = sqrtf(pow(currPot->getOrigin().x - ptDrop.x*kitchenViewport::getWidth() , 2.0f) + pow(currPot->getOrigin().y - ptDrop.y*kitchenViewport::getHeight(), 2.0f));
+	float fVolume = 1.0f - fDistFromCenter / currPot->getRadius();
+	cookNode.setRelativeVolume(fVolume*1.5f);
+	
+	// Set lowpass
+	float yStart = currPot->getOrigin().y + currPot->getRadius(); // lowest point in the pot
+	float tmp1 = ptDrop.y*kitchenViewport::getHeight();
+	float fRelHeight = (yStart - tmp1)/(2*currPot->getRadius());
+	cookNode.setLowpass(fRelHeight);
+
+	// Do not set loop length until the node is redropped on the pot.
+
+	m_stovetops[nStove].addCookElement(cookNode);
+}
+
+/**
+* \param nStove The ID of the stove top.
+* \param nLoop The index of the loop in the loop configuration.
+* \return Whether or not the loop was added.
+*/
+bool metaphorKitchen::addLoop(int nStove, int nLoop)
+{
+	if (nStove < 0 || nStove >= 4 || nLoop < 0 || nLoop >= (int)m_loops.size())
+	{
+		return false;
+	}
+
+	// Place the node halfway between the centre and the edge of the pot, at mid height
+	ofxPot* currPot = m_stovetops[nStove].getPot();
+	ofPoint ptNodeOrigin = currPot->getOrigin() + ofPoint(currPot->getRadius() / 2, 0);
+	ofPoint ptDrop(ptNodeOrigin.x / kitchenViewport::getWidth(), ptNodeOrigin.y / kitchenViewport::getHeight());
+	dropLoop(m_loops[nLoop], nStove, ptNodeOrigin, ptDrop);
+	return true;
+}
+
+/**
+* \param nStove The ID of the stove top.
+* \param nLane The index of the audio channel (0 for drums, 1 for bass, 2 for lead).
+* \return Whether or not a node was removed.
+*/
+bool metaphorKitchen::removeLoop(int nStove, int nLane)
+{
+	if (nStove < 0 || nStove >= 4)
+	{
+		return false;
+	}
+	return m_stovetops[nStove].getPot()->removePlayingNode(nLane);
+}
+
+/** \return Whether or not a node is playing in one of the pots.
+*/
+bool metaphorKitchen::isPlaying()
+{
+	for (int i=0; i<4; i++)
+	{
+		ofxPot* pot = m_stovetops[i].getPot();
+		for (int nLane = 0; nLane < OFX_POT_NUMLANES; nLane++)
+		{
+			ofxCookableNode* node = pot->getPlayingNode(nLane);
+			if (node != NULL && node->getIsPlaying())
+			{
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/** \param snapshot The snapshot to fill.
+*/
+void metaphorKitchen::fillSnapshot(kitchenSnapshot& snapshot)
+{
+	snapshot.fDragX = m_dragOffset.x;
+	snapshot.fDragY = m_dragOffset.y;
+	ofPoint ptDrawnOffset = getDrawnDragOffset();
+	snapshot.fDrawnDragX = ptDrawnOffset.x;
+	snapshot.fDrawnDragY = ptDrawnOffset.y;
+	for (int i=0; i<4; i++)
+	{
+		m_stovetops[i].fillSnapshot(snapshot.pots[i]);
+	}
+
+	// The menu, its opened category and the loops dragged out of it, which are drawn last but kept before the loops of the category
+	snapshot.nNumMenuNodes = 0;
+	snapshot.nNumDroppedMenuNodes = 0;
+	addMenuNode(snapshot, m_menuRoot);
+	for (size_t i = 0; i < m_menuCategories.size(); i++)
+	{
+		addMenuNode(snapshot, m_menuCategories[i]);
+	}
+	vector<ofxTactoBeatNode*>* draggedNodes = m_shpmMenu.getDraggedNodes();
+	int nMaxMenuNodes = max(KITCHEN_SNAPSHOT_MAX_MENU_NODES - (int)draggedNodes->size(), snapshot.nNumMenuNodes);
+	for (size_t i = 0; i < m_loops.size(); i++)
+	{
+		if (m_loops[i]->getLoopType() == m_nOpenCategory)
+		{
+			addMenuNode(snapshot, m_loops[i], nMaxMenuNodes);
+		}
+	}
+	for (size_t i = 0; i < draggedNodes->size(); i++)
+	{
+		addMenuNode(snapshot, (*draggedNodes)[i]);
+	}
+
+	snapshot.nNumDragPoints = 0;
+	snapshot.nNumDroppedDragPoints = max((int)m_draggedBackgroundPoints.size() - KITCHEN_SNAPSHOT_MAX_DRAG_POINTS, 0);
+	for (size_t i = 0; i < m_draggedBackgroundPoints.size() && snapshot.nNumDragPoints < KITCHEN_SNAPSHOT_MAX_DRAG_POINTS; i++)
+	{
+		draggedBGPoint& point = m_draggedBackgroundPoints[i];
+		kitchenDiscState& disc = snapshot.dragPoints[snapshot.nNumDragPoints++];
+		disc.x = point.x * kitchenViewport::getWidth();
+		disc.y = point.y * kitchenViewport::getHeight();
+		disc.fRadius = point.getRadius();
+		disc.nColor = point.getColor();
+	}
+}
+
+/**
+* \param snapshot The snapshot to which the node is added, unless its menu nodes are full.
+* \param node The node of the menu.
+* \param nMaxMenuNodes The number of menu nodes up to which the node is added, to keep room for those that follow.
+*/
+void metaphorKitchen::addMenuNode(kitchenSnapshot& snapshot, ofxTactoSHPMNode* node, int nMaxMenuNodes)
+{
+	if (snapshot.nNumMenuNodes >= nMaxMenuNodes)
+	{
+		snapshot.nNumDroppedMenuNodes++;
+		return;
+	}
+	kitchenDiscState& disc = snapshot.menuNodes[snapshot.nNumMenuNodes++];
+	disc.x = node->getOrigin().x;
+	disc.y = node->getOrigin().y;
+	disc.fRadius = node->getRadius();
+	disc.nColor = node->getColor().getHex();
 }
@@ -21,24 +21,41 @@
 #include "UI/ofxTactoBeatNode.h"
 #include "ofxStovetop.h"
 #include "ofxCookableNode.h"
+#include "ofxTouchPredictor.h"
 #include <vector>
 #include "ofxXmlSettings.h"
 
+#define KITCHEN_LATE_BEAT_MS 30 ///< A beat handled later than this (in milliseconds) after its due time counts as late.
+
+/// A node playing a new beat of its pot.
+struct kitchenOnset
+{
+	int						nStove; ///< The ID of the stove top of the pot.
+	int						nLane; ///< The audio channel of the node (0 for drums, 1 for bass, 2 for lead).
+	ofPoint					ptOrigin; ///< The position in pixels of the node.
+	ofColor					color; ///< The colour of the node.
+	float					fStrength; ///< The volume ([0;1] range) of the node, including the focus of its pot.
+};
+
 /// A class that implements a dragged point.
 class draggedBGPoint : public ofPoint
 {
 public:
-	draggedBGPoint(float x, float y); ///< Constructor
-	void					draw(); ///< Regular OpenFrameworks function.
+	draggedBGPoint(float x, float y, int nTouchId = 0); ///< Constructor
+	void					draw(ofxBatchRenderer& batch); ///< Adds the point to a batch.
 	void					setPosition(ofPoint pt); ///< Sets the position of the point.
 	bool					isPointInside(ofPoint pt); ///< Returns true if and only if the queried point is inside the dragged point.
 	float					getDragDistance(); ///< Returns the distance dragged by the point.
 	ofPoint					getDrag(bool incremental = false); /// Returns the drag offset of the point.
+	int						getTouchId() { return m_nTouchId; } ///< Returns the ID of the touch dragging the point. \return The ID of the touch.
+	float					getRadius() { return m_radius; } ///< Returns the radius of the point. \return The radius in pixels of the point.
+	int						getColor() { return m_color; } ///< Returns the colour of the point. \return The colour in hexadecimal values of the point.
 private:
 	float					m_radius; ///< The radius of the point.
 	int						m_color; ///< The colour of the point.
 	ofPoint					m_startingPoint; ///< The origin of the drag motion.
 	ofPoint					m_positionLastFrame; ///< A reference point to compute the drag motion.
+	int						m_nTouchId; ///< The ID of the touch (or mouse button) dragging the point.
 };
 
 /// A class that implements the MAKING MUSIC IS COOKING metaphor.
@@ -46,7 +63,9 @@ class metaphorKitchen : public ofBaseApp
 {
 public:	
 	void					setup(); ///< Regular OpenFrameworks function.
+	void					setup(int nWidth, int nHeight, const ofxKitchenClock* clock = NULL); ///< Sets up the kitchen for a view of a given size and a clock, without a window.
 	void					update(); ///< Regular OpenFrameworks function.
+	void					update(float fElapsedSeconds); ///< Updates the kitchen by a time step other than the last frame, as on the simulation thread.
 	void					draw(); ///< Regular OpenFrameworks function.
 	void					exit(); ///< Regular OpenFrameworks function.
 	
@@ -64,14 +83,43 @@ public:
 
 	// Getters & setters
 	ofPoint					getDragOffset() { return m_dragOffset; } ///< Returns the drag offset of the motion. \return A point representing the offset of the drag.
+	void					setDragOffset(ofPoint offset); ///< Sets the normalized drag offset of the kitchen, which moves the view and crossfades the pots.
+	ofPoint					getDrawnDragOffset(); ///< Returns the drag offset at which the kitchen is drawn, ahead of the measured swipe.
+	ofxTouchPredictor*		getTouchPredictor() { return &m_touchPredictor; } ///< Returns the predictor of the touches. \return The predictor of the touches.
+	ofxStovetop*			getStovetop(int nStove) { return &m_stovetops[nStove]; } ///< Returns one of the four stove tops. \param nStove The ID of the stove top. \return The stove top.
+	int						getNumLoops() { return m_loops.size(); } ///< Returns the number of loops in the loop configuration. \return The number of loops.
+	ofxTactoBeatNode*		getLoop(int nLoop) { return m_loops[nLoop]; } ///< Returns a loop of the loop configuration. \param nLoop The index of the loop. \return The menu node of the loop.
+	bool					addLoop(int nStove, int nLoop); ///< Adds a loop of the loop configuration to the pot of a stove top.
+	bool					removeLoop(int nStove, int nLane); ///< Removes the playing node of an audio channel of the pot of a stove top.
+	void					fillSnapshot(kitchenSnapshot& snapshot); ///< Copies the state of the kitchen.
+	bool					isPlaying(); ///< Returns whether or not a node is playing in one of the pots.
+	const ofxKitchenClock*	getClock() { return m_clock; } ///< Returns the clock of the kitchen. \return The clock.
+	int						getNumLateBeats() { return m_nLateBeats; } ///< Returns the number of beats that were skipped or handled late, the musical equivalent of audio xruns. \return The number of late beats.
+
+	ofEvent<kitchenOnset>	onsetEvent; ///< The event notified for every node playing a new beat of its pot.
 
 private:
+	void					dropLoop(ofxTactoBeatNode* beatNode, int nStove, ofPoint ptNodeOrigin, ofPoint ptDrop); ///< Creates a node for a loop and adds it to the pot of a stove top.
+	void					notifyOnsets(int nStove); ///< Notifies an onset for every node playing on the new beat of the pot of a stove top.
+	void					addMenuNode(kitchenSnapshot& snapshot, ofxTactoSHPMNode* node, int nMaxMenuNodes = KITCHEN_SNAPSHOT_MAX_MENU_NODES); ///< Copies a node of the menu into a snapshot, or counts it as left out.
+
 	ofPoint					m_dragOffset; ///< The offset caused by dragging the element around.
 	ofxTactoSHPM			m_shpmMenu; ///< The Stacked Half-Pie Menu (SHPM) of musical elements.
 	ofxStovetop				m_stovetops[4]; ///< The four stove tops in the metaphor.
 	int						m_nBPM; ///< The tempo in beats per minute of the music.
+	vector<ofxTactoBeatNode*>	m_loops; ///< The loops of the loop configuration, in the order of the menu (drums, bass, lead). They are owned by the menu.
+	ofxTactoSHPMNode*		m_menuRoot; ///< The root node of the menu, owned by the menu.
+	vector<ofxTactoSHPMNode*>	m_menuCategories; ///< The categories of loops of the menu (drums, bass, lead), owned by the menu.
+	int						m_nOpenCategory; ///< The index of the category last touched in the menu, whose loops are shown in snapshots, or -1 once a touch lands outside the menu or on its root.
 	vector<draggedBGPoint>	m_draggedBackgroundPoints; ///< A vector of points being dragged in the background of the user interface.
+	ofxBatchRenderer		m_batch; ///< The batch of the shapes of the kitchen that change from frame to frame.
+	ofxBatchRenderer		m_staticShapes; ///< The retained shapes of the stove tops, without the dragged offset, rebuilt when they change.
+	ofxBatchRenderer		m_unitDisc; ///< The retained disc of radius 1 from which the pots are drawn.
+	ofxTouchPredictor		m_touchPredictor; ///< The predictor of the touches, with which dragged nodes and the swiped kitchen are drawn.
+	const ofxKitchenClock*	m_clock; ///< The clock of the kitchen, from which the beats follow.
 	int						m_nTimeOfCreationMs; ///< The time in milliseconds of creation of the metaphor.
+	int						m_nLastBeatHandled; ///< The number of beats elapsed at the last handled beat.
+	int						m_nLateBeats; ///< The number of beats that were skipped or handled late.
 	ofxXmlSettings			m_settings; ///< The XML interface to save and load the configuration.
 };
 
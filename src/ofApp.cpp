@@ -3,6 +3,10 @@
 #include "ofLog.h"
 
 //#define USE_PARTICLES
+#define PARTICLE_COUNT 50000 ///< The number of particles of the OF math example, with USE_PARTICLES.
+//#define USE_FAST_TUIO ///< Receives TUIO with ofxTuioReceiver instead of ofxTactoHandler
+//#define USE_SIMULATION_THREAD ///< Updates the kitchen on ofxKitchenSimulation and draws it with ofxKitchenRenderer
+//#define USE_VERBOSE_LOG ///< Writes the verbose traces of the kitchen, through ofxBinaryLog
 
 //--------------------------------------------------------------
 void ofApp::setup(){
@@ -10,16 +14,21 @@ void ofApp::setup(){
 	ofSetLogLevel(OF_LOG_NOTICE);
 #endif
 
+	// The ring of the profiler is taken before any allocation-free scope runs
+	ofxProfiler::setThreadName("Render");
+	ofxBinaryLog::setup();
+#ifdef USE_VERBOSE_LOG
+	ofxBinaryLog::setLevel(OF_LOG_VERBOSE);
+#endif
 	ofBackground(0, 0, 0);
-	ofSetFrameRate(60);
+	m_frameScheduler.setup();
 	ofSetCircleResolution(40);
 	ofEnableAlphaBlending();
 	ofEnableSmoothing();
 	ofDisableArbTex(); // backward compatibility with old graphics cards
 
-	m_profileInfo.init("fonts/arial.ttf", 20);
-	m_profileInfo.setText("");
-	m_profileInfo.wrapTextX(ofGetWidth() * 3 / 4);
+	m_profileInfo.setFont("fonts/arial.ttf", 20);
+	m_screenCapture.setup();
 
 	// ********************************************************************************
 	// GUI
@@ -31,32 +40,69 @@ void ofApp::setup(){
 	// Metaphor environments
 	// ********************************************************************************
 	m_metaKitchen.setup();
+	m_oscControl.setup(&m_metaKitchen);
+	m_statePublisher.setup();
+	m_kitchenMarkers.setup(&m_metaKitchen);
 
 	// ********************************************************************************
 	// Multi-touch support
 	// ********************************************************************************
+#ifdef USE_FAST_TUIO
+	m_tuioReceiver.setup();
+#else
 	m_touchEngine.setup();
+#endif
 	ofAddListener(ofEvents().touchDown, this, &ofApp::touchDown);
 	ofAddListener(ofEvents().touchUp, this, &ofApp::touchUp);
 
+	// ********************************************************************************
+	// Session recording and replay
+	// ********************************************************************************
+	ofAddListener(m_touchPlayer.recordEvent, this, &ofApp::replayedTouch);
+
 #ifdef USE_PARTICLES
 	// ********************************************************************************
 	// Particle system
 	// ********************************************************************************
 	m_dragDelta = ofPoint(0.0f, 0.0f);
-	// 1 - ofxParticleEmitter particles
-	if (!m_emitter.loadFromXml("snowflakes.pex"))
-	{
-		ofLog(OF_LOG_ERROR, "ofApp::setup() - failed to load emitter config");
-	}
+	m_nNumLiveTouches = 0;
+	// 1 - bursts on the onsets of the music, with a preset set once
+	onsetEmitterPreset preset;
+	preset.nParticlesPerBurst = 20;
+	preset.fLifespan = 0.8f;
+	preset.fLifespanVariance = 0.4f;
+	preset.fSpeed = 60.0f;
+	preset.fSpeedVariance = 40.0f;
+	preset.fAngle = 0.0f;
+	preset.fAngleVariance = 360.0f;
+	preset.fRadialAcceleration = 32.0f;
+	preset.fRadialAccelVariance = 10.0f;
+	preset.fStartSize = 24.0f;
+	preset.fFinishSize = 10.0f;
+	preset.startColor = ofFloatColor(1.0f, 1.0f, 1.0f, 0.7f);
+	preset.finishColor = ofFloatColor(0.4f, 0.4f, 0.4f, 0.0f);
+	m_onsetEmitter.setup();
+	m_onsetEmitter.setPreset(preset);
+#ifndef USE_SIMULATION_THREAD
+	// With the simulation thread, the onsets are drained in update() instead
+	ofAddListener(m_metaKitchen.onsetEvent, this, &ofApp::kitchenOnsetReceived);
+#endif
 
-	// 2 - particles from OF math example
-	int numParticles = 500;
-	p.assign(numParticles, demoParticle());
-	currentMode = PARTICLE_MODE_OFXPARTICLEEMITTER;
+	// 2 - particles from OF math example, on every core
+	m_particles.setup(PARTICLE_COUNT);
+	currentMode = PARTICLE_MODE_ONSETS;
 	currentModeStr = "1 - PARTICLE_MODE_ATTRACT: attracts to mouse";
 	resetParticles();
 #endif
+
+#ifdef USE_SIMULATION_THREAD
+	// ********************************************************************************
+	// Simulation thread, started last as it takes the kitchen over
+	// ********************************************************************************
+	m_kitchenRenderer.setup();
+	m_simulation.setPaused(m_nState != STATE_KITCHEN);
+	m_simulation.setup(&m_metaKitchen, &m_oscControl, &m_kitchenMarkers);
+#endif
 }
 
 //--------------------------------------------------------------
@@ -72,16 +118,93 @@ void ofApp::resetParticles()
 
 	attractPointsWithMovement = attractPoints;
 
-	for (int i = 0; i < p.size(); i++) {
-		p[i].setMode(currentMode);
-		p[i].setAttractPoints(&attractPointsWithMovement);;
-		p[i].reset();
-	}
+	m_particles.setMode(currentMode);
+	m_particles.reset();
 #endif
 }
 
 //--------------------------------------------------------------
 void ofApp::update(){
+	PROFILER_SCOPE("ofApp::update");
+	m_loadStats.beginFrame(ofGetElapsedTimeMicros());
+#ifdef USE_SIMULATION_THREAD
+	m_loadStats.setLateBeats(m_simulation.getFrame().nLateBeats);
+#else
+	m_loadStats.setLateBeats(m_metaKitchen.getNumLateBeats());
+#endif
+	// In strict mode, the allocations of the last frame where there should be none
+	uint64_t nNumViolations = ofxAllocationCounter::getNumViolations();
+	if (nNumViolations != m_nNumViolations)
+	{
+		ofLogWarning("ofxAllocationCounter", ofToString(nNumViolations - m_nNumViolations) + " allocations in allocation-free scopes, the last in "
+			+ ofxAllocationCounter::getLastViolation());
+		m_nNumViolations = nNumViolations;
+	}
+
+	// ************************************************************
+	// Session replay
+	// ************************************************************
+	m_touchPlayer.update(ofGetElapsedTimeMillis());
+
+#ifndef USE_SIMULATION_THREAD
+	// ************************************************************
+	// OSC control surface
+	// ************************************************************
+	if (m_oscControl.update(ofGetElapsedTimeMillis()))
+	{
+		// Loops added or changed from afar count as input
+		m_frameScheduler.wake(ofGetElapsedTimeMillis());
+	}
+#endif
+
+	// ************************************************************
+	// Camera touch detection
+	// ************************************************************
+	m_blobPipeline.update();
+	ofTouchEventArgs touch;
+	while (m_blobPipeline.getNextTouch(touch))
+	{
+		dispatchTouch(touch);
+	}
+	fiducialEvent marker;
+	while (m_blobPipeline.getNextMarker(marker))
+	{
+		// Markers placed, turned or taken off count as input, as touches do
+		m_frameScheduler.wake(ofGetElapsedTimeMillis());
+#ifdef USE_SIMULATION_THREAD
+		m_simulation.postMarker(marker);
+#else
+		m_kitchenMarkers.markerEvent(marker);
+#endif
+	}
+
+#ifdef USE_SIMULATION_THREAD
+	// ************************************************************
+	// Simulation thread
+	// ************************************************************
+	// The kitchen only runs in its state, the commands and OSC being handled anyway
+	m_simulation.setPaused(m_nState != STATE_KITCHEN);
+	if (m_simulation.updateFrame())
+	{
+		m_kitchenRenderer.addFrame(m_simulation.getFrame());
+		if (m_simulation.getFrame().nNumOscUpdates != m_nNumOscUpdates)
+		{
+			// OSC commands applied on the simulation thread count as input
+			m_nNumOscUpdates = m_simulation.getFrame().nNumOscUpdates;
+			m_frameScheduler.wake(ofGetElapsedTimeMillis());
+		}
+	}
+	kitchenOnset onset;
+	while (m_simulation.getNextOnset(onset))
+	{
+		kitchenOnsetReceived(onset);
+	}
+
+	// ************************************************************
+	// Visualizer state
+	// ************************************************************
+	m_snapshot = m_simulation.getFrame().snapshot;
+#else
 	// ************************************************************
 	// Blob handling
 	// ************************************************************
@@ -91,33 +214,113 @@ void ofApp::update(){
 		break;
 	}
 
+	// ************************************************************
+	// Visualizer state
+	// ************************************************************
+	m_metaKitchen.fillSnapshot(m_snapshot);
+#endif
+	// A full snapshot leaves out queued nodes, menu nodes or drag points, which is reported when it starts
+	int nNumDroppedNodes = 0;
+	for (int nPot = 0; nPot < KITCHEN_SNAPSHOT_NUM_POTS; nPot++)
+	{
+		nNumDroppedNodes += m_snapshot.pots[nPot].nNumDroppedNodes;
+	}
+	int nNumDropped = nNumDroppedNodes + m_snapshot.nNumDroppedMenuNodes + m_snapshot.nNumDroppedDragPoints;
+	if (nNumDropped > 0 && m_nNumSnapshotDropped == 0)
+	{
+		ofLogWarning("kitchenSnapshot", "Full: " + ofToString(nNumDroppedNodes) + " queued nodes, " + ofToString(m_snapshot.nNumDroppedMenuNodes)
+			+ " menu nodes and " + ofToString(m_snapshot.nNumDroppedDragPoints) + " drag points left out");
+	}
+	m_nNumSnapshotDropped = nNumDropped;
+	m_statePublisher.update(m_snapshot, ofGetElapsedTimeMillis());
+
 	// ************************************************************
 	// Multi-touch
 	// ************************************************************
+#ifdef USE_FAST_TUIO
+	while (m_tuioReceiver.getNextTouch(touch))
+	{
+		dispatchTouch(touch);
+	}
+#else
 	m_touchEngine.update();
+#endif
 
 #ifdef USE_PARTICLES
 	// ************************************************************
 	// Particle system
 	// ************************************************************
-	// 1 - ofxParticleEmitter particles
-	m_emitter.update();
+	// 1 - bursts on the onsets of the music
+	{
+		PROFILER_SCOPE("ofxOnsetEmitter::update");
+		m_onsetEmitter.update(ofGetLastFrameTime());
+	}
 
 	// 2 - particles from OF math example
-	for (int i = 0; i < p.size(); i++) {
-		p[i].setMode(currentMode);
-		p[i].update();
-	}
 	// add a bit of movement to the attract points
 	for (int i = 0; i < attractPointsWithMovement.size(); i++) {
 		attractPointsWithMovement[i].x = attractPoints[i].x + ofSignedNoise(i * 10, ofGetElapsedTimef() * 0.7) * 12.0;
 		attractPointsWithMovement[i].y = attractPoints[i].y + ofSignedNoise(i * -10, ofGetElapsedTimef() * 0.7) * 12.0;
 	}
+	// the particles react to every live touch and every playing node
+	m_contacts.clear();
+	for (int i = 0; i < m_nNumLiveTouches; i++)
+	{
+		m_contacts.push_back(m_liveTouches[i].pt);
+	}
+	ofPoint ptDrag(m_snapshot.fDragX * ofGetWidth(), m_snapshot.fDragY * ofGetHeight());
+	for (int nPot = 0; nPot < KITCHEN_SNAPSHOT_NUM_POTS; nPot++)
+	{
+		const kitchenPotState& pot = m_snapshot.pots[nPot];
+		for (int i = 0; i < pot.nNumNodes; i++)
+		{
+			if (pot.nodes[i].bPlaying)
+			{
+				m_contacts.push_back(ofPoint(pot.nodes[i].x, pot.nodes[i].y) + ptDrag);
+			}
+		}
+	}
+	if (currentMode == PARTICLE_MODE_NEAREST_POINTS)
+	{
+		m_contacts.insert(m_contacts.end(), attractPointsWithMovement.begin(), attractPointsWithMovement.end());
+	}
+	else if (m_nNumLiveTouches == 0)
+	{
+		// as in the example, the mouse pointer attracts or repels without a click
+		m_contacts.push_back(ofPoint(ofGetMouseX(), ofGetMouseY()));
+	}
+	m_particles.setMode(currentMode);
+	m_particles.setContacts(m_contacts);
+	{
+		PROFILER_SCOPE("ofxParticleSystem::update");
+		m_particles.update();
+	}
+#endif
+
+	// ************************************************************
+	// Frame rate
+	// ************************************************************
+	// Playing nodes pulse on the beats and schedule the music, so they keep the full rate like moving particles
+	bool bAnimating = false;
+	for (int nPot = 0; nPot < KITCHEN_SNAPSHOT_NUM_POTS && !bAnimating && m_nState == STATE_KITCHEN; nPot++)
+	{
+		const kitchenPotState& pot = m_snapshot.pots[nPot];
+		for (int i = 0; i < pot.nNumNodes; i++)
+		{
+			bAnimating |= pot.nodes[i].bPlaying;
+		}
+	}
+#ifdef USE_PARTICLES
+	bAnimating |= currentMode != PARTICLE_MODE_ONSETS || m_onsetEmitter.getNumParticles() > 0;
 #endif
+	// A frame sequence is recorded at a steady rate
+	bAnimating |= m_screenCapture.isRecording();
+	m_frameScheduler.update(ofGetElapsedTimeMillis(), bAnimating);
 }
 
 //--------------------------------------------------------------
 void ofApp::draw(){
+	PROFILER_SCOPE("ofApp::draw");
 	switch (m_nState)
 	{
 	case STATE_INTRO:
@@ -131,7 +334,11 @@ void ofApp::draw(){
 	case STATE_ENVIRONMENTS:
 		// not implemented
 	case STATE_KITCHEN:
+#ifdef USE_SIMULATION_THREAD
+		m_kitchenRenderer.draw(ofGetElapsedTimeMicros());
+#else
 		m_metaKitchen.draw();
+#endif
 		break;
 	case STATE_CROUPIER:
 		break;
@@ -142,21 +349,46 @@ void ofApp::draw(){
 	// draw the frame rate
 #ifdef _DEBUG
 	ofSetHexColor(0xFF0000); // red
-	m_profileInfo.setText(ofToString((int)ofGetFrameRate()));
+	m_profileInfo.setNumber((int)ofGetFrameRate());
 	m_profileInfo.drawCenter(0.1f*ofGetWidth(), 0.9*ofGetHeight());
 #endif
 
 	m_touchEngine.drawBlobs();
 
+	// draw the load statistics
+	if (m_bShowLoadStats)
+	{
+		ofSetHexColor(0xFFFF00);
+		ofDrawBitmapString(m_loadStats.getReport(), 10, ofGetHeight() - 110);
+		ofDrawBitmapString(string(m_frameScheduler.isIdle() ? "Idle" : "Active") + " at " + ofToString(m_frameScheduler.getFrameRate()) + " fps, idle "
+			+ ofToString(m_frameScheduler.getNumIdlePeriods()) + " times" + (m_frameScheduler.isEnabled() ? "" : " (off)") + ", captured "
+			+ ofToString(m_screenCapture.getNumFramesWritten()) + " frames, dropped " + ofToString(m_screenCapture.getNumDropped())
+			+ (m_screenCapture.isRecording() ? " (recording)" : ""), 10, ofGetHeight() - 170);
+		if (m_blobPipeline.isRunning()) {
+			ofDrawBitmapString(m_blobPipeline.getReport(), 10, ofGetHeight() - 150);
+		}
+#ifdef USE_PARTICLES
+		ofDrawBitmapString("Particles: " + ofToString(m_particles.getNumParticles()) + " in " + ofToString(m_particles.getUpdateUs(), 0) + " us, onsets: "
+			+ ofToString(m_onsetEmitter.getNumParticles()) + "/" + ofToString(m_onsetEmitter.getCapacity()), 10, ofGetHeight() - 130);
+#endif
+	}
+
+	// draw the timings of the profiled scopes, per thread
+	if (m_bShowProfiler)
+	{
+		ofSetHexColor(0x00FFFF);
+		ofDrawBitmapString(ofxProfiler::getReport(ofGetElapsedTimeMicros()), ofGetWidth() - 420, 40);
+	}
+
 #ifdef USE_PARTICLES
 	// Draw the particle system
-	if (currentMode == PARTICLE_MODE_OFXPARTICLEEMITTER) {
-		m_emitter.draw(0, 0);
+	if (currentMode == PARTICLE_MODE_ONSETS) {
+		PROFILER_SCOPE("ofxOnsetEmitter::draw");
+		m_onsetEmitter.draw();
 	}
 	else {
-		for (int i = 0; i < p.size(); i++) {
-			p[i].draw();
-		}
+		PROFILER_SCOPE("ofxParticleSystem::draw");
+		m_particles.draw();
 
 		ofSetColor(190);
 		if (currentMode == PARTICLE_MODE_NEAREST_POINTS) {
@@ -174,23 +406,185 @@ void ofApp::draw(){
 	ofSetHexColor(0xFF0000);
 	ofLine(100, 100, 100 + m_dragDelta.x, 100 + m_dragDelta.y);
 
-	// Display text
+	// Display text, formatted again only when the drag changes
 	ofSetColor(230);
-	ofPoint zeroAngle(1.0f, 0.0f);
-	float angle = zeroAngle.angle(m_dragDelta);
-	currentModeStr = "Current drag: " + ofToString(m_dragDelta.x) + " " + ofToString(m_dragDelta.y) + " / angle: " + ofToString(angle);
-	ofDrawBitmapString(currentModeStr + "\n\nSpacebar to reset. \nKeys 1-5 to change mode.", 10, 20);
+	if (m_sDragInfo.empty() || m_dragDelta != m_shownDragDelta)
+	{
+		m_shownDragDelta = m_dragDelta;
+		ofPoint zeroAngle(1.0f, 0.0f);
+		float angle = zeroAngle.angle(m_dragDelta);
+		char sDragInfo[192];
+		snprintf(sDragInfo, sizeof(sDragInfo), "Current drag: %g %g / angle: %g\n\nSpacebar to reset. \nKeys 1-5 to change mode.",
+			m_dragDelta.x, m_dragDelta.y, angle);
+		m_sDragInfo.assign(sDragInfo);
+	}
+	ofDrawBitmapString(m_sDragInfo, 10, 20);
+
+	// Read the frame for the screenshot or the frame sequence, once it is complete
+	m_screenCapture.capture();
 }
 
 void ofApp::exit()
 {
+	m_touchRecorder.stop();
+	m_screenCapture.stop();
+	m_blobPipeline.stop();
+	m_tuioReceiver.stop();
+	m_particles.stop();
+#ifdef USE_SIMULATION_THREAD
+	m_simulation.stop();
+#endif
 	m_metaKitchen.exit();
+	ofxBinaryLog::stop();
+}
+
+void ofApp::resetSession()
+{
+#ifdef USE_SIMULATION_THREAD
+	// The kitchen is set up again on the render thread, while the simulation is stopped
+	m_simulation.stop();
+#endif
+	m_metaKitchen.exit();
+	m_metaKitchen.setup();
+	m_nState = STATE_INTRO;
+#ifdef USE_SIMULATION_THREAD
+	m_kitchenRenderer.setup();
+	m_simulation.setPaused(true);
+	m_simulation.setup(&m_metaKitchen, &m_oscControl, &m_kitchenMarkers);
+#endif
+}
+
+/** \param bRealTime Whether the replay should follow the recorded timing (true) or run as fast as possible (false).
+*/
+void ofApp::startReplay(bool bRealTime)
+{
+	m_touchRecorder.stop();
+	string sFilePath = m_touchRecorder.getFilePath();
+	if (sFilePath == "")
+	{
+		sFilePath = "sessions/replay.tsxs";
+	}
+	if (!m_touchPlayer.load(sFilePath))
+	{
+		return;
+	}
+
+	// A session always starts from the intro screen
+	resetSession();
+	m_touchPlayer.start(ofGetElapsedTimeMillis(), bRealTime);
+	ofLog(OF_LOG_NOTICE, "Replaying " + ofToString(m_touchPlayer.getNumRecords()) + " events from " + sFilePath);
 }
 
 //--------------------------------------------------------------
 void ofApp::keyPressed(int key){
+	m_frameScheduler.wake(ofGetElapsedTimeMillis());
 	m_metaKitchen.keyPressed(key);
 
+	if (key == 'p') {
+		m_bShowLoadStats = !m_bShowLoadStats;
+	}
+	if (key == 's') {
+		// Take a screenshot, encoded on the capture thread
+		std::string strSuffix = ofGetTimestampString();
+#ifdef _DEBUG
+		strSuffix += "_debug";
+#endif
+		m_screenCapture.requestScreenshot("screenshot_" + strSuffix + ".png");
+	}
+	if (key == 'v') {
+		// Record the session as a numbered frame sequence
+		if (m_screenCapture.isRecording()) {
+			m_screenCapture.stopSequence();
+		}
+		else {
+			m_screenCapture.startSequence("captures/" + ofGetTimestampString());
+		}
+	}
+	if (key == 'o') {
+		m_bShowProfiler = !m_bShowProfiler;
+	}
+	if (key == 'a') {
+		// Flag the allocations of the steady-state update and of the voices
+		ofxAllocationCounter::setStrict(!ofxAllocationCounter::isStrict());
+	}
+	if (key == 't') {
+		// Write the timings of the last seconds, to open in chrome://tracing
+		ofDirectory::createDirectory("traces", true, true);
+		string sPath = "traces/trace_" + ofGetTimestampString() + ".json";
+		if (ofxProfiler::writeChromeTrace(sPath)) {
+			ofLog(OF_LOG_NOTICE, "Wrote the trace " + sPath);
+		}
+	}
+	if (key == 'i') {
+		// Keep the full frame rate even when the table is idle
+		m_frameScheduler.setEnabled(!m_frameScheduler.isEnabled());
+	}
+	if (key == 'l') {
+		// Draw dragged nodes and the kitchen at the measured or at the predicted touch positions
+#ifdef USE_SIMULATION_THREAD
+		m_simulation.postTogglePrediction();
+#else
+		ofxTouchPredictor* predictor = m_metaKitchen.getTouchPredictor();
+		predictor->setEnabled(!predictor->isEnabled());
+#endif
+	}
+	if (key == OF_KEY_F5) {
+		// Start or stop recording a session
+		if (m_touchRecorder.isRecording()) {
+			m_touchRecorder.stop();
+			ofLog(OF_LOG_NOTICE, "Recorded session " + m_touchRecorder.getFilePath());
+		}
+		else {
+			ofDirectory::createDirectory("sessions", true, true);
+			resetSession();
+			m_touchRecorder.start("sessions/session_" + ofGetTimestampString() + ".tsxs", ofGetElapsedTimeMillis());
+		}
+	}
+	if (key == OF_KEY_F6) {
+		startReplay(true);
+	}
+	if (key == OF_KEY_F7) {
+		// As fast as possible: the whole session is dispatched in the next update
+		startReplay(false);
+	}
+	if (key == OF_KEY_F8) {
+		// Start or stop the camera touch detection
+		if (m_blobPipeline.isRunning()) {
+			m_blobPipeline.stop();
+		}
+		else {
+			m_blobPipeline.setupCamera();
+		}
+	}
+	if (key == OF_KEY_F9) {
+		// Run the camera touch detection on a recorded video
+		ofFileDialogResult result = ofSystemLoadDialog("Select a recorded camera video");
+		if (result.bSuccess) {
+			m_blobPipeline.setupVideo(result.getPath());
+		}
+	}
+	if (key == OF_KEY_F11) {
+		// Run the camera touch detection on a recorded image sequence
+		ofFileDialogResult result = ofSystemLoadDialog("Select a directory of recorded camera images", true);
+		if (result.bSuccess) {
+			m_blobPipeline.setupImageSequence(result.getPath());
+		}
+	}
+	if (key == OF_KEY_F12) {
+		m_blobPipeline.setFindMarkers(!m_blobPipeline.getFindMarkers());
+	}
+	if (key == 'b') {
+		m_blobPipeline.learnBackground();
+	}
+	if (key == OF_KEY_F10) {
+		// Cost of the touch tracker for growing numbers of fingers
+		ofLogNotice("ofxBlobTracker", "\n" + ofxBlobTracker::benchmark());
+	}
+	if (key == OF_KEY_F4) {
+		// Cost of the TUIO parser and of a loopback TUIO stream
+		ofLogNotice("ofxTuioReceiver", "\n" + ofxTuioReceiver::benchmark());
+	}
+
 #ifdef USE_PARTICLES
 	if (key == '1') {
 		currentMode = PARTICLE_MODE_ATTRACT;
@@ -215,14 +609,14 @@ void ofApp::keyPressed(int key){
 		resetParticles();
 	}
 	if (key == '9') {
-		currentMode = PARTICLE_MODE_OFXPARTICLEEMITTER;
-		currentModeStr = "9 - Using ofxParticleEmitter add-on";
+		currentMode = PARTICLE_MODE_ONSETS;
+		currentModeStr = "9 - Bursts on the onsets of the music";
 	}
 	if (key == 'x') {
-		m_emitter.stopEmitting();
+		m_onsetEmitter.clear();
 	}
 	if (key == 'z') {
-		m_emitter.startEmitting();
+		m_onsetEmitter.burst(ofGetMouseX(), ofGetMouseY(), ofFloatColor(1.0f, 1.0f, 0.0f));
 	}
 
 	if (key == ' ') {
@@ -235,9 +629,7 @@ void ofApp::keyPressed(int key){
 void ofApp::keyReleased(int key){
 	if (key == 'r') {
 		// reset
-		m_metaKitchen.exit();
-		m_metaKitchen.setup();
-		m_nState = STATE_INTRO;
+		resetSession();
 	}
 }
 
@@ -274,7 +666,33 @@ void ofApp::mouseExited(int x, int y){
 
 //--------------------------------------------------------------
 void ofApp::windowResized(int w, int h){
+	m_frameScheduler.wake(ofGetElapsedTimeMillis());
+#ifdef USE_SIMULATION_THREAD
+	m_simulation.postResize(w, h);
+#else
 	m_metaKitchen.windowResized(w, h);
+#endif
+}
+
+/**
+* \param args The touch event, whatever its type.
+*/
+void ofApp::dispatchTouch(ofTouchEventArgs& args)
+{
+	switch (args.type)
+	{
+	case ofTouchEventArgs::down:
+		touchDown(args);
+		break;
+	case ofTouchEventArgs::move:
+		touchMoved(args);
+		break;
+	case ofTouchEventArgs::up:
+		touchUp(args);
+		break;
+	default:
+		break;
+	}
 }
 
 /**
@@ -301,6 +719,34 @@ void ofApp::touchUp(ofTouchEventArgs& args)
 	mouseTouchUp(args.x, args.y, false, 0, args.id);
 }
 
+/**
+* \param rec The replayed event.
+*/
+void ofApp::replayedTouch(tactoTouchRecord& rec)
+{
+	switch (rec.type)
+	{
+	case TACTO_TOUCH_DOWN:
+		mouseTouchDown(rec.x, rec.y, rec.fullRange != 0, rec.button, rec.touchId);
+		break;
+	case TACTO_TOUCH_MOVED:
+		mouseTouchMoved(rec.x, rec.y, rec.fullRange != 0, rec.button, rec.touchId);
+		break;
+	case TACTO_TOUCH_UP:
+		mouseTouchUp(rec.x, rec.y, rec.fullRange != 0, rec.button, rec.touchId);
+		break;
+	}
+}
+
+/** \param onset The node playing a new beat of its pot.
+*/
+void ofApp::kitchenOnsetReceived(kitchenOnset& onset)
+{
+#ifdef USE_PARTICLES
+	m_onsetEmitter.burst(onset.ptOrigin.x, onset.ptOrigin.y, ofFloatColor(onset.color), onset.fStrength);
+#endif
+}
+
 /**
 * \param x The x coordinate of the point.
 * \param y The y coordinate of the point.
@@ -310,8 +756,22 @@ void ofApp::touchUp(ofTouchEventArgs& args)
 */
 void ofApp::mouseTouchDown(float x, float y, bool fullRange, int button, int touchId)
 {
+	PROFILER_SCOPE("ofApp::mouseTouchDown");
+	uint64_t nDispatchStartUs = ofGetElapsedTimeMicros();
+	m_touchRecorder.record(TACTO_TOUCH_DOWN, x, y, fullRange, button, touchId, ofGetElapsedTimeMillis());
+	m_frameScheduler.wake(ofGetElapsedTimeMillis());
 #ifdef USE_PARTICLES
-	m_emitter.startEmitting();
+	// Touches beyond APP_MAX_LIVE_TOUCHES still reach the kitchen, the particles just ignore them
+	int nLiveTouch = findLiveTouch(fullRange ? -1 : touchId);
+	if (nLiveTouch < 0 && m_nNumLiveTouches < APP_MAX_LIVE_TOUCHES)
+	{
+		nLiveTouch = m_nNumLiveTouches++;
+		m_liveTouches[nLiveTouch].nTouchId = fullRange ? -1 : touchId;
+	}
+	if (nLiveTouch >= 0)
+	{
+		m_liveTouches[nLiveTouch].pt = fullRange ? ofPoint(x, y) : ofPoint(x * ofGetWidth(), y * ofGetHeight());
+	}
 #endif
 	switch (m_nState) {
 	case STATE_INTRO:
@@ -319,11 +779,16 @@ void ofApp::mouseTouchDown(float x, float y, bool fullRange, int button, int tou
 	case STATE_ENVIRONMENTS:
 		break;
 	case STATE_KITCHEN:
+#ifdef USE_SIMULATION_THREAD
+		m_simulation.postTouch(TACTO_TOUCH_DOWN, x, y, fullRange, button, touchId);
+#else
 		m_metaKitchen.mouseTouchDown(x, y, fullRange, button, touchId);
+#endif
 		break;
 	default:
 		break;
 	}
+	m_loadStats.addDispatchTime(ofGetElapsedTimeMicros() - nDispatchStartUs);
 }
 
 /**
@@ -335,47 +800,37 @@ void ofApp::mouseTouchDown(float x, float y, bool fullRange, int button, int tou
 */
 void ofApp::mouseTouchMoved(float x, float y, bool fullRange, int button, int touchId)
 {
+	PROFILER_SCOPE("ofApp::mouseTouchMoved");
+	uint64_t nDispatchStartUs = ofGetElapsedTimeMicros();
+	m_touchRecorder.record(TACTO_TOUCH_MOVED, x, y, fullRange, button, touchId, ofGetElapsedTimeMillis());
+	m_frameScheduler.wake(ofGetElapsedTimeMillis());
+
 	// compute drag delta
 	m_dragDelta = ofPoint(x, y) - m_oldCursorPosition;
 	m_oldCursorPosition = ofPoint(x, y);
-	// Compute angle
-	ofPoint zeroAngle(1.0f, 0.0f);
-	float angle = zeroAngle.angle(m_dragDelta);
+#ifdef USE_PARTICLES
+	// The mouse also moves without a button down, which is not a contact
+	int nLiveTouch = findLiveTouch(fullRange ? -1 : touchId);
+	if (nLiveTouch >= 0)
+	{
+		m_liveTouches[nLiveTouch].pt = fullRange ? ofPoint(x, y) : ofPoint(x * ofGetWidth(), y * ofGetHeight());
+	}
+#endif
 	
 	switch(m_nState) {
 		case STATE_INTRO:
 		case STATE_ENVIRONMENTS:
 		case STATE_KITCHEN:
+#ifdef USE_SIMULATION_THREAD
+			m_simulation.postTouch(TACTO_TOUCH_MOVED, x, y, fullRange, button, touchId);
+#else
 			m_metaKitchen.mouseTouchMoved(x, y, fullRange, button, touchId);
-#ifdef USE_PARTICLES
-			m_emitter.duration = -1.0f;
-			m_emitter.radialAcceleration = 32.0f;
-			m_emitter.radialAccelVariance = 10.0f;
-			m_emitter.startColor.red = 1.0f;
-			m_emitter.startColor.green = 1.0f;
-			m_emitter.startColor.blue = 0.0f;
-			m_emitter.startColor.alpha = 0.7f;
-			m_emitter.startParticleSize = 24.0f;
-			m_emitter.finishColor.red = 0.4f;
-			m_emitter.finishColor.green = 0.4f;
-			m_emitter.finishColor.blue = 0.0f;
-			m_emitter.finishColor.alpha = 0.0f;
-			m_emitter.finishParticleSize = 10.0f;
-			m_emitter.maxParticles = 20;
-			m_emitter.speed = 60.0f;
-			m_emitter.speedVariance = 40.0f;
-			m_emitter.angle = angle;
-			m_emitter.angleVariance = 0.0f; //360.0f;
-			
-			if(currentMode == PARTICLE_MODE_OFXPARTICLEEMITTER){
-				m_emitter.sourcePosition.x = x;
-				m_emitter.sourcePosition.y = y;
-			}
 #endif
 		break;
 	default:
 		break;
 	}
+	m_loadStats.addDispatchTime(ofGetElapsedTimeMicros() - nDispatchStartUs);
 }
 
 /**
@@ -387,6 +842,11 @@ void ofApp::mouseTouchMoved(float x, float y, bool fullRange, int button, int to
 */
 void ofApp::mouseTouchUp(float x, float y, bool fullRange, int button, int touchId)
 {
+	PROFILER_SCOPE("ofApp::mouseTouchUp");
+	uint64_t nDispatchStartUs = ofGetElapsedTimeMicros();
+	m_touchRecorder.record(TACTO_TOUCH_UP, x, y, fullRange, button, touchId, ofGetElapsedTimeMillis());
+	m_frameScheduler.wake(ofGetElapsedTimeMillis());
+
 	switch(m_nState)
 	{
 	case STATE_INTRO:
@@ -396,15 +856,40 @@ void ofApp::mouseTouchUp(float x, float y, bool fullRange, int button, int touch
 	case STATE_ENVIRONMENTS:
 		break;
 	case STATE_KITCHEN:
+#ifdef USE_SIMULATION_THREAD
+		m_simulation.postTouch(TACTO_TOUCH_UP, x, y, fullRange, button, touchId);
+#else
 		m_metaKitchen.mouseTouchUp(x, y, fullRange, button, touchId);
+#endif
 		break;
 	default:
 		break;
 	}
 
 #ifdef USE_PARTICLES
-	m_emitter.stopEmitting();
+	// The last touch takes the place of the one released
+	int nLiveTouch = findLiveTouch(fullRange ? -1 : touchId);
+	if (nLiveTouch >= 0)
+	{
+		m_liveTouches[nLiveTouch] = m_liveTouches[--m_nNumLiveTouches];
+	}
 #endif
+	m_loadStats.addDispatchTime(ofGetElapsedTimeMicros() - nDispatchStartUs);
+}
+
+/** \param nTouchId The ID of the touch (-1 for the mouse).
+* \return The index of the touch in m_liveTouches, or -1 if it is not down.
+*/
+int ofApp::findLiveTouch(int nTouchId)
+{
+	for (int i = 0; i < m_nNumLiveTouches; i++)
+	{
+		if (m_liveTouches[i].nTouchId == nTouchId)
+		{
+			return i;
+		}
+	}
+	return -1;
 }
 
 //--------------------------------------------------------------
@@ -1,12 +1,35 @@
 #pragma once
 
 #include "ofMain.h"
-#include "ofxTextSuite.h"
+#include "ofxCachedText.h"
 #include "metaphorKitchen.h"
 #include "ofxTactoHandler.h"
+#include "ofxTouchRecorder.h"
+#include "ofxLoadStats.h"
+#include "ofxProfiler.h"
+#include "ofxAllocationCounter.h"
+#include "ofxBinaryLog.h"
+#include "ofxFrameScheduler.h"
+#include "ofxScreenCapture.h"
+#include "ofxKitchenOscControl.h"
+#include "ofxKitchenStatePublisher.h"
+#include "ofxBlobPipeline.h"
+#include "ofxKitchenMarkers.h"
+#include "ofxTuioReceiver.h"
+#include "ofxKitchenSimulation.h"
+#include "ofxKitchenRenderer.h"
 
-#include "ofxParticleEmitter.h"
-#include "demoParticle.h"
+#include "ofxOnsetEmitter.h"
+#include "ofxParticleSystem.h"
+
+#define APP_MAX_LIVE_TOUCHES 32 ///< The maximum number of touches down at once that the particles react to.
+
+/// A touch that is down, which the particles react to.
+struct liveTouch
+{
+	int							nTouchId; ///< The ID of the touch (-1 for the mouse).
+	ofPoint						pt; ///< The position in pixels.
+};
 
 // The states of the application
 enum testAppStates
@@ -40,14 +63,17 @@ class ofApp : public ofBaseApp{
 		void					touchDown(ofTouchEventArgs& args); ///< Regular OpenFrameworks function.
 		void					touchUp(ofTouchEventArgs& args); ///< Regular OpenFrameworks function.
 		void					touchMoved(ofTouchEventArgs& args); ///< Regular OpenFrameworks function.
+		void					dispatchTouch(ofTouchEventArgs& args); ///< Calls touchDown(), touchMoved() or touchUp() for a queued touch event.
 		void					mouseTouchDown(float x, float y, bool fullRange, int button = 0, int touchId = 0); ///< A handler function for mouse and touch down events.
 		void					mouseTouchMoved(float x, float y, bool fullRange, int button = 0, int touchId = 0); ///< A handler function for mouse and touch moved events.
 		void					mouseTouchUp(float x, float y, bool fullRange, int button = 0, int touchId = 0);
+		void					replayedTouch(tactoTouchRecord& rec); ///< A handler function for the events of a replayed session.
+		void					kitchenOnsetReceived(kitchenOnset& onset); ///< Emits a burst of particles on an onset of the music.
 
 		metaphorKitchen*		getKitchen() { return &m_metaKitchen; } ///< Returns the kitchen metaphor class.
 
 		ofApp()
-		: m_nState(STATE_INTRO) {} ///< Constructor
+		: m_nState(STATE_INTRO), m_bShowLoadStats(false), m_bShowProfiler(false), m_nNumViolations(0), m_nNumOscUpdates(0), m_nNumSnapshotDropped(0) {} ///< Constructor
 
 private:
 		unsigned long int		m_nCounter; ///< A counter for dynamic features.
@@ -57,23 +83,52 @@ private:
 		ofImage					m_IDMILlogo; ///< The IDMIL logo.
 
 		// Display
-		ofxTextBlock			m_profileInfo; ///< A text block to display profiling information for the application.
+		ofxCachedText			m_profileInfo; ///< A text block to display profiling information for the application.
+		ofxLoadStats			m_loadStats; ///< The frame time, dispatch time and late beat statistics of the application.
+		bool					m_bShowLoadStats; ///< Whether or not the load statistics are displayed.
+		bool					m_bShowProfiler; ///< Whether or not the timings of the profiled scopes are displayed.
+		uint64_t				m_nNumViolations; ///< The number of allocations in allocation-free scopes already reported.
+		uint64_t				m_nNumOscUpdates; ///< The number of simulation steps that applied OSC commands, as last seen, with USE_SIMULATION_THREAD.
+		int						m_nNumSnapshotDropped; ///< The number of entries left out of the last snapshot, reported when it stops being 0.
+		ofxFrameScheduler		m_frameScheduler; ///< The adaptation of the frame rate to the activity of the table.
+		ofxScreenCapture		m_screenCapture; ///< The screenshots and frame sequences, encoded on a worker thread.
 
 											   // Metaphor environments
 		metaphorKitchen			m_metaKitchen; ///< The implementation of the MAKING MUSIC IS COOKING metaphor.
 
+		ofxKitchenOscControl	m_oscControl; ///< The OSC control surface of the kitchen.
+		ofxKitchenStatePublisher	m_statePublisher; ///< The publisher of the kitchen state to external visualizers.
+		kitchenSnapshot			m_snapshot; ///< The state of the kitchen at the last update.
+		ofxKitchenSimulation	m_simulation; ///< The thread that updates the kitchen, with USE_SIMULATION_THREAD.
+		ofxKitchenRenderer		m_kitchenRenderer; ///< The renderer of the states published by m_simulation, with USE_SIMULATION_THREAD.
+
 											   // Touch handler
 		ofxTactoHandler			m_touchEngine; ///< The handler of TUIO events.
+		ofxTuioReceiver			m_tuioReceiver; ///< The allocation-free TUIO receiver, used instead of m_touchEngine with USE_FAST_TUIO.
 		ofPoint					m_dragDelta; ///< The drag motion difference between frames.
 		ofPoint					m_oldCursorPosition;
+		ofPoint					m_shownDragDelta; ///< The drag motion described by m_sDragInfo.
+		string					m_sDragInfo; ///< The description of the drag motion, displayed every frame.
+		ofxBlobPipeline			m_blobPipeline; ///< The camera-based touch detection, as an alternative to TUIO.
+		ofxKitchenMarkers		m_kitchenMarkers; ///< The mapping of fiducial markers to the kitchen.
+
+		// Session recording and replay
+		ofxTouchRecorder		m_touchRecorder; ///< The recorder of input events.
+		ofxTouchPlayer			m_touchPlayer; ///< The player of recorded input events.
+		void					resetSession(); ///< Resets the application to the intro screen with a fresh kitchen.
+		void					startReplay(bool bRealTime); ///< Replays the last recorded session.
 
 		// Particle system
-		ofxParticleEmitter		m_emitter;
+		ofxOnsetEmitter			m_onsetEmitter; ///< The bursts of particles on the onsets of the music.
 		void					resetParticles();
 		particleMode			currentMode;
 		string					currentModeStr;
 
-		vector<demoParticle>	p;
+		ofxParticleSystem		m_particles; ///< The particles of the OF math example.
 		vector<ofPoint>			attractPoints;
 		vector<ofPoint>			attractPointsWithMovement;
+		liveTouch				m_liveTouches[APP_MAX_LIVE_TOUCHES]; ///< The touches that are down, in no particular order, so that a touch down does not allocate.
+		int						m_nNumLiveTouches; ///< The number of touches that are down.
+		int						findLiveTouch(int nTouchId); ///< Returns the index of a touch that is down, or -1.
+		vector<ofPoint>			m_contacts; ///< The live touches and playing nodes the particles react to.
 };
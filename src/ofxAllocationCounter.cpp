@@ -0,0 +1,159 @@
+#include "ofxAllocationCounter.h"
+#include <cstdlib>
+#include <new>
+
+std::atomic<uint64_t> ofxAllocationCounter::s_nNumAllocations(0);
+std::atomic<uint64_t> ofxAllocationCounter::s_nNumBytes(0);
+std::atomic<bool> ofxAllocationCounter::s_bStrict(false);
+std::atomic<uint64_t> ofxAllocationCounter::s_nNumViolations(0);
+std::atomic<const char*> ofxAllocationCounter::s_sLastViolation(NULL);
+allocationScope ofxAllocationCounter::s_scopes[ALLOCATION_MAX_SCOPES];
+std::atomic<int> ofxAllocationCounter::s_nNumScopes(0);
+std::mutex ofxAllocationCounter::s_scopesMutex;
+
+// The counters of each thread are plain values, which need no construction before the first allocation
+static thread_local uint64_t s_nThreadNumAllocations = 0;
+static thread_local const char* s_sThreadScope = NULL;
+
+/** \return The number of allocations of the calling thread since it started.
+*/
+uint64_t ofxAllocationCounter::getThreadNumAllocations()
+{
+	return s_nThreadNumAllocations;
+}
+
+/** \param nBytes The size in bytes of the allocation.
+*/
+void ofxAllocationCounter::countAllocation(size_t nBytes)
+{
+	s_nNumAllocations.fetch_add(1, std::memory_order_relaxed);
+	s_nNumBytes.fetch_add(nBytes, std::memory_order_relaxed);
+	s_nThreadNumAllocations++;
+	if (s_sThreadScope != NULL && s_bStrict.load(std::memory_order_relaxed))
+	{
+		s_nNumViolations.fetch_add(1, std::memory_order_relaxed);
+		s_sLastViolation.store(s_sThreadScope, std::memory_order_relaxed);
+		onViolation(s_sThreadScope, nBytes);
+	}
+}
+
+/**
+* \param sScope The name of the innermost allocation-free scope.
+* \param nBytes The size in bytes of the allocation.
+*/
+void ofxAllocationCounter::onViolation(const char* sScope, size_t nBytes)
+{
+	// Logging would allocate again: the violation is reported once the scope is left. The arguments are kept named for
+	// the debugger.
+	(void)sScope;
+	(void)nBytes;
+#ifdef ALLOCATION_STRICT_ABORT
+	abort();
+#endif
+}
+
+/** \param sName The name of the scope.
+* \return The index of the scope, or -1 if the table of the scopes is full.
+*/
+int ofxAllocationCounter::findScope(const char* sName)
+{
+	int nNumScopes = s_nNumScopes.load(std::memory_order_acquire);
+	for (int i = 0; i < nNumScopes; i++)
+	{
+		if (s_scopes[i].sName.load(std::memory_order_relaxed) == sName)
+		{
+			return i;
+		}
+	}
+
+	// The scope runs for the first time: another thread may have registered it meanwhile
+	std::lock_guard<std::mutex> lock(s_scopesMutex);
+	nNumScopes = s_nNumScopes.load(std::memory_order_relaxed);
+	for (int i = 0; i < nNumScopes; i++)
+	{
+		if (s_scopes[i].sName.load(std::memory_order_relaxed) == sName)
+		{
+			return i;
+		}
+	}
+	if (nNumScopes == ALLOCATION_MAX_SCOPES)
+	{
+		return -1;
+	}
+	s_scopes[nNumScopes].sName.store(sName, std::memory_order_relaxed);
+	s_nNumScopes.store(nNumScopes + 1, std::memory_order_release);
+	return nNumScopes;
+}
+
+/** \param sName The name of the scope, which must live as long as the application.
+*/
+ofxAllocationFreeScope::ofxAllocationFreeScope(const char* sName) :
+	m_nScope(ofxAllocationCounter::findScope(sName)),
+	m_sOuterScope(s_sThreadScope),
+	m_nStartAllocations(s_nThreadNumAllocations)
+{
+	s_sThreadScope = sName;
+}
+
+ofxAllocationFreeScope::~ofxAllocationFreeScope()
+{
+	s_sThreadScope = m_sOuterScope;
+	if (m_nScope >= 0)
+	{
+		allocationScope& scope = ofxAllocationCounter::s_scopes[m_nScope];
+		scope.nNumCalls.fetch_add(1, std::memory_order_relaxed);
+		scope.nNumAllocations.fetch_add(s_nThreadNumAllocations - m_nStartAllocations, std::memory_order_relaxed);
+	}
+}
+
+// ********************************************************************************
+// Global allocation functions
+// ********************************************************************************
+// The array and nothrow forms, and the sized deallocations of C++14, otherwise forward to these
+
+void* operator new(size_t nBytes)
+{
+	ofxAllocationCounter::countAllocation(nBytes);
+	void* p = malloc(nBytes > 0 ? nBytes : 1);
+	if (p == NULL)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+void* operator new[](size_t nBytes)
+{
+	return operator new(nBytes);
+}
+
+void* operator new(size_t nBytes, const std::nothrow_t&) noexcept
+{
+	ofxAllocationCounter::countAllocation(nBytes);
+	return malloc(nBytes > 0 ? nBytes : 1);
+}
+
+void* operator new[](size_t nBytes, const std::nothrow_t& tag) noexcept
+{
+	return operator new(nBytes, tag);
+}
+
+void operator delete(void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+	free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+	free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+	free(p);
+}
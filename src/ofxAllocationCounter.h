@@ -0,0 +1,91 @@
+#ifndef _OFX_ALLOCATION_COUNTER
+#define _OFX_ALLOCATION_COUNTER
+
+/**
+ * \class ofxAllocationCounter
+ *
+ * \brief This class counts the allocations of the whole application, through the global operator new and delete
+ * that it replaces, and flags those made where the frames should not allocate.
+ *
+ * Every allocation is counted once for the application and once for its thread, with no lock. The load statistics
+ * take the difference from frame to frame. The code that runs every frame once the application is in its steady
+ * state, and the update of the voices of the pots that stands in for the audio block, is marked with
+ * ALLOCATION_FREE_SCOPE("name"): the allocations within each named scope are counted per call. In strict mode, an
+ * allocation within such a scope is a violation: it is counted with the name of the innermost scope, and
+ * onViolation() is called from within the allocation, so that a breakpoint there stops on the offending code. With
+ * ALLOCATION_STRICT_ABORT defined, a violation aborts the application instead.
+ *
+ * Nothing here allocates: the names of the scopes are not copied, so they must be string literals, and the scopes are
+ * kept in a fixed table.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define ALLOCATION_MAX_SCOPES 16 ///< The maximum number of named allocation-free scopes.
+
+//#define ALLOCATION_STRICT_ABORT // Aborts on the first violation in strict mode, rather than counting it
+
+#define ALLOCATION_CONCAT_INNER(a, b) a##b
+#define ALLOCATION_CONCAT(a, b) ALLOCATION_CONCAT_INNER(a, b)
+#define ALLOCATION_FREE_SCOPE(name) ofxAllocationFreeScope ALLOCATION_CONCAT(allocationFreeScope, __LINE__)(name) ///< Marks the rest of the enclosing scope as one that should not allocate.
+
+/// The allocations of a named allocation-free scope.
+struct allocationScope
+{
+	std::atomic<const char*>		sName; ///< The name of the scope, or NULL while the entry is being registered.
+	std::atomic<uint64_t>			nNumCalls; ///< The number of times the scope ran.
+	std::atomic<uint64_t>			nNumAllocations; ///< The number of allocations within the scope.
+};
+
+/// A class that counts the allocations of the application.
+class ofxAllocationCounter
+{
+public:
+	static uint64_t					getNumAllocations() { return s_nNumAllocations.load(std::memory_order_relaxed); } ///< Returns the number of allocations of all threads. \return The number of allocations since the start.
+	static uint64_t					getNumBytes() { return s_nNumBytes.load(std::memory_order_relaxed); } ///< Returns the number of bytes allocated by all threads. \return The number of bytes since the start.
+	static uint64_t					getThreadNumAllocations(); ///< Returns the number of allocations of the calling thread.
+
+	static void						setStrict(bool bStrict) { s_bStrict = bStrict; } ///< Turns strict mode on or off. \param bStrict Whether or not the allocations within allocation-free scopes are violations.
+	static bool						isStrict() { return s_bStrict; } ///< Returns whether or not strict mode is on. \return Whether or not violations are flagged.
+	static uint64_t					getNumViolations() { return s_nNumViolations.load(std::memory_order_relaxed); } ///< Returns the number of allocations within allocation-free scopes in strict mode. \return The number of violations.
+	static const char*				getLastViolation() { return s_sLastViolation.load(std::memory_order_relaxed); } ///< Returns the name of the scope of the last violation. \return The name, or NULL if there was none.
+
+	static int						getNumScopes() { return s_nNumScopes.load(std::memory_order_acquire); } ///< Returns the number of named allocation-free scopes that ran. \return The number of scopes.
+	static const allocationScope&	getScope(int nScope) { return s_scopes[nScope]; } ///< Returns the allocations of a named scope. \param nScope The index of the scope. \return The scope.
+
+	static void						countAllocation(size_t nBytes); ///< Counts an allocation, from the global operator new.
+	static void						onViolation(const char* sScope, size_t nBytes); ///< Called on every violation in strict mode, as a place for a breakpoint.
+
+private:
+	friend class ofxAllocationFreeScope;
+	static int						findScope(const char* sName); ///< Returns the index of a named scope, registered on first use.
+
+	static std::atomic<uint64_t>	s_nNumAllocations; ///< The number of allocations of all threads.
+	static std::atomic<uint64_t>	s_nNumBytes; ///< The number of bytes allocated by all threads.
+	static std::atomic<bool>		s_bStrict; ///< Whether or not strict mode is on.
+	static std::atomic<uint64_t>	s_nNumViolations; ///< The number of violations.
+	static std::atomic<const char*>	s_sLastViolation; ///< The name of the scope of the last violation.
+	static allocationScope			s_scopes[ALLOCATION_MAX_SCOPES]; ///< The named scopes, in the order in which they first ran.
+	static std::atomic<int>			s_nNumScopes; ///< The number of named scopes registered.
+	static std::mutex				s_scopesMutex; ///< The lock of the registration of the scopes.
+};
+
+/// A scope that should not allocate, from its construction to its destruction.
+class ofxAllocationFreeScope
+{
+public:
+	ofxAllocationFreeScope(const char* sName); ///< Constructor
+	~ofxAllocationFreeScope(); ///< Destructor, which counts the allocations of the scope.
+
+private:
+	int								m_nScope; ///< The index of the named scope, or -1 if the table is full.
+	const char*						m_sOuterScope; ///< The name of the enclosing scope on this thread, restored on destruction.
+	uint64_t						m_nStartAllocations; ///< The number of allocations of the thread when the scope started.
+};
+
+#endif
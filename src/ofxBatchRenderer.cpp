@@ -0,0 +1,236 @@
+#include "ofxBatchRenderer.h"
+
+/** \param nCircleResolution The number of segments of circles and rings.
+*/
+ofxBatchRenderer::ofxBatchRenderer(int nCircleResolution) :
+	m_nNumOffsets(0), m_offset(0.0f, 0.0f), m_nNumUploaded(0), m_bUploaded(false), m_bUseColors(true), m_nNumDrawCalls(0)
+{
+	setCircleResolution(nCircleResolution);
+}
+
+/** \param nCircleResolution The number of segments of circles and rings.
+*/
+void ofxBatchRenderer::setCircleResolution(int nCircleResolution)
+{
+	m_nCircleResolution = max(nCircleResolution, 3);
+	m_unitCircle.resize(m_nCircleResolution + 1);
+	for (int i = 0; i < m_nCircleResolution; i++)
+	{
+		float fAngle = TWO_PI * i / m_nCircleResolution;
+		m_unitCircle[i] = ofVec2f(cos(fAngle), sin(fAngle));
+	}
+	m_unitCircle[m_nCircleResolution] = m_unitCircle[0];
+}
+
+/**
+* \param x The x coordinate of the centre.
+* \param y The y coordinate of the centre.
+* \param fRadius The radius.
+* \param color The colour, with its alpha.
+*/
+void ofxBatchRenderer::addCircle(float x, float y, float fRadius, const ofColor& color)
+{
+	ofFloatColor floatColor(color);
+	for (int i = 0; i < m_nCircleResolution; i++)
+	{
+		const ofVec2f& a = m_unitCircle[i];
+		const ofVec2f& b = m_unitCircle[i + 1];
+		addTriangle(x, y, x + fRadius * a.x, y + fRadius * a.y, x + fRadius * b.x, y + fRadius * b.y, floatColor);
+	}
+}
+
+/**
+* \param x The x coordinate of the centre.
+* \param y The y coordinate of the centre.
+* \param fRadius The radius, in the middle of the line.
+* \param fLineWidth The width of the line.
+* \param color The colour, with its alpha.
+*/
+void ofxBatchRenderer::addRing(float x, float y, float fRadius, float fLineWidth, const ofColor& color)
+{
+	ofFloatColor floatColor(color);
+	float fInner = max(fRadius - 0.5f * fLineWidth, 0.0f);
+	float fOuter = fRadius + 0.5f * fLineWidth;
+	for (int i = 0; i < m_nCircleResolution; i++)
+	{
+		const ofVec2f& a = m_unitCircle[i];
+		const ofVec2f& b = m_unitCircle[i + 1];
+		addQuad(x + fInner * a.x, y + fInner * a.y, x + fOuter * a.x, y + fOuter * a.y,
+			x + fOuter * b.x, y + fOuter * b.y, x + fInner * b.x, y + fInner * b.y, floatColor);
+	}
+}
+
+/**
+* \param from The start of the line.
+* \param to The end of the line.
+* \param fLineWidth The width of the line.
+* \param color The colour, with its alpha.
+*/
+void ofxBatchRenderer::addLine(const ofPoint& from, const ofPoint& to, float fLineWidth, const ofColor& color)
+{
+	float dx = to.x - from.x;
+	float dy = to.y - from.y;
+	float fLength = sqrt(dx * dx + dy * dy);
+	if (fLength == 0.0f)
+	{
+		return;
+	}
+	// Half the width, across the line
+	float nx = -dy / fLength * 0.5f * fLineWidth;
+	float ny = dx / fLength * 0.5f * fLineWidth;
+	addQuad(from.x + nx, from.y + ny, to.x + nx, to.y + ny, to.x - nx, to.y - ny, from.x - nx, from.y - ny, ofFloatColor(color));
+}
+
+/**
+* \param x The x coordinate of the top left corner.
+* \param y The y coordinate of the top left corner.
+* \param fWidth The width of the rectangle.
+* \param fHeight The height of the rectangle.
+* \param fLineWidth The width of the line, centred on the edges.
+* \param color The colour, with its alpha.
+*/
+void ofxBatchRenderer::addFrame(float x, float y, float fWidth, float fHeight, float fLineWidth, const ofColor& color)
+{
+	// Four bands that do not overlap, so that translucent corners are not drawn twice
+	ofFloatColor floatColor(color);
+	float h = 0.5f * fLineWidth;
+	float x0 = x - h, x1 = x + h, x2 = x + fWidth - h, x3 = x + fWidth + h;
+	float y0 = y - h, y1 = y + h, y2 = y + fHeight - h, y3 = y + fHeight + h;
+	addQuad(x0, y0, x3, y0, x3, y1, x0, y1, floatColor);
+	addQuad(x0, y2, x3, y2, x3, y3, x0, y3, floatColor);
+	addQuad(x0, y1, x1, y1, x1, y2, x0, y2, floatColor);
+	addQuad(x2, y1, x3, y1, x3, y2, x2, y2, floatColor);
+}
+
+/**
+* \param x The x coordinate of the centre.
+* \param y The y coordinate of the centre.
+* \param fInnerRadius The radius of the points between the tips, the first of which is at angle 0.
+* \param fOuterRadius The radius of the tips.
+* \param nTips The number of tips.
+* \param color The colour, with its alpha.
+*/
+void ofxBatchRenderer::addStar(float x, float y, float fInnerRadius, float fOuterRadius, int nTips, const ofColor& color)
+{
+	// A fan around the centre, since a star is convex as seen from its centre
+	ofFloatColor floatColor(color);
+	int nPoints = 2 * nTips;
+	float fStep = TWO_PI / nPoints;
+	float px = x + fInnerRadius;
+	float py = y;
+	for (int i = 1; i <= nPoints; i++)
+	{
+		float fRadius = (i % 2 == 0) ? fInnerRadius : fOuterRadius;
+		float qx = x + fRadius * cos(i * fStep);
+		float qy = y + fRadius * sin(i * fStep);
+		addTriangle(x, y, px, py, qx, qy, floatColor);
+		px = qx;
+		py = qy;
+	}
+}
+
+/**
+* \param x The x offset in pixels.
+* \param y The y offset in pixels.
+*/
+void ofxBatchRenderer::pushOffset(float x, float y)
+{
+	if (m_nNumOffsets == BATCH_MAX_OFFSETS)
+	{
+		ofLogError("ofxBatchRenderer", "Too many offsets pushed");
+		return;
+	}
+	m_offsets[m_nNumOffsets++] = m_offset;
+	m_offset.x += x;
+	m_offset.y += y;
+}
+
+void ofxBatchRenderer::popOffset()
+{
+	if (m_nNumOffsets > 0)
+	{
+		m_offset = m_offsets[--m_nNumOffsets];
+	}
+}
+
+void ofxBatchRenderer::flush()
+{
+	if (m_vertices.empty())
+	{
+		return;
+	}
+	upload();
+	draw();
+	clear();
+}
+
+void ofxBatchRenderer::upload()
+{
+	m_bUploaded = true;
+	m_nNumUploaded = m_vertices.size();
+	if (m_nNumUploaded == 0)
+	{
+		return;
+	}
+	m_vbo.setVertexData(&m_vertices[0].x, 2, m_nNumUploaded, GL_DYNAMIC_DRAW, sizeof(ofVec2f));
+	if (m_bUseColors)
+	{
+		m_vbo.setColorData(&m_colors[0], m_nNumUploaded, GL_DYNAMIC_DRAW);
+	}
+	else
+	{
+		m_vbo.disableColors();
+	}
+}
+
+void ofxBatchRenderer::draw()
+{
+	if (m_nNumUploaded > 0)
+	{
+		m_vbo.draw(GL_TRIANGLES, 0, m_nNumUploaded);
+		m_nNumDrawCalls++;
+	}
+}
+
+void ofxBatchRenderer::clear()
+{
+	// The capacity stays, so that the next frames do not allocate
+	m_vertices.clear();
+	m_colors.clear();
+}
+
+/**
+* \param x0 The x coordinate of the first corner.
+* \param y0 The y coordinate of the first corner.
+* \param x1 The x coordinate of the second corner.
+* \param y1 The y coordinate of the second corner.
+* \param x2 The x coordinate of the third corner.
+* \param y2 The y coordinate of the third corner.
+* \param color The colour.
+*/
+void ofxBatchRenderer::addTriangle(float x0, float y0, float x1, float y1, float x2, float y2, const ofFloatColor& color)
+{
+	m_vertices.push_back(ofVec2f(x0 + m_offset.x, y0 + m_offset.y));
+	m_vertices.push_back(ofVec2f(x1 + m_offset.x, y1 + m_offset.y));
+	m_vertices.push_back(ofVec2f(x2 + m_offset.x, y2 + m_offset.y));
+	m_colors.push_back(color);
+	m_colors.push_back(color);
+	m_colors.push_back(color);
+}
+
+/**
+* \param x0 The x coordinate of the first corner.
+* \param y0 The y coordinate of the first corner.
+* \param x1 The x coordinate of the second corner.
+* \param y1 The y coordinate of the second corner.
+* \param x2 The x coordinate of the third corner.
+* \param y2 The y coordinate of the third corner.
+* \param x3 The x coordinate of the fourth corner.
+* \param y3 The y coordinate of the fourth corner.
+* \param color The colour.
+*/
+void ofxBatchRenderer::addQuad(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3, const ofFloatColor& color)
+{
+	addTriangle(x0, y0, x1, y1, x2, y2, color);
+	addTriangle(x0, y0, x2, y2, x3, y3, color);
+}
@@ -0,0 +1,79 @@
+#ifndef _OFX_BATCH_RENDERER
+#define _OFX_BATCH_RENDERER
+
+/**
+ * \class ofxBatchRenderer
+ *
+ * \brief This class collects the circles, rings, lines and shapes of a frame and draws them with one call.
+ *
+ * Each shape is tessellated on the CPU into coloured triangles, in a vertex array that keeps its capacity from
+ * frame to frame. flush() uploads the array into a dynamic vertex buffer, draws it as a single batch of triangles
+ * under the current matrix, and empties it. Shapes drawn between two flushes thus keep their order among
+ * themselves, but code that draws in immediate mode in between (add-ons, text) has to be preceded by a flush.
+ *
+ * A batch can also be retained: shapes that rarely change are tessellated and uploaded once with upload(), then
+ * drawn every frame with draw(), under whatever matrix places them. Without colours (setUseColors(false)),
+ * the batch takes the colour of ofSetColor(), so one retained shape can be drawn in several colours.
+ *
+ * Tessellation makes no OpenGL call, so it also runs without a window.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define BATCH_DEFAULT_CIRCLE_RESOLUTION 40 ///< The number of segments of a circle, as set with ofSetCircleResolution() in ofApp.
+#define BATCH_MAX_OFFSETS 8 ///< The depth of the offset stack.
+
+/// A class that draws 2D shapes in batches.
+class ofxBatchRenderer
+{
+public:
+	ofxBatchRenderer(int nCircleResolution = BATCH_DEFAULT_CIRCLE_RESOLUTION); ///< Constructor
+
+	void							setCircleResolution(int nCircleResolution); ///< Sets the number of segments of circles and rings.
+	int								getCircleResolution() const { return m_nCircleResolution; } ///< Returns the number of segments of circles and rings. \return The number of segments.
+
+	void							addCircle(float x, float y, float fRadius, const ofColor& color); ///< Adds a filled circle.
+	void							addRing(float x, float y, float fRadius, float fLineWidth, const ofColor& color); ///< Adds the outline of a circle.
+	void							addLine(const ofPoint& from, const ofPoint& to, float fLineWidth, const ofColor& color); ///< Adds a line.
+	void							addFrame(float x, float y, float fWidth, float fHeight, float fLineWidth, const ofColor& color); ///< Adds the outline of a rectangle.
+	void							addStar(float x, float y, float fInnerRadius, float fOuterRadius, int nTips, const ofColor& color); ///< Adds a filled star.
+
+	void							pushOffset(float x, float y); ///< Moves the shapes added until the matching popOffset(), on top of the current offset.
+	void							popOffset(); ///< Restores the offset of the previous pushOffset().
+
+	void							flush(); ///< Draws the shapes added since the last flush, then forgets them.
+	void							clear(); ///< Forgets the shapes added since the last flush.
+	void							upload(); ///< Copies the shapes added into the vertex buffer, for draw().
+	void							draw(); ///< Draws the shapes of the last upload.
+	bool							isUploaded() const { return m_bUploaded; } ///< Returns whether or not upload() ran, even with no shapes. \return Whether or not the retained batch is built.
+	void							setUseColors(bool bUseColors) { m_bUseColors = bUseColors; } ///< Sets whether the shapes keep their colours (true) or take the current colour (false). \param bUseColors Whether or not to use the colours of the shapes.
+
+	int								getNumVertices() const { return m_vertices.size(); } ///< Returns the number of vertices waiting to be drawn. \return The number of vertices.
+	const vector<ofVec2f>&			getVertices() const { return m_vertices; } ///< Returns the vertices waiting to be drawn, three per triangle. \return The vertices.
+	const vector<ofFloatColor>&		getColors() const { return m_colors; } ///< Returns the colours of the vertices waiting to be drawn. \return The colours.
+	int								getNumDrawCalls() const { return m_nNumDrawCalls; } ///< Returns the number of batches drawn since the start. \return The number of draw calls.
+
+private:
+	void							addTriangle(float x0, float y0, float x1, float y1, float x2, float y2, const ofFloatColor& color); ///< Adds a triangle, moved by the current offset.
+	void							addQuad(float x0, float y0, float x1, float y1, float x2, float y2, float x3, float y3, const ofFloatColor& color); ///< Adds a convex quadrilateral, as two triangles.
+
+	int								m_nCircleResolution; ///< The number of segments of circles and rings.
+	vector<ofVec2f>					m_unitCircle; ///< The points of the unit circle, the first one repeated at the end.
+	vector<ofVec2f>					m_vertices; ///< The vertices of the triangles waiting to be drawn.
+	vector<ofFloatColor>			m_colors; ///< The colours of the vertices.
+	ofVec2f							m_offsets[BATCH_MAX_OFFSETS]; ///< The stack of offsets.
+	int								m_nNumOffsets; ///< The number of offsets pushed.
+	ofVec2f							m_offset; ///< The current offset.
+	ofVbo							m_vbo; ///< The dynamic vertex buffer.
+	int								m_nNumUploaded; ///< The number of vertices in the vertex buffer.
+	bool							m_bUploaded; ///< Whether or not upload() ran, so that an empty retained batch is not rebuilt every frame.
+	bool							m_bUseColors; ///< Whether or not the shapes keep their colours.
+	int								m_nNumDrawCalls; ///< The number of batches drawn.
+};
+
+#endif
@@ -0,0 +1,207 @@
+#include "ofxBinaryLog.h"
+
+binaryLogRing* ofxBinaryLog::s_rings[BINARY_LOG_MAX_THREADS] = {};
+std::atomic<int> ofxBinaryLog::s_nNumRings(0);
+std::mutex ofxBinaryLog::s_ringsMutex;
+std::mutex ofxBinaryLog::s_flushMutex;
+std::atomic<int> ofxBinaryLog::s_nLevel(BINARY_LOG_DEFAULT_LEVEL);
+std::atomic<uint64_t> ofxBinaryLog::s_nNumDropped(0);
+vector<binaryLogRecord> ofxBinaryLog::s_pending;
+
+/// The ring of a thread, given back when the thread ends.
+struct binaryLogRingHandle
+{
+	binaryLogRingHandle() : ring(NULL) {} ///< Constructor
+	~binaryLogRingHandle() { if (ring != NULL) { ring->bInUse = false; } } ///< Destructor, at the end of the thread.
+	binaryLogRing*					ring; ///< The ring of the thread, or NULL before its first record.
+};
+
+static thread_local binaryLogRingHandle s_threadRing; ///< The ring of the calling thread.
+
+/// The thread that formats and writes the records.
+class binaryLogWriter : public ofThread
+{
+protected:
+	void threadedFunction()
+	{
+		while (isThreadRunning())
+		{
+			ofxBinaryLog::flush();
+			ofSleepMillis(BINARY_LOG_FLUSH_MS);
+		}
+	}
+};
+
+/** \return The writer thread, created on first use.
+*/
+static binaryLogWriter& getWriter()
+{
+	static binaryLogWriter writer;
+	return writer;
+}
+
+void ofxBinaryLog::setup()
+{
+	{
+		std::lock_guard<std::mutex> lock(s_ringsMutex);
+		if (s_nNumRings == 0)
+		{
+			// Every ring is allocated up front, so that no record ever allocates
+			for (int i = 0; i < BINARY_LOG_MAX_THREADS; i++)
+			{
+				s_rings[i] = new binaryLogRing();
+				s_rings[i]->nHead = 0;
+				s_rings[i]->nTail = 0;
+				s_rings[i]->bInUse = false;
+			}
+			s_pending.reserve(BINARY_LOG_RING_SIZE);
+			s_nNumRings = BINARY_LOG_MAX_THREADS;
+		}
+	}
+	if (!getWriter().isThreadRunning())
+	{
+		getWriter().startThread();
+	}
+}
+
+void ofxBinaryLog::stop()
+{
+	if (getWriter().isThreadRunning())
+	{
+		getWriter().waitForThread(true);
+	}
+	flush();
+	if (getNumDropped() > 0)
+	{
+		ofLogWarning("ofxBinaryLog", "Dropped " + ofToString(getNumDropped()) + " records");
+	}
+}
+
+/** \return The ring of the calling thread, or NULL before setup() or when every ring is taken.
+*/
+binaryLogRing* ofxBinaryLog::getThreadRing()
+{
+	if (s_threadRing.ring != NULL)
+	{
+		return s_threadRing.ring;
+	}
+
+	std::lock_guard<std::mutex> lock(s_ringsMutex);
+	int nNumRings = s_nNumRings;
+	for (int i = 0; i < nNumRings; i++)
+	{
+		if (!s_rings[i]->bInUse)
+		{
+			s_rings[i]->bInUse = true;
+			s_threadRing.ring = s_rings[i];
+			return s_rings[i];
+		}
+	}
+	return NULL;
+}
+
+/**
+* \param level The level of the message.
+* \param sModule The module of the message.
+* \param sFormat The format of the message.
+* \return The record to fill with the arguments, or NULL if it is dropped.
+*/
+binaryLogRecord* ofxBinaryLog::beginRecord(ofLogLevel level, const char* sModule, const char* sFormat)
+{
+	binaryLogRing* ring = getThreadRing();
+	if (ring == NULL)
+	{
+		s_nNumDropped.fetch_add(1, std::memory_order_relaxed);
+		return NULL;
+	}
+	// Only this thread writes the ring, and the writer thread frees its records by moving the tail
+	uint64_t nHead = ring->nHead.load(std::memory_order_relaxed);
+	if (nHead - ring->nTail.load(std::memory_order_acquire) >= BINARY_LOG_RING_SIZE)
+	{
+		s_nNumDropped.fetch_add(1, std::memory_order_relaxed);
+		return NULL;
+	}
+	binaryLogRecord& record = ring->records[nHead & (BINARY_LOG_RING_SIZE - 1)];
+	record.sFormat = sFormat;
+	record.sModule = sModule;
+	record.nTimeUs = ofGetElapsedTimeMicros();
+	record.level = level;
+	record.nNumArgs = 0;
+	return &record;
+}
+
+void ofxBinaryLog::endRecord()
+{
+	binaryLogRing* ring = s_threadRing.ring;
+	ring->nHead.store(ring->nHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void ofxBinaryLog::flush()
+{
+	std::lock_guard<std::mutex> lock(s_flushMutex);
+	s_pending.clear();
+	int nNumRings = s_nNumRings;
+	for (int i = 0; i < nNumRings; i++)
+	{
+		binaryLogRing* ring = s_rings[i];
+		uint64_t nHead = ring->nHead.load(std::memory_order_acquire);
+		uint64_t nTail = ring->nTail.load(std::memory_order_relaxed);
+		for (; nTail < nHead; nTail++)
+		{
+			s_pending.push_back(ring->records[nTail & (BINARY_LOG_RING_SIZE - 1)]);
+		}
+		ring->nTail.store(nTail, std::memory_order_release);
+	}
+	if (s_pending.empty())
+	{
+		return;
+	}
+
+	// The records of the threads are written in the order in which they happened
+	std::stable_sort(s_pending.begin(), s_pending.end(),
+		[](const binaryLogRecord& a, const binaryLogRecord& b) { return a.nTimeUs < b.nTimeUs; });
+	shared_ptr<ofBaseLoggerChannel> channel = ofGetLoggerChannel();
+	for (size_t i = 0; i < s_pending.size(); i++)
+	{
+		channel->log(s_pending[i].level, s_pending[i].sModule, format(s_pending[i]));
+	}
+}
+
+/** \param record The record.
+* \return The format of the record, with its "{}" replaced by its arguments.
+*/
+string ofxBinaryLog::format(const binaryLogRecord& record)
+{
+	string sMessage;
+	int nArg = 0;
+	for (const char* c = record.sFormat; *c != '\0'; c++)
+	{
+		if (c[0] != '{' || c[1] != '}' || nArg == record.nNumArgs)
+		{
+			sMessage += *c;
+			continue;
+		}
+		const binaryLogArg& arg = record.args[nArg++];
+		char sArg[32];
+		switch (arg.type)
+		{
+		case binaryLogArg::ARG_INT:
+			snprintf(sArg, sizeof(sArg), "%lld", (long long)arg.n);
+			sMessage += sArg;
+			break;
+		case binaryLogArg::ARG_UINT:
+			snprintf(sArg, sizeof(sArg), "%llu", (unsigned long long)arg.u);
+			sMessage += sArg;
+			break;
+		case binaryLogArg::ARG_FLOAT:
+			snprintf(sArg, sizeof(sArg), "%g", arg.f);
+			sMessage += sArg;
+			break;
+		case binaryLogArg::ARG_STRING:
+			sMessage += arg.s;
+			break;
+		}
+		c++;
+	}
+	return sMessage;
+}
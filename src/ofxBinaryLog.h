@@ -0,0 +1,142 @@
+#ifndef _OFX_BINARY_LOG
+#define _OFX_BINARY_LOG
+
+/**
+ * \class ofxBinaryLog
+ *
+ * \brief This class logs from the frame and the voices without formatting or writing on the way: the call sites
+ * store fixed-size records, which a background thread formats and writes to the logger channel of OpenFrameworks.
+ *
+ * A record is written by BINARY_LOG(level, "module", "format", args...), and is only stored at or above the level of
+ * the binary log, which is independent of the level of ofLog. Its format, a string literal whose "{}" are replaced by
+ * the arguments in order, identifies it: it is stored as a pointer, with the time, the level, the module and up to
+ * BINARY_LOG_MAX_ARGS numbers or string literals. Every thread takes a ring of its own on its first record, and then
+ * writes with no lock and no allocation: the rings are allocated by setup(), and records written before it are
+ * dropped. When a ring is full, because the writer thread falls behind, the records are dropped and counted rather
+ * than waited for.
+ *
+ * The writer thread wakes every BINARY_LOG_FLUSH_MS milliseconds, takes the records of every ring, sorts them by
+ * time and writes them. stop() writes the records left.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define BINARY_LOG_RING_SIZE 1024 ///< The number of records waiting per thread, a power of two.
+#define BINARY_LOG_MAX_THREADS 16 ///< The maximum number of threads logging at once.
+#define BINARY_LOG_MAX_ARGS 4 ///< The maximum number of arguments of a record.
+#define BINARY_LOG_FLUSH_MS 50 ///< The period in milliseconds at which the writer thread writes the records.
+#define BINARY_LOG_DEFAULT_LEVEL OF_LOG_NOTICE ///< The level below which records are not stored, until setLevel().
+
+#define BINARY_LOG(level, module, ...) do { if (ofxBinaryLog::isEnabled(level)) { ofxBinaryLog::write(level, module, __VA_ARGS__); } } while (0) ///< Logs a record if its level is enabled, without evaluating its arguments otherwise.
+
+/// An argument of a record.
+struct binaryLogArg
+{
+	/// The type of an argument.
+	enum argType
+	{
+		ARG_INT, ///< A signed integer.
+		ARG_UINT, ///< An unsigned integer.
+		ARG_FLOAT, ///< A floating-point number.
+		ARG_STRING ///< A string literal.
+	};
+
+	argType							type; ///< The type of the argument.
+	union
+	{
+		int64_t						n; ///< The value of a signed integer.
+		uint64_t					u; ///< The value of an unsigned integer.
+		double						f; ///< The value of a floating-point number.
+		const char*					s; ///< The string literal.
+	};
+};
+
+/// A record, as stored in a ring.
+struct binaryLogRecord
+{
+	const char*						sFormat; ///< The format of the message, which identifies the record.
+	const char*						sModule; ///< The module of the message.
+	uint64_t						nTimeUs; ///< The time in microseconds at which the record was written.
+	ofLogLevel						level; ///< The level of the message.
+	int								nNumArgs; ///< The number of arguments.
+	binaryLogArg					args[BINARY_LOG_MAX_ARGS]; ///< The arguments, in the order of the "{}" of the format.
+};
+
+/// The ring of the records of a thread, with a single writer and a single reader.
+struct binaryLogRing
+{
+	binaryLogRecord					records[BINARY_LOG_RING_SIZE]; ///< The records.
+	std::atomic<uint64_t>			nHead; ///< The number of records ever written into the ring.
+	std::atomic<uint64_t>			nTail; ///< The number of records ever taken by the writer thread.
+	std::atomic<bool>				bInUse; ///< Whether or not a thread writes into the ring.
+};
+
+/// A class that logs fixed-size records, formatted and written on a background thread.
+class ofxBinaryLog
+{
+public:
+	static void						setup(); ///< Allocates the rings and starts the writer thread.
+	static void						stop(); ///< Writes the records left and stops the writer thread.
+	static void						setLevel(ofLogLevel level) { s_nLevel = level; } ///< Sets the level below which records are not stored. \param level The lowest level stored.
+	static ofLogLevel				getLevel() { return (ofLogLevel)s_nLevel.load(std::memory_order_relaxed); } ///< Returns the level below which records are not stored. \return The lowest level stored.
+	static bool						isEnabled(ofLogLevel level) { return level >= s_nLevel.load(std::memory_order_relaxed); } ///< Returns whether or not records of a level are stored. \param level The level. \return Whether or not the level is stored.
+	static uint64_t					getNumDropped() { return s_nNumDropped.load(std::memory_order_relaxed); } ///< Returns the number of records dropped because a ring was full or missing. \return The number of dropped records.
+	static bool						isSetUp() { return s_nNumRings.load(std::memory_order_acquire) > 0; } ///< Returns whether or not the rings are allocated, without which every record is dropped. \return Whether or not setup() was called.
+
+	/** Stores a record into the ring of the calling thread.
+	* \param level The level of the message.
+	* \param sModule The module of the message, a string literal.
+	* \param sFormat The format of the message, a string literal.
+	* \param args The arguments, numbers or string literals.
+	* \return Whether or not the record was stored, rather than dropped.
+	*/
+	template<typename... Args>
+	static bool						write(ofLogLevel level, const char* sModule, const char* sFormat, Args... args)
+	{
+		static_assert(sizeof...(Args) <= BINARY_LOG_MAX_ARGS, "Too many arguments for a binary log record");
+		binaryLogRecord* record = beginRecord(level, sModule, sFormat);
+		if (record == NULL)
+		{
+			return false;
+		}
+		addArgs(*record, args...);
+		endRecord();
+		return true;
+	}
+
+	static void						flush(); ///< Formats and writes the records of every ring, on the writer thread or on stop().
+
+private:
+	static binaryLogRing*			getThreadRing(); ///< Returns the ring of the calling thread, taken on its first record.
+	static binaryLogRecord*			beginRecord(ofLogLevel level, const char* sModule, const char* sFormat); ///< Returns the next record of the ring of the calling thread.
+	static void						endRecord(); ///< Publishes the record begun to the writer thread.
+	static string					format(const binaryLogRecord& record); ///< Returns the message of a record.
+
+	static void						addArgs(binaryLogRecord&) {} ///< Ends the arguments of a record.
+	template<typename T, typename... Rest>
+	static void						addArgs(binaryLogRecord& record, T arg, Rest... rest) { setArg(record.args[record.nNumArgs++], arg); addArgs(record, rest...); } ///< Adds the arguments of a record, in order.
+	static void						setArg(binaryLogArg& arg, int n) { arg.type = binaryLogArg::ARG_INT; arg.n = n; } ///< Sets an integer argument.
+	static void						setArg(binaryLogArg& arg, long n) { arg.type = binaryLogArg::ARG_INT; arg.n = n; } ///< Sets an integer argument.
+	static void						setArg(binaryLogArg& arg, long long n) { arg.type = binaryLogArg::ARG_INT; arg.n = n; } ///< Sets an integer argument.
+	static void						setArg(binaryLogArg& arg, unsigned int u) { arg.type = binaryLogArg::ARG_UINT; arg.u = u; } ///< Sets an unsigned integer argument.
+	static void						setArg(binaryLogArg& arg, unsigned long u) { arg.type = binaryLogArg::ARG_UINT; arg.u = u; } ///< Sets an unsigned integer argument.
+	static void						setArg(binaryLogArg& arg, unsigned long long u) { arg.type = binaryLogArg::ARG_UINT; arg.u = u; } ///< Sets an unsigned integer argument.
+	static void						setArg(binaryLogArg& arg, bool b) { arg.type = binaryLogArg::ARG_INT; arg.n = b ? 1 : 0; } ///< Sets a boolean argument, written as 0 or 1.
+	static void						setArg(binaryLogArg& arg, double f) { arg.type = binaryLogArg::ARG_FLOAT; arg.f = f; } ///< Sets a floating-point argument.
+	static void						setArg(binaryLogArg& arg, const char* s) { arg.type = binaryLogArg::ARG_STRING; arg.s = s; } ///< Sets a string literal argument.
+
+	static binaryLogRing*			s_rings[BINARY_LOG_MAX_THREADS]; ///< The rings, allocated by setup() and reused once their thread ends.
+	static std::atomic<int>			s_nNumRings; ///< The number of rings allocated.
+	static std::mutex				s_ringsMutex; ///< The lock of the rings taken by threads.
+	static std::mutex				s_flushMutex; ///< The lock of the writing of the records.
+	static std::atomic<int>			s_nLevel; ///< The level below which records are not stored.
+	static std::atomic<uint64_t>	s_nNumDropped; ///< The number of records dropped.
+	static vector<binaryLogRecord>	s_pending; ///< The records taken from the rings, sorted before they are written.
+};
+
+#endif
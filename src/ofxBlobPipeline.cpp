@@ -0,0 +1,490 @@
+#include "ofxBlobPipeline.h"
+
+#define BLOB_PIPELINE_SMOOTHING 0.1f ///< The weight of a new frame in the average timings.
+
+void blobStageThread::threadedFunction()
+{
+	int nFrame;
+	while (isThreadRunning())
+	{
+		// Wake up regularly to notice when the thread is asked to stop
+		if (m_pipeline->getStageInput(m_nStage).tryReceive(nFrame, BLOB_PIPELINE_WAIT_MS))
+		{
+			m_pipeline->runStage(m_nStage, nFrame);
+		}
+	}
+}
+
+ofxBlobPipeline::ofxBlobPipeline() :
+	m_nNextImage(0), m_fImageRate(BLOB_PIPELINE_IMAGE_RATE), m_nLastImageMs(0), m_source(BLOB_SOURCE_CAMERA), m_bRunning(false),
+	m_nWidth(0), m_nHeight(0), m_bLearnBackground(true), m_nThreshold(BLOB_PIPELINE_THRESHOLD), m_bFindMarkers(false),
+	m_fLatencyAvgUs(0.0f), m_nFramesTracked(0), m_nFramesDropped(0), m_nRateStartUs(0), m_nRateFrames(0), m_fFrameRate(0.0f)
+{
+	for (int i = 0; i < BLOB_STAGE_COUNT; i++)
+	{
+		m_stages[i].setup(this, i);
+		m_fStageAvgUs[i] = 0.0f;
+	}
+}
+
+ofxBlobPipeline::~ofxBlobPipeline()
+{
+	stop();
+}
+
+/**
+* \param nDeviceId The ID of the camera.
+* \param nWidth The requested width of the images.
+* \param nHeight The requested height of the images.
+* \return Whether or not the camera could be opened.
+*/
+bool ofxBlobPipeline::setupCamera(int nDeviceId, int nWidth, int nHeight)
+{
+	stop();
+	m_grabber.setDeviceID(nDeviceId);
+	if (!m_grabber.setup(nWidth, nHeight, false))
+	{
+		ofLogError("ofxBlobPipeline", "Could not open camera " + ofToString(nDeviceId));
+		return false;
+	}
+	m_source = BLOB_SOURCE_CAMERA;
+	return start(m_grabber.getWidth(), m_grabber.getHeight());
+}
+
+/** \param sFilePath The path of the video file.
+* \return Whether or not the video could be loaded.
+*/
+bool ofxBlobPipeline::setupVideo(string sFilePath)
+{
+	stop();
+	m_player.setUseTexture(false);
+	if (!m_player.load(sFilePath))
+	{
+		ofLogError("ofxBlobPipeline", "Could not load " + sFilePath);
+		return false;
+	}
+	m_player.setLoopState(OF_LOOP_NORMAL);
+	m_player.play();
+	m_source = BLOB_SOURCE_VIDEO;
+	return start(m_player.getWidth(), m_player.getHeight());
+}
+
+/**
+* \param sDirectory The directory of the images, played in alphabetical order.
+* \param fFrameRate The number of images per second.
+* \return Whether or not the first image could be loaded.
+*/
+bool ofxBlobPipeline::setupImageSequence(string sDirectory, float fFrameRate)
+{
+	stop();
+	ofDirectory dir;
+	dir.allowExt("png");
+	dir.allowExt("jpg");
+	dir.allowExt("bmp");
+	dir.listDir(sDirectory);
+	dir.sort();
+	m_imagePaths.clear();
+	for (size_t i = 0; i < dir.size(); i++)
+	{
+		m_imagePaths.push_back(dir.getPath(i));
+	}
+	if (m_imagePaths.empty() || !ofLoadImage(m_image, m_imagePaths[0]))
+	{
+		ofLogError("ofxBlobPipeline", "Could not load images from " + sDirectory);
+		return false;
+	}
+	m_nNextImage = 0;
+	m_fImageRate = fFrameRate;
+	m_nLastImageMs = 0;
+	m_source = BLOB_SOURCE_IMAGES;
+	return start(m_image.getWidth(), m_image.getHeight());
+}
+
+/**
+* \param nWidth The width of the images.
+* \param nHeight The height of the images.
+* \return Whether or not the pipeline started.
+*/
+bool ofxBlobPipeline::start(int nWidth, int nHeight)
+{
+	if (nWidth <= 0 || nHeight <= 0)
+	{
+		return false;
+	}
+	m_nWidth = nWidth;
+	m_nHeight = nHeight;
+
+	// Everything is allocated once here, the stages only reuse it
+	ofxCvImage* images[] = { &m_colorImg, &m_grayImg, &m_background, &m_diff, &m_maskImg };
+	for (int i = 0; i < 5; i++)
+	{
+		images[i]->setUseTexture(false);
+		images[i]->allocate(nWidth, nHeight);
+	}
+	m_frames.resize(BLOB_PIPELINE_POOL_SIZE);
+	for (int i = 0; i < BLOB_PIPELINE_POOL_SIZE; i++)
+	{
+		m_frames[i].input.allocate(nWidth, nHeight, OF_PIXELS_RGB);
+		m_frames[i].gray.allocate(nWidth, nHeight, OF_PIXELS_GRAY);
+		m_frames[i].mask.allocate(nWidth, nHeight, OF_PIXELS_GRAY);
+		m_frames[i].markers.reserve(BLOB_PIPELINE_MAX_MARKERS);
+		m_frames[i].blobs.reserve(BLOB_PIPELINE_MAX_BLOBS);
+		m_stageInput[BLOB_STAGE_CAPTURE].send(i);
+	}
+	m_events.reserve(2 * BLOB_PIPELINE_MAX_BLOBS);
+	m_markers.reserve(BLOB_PIPELINE_MAX_MARKERS);
+	m_bLearnBackground = true;
+
+	m_statsMutex.lock();
+	for (int i = 0; i < BLOB_STAGE_COUNT; i++)
+	{
+		m_fStageAvgUs[i] = 0.0f;
+	}
+	m_fLatencyAvgUs = 0.0f;
+	m_nFramesTracked = 0;
+	m_nFramesDropped = 0;
+	m_nRateStartUs = ofGetElapsedTimeMicros();
+	m_nRateFrames = 0;
+	m_fFrameRate = 0.0f;
+	m_statsMutex.unlock();
+
+	for (int i = BLOB_STAGE_PROCESS; i < BLOB_STAGE_COUNT; i++)
+	{
+		m_stages[i].startThread();
+	}
+	m_bRunning = true;
+	return true;
+}
+
+void ofxBlobPipeline::stop()
+{
+	if (!m_bRunning)
+	{
+		return;
+	}
+	for (int i = BLOB_STAGE_PROCESS; i < BLOB_STAGE_COUNT; i++)
+	{
+		m_stages[i].waitForThread(true);
+	}
+	m_bRunning = false;
+
+	// The fingers still on the surface are released
+	m_events.clear();
+	m_tracker.releaseAll(ofGetElapsedTimeMillis(), m_events);
+	for (vector<ofTouchEventArgs>::iterator It = m_events.begin(); It != m_events.end(); ++It)
+	{
+		m_touches.send(*It);
+	}
+	fiducialEvent event;
+	event.type = fiducialEvent::REMOVED;
+	for (vector<trackedMarker>::iterator It = m_markers.begin(); It != m_markers.end(); ++It)
+	{
+		event.marker = It->marker;
+		m_markerEvents.send(event);
+	}
+	m_markers.clear();
+
+	// Frames still in flight are simply forgotten
+	int nFrame;
+	for (int i = 0; i < BLOB_STAGE_COUNT; i++)
+	{
+		while (m_stageInput[i].tryReceive(nFrame))
+		{
+		}
+	}
+
+	switch (m_source)
+	{
+	case BLOB_SOURCE_CAMERA:
+		m_grabber.close();
+		break;
+	case BLOB_SOURCE_VIDEO:
+		m_player.close();
+		break;
+	default:
+		break;
+	}
+}
+
+void ofxBlobPipeline::update()
+{
+	if (!m_bRunning)
+	{
+		return;
+	}
+	switch (m_source)
+	{
+	case BLOB_SOURCE_CAMERA:
+		m_grabber.update();
+		if (m_grabber.isFrameNew())
+		{
+			capture(m_grabber.getPixels());
+		}
+		break;
+	case BLOB_SOURCE_VIDEO:
+		m_player.update();
+		if (m_player.isFrameNew())
+		{
+			capture(m_player.getPixels());
+		}
+		break;
+	case BLOB_SOURCE_IMAGES:
+		if (ofGetElapsedTimeMillis() - m_nLastImageMs >= 1000.0f / m_fImageRate)
+		{
+			m_nLastImageMs = ofGetElapsedTimeMillis();
+			if (ofLoadImage(m_image, m_imagePaths[m_nNextImage]))
+			{
+				capture(m_image);
+			}
+			m_nNextImage = (m_nNextImage + 1) % m_imagePaths.size();
+		}
+		break;
+	}
+}
+
+/** \param args The touch event to fill.
+* \return Whether or not an event was waiting.
+*/
+bool ofxBlobPipeline::getNextTouch(ofTouchEventArgs& args)
+{
+	return m_touches.tryReceive(args);
+}
+
+/** \param event The marker event to fill.
+* \return Whether or not an event was waiting.
+*/
+bool ofxBlobPipeline::getNextMarker(fiducialEvent& event)
+{
+	return m_markerEvents.tryReceive(event);
+}
+
+/** \param pixels The new image of the source.
+*/
+void ofxBlobPipeline::capture(const ofPixels& pixels)
+{
+	int nFrame;
+	if (!m_stageInput[BLOB_STAGE_CAPTURE].tryReceive(nFrame))
+	{
+		m_statsMutex.lock();
+		m_nFramesDropped++;
+		m_statsMutex.unlock();
+		return;
+	}
+
+	blobFrame& frame = m_frames[nFrame];
+	frame.nCaptureUs = ofGetElapsedTimeMicros();
+	frame.input = pixels; // same size and format as last time, so no allocation
+	frame.nStageUs[BLOB_STAGE_CAPTURE] = ofGetElapsedTimeMicros() - frame.nCaptureUs;
+	m_stageInput[BLOB_STAGE_PROCESS].send(nFrame);
+}
+
+/**
+* \param nStage The stage to run.
+* \param nFrame The index of the frame in the pool.
+*/
+void ofxBlobPipeline::runStage(int nStage, int nFrame)
+{
+	blobFrame& frame = m_frames[nFrame];
+	uint64_t nStartUs = ofGetElapsedTimeMicros();
+	switch (nStage)
+	{
+	case BLOB_STAGE_PROCESS:
+		processFrame(frame);
+		break;
+	case BLOB_STAGE_FIDUCIALS:
+		findMarkers(frame);
+		break;
+	case BLOB_STAGE_CONTOURS:
+		findBlobs(frame);
+		break;
+	case BLOB_STAGE_TRACKING:
+		trackBlobs(frame);
+		trackMarkers(frame);
+		break;
+	default:
+		break;
+	}
+	uint64_t nNowUs = ofGetElapsedTimeMicros();
+	frame.nStageUs[nStage] = nNowUs - nStartUs;
+
+	if (nStage == BLOB_STAGE_TRACKING)
+	{
+		addTiming(frame, nNowUs);
+	}
+	// After tracking, the frame goes back to capture
+	m_stageInput[(nStage + 1) % BLOB_STAGE_COUNT].send(nFrame);
+}
+
+/** \param frame The frame to process.
+*/
+void ofxBlobPipeline::processFrame(blobFrame& frame)
+{
+	if (frame.input.getNumChannels() == 1)
+	{
+		m_grayImg.setFromPixels(frame.input);
+	}
+	else
+	{
+		m_colorImg.setFromPixels(frame.input);
+		m_grayImg = m_colorImg;
+	}
+	if (m_bFindMarkers)
+	{
+		frame.gray = m_grayImg.getPixels();
+	}
+	if (m_bLearnBackground)
+	{
+		m_background = m_grayImg;
+		m_bLearnBackground = false;
+	}
+
+	// Fingers are brighter than the background on FTIR and DI surfaces, so darker pixels saturate to 0
+	m_diff = m_grayImg;
+	m_diff -= m_background;
+	m_diff.blur(3);
+	m_diff.threshold(m_nThreshold);
+	frame.mask = m_diff.getPixels();
+}
+
+/** \param frame The frame in which to find markers.
+*/
+void ofxBlobPipeline::findMarkers(blobFrame& frame)
+{
+	frame.markers.clear();
+	if (m_bFindMarkers)
+	{
+		m_fiducialFinder.findMarkers(frame.gray, frame.markers);
+	}
+}
+
+/** \param frame The frame in which to find blobs.
+*/
+void ofxBlobPipeline::findBlobs(blobFrame& frame)
+{
+	m_maskImg.setFromPixels(frame.mask);
+	m_contourFinder.findContours(m_maskImg, BLOB_PIPELINE_MIN_AREA, BLOB_PIPELINE_MAX_AREA, BLOB_PIPELINE_MAX_BLOBS, false);
+
+	frame.blobs.clear();
+	for (vector<ofxCvBlob>::const_iterator It = m_contourFinder.blobs.begin(); It != m_contourFinder.blobs.end(); ++It)
+	{
+		blobContact contact;
+		contact.x = It->centroid.x / m_nWidth;
+		contact.y = It->centroid.y / m_nHeight;
+		contact.fArea = It->area;
+		frame.blobs.push_back(contact);
+	}
+}
+
+/** \param frame The frame whose blobs are tracked.
+*/
+void ofxBlobPipeline::trackBlobs(blobFrame& frame)
+{
+	m_events.clear();
+	m_tracker.update(frame.blobs, frame.nCaptureUs / 1000, m_events);
+	for (vector<ofTouchEventArgs>::iterator It = m_events.begin(); It != m_events.end(); ++It)
+	{
+		m_touches.send(*It);
+	}
+}
+
+/** \param frame The frame whose markers are compared with the markers on the surface.
+*/
+void ofxBlobPipeline::trackMarkers(blobFrame& frame)
+{
+	// Marker IDs are unique, so markers are matched by ID
+	fiducialEvent event;
+	for (vector<trackedMarker>::iterator It = m_markers.begin(); It != m_markers.end(); ++It)
+	{
+		It->nMissed++;
+	}
+	for (vector<fiducialMarker>::iterator It = frame.markers.begin(); It != frame.markers.end(); ++It)
+	{
+		vector<trackedMarker>::iterator Found = m_markers.begin();
+		while (Found != m_markers.end() && Found->marker.nId != It->nId)
+		{
+			++Found;
+		}
+		if (Found == m_markers.end())
+		{
+			trackedMarker tracked;
+			tracked.marker = *It;
+			tracked.nMissed = 0;
+			m_markers.push_back(tracked);
+			event.type = fiducialEvent::ADDED;
+		}
+		else if (Found->nMissed == 0)
+		{
+			continue; // the same ID twice in a frame
+		}
+		else
+		{
+			bool bMoved = Found->marker.x != It->x || Found->marker.y != It->y || Found->marker.fAngle != It->fAngle;
+			Found->marker = *It;
+			Found->nMissed = 0;
+			if (!bMoved)
+			{
+				continue;
+			}
+			event.type = fiducialEvent::MOVED;
+		}
+		event.marker = *It;
+		m_markerEvents.send(event);
+	}
+
+	// Markers missing for too long are taken off the surface
+	vector<trackedMarker>::iterator It = m_markers.begin();
+	while (It != m_markers.end())
+	{
+		if (It->nMissed > BLOB_PIPELINE_MARKER_MAX_MISSED)
+		{
+			event.type = fiducialEvent::REMOVED;
+			event.marker = It->marker;
+			m_markerEvents.send(event);
+			It = m_markers.erase(It);
+		}
+		else
+		{
+			++It;
+		}
+	}
+}
+
+/**
+* \param frame The frame that went through the pipeline.
+* \param nNowUs The current time in microseconds.
+*/
+void ofxBlobPipeline::addTiming(const blobFrame& frame, uint64_t nNowUs)
+{
+	m_statsMutex.lock();
+	for (int i = 0; i < BLOB_STAGE_COUNT; i++)
+	{
+		m_fStageAvgUs[i] += BLOB_PIPELINE_SMOOTHING * (frame.nStageUs[i] - m_fStageAvgUs[i]);
+	}
+	m_fLatencyAvgUs += BLOB_PIPELINE_SMOOTHING * ((nNowUs - frame.nCaptureUs) - m_fLatencyAvgUs);
+	m_nFramesTracked++;
+	m_nRateFrames++;
+	if (nNowUs - m_nRateStartUs >= 1000000)
+	{
+		m_fFrameRate = m_nRateFrames * 1000000.0f / (nNowUs - m_nRateStartUs);
+		m_nRateStartUs = nNowUs;
+		m_nRateFrames = 0;
+	}
+	m_statsMutex.unlock();
+}
+
+/** \return The statistics of the pipeline.
+*/
+string ofxBlobPipeline::getReport()
+{
+	static const char* stageNames[BLOB_STAGE_COUNT] = { "capture", "process", "fiducials", "contours", "tracking" };
+
+	m_statsMutex.lock();
+	string sReport = "Camera: " + ofToString(m_fFrameRate, 1) + " fps, " + ofToString(m_nWidth) + "x" + ofToString(m_nHeight)
+		+ ", " + ofToString(m_nFramesDropped) + " dropped, latency " + ofToString(m_fLatencyAvgUs / 1000.0f, 2) + " ms\n";
+	for (int i = 0; i < BLOB_STAGE_COUNT; i++)
+	{
+		sReport += string(i == 0 ? "" : " | ") + stageNames[i] + " " + ofToString(m_fStageAvgUs[i] / 1000.0f, 2) + " ms";
+	}
+	m_statsMutex.unlock();
+	return sReport;
+}
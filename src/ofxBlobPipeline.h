@@ -0,0 +1,200 @@
+#ifndef _OFX_BLOB_PIPELINE
+#define _OFX_BLOB_PIPELINE
+
+/**
+ * \class ofxBlobPipeline
+ *
+ * \brief This class finds the fingers touching an FTIR or DI surface in the images of a camera, a recorded
+ * video or a recorded image sequence, and turns them into touch events. It can also find fiducial markers.
+ *
+ * The work is split into stages: capture, background subtraction and threshold, fiducial markers, contour and
+ * blob extraction, and tracking. Capture runs in update() because the video grabbers and players of OpenFrameworks belong to the
+ * thread that opened them; it only copies the new image into a free frame of a fixed pool. Every other stage runs
+ * on its own thread and hands the frame over to the next stage through a channel, so that the stages of successive
+ * frames overlap. The tracking stage hands the frame back to capture, and when no frame is free the new image is
+ * dropped rather than queued.
+ *
+ * The touch events (in normalized coordinates) are queued for the main thread, which reads them with getNextTouch(),
+ * and so are the marker events, read with getNextMarker(). The fiducial stage is off by default.
+ * The time spent in each stage is averaged over the frames and reported by getReport().
+ *
+ * \version 1.1
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxOpenCv.h"
+#include "ofxBlobTracker.h"
+#include "ofxFiducialFinder.h"
+
+#define BLOB_PIPELINE_POOL_SIZE 4 ///< The number of frames in the pool.
+#define BLOB_PIPELINE_WIDTH 320 ///< The default width of the camera images.
+#define BLOB_PIPELINE_HEIGHT 240 ///< The default height of the camera images.
+#define BLOB_PIPELINE_THRESHOLD 40 ///< The default brightness threshold above the background.
+#define BLOB_PIPELINE_MIN_AREA 20 ///< The minimum area in pixels of a blob.
+#define BLOB_PIPELINE_MAX_AREA 4000 ///< The maximum area in pixels of a blob.
+#define BLOB_PIPELINE_MAX_BLOBS 64 ///< The maximum number of blobs per frame.
+#define BLOB_PIPELINE_WAIT_MS 50 ///< How long a stage waits for a frame before checking whether it should stop.
+#define BLOB_PIPELINE_MAX_MARKERS 32 ///< The maximum number of markers per frame.
+#define BLOB_PIPELINE_MARKER_MAX_MISSED 3 ///< The number of frames a marker may be missing before it is removed.
+#define BLOB_PIPELINE_IMAGE_RATE 30.0f ///< The default frame rate of image sequences.
+
+/// The stages of the pipeline.
+enum blobPipelineStage
+{
+	BLOB_STAGE_CAPTURE, ///< The copy of the camera image (main thread)
+	BLOB_STAGE_PROCESS, ///< The background subtraction and threshold
+	BLOB_STAGE_FIDUCIALS, ///< The fiducial markers
+	BLOB_STAGE_CONTOURS, ///< The contour and blob extraction
+	BLOB_STAGE_TRACKING, ///< The tracking of the blobs into touch events
+	BLOB_STAGE_COUNT
+};
+
+/// The source of the images.
+enum blobPipelineSource
+{
+	BLOB_SOURCE_CAMERA, ///< A camera
+	BLOB_SOURCE_VIDEO, ///< A recorded video
+	BLOB_SOURCE_IMAGES ///< A recorded image sequence
+};
+
+/// A change of the markers on the surface.
+struct fiducialEvent
+{
+	/// The type of a change.
+	enum eventType {
+		ADDED, ///< The marker was put on the surface.
+		MOVED, ///< The marker moved or turned.
+		REMOVED ///< The marker was taken off the surface.
+	};
+
+	eventType						type; ///< The type of the change.
+	fiducialMarker					marker; ///< The marker, as last seen.
+};
+
+/// A frame of the pool, handed over from stage to stage.
+struct blobFrame
+{
+	ofPixels						input; ///< The captured image.
+	ofPixels						gray; ///< The captured image in grayscale, for the fiducial stage.
+	ofPixels						mask; ///< The thresholded image.
+	vector<fiducialMarker>			markers; ///< The markers found in the image.
+	vector<blobContact>				blobs; ///< The blobs found in the image.
+	uint64_t						nCaptureUs; ///< The time in microseconds at which the image was captured.
+	uint64_t						nStageUs[BLOB_STAGE_COUNT]; ///< The time in microseconds spent in each stage.
+};
+
+class ofxBlobPipeline;
+
+/// A thread running one stage of the pipeline.
+class blobStageThread : public ofThread
+{
+public:
+	blobStageThread() : m_pipeline(NULL), m_nStage(BLOB_STAGE_PROCESS) {} ///< Constructor
+
+	void							setup(ofxBlobPipeline* pipeline, int nStage) { m_pipeline = pipeline; m_nStage = nStage; } ///< Sets the stage run by the thread. \param pipeline The pipeline. \param nStage The stage.
+
+protected:
+	void							threadedFunction(); ///< Runs the stage on the frames it receives.
+
+	ofxBlobPipeline*				m_pipeline; ///< The pipeline.
+	int								m_nStage; ///< The stage run by the thread.
+};
+
+/// A class that turns the images of a camera into touch events.
+class ofxBlobPipeline
+{
+public:
+	ofxBlobPipeline(); ///< Constructor
+	~ofxBlobPipeline(); ///< Destructor
+
+	bool							setupCamera(int nDeviceId = 0, int nWidth = BLOB_PIPELINE_WIDTH, int nHeight = BLOB_PIPELINE_HEIGHT); ///< Starts the pipeline on a camera.
+	bool							setupVideo(string sFilePath); ///< Starts the pipeline on a recorded video, played in a loop.
+	bool							setupImageSequence(string sDirectory, float fFrameRate = BLOB_PIPELINE_IMAGE_RATE); ///< Starts the pipeline on the images of a directory, played in a loop.
+	void							stop(); ///< Stops the pipeline and closes its source.
+	bool							isRunning() const { return m_bRunning; } ///< Returns whether or not the pipeline is running.
+
+	void							update(); ///< Captures the new image of the source, if any.
+	bool							getNextTouch(ofTouchEventArgs& args); ///< Reads the next touch event, if any.
+	bool							getNextMarker(fiducialEvent& event); ///< Reads the next marker event, if any.
+	void							setFindMarkers(bool bFind) { m_bFindMarkers = bFind; } ///< Turns the fiducial stage on or off. \param bFind Whether or not markers are searched.
+	bool							getFindMarkers() const { return m_bFindMarkers; } ///< Returns whether or not markers are searched.
+
+	void							learnBackground() { m_bLearnBackground = true; } ///< Takes the next image as the background.
+	void							setThreshold(int nThreshold) { m_nThreshold = nThreshold; } ///< Sets the brightness threshold above the background. \param nThreshold The threshold (0-255).
+	string							getReport(); ///< Returns the frame rate, the average time spent in each stage and the number of dropped frames.
+
+	void							runStage(int nStage, int nFrame); ///< Runs a stage on a frame and hands it over to the next stage.
+	ofThreadChannel<int>&			getStageInput(int nStage) { return m_stageInput[nStage]; } ///< Returns the channel of the frames waiting for a stage.
+
+private:
+	bool							start(int nWidth, int nHeight); ///< Allocates the images and starts the stage threads.
+	void							capture(const ofPixels& pixels); ///< Copies a new image into a free frame.
+	void							processFrame(blobFrame& frame); ///< Subtracts the background and thresholds.
+	void							findMarkers(blobFrame& frame); ///< Finds the fiducial markers.
+	void							findBlobs(blobFrame& frame); ///< Extracts the blobs.
+	void							trackBlobs(blobFrame& frame); ///< Tracks the blobs into touch events.
+	void							trackMarkers(blobFrame& frame); ///< Turns the markers into marker events.
+	void							addTiming(const blobFrame& frame, uint64_t nNowUs); ///< Adds the timing of a frame to the statistics.
+
+	// Source
+	ofVideoGrabber					m_grabber; ///< The camera.
+	ofVideoPlayer					m_player; ///< The recorded video.
+	vector<string>					m_imagePaths; ///< The files of the recorded image sequence.
+	ofPixels						m_image; ///< The current image of the recorded image sequence.
+	int								m_nNextImage; ///< The index of the next image of the sequence.
+	float							m_fImageRate; ///< The frame rate of the image sequence.
+	uint64_t						m_nLastImageMs; ///< The time in milliseconds at which the last image of the sequence was captured.
+	blobPipelineSource				m_source; ///< The source of the images.
+	bool							m_bRunning; ///< Whether or not the pipeline is running.
+	int								m_nWidth; ///< The width of the images.
+	int								m_nHeight; ///< The height of the images.
+
+	// Frames
+	vector<blobFrame>				m_frames; ///< The pool of frames.
+	ofThreadChannel<int>			m_stageInput[BLOB_STAGE_COUNT]; ///< The frames waiting for each stage (the free frames for capture).
+	blobStageThread					m_stages[BLOB_STAGE_COUNT]; ///< The threads of the stages (all but capture).
+	ofThreadChannel<ofTouchEventArgs>	m_touches; ///< The touch events waiting for the main thread.
+	ofThreadChannel<fiducialEvent>	m_markerEvents; ///< The marker events waiting for the main thread.
+
+	// Background subtraction and threshold stage
+	ofxCvColorImage					m_colorImg; ///< The captured image, in colour.
+	ofxCvGrayscaleImage				m_grayImg; ///< The captured image, in grayscale.
+	ofxCvGrayscaleImage				m_background; ///< The background image.
+	ofxCvGrayscaleImage				m_diff; ///< The difference with the background.
+	std::atomic<bool>				m_bLearnBackground; ///< Whether or not the next image is taken as the background.
+	std::atomic<int>				m_nThreshold; ///< The brightness threshold above the background.
+
+	// Fiducial stage
+	ofxFiducialFinder				m_fiducialFinder; ///< The finder of fiducial markers.
+	std::atomic<bool>				m_bFindMarkers; ///< Whether or not markers are searched.
+
+	// Contour stage
+	ofxCvGrayscaleImage				m_maskImg; ///< The thresholded image.
+	ofxCvContourFinder				m_contourFinder; ///< The contour finder.
+
+	// Tracking stage
+	ofxBlobTracker					m_tracker; ///< The tracker of the blobs.
+	vector<ofTouchEventArgs>		m_events; ///< The touch events of the current frame.
+	/// A marker on the surface.
+	struct trackedMarker
+	{
+		fiducialMarker				marker; ///< The marker, as last seen.
+		int							nMissed; ///< The number of frames since the marker was last seen.
+	};
+	vector<trackedMarker>			m_markers; ///< The markers on the surface.
+
+	// Statistics
+	std::mutex						m_statsMutex; ///< The protection of the statistics.
+	float							m_fStageAvgUs[BLOB_STAGE_COUNT]; ///< The average time in microseconds spent in each stage.
+	float							m_fLatencyAvgUs; ///< The average time in microseconds from capture to touch events.
+	uint64_t						m_nFramesTracked; ///< The number of frames that went through the pipeline.
+	uint64_t						m_nFramesDropped; ///< The number of images dropped because no frame was free.
+	uint64_t						m_nRateStartUs; ///< The start time in microseconds of the frame rate measure.
+	int								m_nRateFrames; ///< The number of frames tracked since the start of the frame rate measure.
+	float							m_fFrameRate; ///< The number of frames tracked per second.
+};
+
+#endif
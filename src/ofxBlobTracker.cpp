@@ -0,0 +1,453 @@
+#include "ofxBlobTracker.h"
+
+#define BLOB_TRACKER_NO_MATCH 1e6f ///< The cost of a pair outside the gate.
+#define BLOB_TRACKER_INFINITY 1e30f
+#define BLOB_TRACKER_VELOCITY_SMOOTHING 0.5f ///< The weight of the last frame in the velocity of a contact.
+
+ofxBlobTracker::ofxBlobTracker() :
+	m_nNextId(BLOB_TRACKER_FIRST_ID), m_fMaxDistance(BLOB_TRACKER_MAX_DISTANCE), m_nLastTimeMs(-1), m_nCells(1)
+{
+}
+
+/**
+* \param blobs The blobs of the new frame.
+* \param nTimeMs The time in milliseconds of the frame.
+* \param events The vector to which the resulting touch events are added.
+*/
+void ofxBlobTracker::update(const vector<blobContact>& blobs, int nTimeMs, vector<ofTouchEventArgs>& events)
+{
+	int nElapsedMs = m_nLastTimeMs < 0 ? 0 : max(nTimeMs - m_nLastTimeMs, 0);
+	m_nLastTimeMs = nTimeMs;
+
+	for (vector<trackedContact>::iterator It = m_contacts.begin(); It != m_contacts.end(); ++It)
+	{
+		It->px = It->x + It->vx * nElapsedMs;
+		It->py = It->y + It->vy * nElapsedMs;
+	}
+
+	int nNumContacts = m_contacts.size();
+	int nNumBlobs = blobs.size();
+	m_contactMatch.assign(nNumContacts, -1);
+	m_blobMatch.assign(nNumBlobs, -1);
+	m_localContact.assign(nNumContacts, -1);
+	m_localBlob.assign(nNumBlobs, -1);
+
+	// Candidate pairs, grouped by cluster
+	bucketBlobs(blobs);
+	findCandidates(blobs);
+	sort(m_pairs.begin(), m_pairs.end());
+	int nNumPairs = m_pairs.size();
+	int nBegin = 0;
+	while (nBegin < nNumPairs)
+	{
+		int nEnd = nBegin + 1;
+		while (nEnd < nNumPairs && m_pairs[nEnd].nCluster == m_pairs[nBegin].nCluster)
+		{
+			nEnd++;
+		}
+		assignCluster(nBegin, nEnd);
+		nBegin = nEnd;
+	}
+
+	// Matched contacts move, the others coast on their prediction or are released
+	int nKept = 0;
+	for (int i = 0; i < nNumContacts; i++)
+	{
+		trackedContact contact = m_contacts[i];
+		int nBlob = m_contactMatch[i];
+		if (nBlob >= 0)
+		{
+			const blobContact& blob = blobs[nBlob];
+			if (nElapsedMs > 0)
+			{
+				contact.vx += BLOB_TRACKER_VELOCITY_SMOOTHING * ((blob.x - contact.x) / nElapsedMs - contact.vx);
+				contact.vy += BLOB_TRACKER_VELOCITY_SMOOTHING * ((blob.y - contact.y) / nElapsedMs - contact.vy);
+			}
+			bool bMoved = contact.x != blob.x || contact.y != blob.y || contact.nMissed > 0;
+			contact.x = blob.x;
+			contact.y = blob.y;
+			contact.nMissed = 0;
+			if (bMoved)
+			{
+				addEvent(ofTouchEventArgs::move, contact, nTimeMs, events);
+			}
+		}
+		else if (++contact.nMissed > BLOB_TRACKER_MAX_MISSED)
+		{
+			addEvent(ofTouchEventArgs::up, contact, nTimeMs, events);
+			continue;
+		}
+		else
+		{
+			contact.x = contact.px;
+			contact.y = contact.py;
+		}
+		m_contacts[nKept++] = contact;
+	}
+	m_contacts.resize(nKept);
+
+	// Unmatched blobs are new contacts
+	for (int j = 0; j < nNumBlobs; j++)
+	{
+		if (m_blobMatch[j] < 0)
+		{
+			trackedContact contact;
+			contact.nId = m_nNextId++;
+			contact.x = blobs[j].x;
+			contact.y = blobs[j].y;
+			contact.vx = 0.0f;
+			contact.vy = 0.0f;
+			contact.nMissed = 0;
+			m_contacts.push_back(contact);
+			addEvent(ofTouchEventArgs::down, contact, nTimeMs, events);
+		}
+	}
+}
+
+/**
+* \param nTimeMs The current time in milliseconds.
+* \param events The vector to which the resulting touch events are added.
+*/
+void ofxBlobTracker::releaseAll(int nTimeMs, vector<ofTouchEventArgs>& events)
+{
+	for (vector<trackedContact>::iterator It = m_contacts.begin(); It != m_contacts.end(); ++It)
+	{
+		addEvent(ofTouchEventArgs::up, *It, nTimeMs, events);
+	}
+	m_contacts.clear();
+	m_nLastTimeMs = -1;
+}
+
+/** \param blobs The blobs of the new frame.
+*/
+void ofxBlobTracker::bucketBlobs(const vector<blobContact>& blobs)
+{
+	// Cells at least as large as the gate, so the 9 cells around a prediction hold all its candidates
+	m_nCells = ofClamp((int)(1.0f / m_fMaxDistance), 1, BLOB_TRACKER_MAX_CELLS);
+	m_cellStart.assign(m_nCells * m_nCells + 1, 0);
+	m_cellBlobs.resize(blobs.size());
+
+	// Counting sort of the blobs by cell
+	for (size_t j = 0; j < blobs.size(); j++)
+	{
+		m_cellStart[getCell(blobs[j].y) * m_nCells + getCell(blobs[j].x) + 1]++;
+	}
+	for (size_t c = 1; c < m_cellStart.size(); c++)
+	{
+		m_cellStart[c] += m_cellStart[c - 1];
+	}
+	for (size_t j = 0; j < blobs.size(); j++)
+	{
+		m_cellBlobs[m_cellStart[getCell(blobs[j].y) * m_nCells + getCell(blobs[j].x)]++] = j;
+	}
+	for (int c = m_cellStart.size() - 1; c > 0; c--)
+	{
+		m_cellStart[c] = m_cellStart[c - 1];
+	}
+	m_cellStart[0] = 0;
+}
+
+/** \param blobs The blobs of the new frame.
+*/
+void ofxBlobTracker::findCandidates(const vector<blobContact>& blobs)
+{
+	int nNumContacts = m_contacts.size();
+	float fMaxDistSq = m_fMaxDistance * m_fMaxDistance;
+	m_pairs.clear();
+	m_parent.resize(nNumContacts + blobs.size());
+	for (size_t n = 0; n < m_parent.size(); n++)
+	{
+		m_parent[n] = n;
+	}
+
+	for (int i = 0; i < nNumContacts; i++)
+	{
+		const trackedContact& contact = m_contacts[i];
+		int cx = getCell(contact.px);
+		int cy = getCell(contact.py);
+		for (int gy = max(cy - 1, 0); gy <= min(cy + 1, m_nCells - 1); gy++)
+		{
+			for (int gx = max(cx - 1, 0); gx <= min(cx + 1, m_nCells - 1); gx++)
+			{
+				int nCell = gy * m_nCells + gx;
+				for (int k = m_cellStart[nCell]; k < m_cellStart[nCell + 1]; k++)
+				{
+					int j = m_cellBlobs[k];
+					float dx = blobs[j].x - contact.px;
+					float dy = blobs[j].y - contact.py;
+					float fDistSq = dx * dx + dy * dy;
+					if (fDistSq > fMaxDistSq)
+					{
+						continue;
+					}
+					candidatePair pair;
+					pair.nContact = i;
+					pair.nBlob = j;
+					pair.fCost = fDistSq;
+					m_pairs.push_back(pair);
+					m_parent[findRoot(i)] = findRoot(nNumContacts + j);
+				}
+			}
+		}
+	}
+
+	for (vector<candidatePair>::iterator It = m_pairs.begin(); It != m_pairs.end(); ++It)
+	{
+		It->nCluster = findRoot(It->nContact);
+	}
+}
+
+/**
+* \param nBegin The index in m_pairs of the first pair of the cluster.
+* \param nEnd The index in m_pairs after the last pair of the cluster.
+*/
+void ofxBlobTracker::assignCluster(int nBegin, int nEnd)
+{
+	if (nEnd - nBegin == 1)
+	{
+		// One contact and one blob: nothing to solve
+		m_contactMatch[m_pairs[nBegin].nContact] = m_pairs[nBegin].nBlob;
+		m_blobMatch[m_pairs[nBegin].nBlob] = m_pairs[nBegin].nContact;
+		return;
+	}
+
+	m_clusterContacts.clear();
+	m_clusterBlobs.clear();
+	for (int k = nBegin; k < nEnd; k++)
+	{
+		if (m_localContact[m_pairs[k].nContact] < 0)
+		{
+			m_localContact[m_pairs[k].nContact] = m_clusterContacts.size();
+			m_clusterContacts.push_back(m_pairs[k].nContact);
+		}
+		if (m_localBlob[m_pairs[k].nBlob] < 0)
+		{
+			m_localBlob[m_pairs[k].nBlob] = m_clusterBlobs.size();
+			m_clusterBlobs.push_back(m_pairs[k].nBlob);
+		}
+	}
+
+	// Rows are the contacts then one dummy per blob (a new contact), columns are the blobs then one dummy
+	// per contact (a missed blob). Leaving a pair unmatched costs two gates, more than any pair within the gate.
+	int nc = m_clusterContacts.size();
+	int nb = m_clusterBlobs.size();
+	int n = nc + nb;
+	float fGateCost = m_fMaxDistance * m_fMaxDistance;
+	m_cost.resize(n * n);
+	for (int r = 0; r < n; r++)
+	{
+		for (int c = 0; c < n; c++)
+		{
+			float fCost = 0.0f;
+			if (r < nc && c < nb)
+			{
+				fCost = BLOB_TRACKER_NO_MATCH;
+			}
+			else if (r < nc || c < nb)
+			{
+				fCost = fGateCost;
+			}
+			m_cost[r * n + c] = fCost;
+		}
+	}
+	for (int k = nBegin; k < nEnd; k++)
+	{
+		m_cost[m_localContact[m_pairs[k].nContact] * n + m_localBlob[m_pairs[k].nBlob]] = m_pairs[k].fCost;
+	}
+
+	solveAssignment(n);
+	for (int c = 0; c < nb; c++)
+	{
+		int r = m_rowOfCol[c + 1] - 1;
+		if (r < nc && m_cost[r * n + c] < BLOB_TRACKER_NO_MATCH)
+		{
+			m_contactMatch[m_clusterContacts[r]] = m_clusterBlobs[c];
+			m_blobMatch[m_clusterBlobs[c]] = m_clusterContacts[r];
+		}
+	}
+}
+
+/** \param n The size of the square cost matrix in m_cost.
+*
+* Shortest augmenting path version of the Hungarian algorithm, in O(n^3). The result is in m_rowOfCol (1-based).
+*/
+void ofxBlobTracker::solveAssignment(int n)
+{
+	m_u.assign(n + 1, 0.0f);
+	m_v.assign(n + 1, 0.0f);
+	m_rowOfCol.assign(n + 1, 0);
+	m_way.assign(n + 1, 0);
+	for (int i = 1; i <= n; i++)
+	{
+		m_rowOfCol[0] = i;
+		int j0 = 0;
+		m_minv.assign(n + 1, BLOB_TRACKER_INFINITY);
+		m_used.assign(n + 1, false);
+		do
+		{
+			m_used[j0] = true;
+			int i0 = m_rowOfCol[j0];
+			float fDelta = BLOB_TRACKER_INFINITY;
+			int j1 = 0;
+			for (int j = 1; j <= n; j++)
+			{
+				if (m_used[j])
+				{
+					continue;
+				}
+				float fReduced = m_cost[(i0 - 1) * n + (j - 1)] - m_u[i0] - m_v[j];
+				if (fReduced < m_minv[j])
+				{
+					m_minv[j] = fReduced;
+					m_way[j] = j0;
+				}
+				if (m_minv[j] < fDelta)
+				{
+					fDelta = m_minv[j];
+					j1 = j;
+				}
+			}
+			for (int j = 0; j <= n; j++)
+			{
+				if (m_used[j])
+				{
+					m_u[m_rowOfCol[j]] += fDelta;
+					m_v[j] -= fDelta;
+				}
+				else
+				{
+					m_minv[j] -= fDelta;
+				}
+			}
+			j0 = j1;
+		} while (m_rowOfCol[j0] != 0);
+
+		do
+		{
+			int j1 = m_way[j0];
+			m_rowOfCol[j0] = m_rowOfCol[j1];
+			j0 = j1;
+		} while (j0 != 0);
+	}
+}
+
+/** \param n The node (contacts first, then blobs).
+* \return The root of the node.
+*/
+int ofxBlobTracker::findRoot(int n)
+{
+	while (m_parent[n] != n)
+	{
+		m_parent[n] = m_parent[m_parent[n]];
+		n = m_parent[n];
+	}
+	return n;
+}
+
+/** \param f The normalized coordinate.
+* \return The cell of the coordinate, clamped to the grid.
+*/
+int ofxBlobTracker::getCell(float f) const
+{
+	return ofClamp((int)(f * m_nCells), 0, m_nCells - 1);
+}
+
+/**
+* \param type The type of the event.
+* \param contact The contact.
+* \param nTimeMs The time in milliseconds of the event.
+* \param events The vector to which the event is added.
+*/
+void ofxBlobTracker::addEvent(ofTouchEventArgs::Type type, const trackedContact& contact, int nTimeMs, vector<ofTouchEventArgs>& events)
+{
+	ofTouchEventArgs args;
+	args.type = type;
+	args.id = contact.nId;
+	args.x = contact.x;
+	args.y = contact.y;
+	args.xspeed = contact.vx;
+	args.yspeed = contact.vy;
+	args.time = nTimeMs;
+	args.numTouches = m_contacts.size();
+	events.push_back(args);
+}
+
+/** \param nFrames The number of frames simulated for each number of fingers.
+* \return A table of the average cost of a frame and of the number of ID switches for each number of fingers.
+*
+* The fingers move in straight lines at random speeds and bounce on the edges, so they cross each other often.
+* An ID switch is counted whenever a touch ID follows a different finger than before.
+*/
+string ofxBlobTracker::benchmark(int nFrames)
+{
+	static const int fingerCounts[] = { 10, 25, 50, 100, 200 };
+	static const int nFrameMs = 16;
+	ofSeedRandom(42);
+
+	string sReport = "Fingers\tus/frame\tID switches\n";
+	for (size_t n = 0; n < sizeof(fingerCounts) / sizeof(int); n++)
+	{
+		int nFingers = fingerCounts[n];
+		ofxBlobTracker tracker;
+		vector<blobContact> blobs(nFingers);
+		vector<ofVec2f> velocities(nFingers);
+		for (int k = 0; k < nFingers; k++)
+		{
+			blobs[k].x = ofRandom(0.05f, 0.95f);
+			blobs[k].y = ofRandom(0.05f, 0.95f);
+			blobs[k].fArea = 100.0f;
+			velocities[k] = ofVec2f(ofRandom(-0.006f, 0.006f), ofRandom(-0.006f, 0.006f));
+		}
+
+		vector<ofTouchEventArgs> events;
+		events.reserve(2 * nFingers);
+		map<int, int> fingerOfId;
+		int nSwitches = 0;
+		uint64_t nTotalUs = 0;
+		for (int f = 0; f < nFrames; f++)
+		{
+			for (int k = 0; k < nFingers; k++)
+			{
+				blobs[k].x += velocities[k].x;
+				blobs[k].y += velocities[k].y;
+				if (blobs[k].x < 0.0f || blobs[k].x > 1.0f)
+				{
+					velocities[k].x = -velocities[k].x;
+				}
+				if (blobs[k].y < 0.0f || blobs[k].y > 1.0f)
+				{
+					velocities[k].y = -velocities[k].y;
+				}
+			}
+
+			events.clear();
+			uint64_t nStartUs = ofGetElapsedTimeMicros();
+			tracker.update(blobs, f * nFrameMs, events);
+			nTotalUs += ofGetElapsedTimeMicros() - nStartUs;
+
+			// The events carry the exact coordinates of their blob
+			for (vector<ofTouchEventArgs>::iterator It = events.begin(); It != events.end(); ++It)
+			{
+				if (It->type == ofTouchEventArgs::up)
+				{
+					continue;
+				}
+				for (int k = 0; k < nFingers; k++)
+				{
+					if (blobs[k].x == It->x && blobs[k].y == It->y)
+					{
+						map<int, int>::iterator Found = fingerOfId.find(It->id);
+						if (Found != fingerOfId.end() && Found->second != k)
+						{
+							nSwitches++;
+						}
+						fingerOfId[It->id] = k;
+						break;
+					}
+				}
+			}
+		}
+		sReport += ofToString(nFingers) + "\t" + ofToString(nTotalUs / (float)nFrames, 1) + "\t\t" + ofToString(nSwitches) + "\n";
+	}
+	return sReport;
+}
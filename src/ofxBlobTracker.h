@@ -0,0 +1,112 @@
+#ifndef _OFX_BLOB_TRACKER
+#define _OFX_BLOB_TRACKER
+
+/**
+ * \class ofxBlobTracker
+ *
+ * \brief This class follows the blobs found in successive camera frames and turns them into touch events.
+ *
+ * The position of each tracked contact is predicted from its velocity, and only the blobs within a gate
+ * distance of the prediction are candidates for it. The blobs are sorted into a grid of cells the size of the gate,
+ * so that each contact only looks at the 9 cells around its prediction. Contacts and blobs linked by candidate pairs
+ * form independent clusters, and the IDs within a cluster are assigned with the Hungarian algorithm, which minimizes
+ * the sum of the squared distances. Fingers that cross therefore keep their IDs, and the cost of a frame grows with
+ * the size of the clusters rather than with the square of the number of fingers.
+ *
+ * A contact without a blob coasts on its prediction for a few frames before it is released, and a blob without
+ * a contact becomes a new contact.
+ *
+ * \version 1.1
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define BLOB_TRACKER_FIRST_ID 10000 ///< The first touch ID given to camera contacts, to keep them apart from TUIO cursors.
+#define BLOB_TRACKER_MAX_DISTANCE 0.05f ///< The maximum normalized distance between the prediction of a contact and its blob.
+#define BLOB_TRACKER_MAX_MISSED 2 ///< The number of frames a contact may miss its blob before it is released.
+#define BLOB_TRACKER_MAX_CELLS 64 ///< The maximum number of cells per side of the grid.
+
+/// A blob found in a camera frame.
+struct blobContact
+{
+	float							x; ///< The normalized x coordinate of the centroid.
+	float							y; ///< The normalized y coordinate of the centroid.
+	float							fArea; ///< The area in pixels of the blob.
+};
+
+/// A class that tracks blobs over time.
+class ofxBlobTracker
+{
+public:
+	ofxBlobTracker(); ///< Constructor
+
+	void							update(const vector<blobContact>& blobs, int nTimeMs, vector<ofTouchEventArgs>& events); ///< Matches the blobs of a new frame with the tracked contacts.
+	void							releaseAll(int nTimeMs, vector<ofTouchEventArgs>& events); ///< Releases all the tracked contacts.
+	void							setMaxDistance(float fDistance) { m_fMaxDistance = fDistance; } ///< Sets the maximum normalized distance between the prediction of a contact and its blob. \param fDistance The distance.
+	int								getNumContacts() const { return m_contacts.size(); } ///< Returns the number of tracked contacts.
+
+	static string					benchmark(int nFrames = 600); ///< Measures the cost of a frame and the ID switches for growing numbers of fingers.
+
+private:
+	/// A contact being tracked.
+	struct trackedContact
+	{
+		int							nId; ///< The touch ID of the contact.
+		float						x; ///< The normalized x coordinate of the contact.
+		float						y; ///< The normalized y coordinate of the contact.
+		float						vx; ///< The x velocity of the contact, per millisecond.
+		float						vy; ///< The y velocity of the contact, per millisecond.
+		float						px; ///< The predicted x coordinate of the contact in the current frame.
+		float						py; ///< The predicted y coordinate of the contact in the current frame.
+		int							nMissed; ///< The number of frames since the contact last had a blob.
+	};
+
+	/// A candidate pair of a contact and a blob within the gate.
+	struct candidatePair
+	{
+		int							nContact; ///< The index of the contact.
+		int							nBlob; ///< The index of the blob.
+		int							nCluster; ///< The cluster of the pair.
+		float						fCost; ///< The squared distance between the prediction of the contact and the blob.
+
+		bool						operator<(const candidatePair& other) const { return nCluster < other.nCluster; }
+	};
+
+	void							bucketBlobs(const vector<blobContact>& blobs); ///< Sorts the blobs into the cells of the grid.
+	void							findCandidates(const vector<blobContact>& blobs); ///< Lists the candidate pairs and their clusters.
+	void							assignCluster(int nBegin, int nEnd); ///< Assigns the blobs of a cluster to its contacts.
+	void							solveAssignment(int n); ///< Solves the n x n assignment problem in m_cost.
+	int								findRoot(int n); ///< Returns the root of a node in the union-find forest.
+	int								getCell(float f) const; ///< Returns the cell of a normalized coordinate.
+	void							addEvent(ofTouchEventArgs::Type type, const trackedContact& contact, int nTimeMs, vector<ofTouchEventArgs>& events); ///< Adds a touch event for a contact.
+
+	vector<trackedContact>			m_contacts; ///< The tracked contacts.
+	int								m_nNextId; ///< The touch ID of the next contact.
+	float							m_fMaxDistance; ///< The maximum normalized distance between the prediction of a contact and its blob.
+	int								m_nLastTimeMs; ///< The time in milliseconds of the last frame (-1 before the first one).
+
+	// Working memory, kept between frames so that tracking does not allocate once it reached its size
+	int								m_nCells; ///< The number of cells per side of the grid.
+	vector<int>						m_cellStart; ///< The index in m_cellBlobs of the first blob of each cell.
+	vector<int>						m_cellBlobs; ///< The blobs, sorted by cell.
+	vector<candidatePair>			m_pairs; ///< The candidate pairs.
+	vector<int>						m_parent; ///< The union-find forest of contacts (first) and blobs (after).
+	vector<int>						m_contactMatch; ///< The blob matched with each contact (-1 for none).
+	vector<int>						m_blobMatch; ///< The contact matched with each blob (-1 for none).
+	vector<int>						m_localContact; ///< The index of each contact within its cluster (-1 when unvisited).
+	vector<int>						m_localBlob; ///< The index of each blob within its cluster (-1 when unvisited).
+	vector<int>						m_clusterContacts; ///< The contacts of the current cluster.
+	vector<int>						m_clusterBlobs; ///< The blobs of the current cluster.
+	vector<float>					m_cost; ///< The cost matrix of the current cluster.
+	vector<float>					m_u; ///< The row potentials of the assignment.
+	vector<float>					m_v; ///< The column potentials of the assignment.
+	vector<float>					m_minv; ///< The smallest reduced costs of the columns.
+	vector<int>						m_rowOfCol; ///< The row assigned to each column (1-based, 0 for none).
+	vector<int>						m_way; ///< The previous column on the augmenting path.
+	vector<bool>					m_used; ///< Whether or not each column is on the augmenting path.
+};
+
+#endif
@@ -0,0 +1,121 @@
+#include "ofxCachedText.h"
+
+int ofxCachedText::s_nNumLayouts = 0;
+
+ofxCachedText::ofxCachedText() :
+	m_nSize(0), m_bDirty(false)
+{
+}
+
+/**
+* \param sFace The path of the font file, relative to the data folder.
+* \param nSize The size of the font in points.
+*/
+void ofxCachedText::setFont(const string& sFace, int nSize)
+{
+	if (sFace == m_sFace && nSize == m_nSize)
+	{
+		return;
+	}
+	m_sFace = sFace;
+	m_nSize = nSize;
+	m_font.reset();
+	m_bDirty = true;
+}
+
+/** \param sText The text.
+*/
+void ofxCachedText::setText(const string& sText)
+{
+	setText(sText.c_str());
+}
+
+/** \param sText The text.
+*/
+void ofxCachedText::setText(const char* sText)
+{
+	if (m_sText.compare(sText) == 0)
+	{
+		return;
+	}
+	// Reuses the capacity of the previous text
+	m_sText.assign(sText);
+	m_bDirty = true;
+}
+
+/** \param nNumber The number.
+*/
+void ofxCachedText::setNumber(int nNumber)
+{
+	char sNumber[16];
+	snprintf(sNumber, sizeof(sNumber), "%d", nNumber);
+	setText(sNumber);
+}
+
+/** \return The width in pixels of the text.
+*/
+float ofxCachedText::getWidth()
+{
+	layout();
+	return m_bounds.width;
+}
+
+/** \return The height in pixels of the text.
+*/
+float ofxCachedText::getHeight()
+{
+	layout();
+	return m_bounds.height;
+}
+
+/**
+* \param x The x coordinate of the top left corner.
+* \param y The y coordinate of the top left corner.
+*/
+void ofxCachedText::draw(float x, float y)
+{
+	layout();
+	if (!m_font || !m_font->isLoaded() || m_sText.empty())
+	{
+		return;
+	}
+	ofPushMatrix();
+	ofTranslate(x - m_bounds.x, y - m_bounds.y);
+	const ofTexture& atlas = m_font->getFontTexture();
+	atlas.bind();
+	m_mesh.draw();
+	atlas.unbind();
+	ofPopMatrix();
+}
+
+/**
+* \param x The x coordinate of the centre.
+* \param y The y coordinate of the centre.
+*/
+void ofxCachedText::drawCenter(float x, float y)
+{
+	layout();
+	draw(x - 0.5f * m_bounds.width, y - 0.5f * m_bounds.height);
+}
+
+void ofxCachedText::layout()
+{
+	if (!m_bDirty)
+	{
+		return;
+	}
+	m_bDirty = false;
+	if (!m_font && !m_sFace.empty())
+	{
+		m_font = ofxFontCache::getFont(m_sFace, m_nSize);
+	}
+	if (!m_font || !m_font->isLoaded())
+	{
+		m_bounds = ofRectangle();
+		return;
+	}
+	// The font rebuilds its own mesh on each call, so the glyphs are copied into ours, which keeps its capacity
+	m_mesh = m_font->getStringMesh(m_sText, 0, 0);
+	m_bounds = m_font->getStringBoundingBox(m_sText, 0, 0);
+	s_nNumLayouts++;
+}
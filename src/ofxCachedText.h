@@ -0,0 +1,56 @@
+#ifndef _OFX_CACHED_TEXT
+#define _OFX_CACHED_TEXT
+
+/**
+ * \class ofxCachedText
+ *
+ * \brief This class draws a line of text whose layout is only computed again when the text changes.
+ *
+ * The font comes from ofxFontCache and is only fetched on first layout, so a text block costs nothing to build or
+ * to copy. Once laid out, the glyph quads and the bounding box are kept, and drawing is a single mesh over the
+ * atlas of the font, in the current colour. Setting the same text again, or the same number, neither allocates nor
+ * lays it out again.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxFontCache.h"
+
+/// A class that draws text with a cached layout.
+class ofxCachedText
+{
+public:
+	ofxCachedText(); ///< Constructor
+
+	void							setFont(const string& sFace, int nSize); ///< Sets the face and size of the font.
+	void							setText(const string& sText); ///< Sets the text.
+	void							setText(const char* sText); ///< Sets the text.
+	void							setNumber(int nNumber); ///< Sets the text to a whole number.
+	const string&					getText() const { return m_sText; } ///< Returns the text. \return The text.
+
+	float							getWidth(); ///< Returns the width of the text.
+	float							getHeight(); ///< Returns the height of the text.
+	void							draw(float x, float y); ///< Draws the text from its top left corner.
+	void							drawCenter(float x, float y); ///< Draws the text around its centre.
+
+	static int						getNumLayouts() { return s_nNumLayouts; } ///< Returns the number of layouts computed by all text blocks since the start. \return The number of layouts.
+
+private:
+	void							layout(); ///< Computes the glyphs and bounding box of the text, if it changed.
+
+	string							m_sFace; ///< The path of the font file.
+	int								m_nSize; ///< The size of the font in points.
+	shared_ptr<ofTrueTypeFont>		m_font; ///< The font, once fetched from the cache.
+	string							m_sText; ///< The text.
+	bool							m_bDirty; ///< Whether or not the text changed since the last layout.
+	ofMesh							m_mesh; ///< The glyph quads of the text, from the origin of its baseline.
+	ofRectangle						m_bounds; ///< The bounding box of the text, from the origin of its baseline.
+
+	static int						s_nNumLayouts; ///< The number of layouts computed since the start.
+};
+
+#endif
@@ -1,9 +1,15 @@
 #include "ofxCookableNode.h"
 #include "TactosonixHelpers.h"
+#include "ofxBinaryLog.h"
+
+static int s_nNextNodeId = 1; ///< The ID of the next node created.
 
 ofxCookableNode::ofxCookableNode()
 {
-	m_nTimeCreatedMs = ofGetElapsedTimeMillis();
+	m_nNodeId = s_nNextNodeId++;
+	m_clock = ofxKitchenClock::getRealtime();
+	m_nTimeCreatedMs = m_clock->getElapsedTimeMillis();
+	m_nLoopIndex = -1;
 }
 
 /** \param _color The colour of the node.
@@ -13,13 +19,16 @@ ofxCookableNode::ofxCookableNode()
 * \param _bLoop Whether or not the node should loop after it has played.
 * \param _soundType The type of loop.
 * \param _nBeatLength The length in beats of the node.
+* \param _clock The clock of the kitchen, or NULL for the time of the application.
 */
 ofxCookableNode::ofxCookableNode(ofColor _color, int _nRadius, int _nLifeTimeMs, string _sFileName,
-	bool _bLoop, TACTO_LOOPTYPE _soundType, int _nBeatLength) :
+	bool _bLoop, TACTO_LOOPTYPE _soundType, int _nBeatLength, const ofxKitchenClock* _clock) :
 	ofxTactoSHPMNode(_color, _soundType)
 {
+	m_nNodeId = s_nNextNodeId++;
 	m_nLifeTimeMs = _nLifeTimeMs;
-	m_nTimeCreatedMs = ofGetElapsedTimeMillis();
+	m_clock = (_clock != NULL) ? _clock : ofxKitchenClock::getRealtime();
+	m_nTimeCreatedMs = m_clock->getElapsedTimeMillis();
 	setRadius(_nRadius);
 	setMultiPlay(false);
 	m_bLoopable = _bLoop;
@@ -30,6 +39,7 @@ ofxCookableNode::ofxCookableNode(ofColor _color, int _nRadius, int _nLifeTimeMs,
 	m_nCurrLoopBeat = 0;
 	m_nLoopStartBeat = 0;
 	m_fLoopStartPosition = 0.0f;
+	m_nLoopIndex = -1;
 
 	m_sFileName = _sFileName;
 	if (m_sFileName != "")
@@ -61,7 +71,7 @@ int ofxCookableNode::getAge()
 	}
 	else
 	{
-		return ofGetElapsedTimeMillis() - m_nTimeCreatedMs;
+		return m_clock->getElapsedTimeMillis() - m_nTimeCreatedMs;
 	}
 }
 
@@ -75,7 +85,7 @@ bool ofxCookableNode::isDead()
 	}
 	else
 	{
-		return ofGetElapsedTimeMillis() - m_nTimeCreatedMs > m_nLifeTimeMs;
+		return m_clock->getElapsedTimeMillis() - m_nTimeCreatedMs > m_nLifeTimeMs;
 	}
 }
 
@@ -83,7 +93,7 @@ bool ofxCookableNode::isDead()
 */
 float ofxCookableNode::getStandardizedAge()
 {
-	return (float)(ofGetElapsedTimeMillis() - m_nTimeCreatedMs) / m_nLifeTimeMs;
+	return (float)(m_clock->getElapsedTimeMillis() - m_nTimeCreatedMs) / m_nLifeTimeMs;
 }
 
 void ofxCookableNode::play()
@@ -111,42 +121,49 @@ void ofxCookableNode::setLowpass(float pct)
 	m_fLowpass = pct;
 	// We map [0-1] to a more purposeful frequency range
 	float mappedValue = 0.33f * pct; // y = 0.33*x
-	ofLogWarning("ofxCookableNode", "No lowpass implementation yet");
+	// Every move of a dragged node sets the lowpass: the warning is given once, and every value traced
+	static bool s_bWarned = false;
+	if (!s_bWarned)
+	{
+		if (!ofxBinaryLog::isSetUp())
+		{
+			// Nothing would store the record
+			ofLogWarning("ofxCookableNode", "No lowpass implementation yet");
+			s_bWarned = true;
+		}
+		else if (ofxBinaryLog::isEnabled(OF_LOG_WARNING))
+		{
+			// A record dropped by a full ring is written again on the next move
+			s_bWarned = ofxBinaryLog::write(OF_LOG_WARNING, "ofxCookableNode", "No lowpass implementation yet");
+		}
+	}
+	BINARY_LOG(OF_LOG_VERBOSE, "ofxCookableNode", "Lowpass of node {} at {}, mapped to {}, not applied", m_nNodeId, pct, mappedValue);
 	//ofSoundPlayer::setLowpass(mappedValue);
 }
 
-void ofxCookableNode::drawLowpass()
+/** \param batch The batch to which the star is added.
+*/
+void ofxCookableNode::drawLowpass(ofxBatchRenderer& batch)
 {
 	// Draw visual feedback indicating lowpass value.
 	int nTips = 8;
-	int nStarPts = nTips * 2;
-	float angleChangePerPt = TWO_PI / (float)nStarPts;
 	float outerRadius = 0.6f*getRadius();
 	float innerRadius = outerRadius * (1.0f - m_fLowpass); // lower cutoff -> larger inner radius
-	float origx = getOrigin().x;
-	float origy = getOrigin().y;
-	float angle = 0;
-	
-	ofSetColor(getColor(), 255);
-	ofSetLineWidth(4.0f);
-	ofFill();
-	ofBeginShape();
-	for (int i = 0; i < nStarPts; i++)
-	{
-		if (i % 2 == 0) {
-			// inside point:
-			float x = origx + innerRadius * cos(angle);
-			float y = origy + innerRadius * sin(angle);
-			ofVertex(x,y);
-		} else {
-			// outside point
-			float x = origx + outerRadius * cos(angle);
-			float y = origy + outerRadius * sin(angle);
-			ofVertex(x,y);
-		}
-		angle += angleChangePerPt;
-	}
-	ofEndShape();
+	batch.addStar(getOrigin().x, getOrigin().y, innerRadius, outerRadius, nTips, ofColor(getColor(), 255));
+}
+
+/**
+* \param batch The batch to which the disc is added.
+* \param x The x coordinate of the centre of the node.
+* \param y The y coordinate of the centre of the node.
+* \param fRadius The radius in pixels of the node.
+* \param color The colour of the node.
+* \param bQueued Whether or not the node waits behind the playing node of its channel, and is not being dragged.
+*/
+void ofxCookableNode::addNodeShape(ofxBatchRenderer& batch, float x, float y, float fRadius, const ofColor& color, bool bQueued)
+{
+	// The filled disc of ofxTactoSHPMNode::draw(), faded while the node waits its turn
+	batch.addCircle(x, y, fRadius, ofColor(color, bQueued ? COOKABLE_NODE_QUEUED_ALPHA : 255));
 }
 
 void ofxCookableNode::incrementCurrLoopBeat()
@@ -156,7 +173,7 @@ void ofxCookableNode::incrementCurrLoopBeat()
 		return;
 	}
 	m_nCurrLoopBeat = (m_nCurrLoopBeat++ % m_nLoopLength);
-	ofLog(OF_LOG_NOTICE, "Loop beat is " + ofToString(m_nCurrLoopBeat));
+	BINARY_LOG(OF_LOG_NOTICE, "ofxCookableNode", "Loop beat is {}", m_nCurrLoopBeat);
 	
 	if (m_nLoopBeats > 0)
 	{
@@ -166,7 +183,7 @@ void ofxCookableNode::incrementCurrLoopBeat()
 			// Start playback at the start position
 			setPosition(m_fLoopStartPosition);
 			m_nCurrLoopBeat = m_nLoopStartBeat;
-			ofLog(OF_LOG_NOTICE, "Looping back over " + ofToString(m_nLoopBeats) + " at this beat #" + ofToString(m_nCurrLoopBeat));
+			BINARY_LOG(OF_LOG_NOTICE, "ofxCookableNode", "Looping back over {} at this beat #{}", m_nLoopBeats, m_nCurrLoopBeat);
 		}
 	}
 }
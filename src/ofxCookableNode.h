@@ -16,13 +16,17 @@
 
 #include "UI/ofxTactoSHPMNode.h"
 #include "UI/ofxTactoBeatNode.h"
+#include "ofxBatchRenderer.h"
+#include "ofxKitchenClock.h"
+
+#define COOKABLE_NODE_QUEUED_ALPHA 64 ///< The alpha of a node waiting behind the playing node of its channel.
 
 /// A class that implements a musical node that can be cooked in a pot.
 class ofxCookableNode : public ofxTactoSHPMNode, public ofSoundPlayer
 {
 public:
 	ofxCookableNode(); ///< Default constructor
-	ofxCookableNode(ofColor _color, int _nRadius, int _nLifeTimeMs, string _sFileName, bool _bLoop, TACTO_LOOPTYPE _soundType, int _nBeatLength); ///< Constructor
+	ofxCookableNode(ofColor _color, int _nRadius, int _nLifeTimeMs, string _sFileName, bool _bLoop, TACTO_LOOPTYPE _soundType, int _nBeatLength, const ofxKitchenClock* _clock = NULL); ///< Constructor
 	void							update(float _fPotVolume); ///< Regular OpenFrameworks function.
 	void							exit(); ///< Regular OpenFrameworks function.
 	void							play(); ///< Override of the ofSoundPlayer function.
@@ -32,7 +36,7 @@ public:
 	float							getStandardizedAge(); ///< Returns the standardized age in the [0;1] range of the node.
 	void							setLifeTimeMs(int _nLifeTimeMs) { m_nLifeTimeMs = _nLifeTimeMs; } ///< Sets the lifetime in milliseconds of the node. \param _nLifeTimeMs The lifetime in milliseconds of the node.
 	void							setLoopLength(int _nLoopLength) { m_nLoopLength = _nLoopLength; } ///< Sets the length in beats of the node. \param _nLoopLength The length in beats of the node.
-	int								getSoundType() { return m_nSoundType; } ///< Returns the type of loop. \return The type of loop.
+	int								getSoundType() const { return m_nSoundType; } ///< Returns the type of loop. \return The type of loop.
 	bool							getLoopable() { return m_bLoopable; } ///< Returns true if and only if the node can be looped.
 	int								getLoopLength() { return m_nLoopLength; } ///< Returns the length in beats of the loop.
 	void							drag(ofPoint deltaDrag); ///< Drags the node by the specified offset.
@@ -41,15 +45,21 @@ public:
 	float							getRelativeVolume() { return m_fRelativeVolume; } ///< Returns the volume of the cookable node within the pot. \return The relative volume of the node within the pot.
 	void							setLowpass(float pct); ///< Override of a new ofSoundPlayer function, to map to different frequency range.
 	float							getLowpass() { return m_fLowpass; } ///< Returns the standardized ([0;1] range) cutoff frequency of the lowpass filter. \return The standardized ([0;1] range) cutoff frequency of the lowpass filter.
-	void							drawLowpass(); ///< Draws the visual feedback for the lowpass filter.
+	void							drawLowpass(ofxBatchRenderer& batch); ///< Draws the visual feedback for the lowpass filter.
+	static void						addNodeShape(ofxBatchRenderer& batch, float x, float y, float fRadius, const ofColor& color, bool bQueued); ///< Adds the disc of a node, in the pot or in the renderer of the snapshots.
 	void							setLoopBeats(unsigned int loops); ///< Sets the number of beats of the loop.
 	unsigned int					getLoopBeats() { return m_nLoopBeats; } ///< Returns the number of beats of the loop.
 	void							setCurrLoopBeat(unsigned int loopLength) { m_nCurrLoopBeat = loopLength;} ///< Sets the current beat if the node is being looped via a stutter-like feature.
 	unsigned int					getCurrLoopBeat() { return m_nCurrLoopBeat; } ///< Returns the current beat if the node is being looped via a stutter-like feature.
 	void							incrementCurrLoopBeat(); ///< Increments the current beat of the looped the node via a stutter-like feature.
+	void							setLoopIndex(int _nLoopIndex) { m_nLoopIndex = _nLoopIndex; } ///< Sets the index of the loop in the kitchen's loop configuration. \param _nLoopIndex The index of the loop.
+	int								getNodeId() { return m_nNodeId; } ///< Returns the unique ID of the node, which copies of the node share. \return The ID of the node.
+	int								getLoopIndex() { return m_nLoopIndex; } ///< Returns the index of the loop in the kitchen's loop configuration (-1 if unknown). \return The index of the loop.
 
 private:
+	int								m_nNodeId; ///< The unique ID of the node.
 	int								m_nTimeCreatedMs; ///< The time in milliseconds of the creation of the node.
+	const ofxKitchenClock*			m_clock; ///< The clock of the kitchen, from which the age of the node follows.
 	int								m_nLifeTimeMs; ///< The lifetime in milliseconds of the node.
 	string							m_sFileName; ///< The name of the file being played back.
 	int								m_nSoundType; ///< The type of sound.
@@ -57,6 +67,7 @@ private:
 	int								m_nLoopLength; ///< The length in beats of the node's loop.
 	float							m_fRelativeVolume; ///< The relative volume of the node.
 	float							m_fLowpass; ///< The standardized ([0;1] range) cutoff frequency of the lowpass filter.
+	int								m_nLoopIndex; ///< The index of the loop in the kitchen's loop configuration.
 	
 	// Useful to handle loops
 	unsigned int					m_nLoopBeats; ///< The loop length when looping this beat via a stutter-like feature.
@@ -0,0 +1,361 @@
+#include "ofxFiducialFinder.h"
+
+#define FIDUCIAL_MAX_WINDOW 255 ///< The largest threshold window, so that the threshold arithmetic fits in 32 bits.
+
+ofxFiducialFinder::ofxFiducialFinder() :
+	m_nThresholdPercent(FIDUCIAL_THRESHOLD_PERCENT), m_nWidth(0), m_nHeight(0)
+{
+	// IDs go by number of branches, then by leaf counts
+	for (int nBranches = 2; nBranches <= FIDUCIAL_MAX_BRANCHES; nBranches++)
+	{
+		vector<int> counts(nBranches, 0);
+		enumerateCodes(counts, 0, FIDUCIAL_MAX_LEAVES);
+	}
+}
+
+/**
+* \param gray The grayscale image.
+* \param markers The vector to which the markers found are added.
+*/
+void ofxFiducialFinder::findMarkers(const ofPixels& gray, vector<fiducialMarker>& markers)
+{
+	if (!gray.isAllocated() || gray.getNumChannels() != 1)
+	{
+		return;
+	}
+	if ((int)gray.getWidth() != m_nWidth || (int)gray.getHeight() != m_nHeight)
+	{
+		m_nWidth = gray.getWidth();
+		m_nHeight = gray.getHeight();
+		m_integral.assign((m_nWidth + 1) * (m_nHeight + 1), 0);
+		m_binary.resize(m_nWidth * m_nHeight);
+		m_labels.resize(m_nWidth * m_nHeight);
+		m_parent.reserve(m_nWidth * m_nHeight);
+		m_regionOf.reserve(m_nWidth * m_nHeight);
+	}
+
+	threshold(gray);
+	labelRegions();
+	buildTree();
+
+	fiducialMarker marker;
+	for (size_t r = 0; r < m_regions.size(); r++)
+	{
+		if (readMarker(r, marker))
+		{
+			markers.push_back(marker);
+		}
+	}
+}
+
+/** \param gray The grayscale image.
+*/
+void ofxFiducialFinder::threshold(const ofPixels& gray)
+{
+	const unsigned char* pixels = gray.getData();
+	int w = m_nWidth;
+	int h = m_nHeight;
+	int nStride = w + 1;
+
+	// Integral image: the first row and column stay at 0
+	for (int y = 0; y < h; y++)
+	{
+		unsigned int nRowSum = 0;
+		const unsigned int* above = &m_integral[y * nStride];
+		unsigned int* row = &m_integral[(y + 1) * nStride];
+		for (int x = 0; x < w; x++)
+		{
+			nRowSum += pixels[y * w + x];
+			row[x + 1] = above[x + 1] + nRowSum;
+		}
+	}
+
+	int nWindow = ofClamp(w / FIDUCIAL_WINDOW_DIVISOR, 3, FIDUCIAL_MAX_WINDOW);
+	int nHalf = nWindow / 2;
+	m_windowLeft.resize(w);
+	m_windowRight.resize(w);
+	for (int x = 0; x < w; x++)
+	{
+		m_windowLeft[x] = max(x - nHalf, 0);
+		m_windowRight[x] = min(x + nHalf + 1, w);
+	}
+	int nInteriorBegin = min(nHalf, w);
+	int nInteriorEnd = max(w - nHalf, nInteriorBegin);
+	unsigned int nDark = 100 - m_nThresholdPercent;
+
+	for (int y = 0; y < h; y++)
+	{
+		int nTop = max(y - nHalf, 0);
+		int nBottom = min(y + nHalf + 1, h);
+		const unsigned int* top = &m_integral[nTop * nStride];
+		const unsigned int* bottom = &m_integral[nBottom * nStride];
+		const unsigned char* src = &pixels[y * w];
+		unsigned char* dst = &m_binary[y * w];
+		unsigned int nRows = nBottom - nTop;
+
+		// Edges, where the window is clipped
+		for (int x = 0; x < w; x++)
+		{
+			if (x == nInteriorBegin)
+			{
+				x = nInteriorEnd;
+				if (x >= w)
+				{
+					break;
+				}
+			}
+			int l = m_windowLeft[x];
+			int r = m_windowRight[x];
+			unsigned int nSum = bottom[r] - top[r] - bottom[l] + top[l];
+			dst[x] = src[x] * (r - l) * nRows * 100 > nSum * nDark;
+		}
+
+		// Interior, branch-free with contiguous loads so the compiler can vectorize it
+		unsigned int nCount100 = (2 * nHalf + 1) * nRows * 100;
+		const unsigned int* topL = top - nHalf;
+		const unsigned int* topR = top + nHalf + 1;
+		const unsigned int* bottomL = bottom - nHalf;
+		const unsigned int* bottomR = bottom + nHalf + 1;
+		for (int x = nInteriorBegin; x < nInteriorEnd; x++)
+		{
+			unsigned int nSum = bottomR[x] - topR[x] - bottomL[x] + topL[x];
+			dst[x] = src[x] * nCount100 > nSum * nDark;
+		}
+	}
+}
+
+void ofxFiducialFinder::labelRegions()
+{
+	int w = m_nWidth;
+	int h = m_nHeight;
+
+	// First pass: provisional labels, merged when a pixel joins two of them
+	m_parent.clear();
+	for (int y = 0; y < h; y++)
+	{
+		for (int x = 0; x < w; x++)
+		{
+			int i = y * w + x;
+			unsigned char v = m_binary[i];
+			int nLeft = (x > 0 && m_binary[i - 1] == v) ? m_labels[i - 1] : -1;
+			int nUp = (y > 0 && m_binary[i - w] == v) ? m_labels[i - w] : -1;
+			if (nLeft < 0 && nUp < 0)
+			{
+				m_labels[i] = m_parent.size();
+				m_parent.push_back(m_parent.size());
+			}
+			else if (nLeft >= 0 && nUp >= 0)
+			{
+				m_labels[i] = nLeft;
+				int nRootLeft = findRoot(nLeft);
+				int nRootUp = findRoot(nUp);
+				if (nRootLeft != nRootUp)
+				{
+					m_parent[max(nRootLeft, nRootUp)] = min(nRootLeft, nRootUp);
+				}
+			}
+			else
+			{
+				m_labels[i] = max(nLeft, nUp);
+			}
+		}
+	}
+
+	// Second pass: regions, their statistics and their parent
+	m_regionOf.assign(m_parent.size(), -1);
+	m_regions.clear();
+	for (int y = 0; y < h; y++)
+	{
+		for (int x = 0; x < w; x++)
+		{
+			int i = y * w + x;
+			int nRoot = findRoot(m_labels[i]);
+			int nRegion = m_regionOf[nRoot];
+			if (nRegion < 0)
+			{
+				// First pixel of the region: the region on its left contains it
+				nRegion = m_regions.size();
+				m_regionOf[nRoot] = nRegion;
+				fiducialRegion region;
+				region.nColor = m_binary[i];
+				region.nParent = x > 0 ? m_labels[i - 1] : -1;
+				region.nArea = 0;
+				region.fSumX = 0.0f;
+				region.fSumY = 0.0f;
+				m_regions.push_back(region);
+			}
+			m_labels[i] = nRegion;
+			fiducialRegion& region = m_regions[nRegion];
+			region.nArea++;
+			region.fSumX += x;
+			region.fSumY += y;
+		}
+	}
+}
+
+void ofxFiducialFinder::buildTree()
+{
+	// Counting sort of the regions by parent
+	int nNumRegions = m_regions.size();
+	m_childStart.assign(nNumRegions + 1, 0);
+	m_children.resize(nNumRegions);
+	for (int r = 0; r < nNumRegions; r++)
+	{
+		if (m_regions[r].nParent >= 0)
+		{
+			m_childStart[m_regions[r].nParent + 1]++;
+		}
+	}
+	for (int r = 1; r <= nNumRegions; r++)
+	{
+		m_childStart[r] += m_childStart[r - 1];
+	}
+	for (int r = 0; r < nNumRegions; r++)
+	{
+		if (m_regions[r].nParent >= 0)
+		{
+			m_children[m_childStart[m_regions[r].nParent]++] = r;
+		}
+	}
+	for (int r = nNumRegions; r > 0; r--)
+	{
+		m_childStart[r] = m_childStart[r - 1];
+	}
+	m_childStart[0] = 0;
+}
+
+/**
+* \param nRegion The region that may be the root of a marker.
+* \param marker The marker to fill.
+* \return Whether or not the region is the root of a marker.
+*/
+bool ofxFiducialFinder::readMarker(int nRegion, fiducialMarker& marker)
+{
+	const fiducialRegion& root = m_regions[nRegion];
+	int nBranches = m_childStart[nRegion + 1] - m_childStart[nRegion];
+	if (root.nColor != 0 || root.nParent < 0 || root.nArea > FIDUCIAL_MAX_AREA
+		|| nBranches < 2 || nBranches > FIDUCIAL_MAX_BRANCHES)
+	{
+		return false;
+	}
+
+	int counts[FIDUCIAL_MAX_BRANCHES];
+	int nArea = root.nArea;
+	float fSumX = root.fSumX;
+	float fSumY = root.fSumY;
+	float fLeafX = 0.0f;
+	float fLeafY = 0.0f;
+	int nLeaves = 0;
+	for (int b = 0; b < nBranches; b++)
+	{
+		int nBranch = m_children[m_childStart[nRegion] + b];
+		const fiducialRegion& branch = m_regions[nBranch];
+		counts[b] = m_childStart[nBranch + 1] - m_childStart[nBranch];
+		if (counts[b] > FIDUCIAL_MAX_LEAVES)
+		{
+			return false;
+		}
+		nArea += branch.nArea;
+		fSumX += branch.fSumX;
+		fSumY += branch.fSumY;
+
+		for (int l = m_childStart[nBranch]; l < m_childStart[nBranch + 1]; l++)
+		{
+			int nLeaf = m_children[l];
+			const fiducialRegion& leaf = m_regions[nLeaf];
+			if (m_childStart[nLeaf + 1] != m_childStart[nLeaf])
+			{
+				return false;
+			}
+			nArea += leaf.nArea;
+			fSumX += leaf.fSumX;
+			fSumY += leaf.fSumY;
+			fLeafX += leaf.fSumX / leaf.nArea;
+			fLeafY += leaf.fSumY / leaf.nArea;
+			nLeaves++;
+		}
+	}
+	if (nLeaves == 0 || nArea < FIDUCIAL_MIN_AREA || nArea > FIDUCIAL_MAX_AREA)
+	{
+		return false;
+	}
+
+	// Leaf counts in decreasing order, whatever the order of the branches in the image
+	for (int b = 1; b < nBranches; b++)
+	{
+		int nCount = counts[b];
+		int k = b;
+		while (k > 0 && counts[k - 1] < nCount)
+		{
+			counts[k] = counts[k - 1];
+			k--;
+		}
+		counts[k] = nCount;
+	}
+	map<unsigned int, int>::const_iterator Found = m_idOfCode.find(getCode(counts, nBranches));
+	if (Found == m_idOfCode.end())
+	{
+		return false;
+	}
+
+	float cx = fSumX / nArea;
+	float cy = fSumY / nArea;
+	marker.nId = Found->second;
+	marker.x = cx / m_nWidth;
+	marker.y = cy / m_nHeight;
+	marker.fAngle = atan2(fLeafY / nLeaves - cy, fLeafX / nLeaves - cx);
+	marker.fSize = sqrt((float)nArea) / m_nWidth;
+	return true;
+}
+
+/** \param nLabel The label.
+* \return The root of the label.
+*/
+int ofxFiducialFinder::findRoot(int nLabel)
+{
+	while (m_parent[nLabel] != nLabel)
+	{
+		m_parent[nLabel] = m_parent[m_parent[nLabel]];
+		nLabel = m_parent[nLabel];
+	}
+	return nLabel;
+}
+
+/**
+* \param counts The leaf counts being enumerated.
+* \param nPos The position of the next count to enumerate.
+* \param nMax The maximum value of the next count, so that counts are in decreasing order.
+*/
+void ofxFiducialFinder::enumerateCodes(vector<int>& counts, int nPos, int nMax)
+{
+	if (nPos == (int)counts.size())
+	{
+		// A marker needs at least one leaf
+		if (counts[0] > 0)
+		{
+			m_idOfCode[getCode(&counts[0], counts.size())] = m_leafCounts.size();
+			m_leafCounts.push_back(counts);
+		}
+		return;
+	}
+	for (int v = 0; v <= nMax; v++)
+	{
+		counts[nPos] = v;
+		enumerateCodes(counts, nPos + 1, v);
+	}
+}
+
+/**
+* \param counts The leaf counts, in decreasing order.
+* \param nBranches The number of branches.
+* \return The code of the leaf counts.
+*/
+unsigned int ofxFiducialFinder::getCode(const int* counts, int nBranches)
+{
+	unsigned int nCode = nBranches;
+	for (int b = 0; b < nBranches; b++)
+	{
+		nCode = nCode * (FIDUCIAL_MAX_LEAVES + 1) + counts[b];
+	}
+	return nCode;
+}
@@ -0,0 +1,96 @@
+#ifndef _OFX_FIDUCIAL_FINDER
+#define _OFX_FIDUCIAL_FINDER
+
+/**
+ * \class ofxFiducialFinder
+ *
+ * \brief This class finds fiducial markers in grayscale images and reports their ID, position and rotation.
+ *
+ * A marker is a black region holding 2 or more white branches, each holding up to FIDUCIAL_MAX_LEAVES black leaves.
+ * Its ID only depends on the number of leaves in each branch, so markers can be drawn freely.
+ *
+ * Each image goes through three passes over its pixels:
+ * - an adaptive threshold, which compares each pixel with the mean of the window around it, read from an
+ *   integral image in constant time;
+ * - a two-pass connected component labelling with union-find, which also sums the area and position of each region;
+ * - the containment tree: the parent of a region is the region left of its first pixel in raster order.
+ *
+ * Position and size are normalized by the image width and height. The rotation (in radians) is the direction from
+ * the centre of the marker to the centre of its leaves.
+ *
+ * All the working memory is kept between images, so nothing is allocated once the image size is known.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define FIDUCIAL_MAX_BRANCHES 5 ///< The maximum number of white branches in a marker.
+#define FIDUCIAL_MAX_LEAVES 5 ///< The maximum number of black leaves in a branch.
+#define FIDUCIAL_THRESHOLD_PERCENT 15 ///< How much darker than its surroundings (in percent) a pixel must be to be black.
+#define FIDUCIAL_WINDOW_DIVISOR 8 ///< The size of the threshold window, as a fraction of the image width.
+#define FIDUCIAL_MIN_AREA 64 ///< The minimum area in pixels of a marker.
+#define FIDUCIAL_MAX_AREA 40000 ///< The maximum area in pixels of a marker.
+
+/// A marker found in an image.
+struct fiducialMarker
+{
+	int								nId; ///< The ID of the marker.
+	float							x; ///< The normalized x coordinate of the centre.
+	float							y; ///< The normalized y coordinate of the centre.
+	float							fAngle; ///< The rotation in radians.
+	float							fSize; ///< The normalized side of a square of the same area.
+};
+
+/// A class that finds fiducial markers.
+class ofxFiducialFinder
+{
+public:
+	ofxFiducialFinder(); ///< Constructor
+
+	void							findMarkers(const ofPixels& gray, vector<fiducialMarker>& markers); ///< Adds the markers found in an image.
+	void							setThresholdPercent(int nPercent) { m_nThresholdPercent = nPercent; } ///< Sets how much darker than its surroundings a pixel must be to be black. \param nPercent The percentage.
+	int								getNumIds() const { return m_leafCounts.size(); } ///< Returns the number of valid marker IDs.
+	const vector<int>&				getLeafCounts(int nId) const { return m_leafCounts[nId]; } ///< Returns the number of leaves of each branch of a marker, to draw it. \param nId The ID of the marker.
+
+private:
+	/// A connected region of black or white pixels.
+	struct fiducialRegion
+	{
+		int							nColor; ///< 0 for black, 1 for white.
+		int							nParent; ///< The region containing this one (-1 for none).
+		int							nArea; ///< The area in pixels.
+		float						fSumX; ///< The sum of the x coordinates of the pixels.
+		float						fSumY; ///< The sum of the y coordinates of the pixels.
+	};
+
+	void							threshold(const ofPixels& gray); ///< Computes the binary image.
+	void							labelRegions(); ///< Finds the regions and their statistics.
+	void							buildTree(); ///< Lists the children of each region.
+	bool							readMarker(int nRegion, fiducialMarker& marker); ///< Reads the marker rooted at a region, if any.
+	int								findRoot(int nLabel); ///< Returns the root of a label in the union-find forest.
+	void							enumerateCodes(vector<int>& counts, int nPos, int nMax); ///< Gives an ID to every valid combination of leaf counts.
+	static unsigned int				getCode(const int* counts, int nBranches); ///< Returns the code of sorted leaf counts.
+
+	int								m_nThresholdPercent; ///< How much darker than its surroundings (in percent) a pixel must be to be black.
+	int								m_nWidth; ///< The width of the image.
+	int								m_nHeight; ///< The height of the image.
+	vector<unsigned int>			m_integral; ///< The integral image, with an extra row and column of zeros.
+	vector<int>						m_windowLeft; ///< The left edge of the threshold window of each column.
+	vector<int>						m_windowRight; ///< The right edge of the threshold window of each column.
+	vector<unsigned char>			m_binary; ///< The binary image (0 for black, 1 for white).
+	vector<int>						m_labels; ///< The label, then the region, of each pixel.
+	vector<int>						m_parent; ///< The union-find forest of the labels.
+	vector<int>						m_regionOf; ///< The region of each root label (-1 for none yet).
+	vector<fiducialRegion>			m_regions; ///< The regions.
+	vector<int>						m_childStart; ///< The index in m_children of the first child of each region.
+	vector<int>						m_children; ///< The children of the regions, sorted by parent.
+
+	map<unsigned int, int>			m_idOfCode; ///< The ID of each valid code.
+	vector< vector<int> >			m_leafCounts; ///< The leaf counts of each ID.
+};
+
+#endif
@@ -0,0 +1,176 @@
+#include "ofxFlowField.h"
+
+ofxFlowField::ofxFlowField() :
+	m_nCols(0), m_nRows(0), m_fCellSize(FLOW_FIELD_CELL_SIZE), m_fCellsPerPixelX(0.0f), m_fCellsPerPixelY(0.0f),
+	m_nFront(0), m_nNextRow(0), m_fBuildTime(0.0f), m_nNumPending(0), m_nNumRefreshes(0)
+{
+}
+
+ofxFlowField::~ofxFlowField()
+{
+	stop();
+}
+
+/**
+* \param fWidth The width of the window.
+* \param fHeight The height of the window.
+* \param fTime The elapsed time in seconds, at which the first grid is evaluated.
+* \param nCellSize The size in pixels of a cell.
+*/
+void ofxFlowField::setup(float fWidth, float fHeight, float fTime, int nCellSize)
+{
+	stop();
+	m_fCellSize = max(nCellSize, 1);
+	m_nCols = max((int)ceil(fWidth / m_fCellSize), 2);
+	m_nRows = max((int)ceil(fHeight / m_fCellSize), 2);
+	m_fCellsPerPixelX = 1.0f / m_fCellSize;
+	m_fCellsPerPixelY = 1.0f / m_fCellSize;
+	m_grids[0].assign(m_nCols * m_nRows * FLOW_CHANNEL_COUNT, 0.0f);
+	m_grids[1].assign(m_nCols * m_nRows * FLOW_CHANNEL_COUNT, 0.0f);
+
+	// The first grid is computed right away, so that the particles have something to read
+	m_nFront = 0;
+	computeRows(m_grids[m_nFront], 0, m_nRows, fTime);
+	m_nNextRow = 0;
+	m_nNumPending = 0;
+	m_nNumRefreshes = 0;
+	startThread();
+}
+
+void ofxFlowField::stop()
+{
+	if (isThreadRunning())
+	{
+		waitForThread(true);
+	}
+	// Requests not taken by the worker and answers that arrived after the last update() are dropped
+	int nRow;
+	while (m_requests.tryReceive(nRow))
+	{
+	}
+	while (m_done.tryReceive(nRow))
+	{
+	}
+	m_nNumPending = 0;
+}
+
+/**
+* \param fTime The elapsed time in seconds.
+* \param fWidth The width of the window.
+* \param fHeight The height of the window.
+*/
+void ofxFlowField::update(float fTime, float fWidth, float fHeight)
+{
+	if (m_nRows == 0)
+	{
+		return;
+	}
+	// A resized window stretches the grid rather than computing a new one
+	m_fCellsPerPixelX = m_nCols / max(fWidth, 1.0f);
+	m_fCellsPerPixelY = m_nRows / max(fHeight, 1.0f);
+
+	int nRow;
+	while (m_nNumPending > 0 && m_done.tryReceive(nRow))
+	{
+		m_nNumPending--;
+	}
+	if (m_nNumPending > 0)
+	{
+		// The worker is late, the particles keep the current grid
+		return;
+	}
+
+	// The worker is idle, so the grids can be swapped
+	if (m_nNextRow >= m_nRows)
+	{
+		m_nFront = 1 - m_nFront;
+		m_nNextRow = 0;
+		m_nNumRefreshes++;
+	}
+	if (m_nNextRow == 0)
+	{
+		m_fBuildTime = fTime;
+	}
+	m_requests.send(m_nNextRow);
+	m_nNextRow += (m_nRows + FLOW_FIELD_REFRESH_FRAMES - 1) / FLOW_FIELD_REFRESH_FRAMES;
+	m_nNumPending++;
+}
+
+void ofxFlowField::threadedFunction()
+{
+	int nFirstRow;
+	int nRowsPerRequest = (m_nRows + FLOW_FIELD_REFRESH_FRAMES - 1) / FLOW_FIELD_REFRESH_FRAMES;
+	while (isThreadRunning())
+	{
+		// Wake up regularly to notice when the thread is asked to stop
+		if (m_requests.tryReceive(nFirstRow, FLOW_FIELD_WAIT_MS))
+		{
+			computeRows(m_grids[1 - m_nFront], nFirstRow, min(nFirstRow + nRowsPerRequest, m_nRows), m_fBuildTime);
+			m_done.send(nFirstRow);
+		}
+	}
+}
+
+/**
+* \param grid The grid.
+* \param nFirstRow The first row.
+* \param nEndRow The row after the last row.
+* \param fTime The elapsed time in seconds.
+*/
+void ofxFlowField::computeRows(vector<float>& grid, int nFirstRow, int nEndRow, float fTime)
+{
+	// The grid wraps around, so each of its axes is a circle in four-dimensional noise, whose circumference is the
+	// size of the grid in pixels: the noise is periodic over the grid and has no seam at its edges. Time moves the
+	// circles along the last dimension.
+	float fRadiusX = m_nCols * m_fCellSize / TWO_PI;
+	float fRadiusY = m_nRows * m_fCellSize / TWO_PI;
+	for (int r = nFirstRow; r < nEndRow; r++)
+	{
+		float fAngleY = TWO_PI * (r + 0.5f) / m_nRows;
+		float y1 = fRadiusY * cos(fAngleY);
+		float y2 = fRadiusY * sin(fAngleY);
+		float* cell = &grid[r * m_nCols * FLOW_CHANNEL_COUNT];
+		for (int c = 0; c < m_nCols; c++, cell += FLOW_CHANNEL_COUNT)
+		{
+			// The scales of the OpenFrameworks particle example, in pixels
+			float fAngleX = TWO_PI * (c + 0.5f) / m_nCols;
+			float x1 = fRadiusX * cos(fAngleX);
+			float x2 = fRadiusX * sin(fAngleX);
+			cell[FLOW_WIND] = ofSignedNoise(x1 * 0.003f, x2 * 0.003f, y1 * 0.006f, y2 * 0.006f + fTime * 0.6f);
+			cell[FLOW_WANDER_X] = ofSignedNoise(x1 * 0.01f, x2 * 0.01f, y1 * 0.01f, y2 * 0.01f + fTime * 0.2f);
+			cell[FLOW_WANDER_Y] = ofSignedNoise(y1 * 0.01f + 100.0f, y2 * 0.01f, x1 * 0.01f, x2 * 0.01f + fTime * 0.2f);
+		}
+	}
+}
+
+/**
+* \param x The x coordinate in pixels, which wraps around the width of the window.
+* \param y The y coordinate in pixels, which wraps around the height of the window.
+* \param values The FLOW_CHANNEL_COUNT interpolated values.
+*/
+void ofxFlowField::sample(float x, float y, float* values) const
+{
+	// The values lie at the centres of the cells
+	float fx = x * m_fCellsPerPixelX - 0.5f;
+	float fy = y * m_fCellsPerPixelY - 0.5f;
+	float fFloorX = floor(fx);
+	float fFloorY = floor(fy);
+	float tx = fx - fFloorX;
+	float ty = fy - fFloorY;
+	int c0 = ((int)fFloorX % m_nCols + m_nCols) % m_nCols;
+	int r0 = ((int)fFloorY % m_nRows + m_nRows) % m_nRows;
+	int c1 = c0 + 1 < m_nCols ? c0 + 1 : 0;
+	int r1 = r0 + 1 < m_nRows ? r0 + 1 : 0;
+
+	const float* grid = &m_grids[m_nFront][0];
+	const float* a = grid + (r0 * m_nCols + c0) * FLOW_CHANNEL_COUNT;
+	const float* b = grid + (r0 * m_nCols + c1) * FLOW_CHANNEL_COUNT;
+	const float* c = grid + (r1 * m_nCols + c0) * FLOW_CHANNEL_COUNT;
+	const float* d = grid + (r1 * m_nCols + c1) * FLOW_CHANNEL_COUNT;
+	for (int k = 0; k < FLOW_CHANNEL_COUNT; k++)
+	{
+		float fTop = a[k] + (b[k] - a[k]) * tx;
+		float fBottom = c[k] + (d[k] - c[k]) * tx;
+		values[k] = fTop + (fBottom - fTop) * ty;
+	}
+}
@@ -0,0 +1,78 @@
+#ifndef _OFX_FLOW_FIELD
+#define _OFX_FLOW_FIELD
+
+/**
+ * \class ofxFlowField
+ *
+ * \brief This class evaluates the noise that moves the particles on a coarse grid over the window, rather than
+ * for each particle.
+ *
+ * Each cell of the grid holds the wind of the snow and the two components of a wandering motion, all drawn from
+ * ofSignedNoise() at the centre of the cell. Particles read them with bilinear interpolation between the four
+ * nearest cells, so the cost of the noise depends on the size of the grid and not on the number of particles.
+ * The grid wraps around at its edges, so that a particle can read it at a position shifted by its own seed: the
+ * noise is drawn on a torus, each axis of the grid being a circle in four dimensions, so that it is periodic over
+ * the grid and the wrap leaves no seam.
+ *
+ * The grid is double-buffered. A worker thread computes the next grid a few rows per frame, at the time of its
+ * first row, while the particles read the current one; update() swaps them once the next grid is complete.
+ * update() is called from the thread that reads the grid, between frames.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define FLOW_FIELD_CELL_SIZE 16 ///< The default size in pixels of a cell, in a window of the size given to setup().
+#define FLOW_FIELD_REFRESH_FRAMES 8 ///< The number of frames over which the next grid is computed.
+#define FLOW_FIELD_WAIT_MS 50 ///< How long the worker waits for a request before checking whether it should stop.
+
+/// The noise channels of a cell.
+enum flowFieldChannel
+{
+	FLOW_WIND, ///< The horizontal wind of the snow.
+	FLOW_WANDER_X, ///< The x component of the wandering motion.
+	FLOW_WANDER_Y, ///< The y component of the wandering motion.
+	FLOW_CHANNEL_COUNT
+};
+
+/// A class that samples noise forces from a grid.
+class ofxFlowField : public ofThread
+{
+public:
+	ofxFlowField(); ///< Constructor
+	~ofxFlowField(); ///< Destructor
+
+	void							setup(float fWidth, float fHeight, float fTime, int nCellSize = FLOW_FIELD_CELL_SIZE); ///< Computes the first grid and starts the worker thread.
+	void							stop(); ///< Stops the worker thread and drops its requests and answers.
+	void							update(float fTime, float fWidth, float fHeight); ///< Swaps in the next grid if it is complete, and asks for the next rows.
+
+	void							sample(float x, float y, float* values) const; ///< Interpolates all channels at a point.
+	int								getNumCells() const { return m_nCols * m_nRows; } ///< Returns the number of cells of the grid. \return The number of cells.
+	int								getNumRefreshes() const { return m_nNumRefreshes; } ///< Returns the number of grids swapped in since setup(). \return The number of grids.
+
+protected:
+	void							threadedFunction(); ///< Computes the rows it is asked for.
+
+private:
+	void							computeRows(vector<float>& grid, int nFirstRow, int nEndRow, float fTime); ///< Evaluates the noise of some rows of a grid.
+
+	int								m_nCols; ///< The number of columns of the grid.
+	int								m_nRows; ///< The number of rows of the grid.
+	float							m_fCellSize; ///< The size in pixels of a cell, in the window of setup().
+	float							m_fCellsPerPixelX; ///< The number of cells per pixel along x, in the current window.
+	float							m_fCellsPerPixelY; ///< The number of cells per pixel along y, in the current window.
+	vector<float>					m_grids[2]; ///< The current and next grids, FLOW_CHANNEL_COUNT floats per cell, row by row.
+	int								m_nFront; ///< The index of the current grid.
+	int								m_nNextRow; ///< The first row of the next grid not asked for yet.
+	float							m_fBuildTime; ///< The time at which the next grid is evaluated.
+	ofThreadChannel<int>			m_requests; ///< The first rows asked of the worker.
+	ofThreadChannel<int>			m_done; ///< The first rows computed by the worker.
+	int								m_nNumPending; ///< The number of requests not answered yet.
+	int								m_nNumRefreshes; ///< The number of grids swapped in.
+};
+
+#endif
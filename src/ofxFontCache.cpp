@@ -0,0 +1,53 @@
+#include "ofxFontCache.h"
+
+/**
+* \param sFace The path of the font file, relative to the data folder.
+* \param nSize The size of the font in points.
+* \return The font, or a font that is not loaded if the file cannot be read.
+*/
+shared_ptr<ofTrueTypeFont> ofxFontCache::getFont(const string& sFace, int nSize)
+{
+	shared_ptr<ofTrueTypeFont>& font = getFonts()[make_pair(sFace, nSize)];
+	if (!font)
+	{
+		font = make_shared<ofTrueTypeFont>();
+		if (!font->load(sFace, nSize))
+		{
+			// Kept anyway, so that a missing file is not read again for every text block
+			ofLogError("ofxFontCache", "Cannot load " + sFace + " at size " + ofToString(nSize));
+		}
+	}
+	return font;
+}
+
+void ofxFontCache::clear()
+{
+	fontMap& fonts = getFonts();
+	for (fontMap::iterator It = fonts.begin(); It != fonts.end(); )
+	{
+		if (It->second.use_count() == 1)
+		{
+			It = fonts.erase(It);
+		}
+		else
+		{
+			++It;
+		}
+	}
+}
+
+/** \return The number of fonts in the cache.
+*/
+int ofxFontCache::getNumFonts()
+{
+	return getFonts().size();
+}
+
+/** \return The fonts of the cache.
+*/
+ofxFontCache::fontMap& ofxFontCache::getFonts()
+{
+	// Built on first use, so that no font is created before the window
+	static fontMap fonts;
+	return fonts;
+}
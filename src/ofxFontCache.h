@@ -0,0 +1,36 @@
+#ifndef _OFX_FONT_CACHE
+#define _OFX_FONT_CACHE
+
+/**
+ * \class ofxFontCache
+ *
+ * \brief This class shares the fonts of the application, each face and size being loaded once.
+ *
+ * Loading a TrueType font rasterizes every glyph into a texture atlas, which takes milliseconds and a texture per
+ * copy. The cache keeps one font per face and size for the whole process, handed out as shared pointers, so the
+ * text blocks of the pots and of the application all draw from the same atlases. It is only used from the
+ * thread that owns the OpenGL context.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+/// A class that loads each font once.
+class ofxFontCache
+{
+public:
+	static shared_ptr<ofTrueTypeFont>	getFont(const string& sFace, int nSize); ///< Returns the font of a face and size, loading it on first use.
+	static void							clear(); ///< Releases the fonts that are not in use anymore.
+	static int							getNumFonts(); ///< Returns the number of fonts in the cache.
+
+private:
+	typedef map<pair<string, int>, shared_ptr<ofTrueTypeFont> > fontMap; ///< The fonts, by face and size.
+
+	static fontMap&						getFonts(); ///< Returns the fonts of the cache.
+};
+
+#endif
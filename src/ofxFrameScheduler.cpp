@@ -0,0 +1,80 @@
+#include "ofxFrameScheduler.h"
+
+ofxFrameScheduler::ofxFrameScheduler() :
+	m_nActiveRate(FRAME_SCHEDULER_ACTIVE_RATE),
+	m_nIdleRate(FRAME_SCHEDULER_IDLE_RATE),
+	m_nIdleTimeoutMs(FRAME_SCHEDULER_IDLE_TIMEOUT_MS),
+	m_bEnabled(true),
+	m_bIdle(false),
+	m_nLastActivityMs(0),
+	m_nNumIdlePeriods(0)
+{
+}
+
+/**
+* \param nActiveRate The frame rate while the table is in use.
+* \param nIdleRate The frame rate while the table is idle.
+* \param nIdleTimeoutMs The time in milliseconds without input or animation after which the table is idle.
+*/
+void ofxFrameScheduler::setup(int nActiveRate, int nIdleRate, int nIdleTimeoutMs)
+{
+	m_nActiveRate = max(nActiveRate, 1);
+	m_nIdleRate = min(max(nIdleRate, 1), m_nActiveRate);
+	m_nIdleTimeoutMs = max(nIdleTimeoutMs, 0);
+	m_nLastActivityMs = ofGetElapsedTimeMillis();
+	m_nNumIdlePeriods = 0;
+	m_bIdle = false;
+	ofSetFrameRate(m_nActiveRate);
+}
+
+/** \param bEnabled Whether or not the idle rate is used.
+*/
+void ofxFrameScheduler::setEnabled(bool bEnabled)
+{
+	m_bEnabled = bEnabled;
+	if (!m_bEnabled)
+	{
+		setIdle(false);
+	}
+}
+
+/** \param nNowMs The time in milliseconds of the input.
+*/
+void ofxFrameScheduler::wake(uint64_t nNowMs)
+{
+	m_nLastActivityMs = nNowMs;
+	setIdle(false);
+}
+
+/**
+* \param nNowMs The time in milliseconds of the frame.
+* \param bAnimating Whether or not something on the screen moves in this frame.
+*/
+void ofxFrameScheduler::update(uint64_t nNowMs, bool bAnimating)
+{
+	if (bAnimating)
+	{
+		m_nLastActivityMs = nNowMs;
+		setIdle(false);
+	}
+	else if (m_bEnabled && nNowMs >= m_nLastActivityMs + m_nIdleTimeoutMs)
+	{
+		setIdle(true);
+	}
+}
+
+/** \param bIdle Whether or not the table is idle.
+*/
+void ofxFrameScheduler::setIdle(bool bIdle)
+{
+	if (bIdle == m_bIdle)
+	{
+		return;
+	}
+	m_bIdle = bIdle;
+	if (m_bIdle)
+	{
+		m_nNumIdlePeriods++;
+	}
+	ofSetFrameRate(getFrameRate());
+}
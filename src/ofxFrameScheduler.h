@@ -0,0 +1,59 @@
+#ifndef _OFX_FRAME_SCHEDULER
+#define _OFX_FRAME_SCHEDULER
+
+/**
+ * \class ofxFrameScheduler
+ *
+ * \brief This class lowers the frame rate of the application while the table is idle.
+ *
+ * The application is active while input arrives or something on the screen moves, and idle once neither happened
+ * for a while. While idle, frames come at a low rate, which saves the power and heat of an installation that runs
+ * all day. Any input wakes the scheduler up from within the event handler: the frame rate goes back to full before
+ * the application sleeps until its next frame, so the first frame after the input already comes at full rate.
+ *
+ * The application tells the scheduler every frame whether something animates, such as a node playing a beat or
+ * particles flying. The music is only scheduled from frames while nodes are playing, and they keep the full rate.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define FRAME_SCHEDULER_ACTIVE_RATE 60 ///< The default frame rate while the table is in use.
+#define FRAME_SCHEDULER_IDLE_RATE 10 ///< The default frame rate while the table is idle.
+#define FRAME_SCHEDULER_IDLE_TIMEOUT_MS 5000 ///< The default time in milliseconds without input or animation after which the table is idle.
+
+/// A class that adapts the frame rate to the activity of the table.
+class ofxFrameScheduler
+{
+public:
+	ofxFrameScheduler(); ///< Constructor
+
+	void							setup(int nActiveRate = FRAME_SCHEDULER_ACTIVE_RATE, int nIdleRate = FRAME_SCHEDULER_IDLE_RATE,
+										int nIdleTimeoutMs = FRAME_SCHEDULER_IDLE_TIMEOUT_MS); ///< Sets the frame rates and the timeout, and starts active.
+	void							setEnabled(bool bEnabled); ///< Turns the idle rate on or off, the frame rate staying active when off.
+	bool							isEnabled() const { return m_bEnabled; } ///< Returns whether or not the idle rate is used. \return Whether or not the scheduler is on.
+
+	void							wake(uint64_t nNowMs); ///< Goes back to the active rate on input.
+	void							update(uint64_t nNowMs, bool bAnimating); ///< Goes idle once the table was still for long enough.
+
+	bool							isIdle() const { return m_bIdle; } ///< Returns whether or not the table is idle. \return Whether or not frames come at the idle rate.
+	int								getFrameRate() const { return m_bIdle ? m_nIdleRate : m_nActiveRate; } ///< Returns the current target frame rate. \return The frames per second.
+	int								getNumIdlePeriods() const { return m_nNumIdlePeriods; } ///< Returns the number of times the table went idle. \return The number of idle periods.
+
+private:
+	void							setIdle(bool bIdle); ///< Switches between the active and idle rates.
+
+	int								m_nActiveRate; ///< The frame rate while the table is in use.
+	int								m_nIdleRate; ///< The frame rate while the table is idle.
+	int								m_nIdleTimeoutMs; ///< The time in milliseconds without input or animation after which the table is idle.
+	bool							m_bEnabled; ///< Whether or not the idle rate is used.
+	bool							m_bIdle; ///< Whether or not the table is idle.
+	uint64_t						m_nLastActivityMs; ///< The time in milliseconds of the last input or animated frame.
+	int								m_nNumIdlePeriods; ///< The number of times the table went idle.
+};
+
+#endif
@@ -0,0 +1,53 @@
+#include "ofxKitchenClock.h"
+
+/** \return The clock of the application, shared by everything set up without a clock.
+*/
+const ofxKitchenClock* ofxKitchenClock::getRealtime()
+{
+	static ofxRealtimeClock realtime;
+	return &realtime;
+}
+
+/** \param fScale The number of seconds of the clock per second of the application.
+*/
+ofxFastForwardClock::ofxFastForwardClock(double fScale) :
+	m_nBaseUs(0),
+	m_nBaseRealUs(ofGetElapsedTimeMicros()),
+	m_fScale(max(fScale, 0.0)),
+	m_bPaused(false)
+{
+}
+
+/** \return The time in microseconds of the clock.
+*/
+uint64_t ofxFastForwardClock::getElapsedTimeMicros() const
+{
+	if (m_bPaused)
+	{
+		return m_nBaseUs;
+	}
+	return m_nBaseUs + (uint64_t)((ofGetElapsedTimeMicros() - m_nBaseRealUs) * m_fScale);
+}
+
+/** \param fScale The number of seconds of the clock per second of the application.
+*/
+void ofxFastForwardClock::setScale(double fScale)
+{
+	rebase();
+	m_fScale = max(fScale, 0.0);
+}
+
+/** \param bPaused Whether or not the clock is stopped.
+*/
+void ofxFastForwardClock::setPaused(bool bPaused)
+{
+	rebase();
+	m_bPaused = bPaused;
+}
+
+void ofxFastForwardClock::rebase()
+{
+	// The time already counted is kept, so that the clock never jumps
+	m_nBaseUs = getElapsedTimeMicros();
+	m_nBaseRealUs = ofGetElapsedTimeMicros();
+}
@@ -0,0 +1,78 @@
+#ifndef _OFX_KITCHEN_CLOCK
+#define _OFX_KITCHEN_CLOCK
+
+/**
+ * \class ofxKitchenClock
+ *
+ * \brief This class is the time of the kitchen, from which its beats, its pots and the ages of its nodes follow.
+ *
+ * The kitchen, its stove tops, pots and nodes read the time from the clock they are set up with rather than from
+ * ofGetElapsedTimeMillis(), so that the time of the music can differ from the time of the wall:
+ * - \link ofxRealtimeClock is the time of the application, as before, and the default everywhere;
+ * - \link ofxManualClock only moves when it is stepped, so that a run is reproducible, and hours of play run in
+ *   seconds when the steps come back to back;
+ * - \link ofxFastForwardClock follows the time of the application at any speed, and can be paused.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+/// The interface of the clocks of the kitchen.
+class ofxKitchenClock
+{
+public:
+	virtual ~ofxKitchenClock() {} ///< Destructor
+
+	virtual uint64_t				getElapsedTimeMicros() const = 0; ///< Returns the time of the kitchen. \return The time in microseconds.
+	uint64_t						getElapsedTimeMillis() const { return getElapsedTimeMicros() / 1000; } ///< Returns the time of the kitchen, in place of ofGetElapsedTimeMillis(). \return The time in milliseconds.
+
+	static const ofxKitchenClock*	getRealtime(); ///< Returns the clock of the application, with which the kitchen is set up by default.
+};
+
+/// A clock that follows the time of the application.
+class ofxRealtimeClock : public ofxKitchenClock
+{
+public:
+	uint64_t						getElapsedTimeMicros() const { return ofGetElapsedTimeMicros(); } ///< Returns the time of the application. \return The time in microseconds.
+};
+
+/// A clock that only moves when it is stepped, from any thread.
+class ofxManualClock : public ofxKitchenClock
+{
+public:
+	ofxManualClock(uint64_t nStartUs = 0) : m_nNowUs(nStartUs) {} ///< Constructor \param nStartUs The time in microseconds at which the clock starts.
+
+	uint64_t						getElapsedTimeMicros() const { return m_nNowUs; } ///< Returns the time the clock was stepped to. \return The time in microseconds.
+	void							setTime(uint64_t nNowUs) { m_nNowUs = nNowUs; } ///< Sets the time of the clock. \param nNowUs The time in microseconds.
+	void							advance(uint64_t nStepUs) { m_nNowUs += nStepUs; } ///< Steps the clock forward. \param nStepUs The step in microseconds.
+
+private:
+	std::atomic<uint64_t>			m_nNowUs; ///< The time in microseconds of the clock.
+};
+
+/// A clock that follows the time of the application at a given speed, changed on the thread that updates the kitchen.
+class ofxFastForwardClock : public ofxKitchenClock
+{
+public:
+	ofxFastForwardClock(double fScale = 1.0); ///< Constructor
+
+	uint64_t						getElapsedTimeMicros() const; ///< Returns the scaled time. \return The time in microseconds.
+	void							setScale(double fScale); ///< Sets the speed of the clock, from now on.
+	double							getScale() const { return m_fScale; } ///< Returns the speed of the clock. \return The number of seconds of the clock per second of the application.
+	void							setPaused(bool bPaused); ///< Stops or restarts the clock.
+	bool							isPaused() const { return m_bPaused; } ///< Returns whether or not the clock is stopped. \return Whether or not the clock is paused.
+
+private:
+	void							rebase(); ///< Starts counting from the current time, before the speed or the pause changes.
+
+	uint64_t						m_nBaseUs; ///< The time in microseconds of the clock at the last change of speed or pause.
+	uint64_t						m_nBaseRealUs; ///< The time in microseconds of the application at the last change of speed or pause.
+	double							m_fScale; ///< The number of seconds of the clock per second of the application.
+	bool							m_bPaused; ///< Whether or not the clock is stopped.
+};
+
+#endif
@@ -0,0 +1,120 @@
+#include "ofxKitchenMarkers.h"
+#include "metaphorKitchen.h"
+
+ofxKitchenMarkers::ofxKitchenMarkers() :
+	m_kitchen(NULL)
+{
+}
+
+/** \param event The change of the markers on the surface.
+*/
+void ofxKitchenMarkers::markerEvent(const fiducialEvent& event)
+{
+	if (m_kitchen == NULL)
+	{
+		return;
+	}
+
+	const fiducialMarker& marker = event.marker;
+	if (marker.nId < KITCHEN_MARKER_FIRST_LOOP)
+	{
+		// The drag offset that gives each stove top the full focus (the kitchen starts on the front right one)
+		static const ofPoint stoveFocus[4] = { ofPoint(0.0f, 0.0f), ofPoint(1.0f, 0.0f), ofPoint(1.0f, 1.0f), ofPoint(0.0f, 1.0f) };
+		if (event.type == fiducialEvent::ADDED)
+		{
+			m_kitchen->setDragOffset(stoveFocus[marker.nId]);
+		}
+		return;
+	}
+
+	vector<placedLoop>::iterator Placed = findPlaced(marker.nId);
+	switch (event.type)
+	{
+	case fiducialEvent::ADDED:
+		if (Placed == m_placedLoops.end())
+		{
+			placeLoop(marker);
+		}
+		break;
+	case fiducialEvent::MOVED:
+		if (Placed != m_placedLoops.end())
+		{
+			ofxCookableNode* node = findNode(*Placed);
+			if (node != NULL)
+			{
+				// A full turn sweeps the cutoff frequency
+				float fTurn = marker.fAngle / TWO_PI;
+				node->setLowpass(fTurn - floor(fTurn));
+			}
+		}
+		break;
+	case fiducialEvent::REMOVED:
+		if (Placed != m_placedLoops.end())
+		{
+			ofxCookableNode* node = findNode(*Placed);
+			if (node != NULL)
+			{
+				m_kitchen->getStovetop(Placed->nStove)->getPot()->removeNode(node);
+			}
+			m_placedLoops.erase(Placed);
+		}
+		break;
+	}
+}
+
+/** \param marker The marker of the loop.
+*/
+void ofxKitchenMarkers::placeLoop(const fiducialMarker& marker)
+{
+	placedLoop placed;
+	placed.nMarkerId = marker.nId;
+	placed.nLoop = marker.nId - KITCHEN_MARKER_FIRST_LOOP;
+	if (placed.nLoop >= m_kitchen->getNumLoops())
+	{
+		return;
+	}
+
+	// The pot under the marker, or else the pot in focus
+	placed.nStove = 0;
+	float fBestFocus = -1.0f;
+	for (int i = 0; i < 4; i++)
+	{
+		ofxPot* pot = m_kitchen->getStovetop(i)->getPot();
+		if (pot->isPointInside(ofPoint(marker.x, marker.y)))
+		{
+			placed.nStove = i;
+			break;
+		}
+		if (pot->getFocusVolume() > fBestFocus)
+		{
+			fBestFocus = pot->getFocusVolume();
+			placed.nStove = i;
+		}
+	}
+
+	if (m_kitchen->addLoop(placed.nStove, placed.nLoop))
+	{
+		m_placedLoops.push_back(placed);
+	}
+}
+
+/** \param placed The loop placed by a marker.
+* \return The node of the loop, playing or still queued behind the other nodes of its audio channel, or NULL if the loop was removed since.
+*/
+ofxCookableNode* ofxKitchenMarkers::findNode(const placedLoop& placed)
+{
+	return m_kitchen->getStovetop(placed.nStove)->getPot()->findLoopNode(placed.nLoop);
+}
+
+/** \param nMarkerId The ID of the marker.
+* \return The loop placed by the marker, or the end of m_placedLoops.
+*/
+vector<ofxKitchenMarkers::placedLoop>::iterator ofxKitchenMarkers::findPlaced(int nMarkerId)
+{
+	vector<placedLoop>::iterator It = m_placedLoops.begin();
+	while (It != m_placedLoops.end() && It->nMarkerId != nMarkerId)
+	{
+		++It;
+	}
+	return It;
+}
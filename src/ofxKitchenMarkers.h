@@ -0,0 +1,54 @@
+#ifndef _OFX_KITCHEN_MARKERS
+#define _OFX_KITCHEN_MARKERS
+
+/**
+ * \class ofxKitchenMarkers
+ *
+ * \brief This class lets physical objects tagged with fiducial markers act on the kitchen.
+ *
+ * - Markers 0 to 3 are stove top pucks: putting one on the surface brings the kitchen to its stove top.
+ * - Markers from KITCHEN_MARKER_FIRST_LOOP on are ingredients: marker KITCHEN_MARKER_FIRST_LOOP + n stands for
+ *   loop n of loops.xml (drums first, then bass, then lead). Putting it on the surface adds the loop to the pot
+ *   under it, or to the pot in focus; turning it sets the lowpass of the loop; taking it off removes the loop.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxBlobPipeline.h"
+
+class metaphorKitchen;
+class ofxCookableNode;
+
+#define KITCHEN_MARKER_FIRST_LOOP 4 ///< The ID of the marker of the first loop.
+
+/// A class that maps fiducial markers to the kitchen.
+class ofxKitchenMarkers
+{
+public:
+	ofxKitchenMarkers(); ///< Constructor
+
+	void							setup(metaphorKitchen* kitchen) { m_kitchen = kitchen; } ///< Sets the kitchen on which markers act. \param kitchen The kitchen.
+	void							markerEvent(const fiducialEvent& event); ///< Applies a change of the markers on the surface to the kitchen.
+
+private:
+	/// A loop added by a marker.
+	struct placedLoop
+	{
+		int							nMarkerId; ///< The ID of the marker.
+		int							nStove; ///< The ID of the stove top of the pot.
+		int							nLoop; ///< The index of the loop in the loop configuration.
+	};
+
+	void							placeLoop(const fiducialMarker& marker); ///< Adds the loop of a marker to a pot.
+	ofxCookableNode*				findNode(const placedLoop& placed); ///< Returns the node of a placed loop, if it is still in its pot.
+	vector<placedLoop>::iterator	findPlaced(int nMarkerId); ///< Returns the loop placed by a marker.
+
+	metaphorKitchen*				m_kitchen; ///< The kitchen.
+	vector<placedLoop>				m_placedLoops; ///< The loops added by markers.
+};
+
+#endif
@@ -0,0 +1,276 @@
+#include "ofxKitchenOscControl.h"
+#include "metaphorKitchen.h"
+
+#define STATE_VALUES_PER_LANE 4
+#define STATE_VALUES_PER_STOVE (1 + OFX_POT_NUMLANES * STATE_VALUES_PER_LANE)
+#define STATE_SIZE (2 + 4 * STATE_VALUES_PER_STOVE)
+
+ofxKitchenOscControl::ofxKitchenOscControl() :
+	m_kitchen(NULL), m_bSetup(false), m_fOutRate(KITCHEN_OSC_OUT_RATE), m_nLastPublishMs(0), m_nNumIgnored(0)
+{
+}
+
+/**
+* \param kitchen The kitchen to control.
+* \param nInPort The port on which the controller messages are received.
+* \param sOutHost The host to which the state bundles are sent.
+* \param nOutPort The port to which the state bundles are sent.
+* \param fOutRate The maximum number of state bundles per second.
+*/
+void ofxKitchenOscControl::setup(metaphorKitchen* kitchen, int nInPort, string sOutHost, int nOutPort, float fOutRate)
+{
+	m_kitchen = kitchen;
+	m_fOutRate = fOutRate;
+	m_receiver.setup(nInPort);
+	m_sender.setup(sOutHost, nOutPort);
+
+	m_batch.reserve(KITCHEN_OSC_MAX_BATCH);
+	m_state.assign(STATE_SIZE, 0.0f);
+	m_publishedState.clear(); // forces a first bundle
+	m_bSetup = true;
+}
+
+/** \param nNowMs The current time in milliseconds.
+* \return Whether or not any command was applied to the kitchen.
+*/
+bool ofxKitchenOscControl::update(uint64_t nNowMs)
+{
+	if (!m_bSetup)
+	{
+		return false;
+	}
+
+	receive();
+	bool bApplied = applyBatch();
+
+	if (m_fOutRate > 0.0f && nNowMs - m_nLastPublishMs >= 1000.0f / m_fOutRate)
+	{
+		m_nLastPublishMs = nNowMs;
+		publish();
+	}
+	return bApplied;
+}
+
+void ofxKitchenOscControl::receive()
+{
+	// Whatever does not fit in this batch waits in the receiver for the next one
+	ofxOscMessage msg;
+	while (m_batch.size() < KITCHEN_OSC_MAX_BATCH && m_receiver.hasWaitingMessages())
+	{
+		m_receiver.getNextMessage(msg);
+		string sAddress = msg.getAddress();
+		int nNumArgs = msg.getNumArgs();
+
+		// The stove top is only read once the address tells that the first argument is one
+		bool bStoveArg = nNumArgs > 0 && msg.getArgType(0) == OFXOSC_TYPE_INT32;
+		kitchenOscCommand cmd;
+		cmd.nStove = 0;
+		cmd.nIndex = 0;
+		cmd.fValue = 0.0f;
+		cmd.fValue2 = 0.0f;
+		if (sAddress == "/tactosonix/loop/add" && nNumArgs == 2 && bStoveArg)
+		{
+			cmd.type = kitchenOscCommand::ADD_LOOP;
+			cmd.nStove = msg.getArgAsInt32(0);
+			cmd.nIndex = msg.getArgAsInt32(1);
+		}
+		else if (sAddress == "/tactosonix/loop/remove" && nNumArgs == 2 && bStoveArg)
+		{
+			cmd.type = kitchenOscCommand::REMOVE_LOOP;
+			cmd.nStove = msg.getArgAsInt32(0);
+			cmd.nIndex = msg.getArgAsInt32(1);
+		}
+		else if (sAddress == "/tactosonix/node/volume" && nNumArgs == 3 && bStoveArg)
+		{
+			cmd.type = kitchenOscCommand::NODE_VOLUME;
+			cmd.nStove = msg.getArgAsInt32(0);
+			cmd.nIndex = msg.getArgAsInt32(1);
+			cmd.fValue = msg.getArgAsFloat(2);
+		}
+		else if (sAddress == "/tactosonix/node/lowpass" && nNumArgs == 3 && bStoveArg)
+		{
+			cmd.type = kitchenOscCommand::NODE_LOWPASS;
+			cmd.nStove = msg.getArgAsInt32(0);
+			cmd.nIndex = msg.getArgAsInt32(1);
+			cmd.fValue = msg.getArgAsFloat(2);
+		}
+		else if (sAddress == "/tactosonix/node/loopbeats" && nNumArgs == 3 && bStoveArg)
+		{
+			cmd.type = kitchenOscCommand::NODE_LOOPBEATS;
+			cmd.nStove = msg.getArgAsInt32(0);
+			cmd.nIndex = msg.getArgAsInt32(1);
+			cmd.fValue = (float)msg.getArgAsInt32(2);
+		}
+		else if (sAddress == "/tactosonix/pot/focus" && nNumArgs == 2 && bStoveArg)
+		{
+			cmd.type = kitchenOscCommand::POT_FOCUS;
+			cmd.nStove = msg.getArgAsInt32(0);
+			cmd.fValue = msg.getArgAsFloat(1);
+		}
+		else if (sAddress == "/tactosonix/focus" && nNumArgs == 2)
+		{
+			cmd.type = kitchenOscCommand::KITCHEN_FOCUS;
+			cmd.fValue = msg.getArgAsFloat(0);
+			cmd.fValue2 = msg.getArgAsFloat(1);
+		}
+		else
+		{
+			// A controller that sends the wrong messages sends them all the time: only the first one is a warning
+			m_nNumIgnored++;
+			if (m_nNumIgnored == 1)
+			{
+				ofLogWarning("ofxKitchenOscControl", "Ignoring " + sAddress + " with " + ofToString(nNumArgs) + " arguments, and logging the next ignored messages as verbose");
+			}
+			else if (ofGetLogLevel() <= OF_LOG_VERBOSE)
+			{
+				ofLogVerbose("ofxKitchenOscControl", "Ignoring " + sAddress + " with " + ofToString(nNumArgs) + " arguments");
+			}
+			continue;
+		}
+		queueCommand(cmd);
+	}
+}
+
+/** \param cmd The command to add to the batch.
+*/
+void ofxKitchenOscControl::queueCommand(const kitchenOscCommand& cmd)
+{
+	if (cmd.type != kitchenOscCommand::ADD_LOOP && cmd.type != kitchenOscCommand::REMOVE_LOOP)
+	{
+		// Only the last value of a parameter matters, unless the lanes of the pot changed in between
+		for (vector<kitchenOscCommand>::reverse_iterator It = m_batch.rbegin(); It != m_batch.rend(); ++It)
+		{
+			if ((It->type == kitchenOscCommand::ADD_LOOP || It->type == kitchenOscCommand::REMOVE_LOOP) && It->nStove == cmd.nStove)
+			{
+				break;
+			}
+			if (It->type == cmd.type && It->nStove == cmd.nStove && It->nIndex == cmd.nIndex)
+			{
+				*It = cmd;
+				return;
+			}
+		}
+	}
+	m_batch.push_back(cmd);
+}
+
+/** \return Whether or not the batch held any command.
+*/
+bool ofxKitchenOscControl::applyBatch()
+{
+	bool bApplied = !m_batch.empty();
+	for (vector<kitchenOscCommand>::iterator It = m_batch.begin(); It != m_batch.end(); ++It)
+	{
+		if (It->type == kitchenOscCommand::KITCHEN_FOCUS)
+		{
+			m_kitchen->setDragOffset(ofPoint(It->fValue, It->fValue2));
+			continue;
+		}
+		if (It->nStove < 0 || It->nStove >= 4)
+		{
+			continue;
+		}
+
+		ofxPot* pot = m_kitchen->getStovetop(It->nStove)->getPot();
+		ofxCookableNode* node = NULL;
+		switch (It->type)
+		{
+		case kitchenOscCommand::ADD_LOOP:
+			m_kitchen->addLoop(It->nStove, It->nIndex);
+			break;
+		case kitchenOscCommand::REMOVE_LOOP:
+			m_kitchen->removeLoop(It->nStove, It->nIndex);
+			break;
+		case kitchenOscCommand::NODE_VOLUME:
+			node = pot->getPlayingNode(It->nIndex);
+			if (node != NULL)
+			{
+				node->setRelativeVolume(It->fValue);
+			}
+			break;
+		case kitchenOscCommand::NODE_LOWPASS:
+			node = pot->getPlayingNode(It->nIndex);
+			if (node != NULL)
+			{
+				node->setLowpass(It->fValue);
+			}
+			break;
+		case kitchenOscCommand::NODE_LOOPBEATS:
+			node = pot->getPlayingNode(It->nIndex);
+			if (node != NULL)
+			{
+				node->setLoopBeats((unsigned int)max(It->fValue, 0.0f));
+			}
+			break;
+		case kitchenOscCommand::POT_FOCUS:
+			pot->setFocusVolume(It->fValue);
+			break;
+		default:
+			break;
+		}
+	}
+	m_batch.clear();
+	return bApplied;
+}
+
+/** \param state The vector to fill with the state of the kitchen.
+*/
+void ofxKitchenOscControl::readState(vector<float>& state)
+{
+	int n = 0;
+	state[n++] = m_kitchen->getDragOffset().x;
+	state[n++] = m_kitchen->getDragOffset().y;
+	for (int i = 0; i < 4; i++)
+	{
+		ofxPot* pot = m_kitchen->getStovetop(i)->getPot();
+		state[n++] = pot->getFocusVolume();
+		for (int j = 0; j < OFX_POT_NUMLANES; j++)
+		{
+			ofxCookableNode* node = pot->getPlayingNode(j);
+			state[n++] = node != NULL ? node->getLoopIndex() : -1;
+			state[n++] = node != NULL ? node->getRelativeVolume() : 0.0f;
+			state[n++] = node != NULL ? node->getLowpass() : 0.0f;
+			state[n++] = node != NULL ? node->getLoopBeats() : 0;
+		}
+	}
+}
+
+void ofxKitchenOscControl::publish()
+{
+	readState(m_state);
+	if (m_state == m_publishedState)
+	{
+		return;
+	}
+	m_publishedState = m_state;
+
+	// Everything goes out in a single bundle
+	ofxOscBundle bundle;
+	int n = 0;
+	ofxOscMessage msg;
+	msg.setAddress("/tactosonix/state/focus");
+	msg.addFloatArg(m_state[n++]);
+	msg.addFloatArg(m_state[n++]);
+	bundle.addMessage(msg);
+	for (int i = 0; i < 4; i++)
+	{
+		msg.clear();
+		msg.setAddress("/tactosonix/state/pot");
+		msg.addIntArg(i);
+		msg.addFloatArg(m_state[n++]);
+		bundle.addMessage(msg);
+		for (int j = 0; j < OFX_POT_NUMLANES; j++)
+		{
+			msg.clear();
+			msg.setAddress("/tactosonix/state/node");
+			msg.addIntArg(i);
+			msg.addIntArg(j);
+			msg.addIntArg((int)m_state[n++]);
+			msg.addFloatArg(m_state[n++]);
+			msg.addFloatArg(m_state[n++]);
+			msg.addIntArg((int)m_state[n++]);
+			bundle.addMessage(msg);
+		}
+	}
+	m_sender.sendBundle(bundle);
+}
@@ -0,0 +1,98 @@
+#ifndef _OFX_KITCHEN_OSC_CONTROL
+#define _OFX_KITCHEN_OSC_CONTROL
+
+/**
+ * \class ofxKitchenOscControl
+ *
+ * \brief This class is an OSC control surface for the kitchen: external controllers can add and remove
+ * loops, change the parameters of the playing nodes and the focus of the pots, and receive the resulting state.
+ *
+ * Inbound messages are gathered into a bounded batch and applied together once per kitchen update. Repeated
+ * parameter changes of the same target within a batch are coalesced. Outbound state goes out as a single
+ * bundle at a configurable rate, and only when it changed.
+ *
+ * Inbound addresses (pot is the stove top ID, lane is 0 for drums, 1 for bass and 2 for lead):
+ * - /tactosonix/loop/add i:pot i:loop (loop is the index in loops.xml, drums first, then bass, then lead)
+ * - /tactosonix/loop/remove i:pot i:lane
+ * - /tactosonix/node/volume i:pot i:lane f:volume
+ * - /tactosonix/node/lowpass i:pot i:lane f:lowpass
+ * - /tactosonix/node/loopbeats i:pot i:lane i:beats
+ * - /tactosonix/pot/focus i:pot f:volume
+ * - /tactosonix/focus f:x f:y (the normalized drag offset of the kitchen)
+ *
+ * Outbound addresses:
+ * - /tactosonix/state/focus f:x f:y
+ * - /tactosonix/state/pot i:pot f:volume
+ * - /tactosonix/state/node i:pot i:lane i:loop f:volume f:lowpass i:beats (loop is -1 for an empty lane)
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+
+class metaphorKitchen;
+
+#define KITCHEN_OSC_IN_PORT 9000
+#define KITCHEN_OSC_OUT_HOST "localhost"
+#define KITCHEN_OSC_OUT_PORT 9001
+#define KITCHEN_OSC_OUT_RATE 20.0f ///< The maximum number of state bundles sent per second.
+#define KITCHEN_OSC_MAX_BATCH 256 ///< The maximum number of commands applied per kitchen update.
+
+/// A command received from an external controller.
+struct kitchenOscCommand
+{
+	/// The type of a command.
+	enum commandType {
+		ADD_LOOP, ///< Adds a loop to a pot.
+		REMOVE_LOOP, ///< Removes the playing node of a lane.
+		NODE_VOLUME, ///< Sets the volume of the playing node of a lane.
+		NODE_LOWPASS, ///< Sets the lowpass of the playing node of a lane.
+		NODE_LOOPBEATS, ///< Sets the loop length in beats of the playing node of a lane.
+		POT_FOCUS, ///< Sets the focus volume of a pot.
+		KITCHEN_FOCUS ///< Sets the drag offset of the kitchen.
+	};
+
+	commandType						type; ///< The type of the command.
+	int								nStove; ///< The ID of the stove top.
+	int								nIndex; ///< The lane, or the loop index for ADD_LOOP.
+	float							fValue; ///< The value of the parameter (x for KITCHEN_FOCUS).
+	float							fValue2; ///< The y value for KITCHEN_FOCUS.
+};
+
+/// A class that implements an OSC control surface for the kitchen.
+class ofxKitchenOscControl
+{
+public:
+	ofxKitchenOscControl(); ///< Constructor
+
+	void							setup(metaphorKitchen* kitchen, int nInPort = KITCHEN_OSC_IN_PORT,
+										string sOutHost = KITCHEN_OSC_OUT_HOST, int nOutPort = KITCHEN_OSC_OUT_PORT,
+										float fOutRate = KITCHEN_OSC_OUT_RATE); ///< Starts listening and sets the destination of the state bundles.
+	bool							update(uint64_t nNowMs); ///< Applies the pending batch of commands and publishes the state if it is due.
+	void							setOutputRate(float fRate) { m_fOutRate = fRate; } ///< Sets the maximum number of state bundles per second. \param fRate The number of bundles per second.
+	uint64_t						getNumIgnored() const { return m_nNumIgnored; } ///< Returns the number of messages ignored because of their address or arguments. \return The number of ignored messages.
+
+private:
+	void							receive(); ///< Reads the waiting messages into the batch.
+	void							queueCommand(const kitchenOscCommand& cmd); ///< Adds a command to the batch, coalescing it with a previous one if possible.
+	bool							applyBatch(); ///< Applies the batch of commands to the kitchen.
+	void							publish(); ///< Sends the state bundle if the state changed.
+	void							readState(vector<float>& state); ///< Reads the published state of the kitchen.
+
+	metaphorKitchen*				m_kitchen; ///< The kitchen being controlled.
+	bool							m_bSetup; ///< Whether or not the control surface is set up.
+	ofxOscReceiver					m_receiver; ///< The receiver of the controller messages.
+	ofxOscSender					m_sender; ///< The sender of the state bundles.
+	float							m_fOutRate; ///< The maximum number of state bundles per second.
+	uint64_t						m_nLastPublishMs; ///< The time in milliseconds at which the state was last published.
+	vector<kitchenOscCommand>		m_batch; ///< The batch of commands to apply at the next update.
+	vector<float>					m_state; ///< The current state of the kitchen.
+	vector<float>					m_publishedState; ///< The state of the kitchen in the last bundle sent.
+	uint64_t						m_nNumIgnored; ///< The number of messages ignored because of their address or arguments.
+};
+
+#endif
@@ -0,0 +1,220 @@
+#include "ofxKitchenRenderer.h"
+#include "ofxProfiler.h"
+
+#include "TactosonixHelpers.h"
+using namespace TactoHelpers;
+
+ofxKitchenRenderer::ofxKitchenRenderer() :
+	m_nNumFrames(0),
+	m_nDelayUs(KITCHEN_SIMULATION_STEP_US)
+{
+	setup();
+}
+
+/** \param nDelayUs How far in the past in microseconds the kitchen is drawn, at least one step of the simulation for
+* the drawn state to fall between two published ones.
+*/
+void ofxKitchenRenderer::setup(int nDelayUs)
+{
+	m_nNumFrames = 0;
+	m_nDelayUs = max(nDelayUs, 0);
+	for (int i = 0; i < KITCHEN_SNAPSHOT_NUM_POTS; i++)
+	{
+		m_beatTimeUs[i] = 0;
+		m_beatPeriodUs[i] = 0;
+	}
+}
+
+/** \param frame The state, taken from the simulation.
+*/
+void ofxKitchenRenderer::addFrame(const kitchenFrame& frame)
+{
+	if (m_nNumFrames > 0 && frame.nStep == m_current.nStep)
+	{
+		return;
+	}
+
+	// The pots pulse on the beats seen in the states, at the tempo measured between them
+	for (int i = 0; i < KITCHEN_SNAPSHOT_NUM_POTS; i++)
+	{
+		if (m_nNumFrames == 0 || frame.snapshot.pots[i].nCurrentBeat != m_current.snapshot.pots[i].nCurrentBeat)
+		{
+			if (m_beatTimeUs[i] > 0)
+			{
+				m_beatPeriodUs[i] = frame.nTimeUs - m_beatTimeUs[i];
+			}
+			m_beatTimeUs[i] = frame.nTimeUs;
+		}
+	}
+
+	m_previous = m_current;
+	m_current = frame;
+	m_nNumFrames = min(m_nNumFrames + 1, 2);
+}
+
+/** \param nNowUs The time in microseconds, on the clock of the simulation.
+*/
+void ofxKitchenRenderer::draw(uint64_t nNowUs)
+{
+	PROFILER_SCOPE("ofxKitchenRenderer::draw");
+	if (m_nNumFrames == 0)
+	{
+		return;
+	}
+
+	// Draw the kitchen as it was between the last two states
+	int64_t nRenderUs = (int64_t)nNowUs - m_nDelayUs;
+	float t = 1.0f;
+	if (m_nNumFrames == 2 && m_current.nTimeUs > m_previous.nTimeUs)
+	{
+		t = ofClamp((float)(nRenderUs - (int64_t)m_previous.nTimeUs) / (float)(m_current.nTimeUs - m_previous.nTimeUs), 0.0f, 1.0f);
+	}
+	interpolate(t);
+
+	// The drag is a single offset, ahead of the swipe as in metaphorKitchen::draw()
+	m_batch.pushOffset(m_drawn.fDrawnDragX * ofGetWidth(), m_drawn.fDrawnDragY * ofGetHeight());
+	for (int i = 0; i < KITCHEN_SNAPSHOT_NUM_POTS; i++)
+	{
+		// Fade from 255 on the beat down to the minimum alpha at the next beat, as in ofxPot::drawDisc()
+		float fAlpha = 255.0f;
+		if (m_beatPeriodUs[i] > 0)
+		{
+			float fBeatPct = ofClamp((float)(nRenderUs - (int64_t)m_beatTimeUs[i]) / (float)m_beatPeriodUs[i], 0.0f, 1.0f);
+			fAlpha = 255.0f * pow(KITCHEN_RENDERER_MIN_ALPHA / 255.0f, fBeatPct);
+		}
+		drawPot(m_drawn.pots[i], (stoveInformation::tactoStove)i, fAlpha);
+	}
+	for (int i = 0; i < KITCHEN_SNAPSHOT_NUM_POTS; i++)
+	{
+		drawDraggedNodes(m_drawn.pots[i]);
+	}
+	m_batch.popOffset();
+
+	// The menu and the points dragged in the background stay in place on the screen
+	for (int i = 0; i < m_drawn.nNumMenuNodes; i++)
+	{
+		const kitchenDiscState& node = m_drawn.menuNodes[i];
+		m_batch.addCircle(node.x, node.y, node.fRadius, ofColor::fromHex(node.nColor));
+	}
+	for (int i = 0; i < m_drawn.nNumDragPoints; i++)
+	{
+		const kitchenDiscState& point = m_drawn.dragPoints[i];
+		m_batch.addCircle(point.x, point.y, point.fRadius, ofColor::fromHex(point.nColor));
+	}
+	m_batch.flush();
+}
+
+/** \param t The position ([0;1] range) of the drawn state between the state before the last one and the last one.
+*/
+void ofxKitchenRenderer::interpolate(float t)
+{
+	m_drawn = m_current.snapshot;
+	if (m_nNumFrames < 2 || t >= 1.0f)
+	{
+		return;
+	}
+
+	const kitchenSnapshot& previous = m_previous.snapshot;
+	m_drawn.fDragX = previous.fDragX + (m_drawn.fDragX - previous.fDragX) * t;
+	m_drawn.fDragY = previous.fDragY + (m_drawn.fDragY - previous.fDragY) * t;
+	m_drawn.fDrawnDragX = previous.fDrawnDragX + (m_drawn.fDrawnDragX - previous.fDrawnDragX) * t;
+	m_drawn.fDrawnDragY = previous.fDrawnDragY + (m_drawn.fDrawnDragY - previous.fDrawnDragY) * t;
+	for (int nPot = 0; nPot < KITCHEN_SNAPSHOT_NUM_POTS; nPot++)
+	{
+		kitchenPotState& pot = m_drawn.pots[nPot];
+		const kitchenPotState& previousPot = previous.pots[nPot];
+		for (int i = 0; i < pot.nNumNodes; i++)
+		{
+			kitchenNodeState& node = pot.nodes[i];
+			for (int j = 0; j < previousPot.nNumNodes; j++)
+			{
+				const kitchenNodeState& previousNode = previousPot.nodes[j];
+				if (previousNode.nNodeId == node.nNodeId)
+				{
+					node.x = previousNode.x + (node.x - previousNode.x) * t;
+					node.y = previousNode.y + (node.y - previousNode.y) * t;
+					node.fLeadX = previousNode.fLeadX + (node.fLeadX - previousNode.fLeadX) * t;
+					node.fLeadY = previousNode.fLeadY + (node.fLeadY - previousNode.fLeadY) * t;
+					break;
+				}
+			}
+		}
+	}
+
+	// The discs of the menu and the dragged points have no ID, and are only blended while their number stays the same
+	if (m_drawn.nNumMenuNodes == previous.nNumMenuNodes)
+	{
+		for (int i = 0; i < m_drawn.nNumMenuNodes; i++)
+		{
+			interpolateDisc(m_drawn.menuNodes[i], previous.menuNodes[i], t);
+		}
+	}
+	if (m_drawn.nNumDragPoints == previous.nNumDragPoints)
+	{
+		for (int i = 0; i < m_drawn.nNumDragPoints; i++)
+		{
+			interpolateDisc(m_drawn.dragPoints[i], previous.dragPoints[i], t);
+		}
+	}
+}
+
+/**
+* \param disc The disc in the last state, blended in place.
+* \param previous The disc in the state before the last one.
+* \param t The position ([0;1] range) of the drawn state between the two states.
+*/
+void ofxKitchenRenderer::interpolateDisc(kitchenDiscState& disc, const kitchenDiscState& previous, float t)
+{
+	disc.x = previous.x + (disc.x - previous.x) * t;
+	disc.y = previous.y + (disc.y - previous.y) * t;
+}
+
+/**
+* \param pot The state of the pot.
+* \param stoveId The ID of the stove top of the pot.
+* \param fAlpha The alpha of the pot.
+*/
+void ofxKitchenRenderer::drawPot(const kitchenPotState& pot, stoveInformation::tactoStove stoveId, float fAlpha)
+{
+	m_batch.addCircle(pot.x, pot.y, pot.fRadius, ofColor::fromHex(pot.nColor, fAlpha));
+
+	// The current beat goes around the pot, as in ofxPot::addStaticShapes()
+	float fCurrBeatPct = (float)(pot.nCurrentBeat % OFX_POT_NUMSEQUENCERSTEPS) / (float)OFX_POT_NUMSEQUENCERSTEPS;
+	cartesianCoords currBeatOffset = polToCar(pot.fRadius, PI/2 + fCurrBeatPct * TWO_PI);
+	m_batch.addCircle(pot.x - currBeatOffset.x, pot.y - currBeatOffset.y, pot.fRadius * 0.05f, ofColor::fromHex(pot.nColor, 255));
+	stoveInformation::addShapes(m_batch, stoveId, ofPoint(pot.fInfoX, pot.fInfoY));
+
+	for (int i = 0; i < pot.nNumNodes; i++)
+	{
+		const kitchenNodeState& node = pot.nodes[i];
+		if (!node.bDragged)
+		{
+			ofxCookableNode::addNodeShape(m_batch, node.x, node.y, node.fRadius, ofColor::fromHex(node.nColor), !node.bPlaying);
+		}
+	}
+}
+
+/** \param pot The state of the pot.
+*/
+void ofxKitchenRenderer::drawDraggedNodes(const kitchenPotState& pot)
+{
+	for (int i = 0; i < pot.nNumNodes; i++)
+	{
+		const kitchenNodeState& node = pot.nodes[i];
+		if (!node.bDragged)
+		{
+			continue;
+		}
+		float fDrawnX = node.x + node.fLeadX;
+		float fDrawnY = node.y + node.fLeadY;
+		ofxCookableNode::addNodeShape(m_batch, fDrawnX, fDrawnY, node.fRadius, ofColor::fromHex(node.nColor), false);
+		if (node.bInPot)
+		{
+			// The volume follows the measured position and the lowpass the drawn one, as in ofxPot::drawOverlay()
+			float fDistance = sqrt(pow(pot.x - node.x, 2) + pow(pot.y - node.y, 2));
+			m_batch.addRing(pot.x, pot.y, fDistance, node.fVolume * 10.0f, ofColor::fromHex(node.nColor, ofClamp(node.fVolume * 255, 0, 255)));
+			float fOuterRadius = 0.6f * node.fRadius;
+			m_batch.addStar(fDrawnX, fDrawnY, fOuterRadius * (1.0f - node.fLowpass), fOuterRadius, KITCHEN_RENDERER_LOWPASS_TIPS, ofColor::fromHex(node.nColor, 255));
+		}
+	}
+}
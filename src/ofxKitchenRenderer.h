@@ -0,0 +1,63 @@
+#ifndef _OFX_KITCHEN_RENDERER
+#define _OFX_KITCHEN_RENDERER
+
+/**
+ * \class ofxKitchenRenderer
+ *
+ * \brief This class draws the states of the kitchen published by an ofxKitchenSimulation.
+ *
+ * The renderer keeps the last two states it was given, and draws the kitchen as it was a little in the past, between
+ * them: the drag offset and the positions of the nodes are interpolated, so that the motion stays smooth whatever
+ * the rate of the display and the rate of the simulation. A node is matched between the two states by its ID, and a
+ * node only present in the newer state is drawn where it is.
+ *
+ * The pots, their current beats, the stove top information, the nodes, the volume and lowpass of the dragged nodes,
+ * the menu of loops and the points dragged in the background are drawn in one batch. The nodes are drawn with
+ * ofxCookableNode::addNodeShape(), as the pots draw them without the simulation thread. The pots pulse on the beats seen
+ * in the states. The kitchen and the dragged nodes are drawn ahead of the touches, at the positions the touch
+ * predictor gave when the state was published: the lead makes up for the latency of the display, but not for the
+ * delay of the renderer. The menu is drawn as the discs of its root, of its categories, of the loops of the category
+ * last touched and of the loops dragged out of it, rather than with the look of ofxTactoSHPM.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "kitchenSnapshot.h"
+#include "ofxKitchenSimulation.h"
+#include "ofxBatchRenderer.h"
+#include "ofxStovetop.h"
+
+#define KITCHEN_RENDERER_MIN_ALPHA 128.0f ///< The alpha of a pot at the end of a beat, down from 255 on the beat.
+#define KITCHEN_RENDERER_LOWPASS_TIPS 8 ///< The number of tips of the lowpass feedback of a dragged node, as in ofxCookableNode::drawLowpass().
+
+/// A class that draws the kitchen from its published states.
+class ofxKitchenRenderer
+{
+public:
+	ofxKitchenRenderer(); ///< Constructor
+
+	void							setup(int nDelayUs = KITCHEN_SIMULATION_STEP_US); ///< Forgets the states and sets how far in the past the kitchen is drawn.
+	void							addFrame(const kitchenFrame& frame); ///< Gives a newer state of the kitchen.
+	void							draw(uint64_t nNowUs); ///< Draws the kitchen as it was the delay before a point in time.
+
+private:
+	void							interpolate(float t); ///< Blends the last two states into the drawn state.
+	void							interpolateDisc(kitchenDiscState& disc, const kitchenDiscState& previous, float t); ///< Blends the position of a disc between two states.
+	void							drawPot(const kitchenPotState& pot, stoveInformation::tactoStove stoveId, float fAlpha); ///< Adds a pot, its stove top information and the nodes not being dragged to the batch.
+	void							drawDraggedNodes(const kitchenPotState& pot); ///< Adds the nodes dragged in a pot and their volume and lowpass to the batch.
+
+	kitchenFrame					m_previous; ///< The state before the last one.
+	kitchenFrame					m_current; ///< The last state.
+	int								m_nNumFrames; ///< The number of states given since setup(), up to 2.
+	int								m_nDelayUs; ///< How far in the past in microseconds the kitchen is drawn.
+	uint64_t						m_beatTimeUs[KITCHEN_SNAPSHOT_NUM_POTS]; ///< The time in microseconds of the last beat of each pot.
+	uint64_t						m_beatPeriodUs[KITCHEN_SNAPSHOT_NUM_POTS]; ///< The time in microseconds between the last two beats of each pot.
+	kitchenSnapshot					m_drawn; ///< The state of the kitchen being drawn.
+	ofxBatchRenderer				m_batch; ///< The batch of the shapes of the kitchen.
+};
+
+#endif
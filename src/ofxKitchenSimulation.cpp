@@ -0,0 +1,215 @@
+#include "ofxKitchenSimulation.h"
+#include "ofxProfiler.h"
+
+#include <chrono>
+#include <thread>
+
+ofxKitchenSimulation::ofxKitchenSimulation() :
+	m_kitchen(NULL),
+	m_oscControl(NULL),
+	m_markers(NULL),
+	m_bPaused(false),
+	m_nNumSteps(0),
+	m_nNumOscUpdates(0),
+	m_nNumOverruns(0)
+{
+}
+
+ofxKitchenSimulation::~ofxKitchenSimulation()
+{
+	stop();
+}
+
+/**
+* \param kitchen The kitchen, already set up on the render thread.
+* \param oscControl The OSC control surface of the kitchen, or NULL.
+* \param markers The mapping of fiducial markers to the kitchen, or NULL.
+*/
+void ofxKitchenSimulation::setup(metaphorKitchen* kitchen, ofxKitchenOscControl* oscControl, ofxKitchenMarkers* markers)
+{
+	stop();
+	m_kitchen = kitchen;
+	m_oscControl = oscControl;
+	m_markers = markers;
+	m_nNumSteps = 0;
+	m_nNumOscUpdates = 0;
+	ofAddListener(m_kitchen->onsetEvent, this, &ofxKitchenSimulation::onsetReceived);
+
+	// The first state is published and taken before the thread starts, so that the render thread always has one
+	step();
+	m_frames.update();
+	startThread();
+}
+
+void ofxKitchenSimulation::stop()
+{
+	if (isThreadRunning())
+	{
+		waitForThread(true);
+	}
+	if (m_kitchen != NULL)
+	{
+		ofRemoveListener(m_kitchen->onsetEvent, this, &ofxKitchenSimulation::onsetReceived);
+	}
+
+	// Commands and onsets of the kitchen that stopped are dropped
+	kitchenCommand command;
+	while (m_commands.tryReceive(command))
+	{
+	}
+	kitchenOnset onset;
+	while (m_onsets.tryReceive(onset))
+	{
+	}
+}
+
+/**
+* \param type The type of the event.
+* \param x The x coordinate of the point.
+* \param y The y coordinate of the point.
+* \param fullRange Whether or not the coordinates of the queried point are in pixels (false means [0-1]).
+* \param button The ID of the mouse button, in the case of mouse input.
+* \param touchId The ID of the touch event, in the case of touch input.
+*/
+void ofxKitchenSimulation::postTouch(tactoTouchEventType type, float x, float y, bool fullRange, int button, int touchId)
+{
+	kitchenCommand command;
+	command.type = KITCHEN_COMMAND_TOUCH;
+	command.touch.timeMs = 0;
+	command.touch.type = type;
+	command.touch.fullRange = fullRange ? 1 : 0;
+	command.touch.button = button;
+	command.touch.touchId = touchId;
+	command.touch.x = x;
+	command.touch.y = y;
+	m_commands.send(command);
+}
+
+/** \param event The change of the markers.
+*/
+void ofxKitchenSimulation::postMarker(const fiducialEvent& event)
+{
+	kitchenCommand command;
+	command.type = KITCHEN_COMMAND_MARKER;
+	command.marker = event;
+	m_commands.send(command);
+}
+
+/**
+* \param nWidth The new width in pixels.
+* \param nHeight The new height in pixels.
+*/
+void ofxKitchenSimulation::postResize(int nWidth, int nHeight)
+{
+	kitchenCommand command;
+	command.type = KITCHEN_COMMAND_RESIZE;
+	command.nWidth = nWidth;
+	command.nHeight = nHeight;
+	m_commands.send(command);
+}
+
+void ofxKitchenSimulation::postTogglePrediction()
+{
+	kitchenCommand command;
+	command.type = KITCHEN_COMMAND_TOGGLE_PREDICTION;
+	m_commands.send(command);
+}
+
+void ofxKitchenSimulation::threadedFunction()
+{
+	// The ring of the profiler is taken before any allocation-free scope runs
+	ofxProfiler::setThreadName("Simulation");
+	uint64_t nNextStepUs = ofGetElapsedTimeMicros() + KITCHEN_SIMULATION_STEP_US;
+	while (isThreadRunning())
+	{
+		uint64_t nNowUs = ofGetElapsedTimeMicros();
+		if (nNowUs < nNextStepUs)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(nNextStepUs - nNowUs));
+			continue;
+		}
+
+		step();
+		nNextStepUs += KITCHEN_SIMULATION_STEP_US;
+
+		// Steps that are late are run back to back, unless the simulation fell too far behind to catch up
+		nNowUs = ofGetElapsedTimeMicros();
+		if (nNowUs > nNextStepUs + KITCHEN_SIMULATION_MAX_LAG_US)
+		{
+			nNextStepUs = nNowUs + KITCHEN_SIMULATION_STEP_US;
+			m_nNumOverruns++;
+		}
+	}
+}
+
+void ofxKitchenSimulation::step()
+{
+	PROFILER_SCOPE("ofxKitchenSimulation::step");
+	kitchenCommand command;
+	while (m_commands.tryReceive(command))
+	{
+		apply(command);
+	}
+
+	uint64_t nNowUs = ofGetElapsedTimeMicros();
+	if (m_oscControl != NULL && m_oscControl->update(nNowUs / 1000))
+	{
+		m_nNumOscUpdates++;
+	}
+	if (!m_bPaused)
+	{
+		m_kitchen->update(KITCHEN_SIMULATION_STEP_US / 1000000.0f);
+	}
+
+	kitchenFrame& frame = m_frames.getWriteBuffer();
+	m_kitchen->fillSnapshot(frame.snapshot);
+	frame.nTimeUs = nNowUs;
+	frame.nStep = m_nNumSteps++;
+	frame.nLateBeats = m_kitchen->getNumLateBeats();
+	frame.nNumOscUpdates = m_nNumOscUpdates;
+	m_frames.publish();
+}
+
+/** \param command The command.
+*/
+void ofxKitchenSimulation::apply(const kitchenCommand& command)
+{
+	switch (command.type)
+	{
+	case KITCHEN_COMMAND_TOUCH:
+		switch (command.touch.type)
+		{
+		case TACTO_TOUCH_DOWN:
+			m_kitchen->mouseTouchDown(command.touch.x, command.touch.y, command.touch.fullRange != 0, command.touch.button, command.touch.touchId);
+			break;
+		case TACTO_TOUCH_MOVED:
+			m_kitchen->mouseTouchMoved(command.touch.x, command.touch.y, command.touch.fullRange != 0, command.touch.button, command.touch.touchId);
+			break;
+		case TACTO_TOUCH_UP:
+			m_kitchen->mouseTouchUp(command.touch.x, command.touch.y, command.touch.fullRange != 0, command.touch.button, command.touch.touchId);
+			break;
+		}
+		break;
+	case KITCHEN_COMMAND_MARKER:
+		if (m_markers != NULL)
+		{
+			m_markers->markerEvent(command.marker);
+		}
+		break;
+	case KITCHEN_COMMAND_RESIZE:
+		m_kitchen->windowResized(command.nWidth, command.nHeight);
+		break;
+	case KITCHEN_COMMAND_TOGGLE_PREDICTION:
+		m_kitchen->getTouchPredictor()->setEnabled(!m_kitchen->getTouchPredictor()->isEnabled());
+		break;
+	default:
+		break;
+	}
+}
+
+/** \param onset The node playing a new beat of its pot.
+*/
+void ofxKitchenSimulation::onsetReceived(kitchenOnset& onset)
+{
+	m_onsets.send(onset);
+}
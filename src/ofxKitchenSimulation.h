@@ -0,0 +1,107 @@
+#ifndef _OFX_KITCHEN_SIMULATION
+#define _OFX_KITCHEN_SIMULATION
+
+/**
+ * \class ofxKitchenSimulation
+ *
+ * \brief This class runs the kitchen on its own thread at a fixed time step, apart from the drawing.
+ *
+ * The thread owns the kitchen, its pots, nodes and transport while it runs: every other thread talks to it through
+ * queues. Input events, marker events, window sizes and toggles of the touch prediction are posted as commands and
+ * applied at the start of the next step. The OSC control surface is updated at every step. Onsets are forwarded to a
+ * queue that the render thread drains. Whatever needs the OpenGL context, such as setting up the kitchen or taking a
+ * screenshot, stays on the render thread, the thread being stopped around a reset of the kitchen.
+ *
+ * After every step, a kitchenSnapshot of the kitchen and the time of the step are published through an
+ * ofxTripleBuffer. The render thread takes the latest one without waiting, and draws it with an ofxKitchenRenderer.
+ * A slow frame therefore never delays a beat, and a slow step never delays a frame.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "metaphorKitchen.h"
+#include "kitchenSnapshot.h"
+#include "ofxTripleBuffer.h"
+#include "ofxTouchRecorder.h"
+#include "ofxBlobPipeline.h"
+#include "ofxKitchenOscControl.h"
+#include "ofxKitchenMarkers.h"
+
+#define KITCHEN_SIMULATION_STEP_US 5000 ///< The time step in microseconds of the simulation.
+#define KITCHEN_SIMULATION_MAX_LAG_US 100000 ///< How far in microseconds the simulation may fall behind before it gives up catching up.
+
+/// A state of the kitchen published by the simulation.
+struct kitchenFrame
+{
+	kitchenSnapshot					snapshot; ///< The state of the kitchen.
+	uint64_t						nTimeUs; ///< The time in microseconds of the step.
+	uint64_t						nStep; ///< The number of the step.
+	int								nLateBeats; ///< The number of beats that were skipped or handled late.
+	uint64_t						nNumOscUpdates; ///< The number of steps since setup() in which OSC commands were applied.
+};
+
+/// The types of the commands posted to the simulation.
+enum kitchenCommandType
+{
+	KITCHEN_COMMAND_TOUCH, ///< An input event.
+	KITCHEN_COMMAND_MARKER, ///< A change of the fiducial markers.
+	KITCHEN_COMMAND_RESIZE, ///< A new size of the window.
+	KITCHEN_COMMAND_TOGGLE_PREDICTION ///< A toggle of the prediction of the touches.
+};
+
+/// A command posted to the simulation.
+struct kitchenCommand
+{
+	kitchenCommandType				type; ///< The type of the command.
+	tactoTouchRecord				touch; ///< The input event, for KITCHEN_COMMAND_TOUCH.
+	fiducialEvent					marker; ///< The change of the markers, for KITCHEN_COMMAND_MARKER.
+	int								nWidth; ///< The width of the window, for KITCHEN_COMMAND_RESIZE.
+	int								nHeight; ///< The height of the window, for KITCHEN_COMMAND_RESIZE.
+};
+
+/// A class that updates the kitchen on a thread of its own.
+class ofxKitchenSimulation : public ofThread
+{
+public:
+	ofxKitchenSimulation(); ///< Constructor
+	~ofxKitchenSimulation(); ///< Destructor
+
+	void							setup(metaphorKitchen* kitchen, ofxKitchenOscControl* oscControl, ofxKitchenMarkers* markers); ///< Sets the kitchen and the objects that act on it, and starts the thread.
+	void							stop(); ///< Stops the thread and drops the pending commands, after which the kitchen belongs to the caller again.
+	void							setPaused(bool bPaused) { m_bPaused = bPaused; } ///< Sets whether or not the kitchen is updated, the commands and OSC being handled anyway. \param bPaused Whether or not the kitchen is paused.
+
+	void							postTouch(tactoTouchEventType type, float x, float y, bool fullRange, int button, int touchId); ///< Queues an input event.
+	void							postMarker(const fiducialEvent& event); ///< Queues a change of the fiducial markers.
+	void							postResize(int nWidth, int nHeight); ///< Queues a new size of the window.
+	void							postTogglePrediction(); ///< Queues a toggle of the prediction of the touches.
+
+	bool							updateFrame() { return m_frames.update(); } ///< Takes the latest state of the kitchen, on the render thread. \return Whether or not it is newer than the last one.
+	const kitchenFrame&				getFrame() const { return m_frames.getReadBuffer(); } ///< Returns the state taken by the last updateFrame(). \return The state of the kitchen.
+	bool							getNextOnset(kitchenOnset& onset) { return m_onsets.tryReceive(onset); } ///< Takes the next onset, on the render thread. \return Whether or not there was one.
+	uint64_t						getNumOverruns() const { return m_nNumOverruns; } ///< Returns the number of times the simulation fell too far behind to catch up. \return The number of overruns.
+
+protected:
+	void							threadedFunction(); ///< Steps the kitchen at a fixed rate.
+
+private:
+	void							step(); ///< Applies the commands, updates the kitchen and publishes its state.
+	void							apply(const kitchenCommand& command); ///< Applies a command to the kitchen.
+	void							onsetReceived(kitchenOnset& onset); ///< Forwards an onset of the kitchen to the render thread.
+
+	metaphorKitchen*				m_kitchen; ///< The kitchen.
+	ofxKitchenOscControl*			m_oscControl; ///< The OSC control surface of the kitchen, or NULL.
+	ofxKitchenMarkers*				m_markers; ///< The mapping of fiducial markers to the kitchen, or NULL.
+	std::atomic<bool>				m_bPaused; ///< Whether or not the kitchen is paused.
+	ofThreadChannel<kitchenCommand>	m_commands; ///< The commands not applied yet.
+	ofThreadChannel<kitchenOnset>	m_onsets; ///< The onsets not drained yet.
+	ofxTripleBuffer<kitchenFrame>	m_frames; ///< The states of the kitchen.
+	uint64_t						m_nNumSteps; ///< The number of steps since setup().
+	uint64_t						m_nNumOscUpdates; ///< The number of steps since setup() in which OSC commands were applied.
+	std::atomic<uint64_t>			m_nNumOverruns; ///< The number of times the simulation fell too far behind.
+};
+
+#endif
@@ -0,0 +1,289 @@
+#include "ofxKitchenStatePublisher.h"
+
+ofxKitchenStatePublisher::ofxKitchenStatePublisher() :
+	m_bSetup(false), m_nBundleMessages(0), m_fRate(KITCHEN_VIZ_RATE), m_nKeyframeIntervalMs(KITCHEN_VIZ_KEYFRAME_MS),
+	m_nLastUpdateMs(0), m_nLastKeyframeMs(0), m_nKeyframeSeq(0), m_bHasLastSent(false), m_nMessagesSent(0)
+{
+}
+
+/**
+* \param sHost The host of the visualizer.
+* \param nPort The port of the visualizer.
+* \param fRate The maximum number of updates per second.
+* \param nKeyframeIntervalMs The interval in milliseconds between two keyframes.
+*/
+void ofxKitchenStatePublisher::setup(string sHost, int nPort, float fRate, int nKeyframeIntervalMs)
+{
+	m_sender.setup(sHost, nPort);
+	m_fRate = fRate;
+	m_nKeyframeIntervalMs = nKeyframeIntervalMs;
+	m_bHasLastSent = false;
+	m_bSetup = true;
+}
+
+/**
+* \param snapshot The current state of the kitchen.
+* \param nNowMs The current time in milliseconds.
+*/
+void ofxKitchenStatePublisher::update(const kitchenSnapshot& snapshot, uint64_t nNowMs)
+{
+	if (!m_bSetup || (m_fRate > 0.0f && nNowMs - m_nLastUpdateMs < 1000.0f / m_fRate))
+	{
+		return;
+	}
+	m_nLastUpdateMs = nNowMs;
+
+	if (!m_bHasLastSent || nNowMs - m_nLastKeyframeMs >= (uint64_t)m_nKeyframeIntervalMs)
+	{
+		m_nLastKeyframeMs = nNowMs;
+		sendKeyframe(snapshot);
+		m_lastSent = snapshot;
+	}
+	else
+	{
+		sendDelta(snapshot);
+	}
+	flush();
+	m_bHasLastSent = true;
+}
+
+/** \param snapshot The current state of the kitchen.
+*/
+void ofxKitchenStatePublisher::sendKeyframe(const kitchenSnapshot& snapshot)
+{
+	m_msg.clear();
+	m_msg.setAddress("/tactosonix/viz/keyframe");
+	m_msg.addIntArg(m_nKeyframeSeq++);
+	addMessage();
+
+	m_msg.clear();
+	m_msg.setAddress("/tactosonix/viz/focus");
+	m_msg.addFloatArg(snapshot.fDragX);
+	m_msg.addFloatArg(snapshot.fDragY);
+	addMessage();
+
+	for (int i = 0; i < KITCHEN_SNAPSHOT_NUM_POTS; i++)
+	{
+		const kitchenPotState& pot = snapshot.pots[i];
+		sendPot(i, pot);
+
+		m_msg.clear();
+		m_msg.setAddress("/tactosonix/viz/pot/focus");
+		m_msg.addIntArg(i);
+		m_msg.addFloatArg(pot.fFocus);
+		addMessage();
+
+		m_msg.clear();
+		m_msg.setAddress("/tactosonix/viz/pot/beat");
+		m_msg.addIntArg(i);
+		m_msg.addIntArg(pot.nCurrentBeat);
+		addMessage();
+
+		for (int j = 0; j < pot.nNumNodes; j++)
+		{
+			sendNodeAdd(i, pot.nodes[j]);
+		}
+	}
+}
+
+/** \param snapshot The current state of the kitchen, whose fields sent are recorded in the last sent state.
+*/
+void ofxKitchenStatePublisher::sendDelta(const kitchenSnapshot& snapshot)
+{
+	if (snapshot.fDragX != m_lastSent.fDragX || snapshot.fDragY != m_lastSent.fDragY)
+	{
+		m_msg.clear();
+		m_msg.setAddress("/tactosonix/viz/focus");
+		m_msg.addFloatArg(snapshot.fDragX);
+		m_msg.addFloatArg(snapshot.fDragY);
+		addMessage();
+		m_lastSent.fDragX = snapshot.fDragX;
+		m_lastSent.fDragY = snapshot.fDragY;
+	}
+
+	for (int i = 0; i < KITCHEN_SNAPSHOT_NUM_POTS; i++)
+	{
+		const kitchenPotState& pot = snapshot.pots[i];
+		const kitchenPotState& lastPot = m_lastSent.pots[i];
+		// The pot as sent: what is not sent this time keeps its last sent value
+		kitchenPotState sentPot = pot;
+		sentPot.fFocus = lastPot.fFocus;
+
+		// The pot geometry only changes when the window is resized
+		if (pot.x != lastPot.x || pot.y != lastPot.y || pot.fRadius != lastPot.fRadius || pot.nColor != lastPot.nColor)
+		{
+			sendPot(i, pot);
+		}
+		if (fabs(pot.fFocus - lastPot.fFocus) > KITCHEN_VIZ_VALUE_EPSILON)
+		{
+			m_msg.clear();
+			m_msg.setAddress("/tactosonix/viz/pot/focus");
+			m_msg.addIntArg(i);
+			m_msg.addFloatArg(pot.fFocus);
+			addMessage();
+			sentPot.fFocus = pot.fFocus;
+		}
+		if (pot.nCurrentBeat != lastPot.nCurrentBeat)
+		{
+			m_msg.clear();
+			m_msg.setAddress("/tactosonix/viz/pot/beat");
+			m_msg.addIntArg(i);
+			m_msg.addIntArg(pot.nCurrentBeat);
+			addMessage();
+		}
+
+		// Nodes that are new or changed
+		for (int j = 0; j < pot.nNumNodes; j++)
+		{
+			const kitchenNodeState& node = pot.nodes[j];
+			int nLast = 0;
+			while (nLast < lastPot.nNumNodes && lastPot.nodes[nLast].nNodeId != node.nNodeId)
+			{
+				nLast++;
+			}
+			if (nLast == lastPot.nNumNodes)
+			{
+				sendNodeAdd(i, node);
+			}
+			else
+			{
+				sentPot.nodes[j] = lastPot.nodes[nLast];
+				sendNodeDelta(node, sentPot.nodes[j]);
+			}
+		}
+
+		// Nodes that are gone
+		for (int j = 0; j < lastPot.nNumNodes; j++)
+		{
+			int nCurr = 0;
+			while (nCurr < pot.nNumNodes && pot.nodes[nCurr].nNodeId != lastPot.nodes[j].nNodeId)
+			{
+				nCurr++;
+			}
+			if (nCurr == pot.nNumNodes)
+			{
+				m_msg.clear();
+				m_msg.setAddress("/tactosonix/viz/node/remove");
+				m_msg.addIntArg(lastPot.nodes[j].nNodeId);
+				addMessage();
+			}
+		}
+		m_lastSent.pots[i] = sentPot;
+	}
+}
+
+/**
+* \param nPot The ID of the stove top of the pot.
+* \param pot The state of the pot.
+*/
+void ofxKitchenStatePublisher::sendPot(int nPot, const kitchenPotState& pot)
+{
+	m_msg.clear();
+	m_msg.setAddress("/tactosonix/viz/pot");
+	m_msg.addIntArg(nPot);
+	m_msg.addFloatArg(pot.x);
+	m_msg.addFloatArg(pot.y);
+	m_msg.addFloatArg(pot.fRadius);
+	m_msg.addIntArg(pot.nColor);
+	addMessage();
+}
+
+/**
+* \param nPot The ID of the stove top of the pot in which the node cooks.
+* \param node The state of the node.
+*/
+void ofxKitchenStatePublisher::sendNodeAdd(int nPot, const kitchenNodeState& node)
+{
+	m_msg.clear();
+	m_msg.setAddress("/tactosonix/viz/node/add");
+	m_msg.addIntArg(node.nNodeId);
+	m_msg.addIntArg(nPot);
+	m_msg.addIntArg(node.nLane);
+	m_msg.addIntArg(node.nLoopIndex);
+	m_msg.addFloatArg(node.x);
+	m_msg.addFloatArg(node.y);
+	m_msg.addFloatArg(node.fRadius);
+	m_msg.addIntArg(node.nColor);
+	m_msg.addFloatArg(node.fVolume);
+	m_msg.addFloatArg(node.fLowpass);
+	m_msg.addIntArg(node.nLoopBeats);
+	m_msg.addIntArg(node.bPlaying ? 1 : 0);
+	addMessage();
+}
+
+/**
+* \param node The current state of the node.
+* \param sentNode The state of the node as last sent, to which the fields sent are copied.
+*/
+void ofxKitchenStatePublisher::sendNodeDelta(const kitchenNodeState& node, kitchenNodeState& sentNode)
+{
+	if (fabs(node.x - sentNode.x) > KITCHEN_VIZ_POSITION_EPSILON || fabs(node.y - sentNode.y) > KITCHEN_VIZ_POSITION_EPSILON)
+	{
+		m_msg.clear();
+		m_msg.setAddress("/tactosonix/viz/node/pos");
+		m_msg.addIntArg(node.nNodeId);
+		m_msg.addFloatArg(node.x);
+		m_msg.addFloatArg(node.y);
+		addMessage();
+		sentNode.x = node.x;
+		sentNode.y = node.y;
+	}
+	if (fabs(node.fVolume - sentNode.fVolume) > KITCHEN_VIZ_VALUE_EPSILON)
+	{
+		m_msg.clear();
+		m_msg.setAddress("/tactosonix/viz/node/volume");
+		m_msg.addIntArg(node.nNodeId);
+		m_msg.addFloatArg(node.fVolume);
+		addMessage();
+		sentNode.fVolume = node.fVolume;
+	}
+	if (fabs(node.fLowpass - sentNode.fLowpass) > KITCHEN_VIZ_VALUE_EPSILON)
+	{
+		m_msg.clear();
+		m_msg.setAddress("/tactosonix/viz/node/lowpass");
+		m_msg.addIntArg(node.nNodeId);
+		m_msg.addFloatArg(node.fLowpass);
+		addMessage();
+		sentNode.fLowpass = node.fLowpass;
+	}
+	if (node.nLoopBeats != sentNode.nLoopBeats)
+	{
+		m_msg.clear();
+		m_msg.setAddress("/tactosonix/viz/node/beats");
+		m_msg.addIntArg(node.nNodeId);
+		m_msg.addIntArg(node.nLoopBeats);
+		addMessage();
+		sentNode.nLoopBeats = node.nLoopBeats;
+	}
+	if (node.bPlaying != sentNode.bPlaying)
+	{
+		m_msg.clear();
+		m_msg.setAddress("/tactosonix/viz/node/playing");
+		m_msg.addIntArg(node.nNodeId);
+		m_msg.addIntArg(node.bPlaying ? 1 : 0);
+		addMessage();
+		sentNode.bPlaying = node.bPlaying;
+	}
+}
+
+void ofxKitchenStatePublisher::addMessage()
+{
+	m_bundle.addMessage(m_msg);
+	m_nBundleMessages++;
+	m_nMessagesSent++;
+	if (m_nBundleMessages >= KITCHEN_VIZ_MAX_BUNDLE)
+	{
+		flush();
+	}
+}
+
+void ofxKitchenStatePublisher::flush()
+{
+	if (m_nBundleMessages > 0)
+	{
+		ofNotifyEvent(bundleEvent, m_bundle, this);
+		m_sender.sendBundle(m_bundle);
+		m_bundle.clear();
+		m_nBundleMessages = 0;
+	}
+}
@@ -0,0 +1,85 @@
+#ifndef _OFX_KITCHEN_STATE_PUBLISHER
+#define _OFX_KITCHEN_STATE_PUBLISHER
+
+/**
+ * \class ofxKitchenStatePublisher
+ *
+ * \brief This class mirrors the state of the kitchen to an external visualizer over OSC.
+ *
+ * Every update, the \link kitchenSnapshot of the kitchen is compared with the last one sent and only the fields
+ * that changed go out, so bandwidth and CPU follow the rate of change rather than the size of the scene. A field is
+ * only compared with the value last sent for it, so that a slow drift below the epsilon still goes out once it adds
+ * up.
+ * Positions are in kitchen coordinates: dragging the kitchen only sends the new drag offset.
+ * A keyframe with the whole state goes out periodically for visualizers that join late.
+ *
+ * Addresses (node is the unique node ID, pot is the stove top ID):
+ * - /tactosonix/viz/keyframe i:sequence (the receiver clears its state, the whole state follows)
+ * - /tactosonix/viz/focus f:x f:y
+ * - /tactosonix/viz/pot i:pot f:x f:y f:radius i:colour
+ * - /tactosonix/viz/pot/focus i:pot f:volume
+ * - /tactosonix/viz/pot/beat i:pot i:beat
+ * - /tactosonix/viz/node/add i:node i:pot i:lane i:loop f:x f:y f:radius i:colour f:volume f:lowpass i:beats i:playing
+ * - /tactosonix/viz/node/remove i:node
+ * - /tactosonix/viz/node/pos i:node f:x f:y
+ * - /tactosonix/viz/node/volume i:node f:volume
+ * - /tactosonix/viz/node/lowpass i:node f:lowpass
+ * - /tactosonix/viz/node/beats i:node i:beats
+ * - /tactosonix/viz/node/playing i:node i:playing
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+#include "kitchenSnapshot.h"
+
+#define KITCHEN_VIZ_HOST "localhost"
+#define KITCHEN_VIZ_PORT 9002
+#define KITCHEN_VIZ_RATE 60.0f ///< The maximum number of updates sent per second.
+#define KITCHEN_VIZ_KEYFRAME_MS 2000 ///< The interval in milliseconds between two keyframes.
+#define KITCHEN_VIZ_MAX_BUNDLE 64 ///< The maximum number of messages per bundle.
+#define KITCHEN_VIZ_POSITION_EPSILON 0.5f ///< The smallest change of position (in pixels) worth sending.
+#define KITCHEN_VIZ_VALUE_EPSILON 0.001f ///< The smallest change of a parameter worth sending.
+
+/// A class that publishes the changes of the kitchen state over OSC.
+class ofxKitchenStatePublisher
+{
+public:
+	ofxKitchenStatePublisher(); ///< Constructor
+
+	void							setup(string sHost = KITCHEN_VIZ_HOST, int nPort = KITCHEN_VIZ_PORT,
+										float fRate = KITCHEN_VIZ_RATE, int nKeyframeIntervalMs = KITCHEN_VIZ_KEYFRAME_MS); ///< Sets the destination and the rates of the updates.
+	void							update(const kitchenSnapshot& snapshot, uint64_t nNowMs); ///< Sends the changes of the kitchen state, or a keyframe if one is due.
+	uint64_t						getNumMessagesSent() const { return m_nMessagesSent; } ///< Returns the number of messages sent so far.
+
+	ofEvent<ofxOscBundle>			bundleEvent; ///< The event notified with every bundle, before it is sent.
+
+private:
+	void							sendKeyframe(const kitchenSnapshot& snapshot); ///< Sends the whole state.
+	void							sendDelta(const kitchenSnapshot& snapshot); ///< Sends the fields that changed since the last update.
+	void							sendPot(int nPot, const kitchenPotState& pot); ///< Sends the geometry of a pot.
+	void							sendNodeAdd(int nPot, const kitchenNodeState& node); ///< Sends a new node.
+	void							sendNodeDelta(const kitchenNodeState& node, kitchenNodeState& sentNode); ///< Sends the fields of a node that changed, and records them as sent.
+	void							addMessage(); ///< Adds the current message to the bundle, sending the bundle when it is full.
+	void							flush(); ///< Sends the pending bundle.
+
+	bool							m_bSetup; ///< Whether or not the publisher is set up.
+	ofxOscSender					m_sender; ///< The sender of the updates.
+	ofxOscBundle					m_bundle; ///< The pending bundle.
+	ofxOscMessage					m_msg; ///< The message being built.
+	int								m_nBundleMessages; ///< The number of messages in the pending bundle.
+	float							m_fRate; ///< The maximum number of updates per second.
+	int								m_nKeyframeIntervalMs; ///< The interval in milliseconds between two keyframes.
+	uint64_t						m_nLastUpdateMs; ///< The time in milliseconds of the last update.
+	uint64_t						m_nLastKeyframeMs; ///< The time in milliseconds of the last keyframe.
+	int								m_nKeyframeSeq; ///< The sequence number of the next keyframe.
+	bool							m_bHasLastSent; ///< Whether or not a keyframe was sent.
+	kitchenSnapshot					m_lastSent; ///< The state of the kitchen as last sent, field by field.
+	uint64_t						m_nMessagesSent; ///< The number of messages sent so far.
+};
+
+#endif
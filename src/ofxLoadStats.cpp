@@ -0,0 +1,94 @@
+#include "ofxLoadStats.h"
+
+ofxLoadStats::ofxLoadStats() :
+	m_nFrameStartUs(0), m_nFrameDispatchUs(0), m_nFrameEvents(0), m_nFrameStartAllocations(0),
+	m_nWindowStartUs(0), m_nWindowFrames(0), m_nWindowFrameUs(0), m_nWindowMaxFrameUs(0),
+	m_nWindowDispatchUs(0), m_nWindowMaxDispatchUs(0), m_nWindowEvents(0),
+	m_nWindowAllocations(0), m_nWindowMaxAllocations(0), m_nLateBeats(0)
+{
+	for (int i = 0; i < ALLOCATION_MAX_SCOPES; i++)
+	{
+		m_nWindowStartScopeCalls[i] = 0;
+		m_nWindowStartScopeAllocations[i] = 0;
+	}
+}
+
+/** \param nNowUs The current time in microseconds.
+*/
+void ofxLoadStats::beginFrame(uint64_t nNowUs)
+{
+	if (m_nFrameStartUs != 0)
+	{
+		// Close the previous frame
+		uint64_t nFrameUs = nNowUs - m_nFrameStartUs;
+		m_nWindowFrames++;
+		m_nWindowFrameUs += nFrameUs;
+		m_nWindowMaxFrameUs = max(m_nWindowMaxFrameUs, nFrameUs);
+		m_nWindowDispatchUs += m_nFrameDispatchUs;
+		m_nWindowMaxDispatchUs = max(m_nWindowMaxDispatchUs, m_nFrameDispatchUs);
+		m_nWindowEvents += m_nFrameEvents;
+		uint64_t nFrameAllocations = ofxAllocationCounter::getNumAllocations() - m_nFrameStartAllocations;
+		m_nWindowAllocations += nFrameAllocations;
+		m_nWindowMaxAllocations = max(m_nWindowMaxAllocations, nFrameAllocations);
+	}
+	else
+	{
+		m_nWindowStartUs = nNowUs;
+	}
+
+	m_nFrameStartUs = nNowUs;
+	m_nFrameDispatchUs = 0;
+	m_nFrameEvents = 0;
+
+	if (nNowUs - m_nWindowStartUs >= LOAD_STATS_WINDOW_MS * 1000)
+	{
+		closeWindow();
+		m_nWindowStartUs = nNowUs;
+	}
+
+	// The report is built after the frame starts counting, so that it does not count its own allocations
+	m_nFrameStartAllocations = ofxAllocationCounter::getNumAllocations();
+}
+
+void ofxLoadStats::closeWindow()
+{
+	if (m_nWindowFrames > 0)
+	{
+		float fAvgFrameMs = m_nWindowFrameUs / 1000.0f / m_nWindowFrames;
+		float fAvgDispatchMs = m_nWindowDispatchUs / 1000.0f / m_nWindowFrames;
+		m_sReport = "frame " + ofToString(fAvgFrameMs, 2) + " ms (max " + ofToString(m_nWindowMaxFrameUs / 1000.0f, 2) + ")\n"
+			+ "dispatch " + ofToString(fAvgDispatchMs, 3) + " ms (max " + ofToString(m_nWindowMaxDispatchUs / 1000.0f, 3) + ")\n"
+			+ "events " + ofToString(m_nWindowEvents / m_nWindowFrames) + " per frame\n"
+			+ "late beats " + ofToString(m_nLateBeats) + "\n"
+			+ "allocations " + ofToString((float)m_nWindowAllocations / m_nWindowFrames, 1) + " per frame (max " + ofToString(m_nWindowMaxAllocations) + ")";
+		if (ofxAllocationCounter::isStrict())
+		{
+			m_sReport += ", strict, " + ofToString(ofxAllocationCounter::getNumViolations()) + " violations";
+		}
+	}
+
+	// The allocation-free scopes that ran during the window, per call
+	int nNumScopes = ofxAllocationCounter::getNumScopes();
+	for (int i = 0; i < nNumScopes; i++)
+	{
+		const allocationScope& scope = ofxAllocationCounter::getScope(i);
+		uint64_t nNumCalls = scope.nNumCalls.load(std::memory_order_relaxed);
+		uint64_t nNumAllocations = scope.nNumAllocations.load(std::memory_order_relaxed);
+		if (m_nWindowFrames > 0 && nNumCalls > m_nWindowStartScopeCalls[i])
+		{
+			float fPerCall = (float)(nNumAllocations - m_nWindowStartScopeAllocations[i]) / (nNumCalls - m_nWindowStartScopeCalls[i]);
+			m_sReport += "\n  " + string(scope.sName.load(std::memory_order_relaxed)) + " " + ofToString(fPerCall, 2) + " per call";
+		}
+		m_nWindowStartScopeCalls[i] = nNumCalls;
+		m_nWindowStartScopeAllocations[i] = nNumAllocations;
+	}
+
+	m_nWindowFrames = 0;
+	m_nWindowFrameUs = 0;
+	m_nWindowMaxFrameUs = 0;
+	m_nWindowDispatchUs = 0;
+	m_nWindowMaxDispatchUs = 0;
+	m_nWindowEvents = 0;
+	m_nWindowAllocations = 0;
+	m_nWindowMaxAllocations = 0;
+}
@@ -0,0 +1,62 @@
+#ifndef _OFX_LOAD_STATS
+#define _OFX_LOAD_STATS
+
+/**
+ * \class ofxLoadStats
+ *
+ * \brief This class gathers per-frame load statistics of the application: frame time,
+ * time spent dispatching input events, beats handled late by the kitchen and allocations.
+ *
+ * Statistics are accumulated over a window of frames and reported as averages and maxima,
+ * so that the application can be observed under the load of \link tuioLoadGenerator. The allocations of
+ * every thread are counted per frame, and those of the allocation-free scopes of \link ofxAllocationCounter per call.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxAllocationCounter.h"
+
+#define LOAD_STATS_WINDOW_MS 1000
+
+/// A class that gathers per-frame load statistics.
+class ofxLoadStats
+{
+public:
+	ofxLoadStats(); ///< Constructor
+
+	void							beginFrame(uint64_t nNowUs); ///< Starts a new frame, closing the statistics of the previous one.
+	void							addDispatchTime(uint64_t nDurationUs) { m_nFrameDispatchUs += nDurationUs; m_nFrameEvents++; } ///< Adds the time spent dispatching one input event. \param nDurationUs The time in microseconds spent dispatching the event.
+	void							setLateBeats(int nLateBeats) { m_nLateBeats = nLateBeats; } ///< Sets the number of beats that were handled late so far. \param nLateBeats The number of late beats.
+	const string&					getReport() const { return m_sReport; } ///< Returns a text report of the last complete window of statistics.
+
+private:
+	void							closeWindow(); ///< Computes the report of the current window and starts a new one.
+
+	// Current frame
+	uint64_t						m_nFrameStartUs; ///< The time in microseconds at which the current frame started.
+	uint64_t						m_nFrameDispatchUs; ///< The time in microseconds spent dispatching input events during the current frame.
+	int								m_nFrameEvents; ///< The number of input events dispatched during the current frame.
+	uint64_t						m_nFrameStartAllocations; ///< The number of allocations of the application when the current frame started.
+
+	// Current window
+	uint64_t						m_nWindowStartUs; ///< The time in microseconds at which the current window started.
+	int								m_nWindowFrames; ///< The number of frames in the current window.
+	uint64_t						m_nWindowFrameUs; ///< The sum of the frame times of the current window.
+	uint64_t						m_nWindowMaxFrameUs; ///< The longest frame time of the current window.
+	uint64_t						m_nWindowDispatchUs; ///< The sum of the dispatch times of the current window.
+	uint64_t						m_nWindowMaxDispatchUs; ///< The longest per-frame dispatch time of the current window.
+	int								m_nWindowEvents; ///< The number of input events dispatched during the current window.
+	uint64_t						m_nWindowAllocations; ///< The number of allocations during the frames of the current window.
+	uint64_t						m_nWindowMaxAllocations; ///< The most allocations of a frame of the current window.
+	uint64_t						m_nWindowStartScopeCalls[ALLOCATION_MAX_SCOPES]; ///< The number of calls of each allocation-free scope when the current window started.
+	uint64_t						m_nWindowStartScopeAllocations[ALLOCATION_MAX_SCOPES]; ///< The number of allocations within each allocation-free scope when the current window started.
+
+	int								m_nLateBeats; ///< The number of beats handled late by the kitchen.
+	string							m_sReport; ///< The text report of the last complete window.
+};
+
+#endif
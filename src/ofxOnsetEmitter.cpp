@@ -0,0 +1,135 @@
+#include "ofxOnsetEmitter.h"
+
+ofxOnsetEmitter::ofxOnsetEmitter() :
+	m_nNumParticles(0)
+{
+	m_preset.nParticlesPerBurst = 20;
+	m_preset.fLifespan = 1.0f;
+	m_preset.fLifespanVariance = 0.0f;
+	m_preset.fSpeed = 60.0f;
+	m_preset.fSpeedVariance = 0.0f;
+	m_preset.fAngle = 0.0f;
+	m_preset.fAngleVariance = 360.0f;
+	m_preset.fRadialAcceleration = 0.0f;
+	m_preset.fRadialAccelVariance = 0.0f;
+	m_preset.fStartSize = 10.0f;
+	m_preset.fFinishSize = 10.0f;
+	m_preset.startColor = ofFloatColor(1.0f, 1.0f, 1.0f, 1.0f);
+	m_preset.finishColor = ofFloatColor(1.0f, 1.0f, 1.0f, 0.0f);
+}
+
+/** \param nCapacity The maximum number of live particles.
+*/
+void ofxOnsetEmitter::setup(int nCapacity)
+{
+	m_particles.assign(max(nCapacity, 1), onsetParticle());
+	m_vertices.assign(m_particles.size() * ONSET_EMITTER_VERTICES_PER_PARTICLE, ofVec2f(0.0f, 0.0f));
+	m_colors.assign(m_particles.size() * ONSET_EMITTER_VERTICES_PER_PARTICLE, ofFloatColor());
+	m_nNumParticles = 0;
+}
+
+/**
+* \param x The x coordinate in pixels of the origin of the burst.
+* \param y The y coordinate in pixels of the origin of the burst.
+* \param color The colour of the burst, by which the colours of the preset are multiplied.
+* \param fStrength The fraction ([0;1] range) of the particles of the preset that are emitted.
+*/
+void ofxOnsetEmitter::burst(float x, float y, const ofFloatColor& color, float fStrength)
+{
+	int nNumNew = (int)(m_preset.nParticlesPerBurst * ofClamp(fStrength, 0.0f, 1.0f) + 0.5f);
+
+	// A full pool cuts the burst short
+	nNumNew = min(nNumNew, (int)m_particles.size() - m_nNumParticles);
+	for (int i = 0; i < nNumNew; i++)
+	{
+		onsetParticle& particle = m_particles[m_nNumParticles++];
+		float fAngle = ofDegToRad(m_preset.fAngle + ofRandom(-0.5f, 0.5f) * m_preset.fAngleVariance);
+		float fSpeed = m_preset.fSpeed + ofRandom(-0.5f, 0.5f) * m_preset.fSpeedVariance;
+		particle.x = x;
+		particle.y = y;
+		particle.vx = cos(fAngle) * fSpeed;
+		particle.vy = sin(fAngle) * fSpeed;
+		particle.fRadialAcceleration = m_preset.fRadialAcceleration + ofRandom(-0.5f, 0.5f) * m_preset.fRadialAccelVariance;
+		particle.fOriginX = x;
+		particle.fOriginY = y;
+		particle.fAge = 0.0f;
+		particle.fLifespan = max(m_preset.fLifespan + ofRandom(-0.5f, 0.5f) * m_preset.fLifespanVariance, 0.01f);
+		particle.color = color;
+	}
+}
+
+/** \param fElapsedSeconds The time in seconds since the last update.
+*/
+void ofxOnsetEmitter::update(float fElapsedSeconds)
+{
+	int i = 0;
+	while (i < m_nNumParticles)
+	{
+		onsetParticle& particle = m_particles[i];
+		particle.fAge += fElapsedSeconds;
+		if (particle.fAge >= particle.fLifespan)
+		{
+			// The last live particle takes the place of the dead one, and is updated next
+			particle = m_particles[--m_nNumParticles];
+			continue;
+		}
+
+		// The radial acceleration pushes the particle away from the origin of its burst
+		float dx = particle.x - particle.fOriginX;
+		float dy = particle.y - particle.fOriginY;
+		float fDist = sqrt(dx * dx + dy * dy);
+		if (fDist > 0.0f)
+		{
+			particle.vx += dx / fDist * particle.fRadialAcceleration * fElapsedSeconds;
+			particle.vy += dy / fDist * particle.fRadialAcceleration * fElapsedSeconds;
+		}
+		particle.x += particle.vx * fElapsedSeconds;
+		particle.y += particle.vy * fElapsedSeconds;
+		i++;
+	}
+}
+
+void ofxOnsetEmitter::draw()
+{
+	if (m_nNumParticles == 0)
+	{
+		return;
+	}
+
+	// One quad per particle, its size and colour interpolated over its life
+	const ofFloatColor& startColor = m_preset.startColor;
+	const ofFloatColor& finishColor = m_preset.finishColor;
+	ofVec2f* vertex = &m_vertices[0];
+	ofFloatColor* vertexColor = &m_colors[0];
+	for (int i = 0; i < m_nNumParticles; i++)
+	{
+		const onsetParticle& particle = m_particles[i];
+		float t = particle.fAge / particle.fLifespan;
+		float fHalfSize = 0.5f * (m_preset.fStartSize + (m_preset.fFinishSize - m_preset.fStartSize) * t);
+		ofFloatColor color(
+			particle.color.r * (startColor.r + (finishColor.r - startColor.r) * t),
+			particle.color.g * (startColor.g + (finishColor.g - startColor.g) * t),
+			particle.color.b * (startColor.b + (finishColor.b - startColor.b) * t),
+			particle.color.a * (startColor.a + (finishColor.a - startColor.a) * t));
+		float fLeft = particle.x - fHalfSize;
+		float fTop = particle.y - fHalfSize;
+		float fRight = particle.x + fHalfSize;
+		float fBottom = particle.y + fHalfSize;
+		*vertex++ = ofVec2f(fLeft, fTop);
+		*vertex++ = ofVec2f(fRight, fTop);
+		*vertex++ = ofVec2f(fRight, fBottom);
+		*vertex++ = ofVec2f(fLeft, fTop);
+		*vertex++ = ofVec2f(fRight, fBottom);
+		*vertex++ = ofVec2f(fLeft, fBottom);
+		for (int v = 0; v < ONSET_EMITTER_VERTICES_PER_PARTICLE; v++)
+		{
+			*vertexColor++ = color;
+		}
+	}
+
+	int nNumVertices = m_nNumParticles * ONSET_EMITTER_VERTICES_PER_PARTICLE;
+	m_vbo.setVertexData(&m_vertices[0].x, 2, nNumVertices, GL_STREAM_DRAW, sizeof(ofVec2f));
+	m_vbo.setColorData(&m_colors[0], nNumVertices, GL_STREAM_DRAW);
+	ofSetColor(255);
+	m_vbo.draw(GL_TRIANGLES, 0, nNumVertices);
+}
@@ -0,0 +1,88 @@
+#ifndef _OFX_ONSET_EMITTER
+#define _OFX_ONSET_EMITTER
+
+/**
+ * \class ofxOnsetEmitter
+ *
+ * \brief This class emits bursts of particles on the onsets of the music, from a pool allocated once.
+ *
+ * The particles live in an array of fixed capacity, of which the first getNumParticles() are alive. A burst appends
+ * particles after the last live one, and a dead particle is replaced by the last live one, so that spawning and
+ * retiring a particle are constant time and the memory never grows. When the pool is full, bursts are cut short
+ * rather than evicting live particles, which bounds the cost of a frame however many pots are playing.
+ *
+ * The look of the particles is set once by a preset, and a burst only gives its origin, its colour and its strength.
+ * The particles are drawn as quads from a single vertex buffer.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define ONSET_EMITTER_CAPACITY 2048 ///< The default maximum number of live particles.
+#define ONSET_EMITTER_VERTICES_PER_PARTICLE 6 ///< The two triangles of the quad of a particle.
+
+/// The look and motion of the particles of an ofxOnsetEmitter.
+struct onsetEmitterPreset
+{
+	int								nParticlesPerBurst; ///< The number of particles of a burst at full strength.
+	float							fLifespan; ///< The lifespan in seconds of a particle.
+	float							fLifespanVariance; ///< The random variation in seconds of the lifespan.
+	float							fSpeed; ///< The initial speed in pixels per second.
+	float							fSpeedVariance; ///< The random variation in pixels per second of the initial speed.
+	float							fAngle; ///< The direction in degrees of the initial velocity.
+	float							fAngleVariance; ///< The random variation in degrees of the direction.
+	float							fRadialAcceleration; ///< The acceleration in pixels per second squared away from the origin of the burst.
+	float							fRadialAccelVariance; ///< The random variation of the radial acceleration.
+	float							fStartSize; ///< The size in pixels of a new particle.
+	float							fFinishSize; ///< The size in pixels of a particle at the end of its life.
+	ofFloatColor					startColor; ///< The colour of a new particle, multiplied by the colour of its burst.
+	ofFloatColor					finishColor; ///< The colour of a particle at the end of its life, multiplied by the colour of its burst.
+};
+
+/// A particle of an ofxOnsetEmitter.
+struct onsetParticle
+{
+	float							x; ///< The x coordinate in pixels.
+	float							y; ///< The y coordinate in pixels.
+	float							vx; ///< The x velocity in pixels per second.
+	float							vy; ///< The y velocity in pixels per second.
+	float							fRadialAcceleration; ///< The acceleration in pixels per second squared away from the origin.
+	float							fOriginX; ///< The x coordinate of the origin of the burst.
+	float							fOriginY; ///< The y coordinate of the origin of the burst.
+	float							fAge; ///< The time in seconds since the burst.
+	float							fLifespan; ///< The lifespan in seconds.
+	ofFloatColor					color; ///< The colour of the burst.
+};
+
+/// A class that emits particles on the onsets of the music.
+class ofxOnsetEmitter
+{
+public:
+	ofxOnsetEmitter(); ///< Constructor
+
+	void							setup(int nCapacity = ONSET_EMITTER_CAPACITY); ///< Allocates the pool of particles.
+	void							setPreset(const onsetEmitterPreset& preset) { m_preset = preset; } ///< Sets the look and motion of the particles. \param preset The preset.
+	const onsetEmitterPreset&		getPreset() const { return m_preset; } ///< Returns the look and motion of the particles. \return The preset.
+
+	void							burst(float x, float y, const ofFloatColor& color, float fStrength = 1.0f); ///< Emits a burst of particles.
+	void							update(float fElapsedSeconds); ///< Moves the particles and retires the dead ones.
+	void							draw(); ///< Draws the particles.
+	void							clear() { m_nNumParticles = 0; } ///< Retires all the particles.
+
+	int								getNumParticles() const { return m_nNumParticles; } ///< Returns the number of live particles. \return The number of particles.
+	int								getCapacity() const { return m_particles.size(); } ///< Returns the maximum number of live particles. \return The capacity of the pool.
+
+private:
+	onsetEmitterPreset				m_preset; ///< The look and motion of the particles.
+	vector<onsetParticle>			m_particles; ///< The pool of particles, of which the first m_nNumParticles are alive.
+	int								m_nNumParticles; ///< The number of live particles.
+	vector<ofVec2f>					m_vertices; ///< The corners of the quads of the particles.
+	vector<ofFloatColor>			m_colors; ///< The colours of the corners of the quads.
+	ofVbo							m_vbo; ///< The vertex buffer of the quads.
+};
+
+#endif
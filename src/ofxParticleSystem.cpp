@@ -0,0 +1,768 @@
+#include "ofxParticleSystem.h"
+
+void particleWorkerThread::threadedFunction()
+{
+	int nSlice;
+	while (isThreadRunning())
+	{
+		// Wake up regularly to notice when the thread is asked to stop
+		if (m_system->getSliceInput(m_nWorker).tryReceive(nSlice, PARTICLE_SYSTEM_WAIT_MS))
+		{
+			m_system->updateSlice(nSlice);
+			m_system->getSliceDone().send(nSlice);
+		}
+	}
+}
+
+// The loops over the particles are free functions whose arrays cannot overlap (__restrict), and whose conditions
+// are turned into 0/1 factors, so that the compiler vectorizes them. GCC also needs square roots that do not set
+// errno and comparisons that do not trap (flags that config.make gives to this file alone).
+
+/**
+* \param drag The drag factors.
+* \param velX The x velocities.
+* \param velY The y velocities.
+* \param n The number of particles.
+*/
+static void dragKernel(const float* __restrict drag, float* __restrict velX, float* __restrict velY, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		velX[i] *= drag[i];
+		velY[i] *= drag[i];
+	}
+}
+
+/**
+* \param posX The x coordinates.
+* \param posY The y coordinates.
+* \param nearestX The x coordinates of the nearest contacts so far.
+* \param nearestY The y coordinates of the nearest contacts so far.
+* \param nearestDistSq The square distances to the nearest contacts so far.
+* \param n The number of particles.
+* \param cx The x coordinate of the contact.
+* \param cy The y coordinate of the contact.
+*/
+static void nearestKernel(const float* __restrict posX, const float* __restrict posY, float* __restrict nearestX,
+	float* __restrict nearestY, float* __restrict nearestDistSq, int n, float cx, float cy)
+{
+	for (int i = 0; i < n; i++)
+	{
+		float dx = cx - posX[i];
+		float dy = cy - posY[i];
+		float fDistSq = dx * dx + dy * dy;
+		float fCloser = fDistSq < nearestDistSq[i] ? 1.0f : 0.0f;
+		nearestDistSq[i] = min(fDistSq, nearestDistSq[i]);
+		nearestX[i] += (cx - nearestX[i]) * fCloser;
+		nearestY[i] += (cy - nearestY[i]) * fCloser;
+	}
+}
+
+/**
+* \param posX The x coordinates.
+* \param posY The y coordinates.
+* \param nearestX The x coordinates of the nearest contacts.
+* \param nearestY The y coordinates of the nearest contacts.
+* \param nearestDistSq The square distances to the nearest contacts.
+* \param velX The x velocities.
+* \param velY The y velocities.
+* \param n The number of particles.
+* \param fStrength The acceleration towards the nearest contact.
+*/
+static void pullKernel(const float* __restrict posX, const float* __restrict posY, const float* __restrict nearestX,
+	const float* __restrict nearestY, const float* __restrict nearestDistSq, float* __restrict velX, float* __restrict velY,
+	int n, float fStrength)
+{
+	for (int i = 0; i < n; i++)
+	{
+		// The force is normalized, so that it does not depend on the distance
+		float fScale = fStrength / sqrt(nearestDistSq[i] + PARTICLE_SYSTEM_EPSILON);
+		velX[i] += (nearestX[i] - posX[i]) * fScale;
+		velY[i] += (nearestY[i] - posY[i]) * fScale;
+	}
+}
+
+/**
+* \param posX The x coordinates.
+* \param posY The y coordinates.
+* \param velX The x velocities.
+* \param velY The y velocities.
+* \param wander Whether (1) or not (0) each particle wanders, cleared for the particles near the contact.
+* \param n The number of particles.
+* \param cx The x coordinate of the contact.
+* \param cy The y coordinate of the contact.
+*/
+static void repelKernel(const float* __restrict posX, const float* __restrict posY, float* __restrict velX,
+	float* __restrict velY, float* __restrict wander, int n, float cx, float cy)
+{
+	for (int i = 0; i < n; i++)
+	{
+		// Only the particles close to the contact are repelled, the others wander
+		float dx = cx - posX[i];
+		float dy = cy - posY[i];
+		float fDistSq = dx * dx + dy * dy;
+		float fNear = fDistSq < PARTICLE_SYSTEM_REPEL_RANGE * PARTICLE_SYSTEM_REPEL_RANGE ? 1.0f : 0.0f;
+		float fScale = 0.6f * fNear / sqrt(fDistSq + PARTICLE_SYSTEM_EPSILON);
+		velX[i] -= dx * fScale;
+		velY[i] -= dy * fScale;
+		wander[i] *= 1.0f - fNear;
+	}
+}
+
+/**
+* \param posX The x coordinates.
+* \param posY The y coordinates.
+* \param nearestX The x coordinates of the nearest contacts.
+* \param nearestY The y coordinates of the nearest contacts.
+* \param nearestDistSq The square distances to the nearest contacts.
+* \param velX The x velocities.
+* \param velY The y velocities.
+* \param wander Whether (1) or not (0) each particle wanders.
+* \param n The number of particles.
+* \param fEnabled Whether (1) or not (0) the contacts pull the particles.
+*/
+static void ringKernel(const float* __restrict posX, const float* __restrict posY, const float* __restrict nearestX,
+	const float* __restrict nearestY, const float* __restrict nearestDistSq, float* __restrict velX, float* __restrict velY,
+	float* __restrict wander, int n, float fEnabled)
+{
+	for (int i = 0; i < n; i++)
+	{
+		// The force is proportional to the distance, within a ring around the contact
+		float fDistSq = nearestDistSq[i];
+		float fPulled = fEnabled * (fDistSq < PARTICLE_SYSTEM_PULL_RANGE * PARTICLE_SYSTEM_PULL_RANGE ? 1.0f : 0.0f) * (fDistSq > 40.0f * 40.0f ? 1.0f : 0.0f);
+		float fScale = 0.003f * fPulled;
+		velX[i] += (nearestX[i] - posX[i]) * fScale;
+		velY[i] += (nearestY[i] - posY[i]) * fScale;
+		wander[i] = 1.0f - fPulled;
+	}
+}
+
+/**
+* \param posX The x coordinates.
+* \param posY The y coordinates.
+* \param velX The x velocities.
+* \param velY The y velocities.
+* \param points The interleaved coordinates for the vertex buffer.
+* \param n The number of particles.
+* \param fWidth The width of the window.
+* \param fHeight The height of the window.
+*/
+static void integrateKernel(float* __restrict posX, float* __restrict posY, float* __restrict velX, float* __restrict velY,
+	float* __restrict points, int n, float fWidth, float fHeight)
+{
+	for (int i = 0; i < n; i++)
+	{
+		// Bounces off the edges
+		float x = posX[i] + velX[i];
+		float y = posY[i] + velY[i];
+		float fOutX = (x > fWidth ? 1.0f : 0.0f) + (x < 0.0f ? 1.0f : 0.0f);
+		float fOutY = (y > fHeight ? 1.0f : 0.0f) + (y < 0.0f ? 1.0f : 0.0f);
+		velX[i] *= 1.0f - 2.0f * fOutX;
+		velY[i] *= 1.0f - 2.0f * fOutY;
+		x = min(max(x, 0.0f), fWidth);
+		y = min(max(y, 0.0f), fHeight);
+		posX[i] = x;
+		posY[i] = y;
+		points[2 * i] = x;
+		points[2 * i + 1] = y;
+	}
+}
+
+/**
+* \param posX The x coordinates.
+* \param posY The y coordinates.
+* \param cell The cell of each particle.
+* \param n The number of particles.
+* \param nCols The number of columns of cells.
+* \param nRows The number of rows of cells.
+*/
+static void cellKernel(const float* __restrict posX, const float* __restrict posY, int* __restrict cell, int n, int nCols, int nRows)
+{
+	float fMaxCol = nCols - 1;
+	float fMaxRow = nRows - 1;
+	for (int i = 0; i < n; i++)
+	{
+		float c = min(max(posX[i] * (1.0f / PARTICLE_SYSTEM_CELL_SIZE), 0.0f), fMaxCol);
+		float r = min(max(posY[i] * (1.0f / PARTICLE_SYSTEM_CELL_SIZE), 0.0f), fMaxRow);
+		cell[i] = (int)r * nCols + (int)c;
+	}
+}
+
+/**
+* \param posX The x coordinates.
+* \param posY The y coordinates.
+* \param n The number of particles.
+* \param fLeft The left edge of the box.
+* \param fTop The top edge of the box.
+* \param fRight The right edge of the box.
+* \param fBottom The bottom edge of the box.
+* \return Whether (not 0) or not (0) a particle is outside the box.
+*/
+static int outsideKernel(const float* __restrict posX, const float* __restrict posY, int n, float fLeft, float fTop,
+	float fRight, float fBottom)
+{
+	int nOutside = 0;
+	for (int i = 0; i < n; i++)
+	{
+		nOutside |= (posX[i] < fLeft) | (posX[i] > fRight) | (posY[i] < fTop) | (posY[i] > fBottom);
+	}
+	return nOutside;
+}
+
+ofxParticleSystem::ofxParticleSystem() :
+	m_mode(PARTICLE_MODE_ATTRACT), m_clock(ofxKitchenClock::getRealtime()), m_nMinHashedContacts(PARTICLE_SYSTEM_MIN_HASHED_CONTACTS), m_nGridCols(0), m_nGridRows(0), m_bSorted(false), m_nNumSlices(0), m_nSliceSize(0), m_fUpdateAvgUs(0.0f)
+{
+	m_frame.bHashed = false;
+}
+
+ofxParticleSystem::~ofxParticleSystem()
+{
+	stop();
+}
+
+/**
+* \param nNumParticles The number of particles.
+* \param nNumThreads The number of threads updating the particles, the calling thread included, or 0 for one per core.
+* \param clock The clock that the noise forces move with, or NULL for the time of the application.
+*/
+void ofxParticleSystem::setup(int nNumParticles, int nNumThreads, const ofxKitchenClock* clock)
+{
+	stop();
+	m_clock = (clock != NULL) ? clock : ofxKitchenClock::getRealtime();
+	m_posX.assign(nNumParticles, 0.0f);
+	m_posY.assign(nNumParticles, 0.0f);
+	m_velX.assign(nNumParticles, 0.0f);
+	m_velY.assign(nNumParticles, 0.0f);
+	m_drag.assign(nNumParticles, 0.0f);
+	m_uniqueVal.assign(nNumParticles, 0.0f);
+	m_wander.assign(nNumParticles, 0.0f);
+	m_nearestX.assign(nNumParticles, 0.0f);
+	m_nearestY.assign(nNumParticles, 0.0f);
+	m_nearestDistSq.assign(nNumParticles, 0.0f);
+	m_particleCell.assign(nNumParticles, 0);
+	m_sortBuffer.assign(nNumParticles, 0.0f);
+	m_points.assign(nNumParticles, ofVec2f(0.0f, 0.0f));
+	m_flowField.setup(ofGetWidth(), ofGetHeight(), m_clock->getElapsedTimeMicros() / 1000000.0);
+
+	if (nNumThreads <= 0)
+	{
+		nNumThreads = std::thread::hardware_concurrency();
+	}
+	nNumThreads = ofClamp(nNumThreads, 1, PARTICLE_SYSTEM_MAX_THREADS);
+	nNumThreads = min(nNumThreads, max(nNumParticles / PARTICLE_SYSTEM_MIN_SLICE, 1));
+	m_nNumSlices = nNumThreads;
+	m_nSliceSize = (nNumParticles + m_nNumSlices - 1) / m_nNumSlices;
+	for (int w = 0; w < m_nNumSlices - 1; w++)
+	{
+		m_workers[w].setup(this, w);
+		m_workers[w].startThread();
+	}
+}
+
+void ofxParticleSystem::stop()
+{
+	for (int w = 0; w < m_nNumSlices - 1; w++)
+	{
+		m_workers[w].waitForThread(true);
+	}
+	m_nNumSlices = 0;
+	m_flowField.stop();
+}
+
+/** \param contacts The points the particles react to, in pixels.
+*/
+void ofxParticleSystem::setContacts(const vector<ofPoint>& contacts)
+{
+	m_contacts.clear();
+	for (size_t j = 0; j < contacts.size(); j++)
+	{
+		m_contacts.push_back(ofVec2f(contacts[j].x, contacts[j].y));
+	}
+}
+
+void ofxParticleSystem::reset()
+{
+	for (size_t i = 0; i < m_posX.size(); i++)
+	{
+		//the unique val allows us to set properties slightly differently for each particle
+		m_uniqueVal[i] = ofRandom(-10000, 10000);
+		m_posX[i] = ofRandomWidth();
+		m_posY[i] = ofRandomHeight();
+		m_velX[i] = ofRandom(-3.9, 3.9);
+		m_velY[i] = ofRandom(-3.9, 3.9);
+		if (m_mode == PARTICLE_MODE_NOISE)
+		{
+			m_drag[i] = ofRandom(0.97, 0.99);
+			m_velY[i] = fabs(m_velY[i]) * 3.0f; //make the particles all be going down
+		}
+		else
+		{
+			m_drag[i] = ofRandom(0.95, 0.998);
+		}
+		m_points[i] = ofVec2f(m_posX[i], m_posY[i]);
+	}
+	m_bSorted = false;
+}
+
+void ofxParticleSystem::update()
+{
+	// The particles of the example are hidden while the onset bursts are shown
+	if (m_posX.empty() || m_nNumSlices == 0 || m_mode == PARTICLE_MODE_ONSETS)
+	{
+		return;
+	}
+	uint64_t nStartUs = ofGetElapsedTimeMicros();
+
+	m_frame.mode = m_mode;
+	m_frame.fWidth = ofGetWidth();
+	m_frame.fHeight = ofGetHeight();
+	m_frame.fTime = m_clock->getElapsedTimeMicros() / 1000000.0;
+	m_frame.bForceEnabled = !ofGetKeyPressed('f');
+
+	// The few contacts of a mouse or a single hand are not worth sorting the particles for
+	m_frame.bHashed = (int)m_contacts.size() >= m_nMinHashedContacts && m_mode != PARTICLE_MODE_NOISE;
+	if (!m_frame.bHashed)
+	{
+		m_candidates.assign(m_contacts.begin(), m_contacts.end());
+		m_candidateStart.assign(2, 0);
+		m_candidateStart[1] = m_candidates.size();
+	}
+	else
+	{
+		int nGridCols = max((int)ceil(m_frame.fWidth / PARTICLE_SYSTEM_CELL_SIZE), 1);
+		int nGridRows = max((int)ceil(m_frame.fHeight / PARTICLE_SYSTEM_CELL_SIZE), 1);
+		if (nGridCols != m_nGridCols || nGridRows != m_nGridRows)
+		{
+			m_nGridCols = nGridCols;
+			m_nGridRows = nGridRows;
+			m_bSorted = false;
+		}
+		if (!m_bSorted || !isSorted())
+		{
+			sortParticles();
+		}
+		if (m_mode == PARTICLE_MODE_REPEL)
+		{
+			hashContacts(PARTICLE_SYSTEM_REPEL_RANGE, false);
+		}
+		else if (m_mode == PARTICLE_MODE_NEAREST_POINTS)
+		{
+			hashContacts(PARTICLE_SYSTEM_PULL_RANGE, true);
+		}
+		else
+		{
+			hashContacts(PARTICLE_SYSTEM_FAR_AWAY, true);
+		}
+	}
+	if (m_mode == PARTICLE_MODE_REPEL || m_mode == PARTICLE_MODE_NEAREST_POINTS || m_mode == PARTICLE_MODE_NOISE)
+	{
+		m_flowField.update(m_frame.fTime, m_frame.fWidth, m_frame.fHeight);
+	}
+
+	// The first slice is ours, the others go to the workers
+	for (int s = 1; s < m_nNumSlices; s++)
+	{
+		m_sliceInput[s - 1].send(s);
+	}
+	updateSlice(0);
+	int nSlice;
+	for (int s = 1; s < m_nNumSlices; s++)
+	{
+		m_sliceDone.receive(nSlice);
+	}
+
+	m_fUpdateAvgUs = 0.95f * m_fUpdateAvgUs + 0.05f * (ofGetElapsedTimeMicros() - nStartUs);
+}
+
+/** \param nSlice The index of the slice.
+*/
+void ofxParticleSystem::updateSlice(int nSlice)
+{
+	int nBegin = nSlice * m_nSliceSize;
+	int nEnd = min(nBegin + m_nSliceSize, (int)m_posX.size());
+	if (nBegin >= nEnd)
+	{
+		return;
+	}
+
+	//1 - APPLY THE FORCES BASED ON WHICH MODE WE ARE IN
+	switch (m_frame.mode)
+	{
+	case PARTICLE_MODE_ATTRACT:
+	case PARTICLE_MODE_EMITTER:
+		applyContacts(nBegin, nEnd);
+		break;
+	case PARTICLE_MODE_REPEL:
+		applyContacts(nBegin, nEnd);
+		applyWander(nBegin, nEnd, 0.04f);
+		break;
+	case PARTICLE_MODE_NEAREST_POINTS:
+		applyContacts(nBegin, nEnd);
+		applyWander(nBegin, nEnd, 0.4f);
+		break;
+	case PARTICLE_MODE_NOISE:
+		applySnow(nBegin, nEnd);
+		break;
+	default:
+		break;
+	}
+
+	//2 - UPDATE OUR POSITION, ON SCREEN
+	integrate(nBegin, nEnd);
+}
+
+/**
+* \param fRange The distance beyond which the contacts have no effect.
+* \param bNearestOnly Whether or not only the nearest contact of each particle acts on it.
+*/
+void ofxParticleSystem::hashContacts(float fRange, bool bNearestOnly)
+{
+	int nNumCells = m_nGridCols * m_nGridRows;
+
+	// 1 - count the contacts of each cell, then place them (a counting sort)
+	m_contactStart.assign(nNumCells + 1, 0);
+	for (size_t j = 0; j < m_contacts.size(); j++)
+	{
+		int c = min(max((int)(m_contacts[j].x / PARTICLE_SYSTEM_CELL_SIZE), 0), m_nGridCols - 1);
+		int r = min(max((int)(m_contacts[j].y / PARTICLE_SYSTEM_CELL_SIZE), 0), m_nGridRows - 1);
+		m_contactStart[r * m_nGridCols + c + 1]++;
+	}
+	for (int k = 0; k < nNumCells; k++)
+	{
+		m_contactStart[k + 1] += m_contactStart[k];
+	}
+	m_hashedContacts.resize(m_contacts.size());
+	m_candidateStart.assign(m_contactStart.begin(), m_contactStart.end());
+	for (size_t j = 0; j < m_contacts.size(); j++)
+	{
+		int c = min(max((int)(m_contacts[j].x / PARTICLE_SYSTEM_CELL_SIZE), 0), m_nGridCols - 1);
+		int r = min(max((int)(m_contacts[j].y / PARTICLE_SYSTEM_CELL_SIZE), 0), m_nGridRows - 1);
+		m_hashedContacts[m_candidateStart[r * m_nGridCols + c]++] = m_contacts[j];
+	}
+
+	// 2 - list the contacts that can act on the particles of each cell, which may be up to the margin outside of it
+	m_candidates.clear();
+	for (int r = 0; r < m_nGridRows; r++)
+	{
+		for (int c = 0; c < m_nGridCols; c++)
+		{
+			int nFirst = m_candidates.size();
+			m_candidateStart[r * m_nGridCols + c] = nFirst;
+			float fLeft = c * PARTICLE_SYSTEM_CELL_SIZE - PARTICLE_SYSTEM_SORT_MARGIN;
+			float fTop = r * PARTICLE_SYSTEM_CELL_SIZE - PARTICLE_SYSTEM_SORT_MARGIN;
+			float fRight = (c + 1) * PARTICLE_SYSTEM_CELL_SIZE + PARTICLE_SYSTEM_SORT_MARGIN;
+			float fBottom = (r + 1) * PARTICLE_SYSTEM_CELL_SIZE + PARTICLE_SYSTEM_SORT_MARGIN;
+
+			// Rings of cells around the cell are visited until they are out of range. The nearest contact of a particle
+			// is never farther than the farthest corner of the box from any contact, which narrows the range.
+			float fLimit = fRange;
+			for (int k = 0; k <= max(m_nGridCols, m_nGridRows) && (k - 1) * PARTICLE_SYSTEM_CELL_SIZE - PARTICLE_SYSTEM_SORT_MARGIN <= fLimit; k++)
+			{
+				for (int nr = max(r - k, 0); nr <= min(r + k, m_nGridRows - 1); nr++)
+				{
+					// The first and last rows of the ring are full, the others only have their ends
+					int nStep = (nr == r - k || nr == r + k) ? 1 : 2 * k;
+					for (int nc = c - k; nc <= c + k; nc += nStep)
+					{
+						if (nc < 0 || nc >= m_nGridCols)
+						{
+							continue;
+						}
+						for (int j = m_contactStart[nr * m_nGridCols + nc]; j < m_contactStart[nr * m_nGridCols + nc + 1]; j++)
+						{
+							const ofVec2f& contact = m_hashedContacts[j];
+							float dx = max(max(fLeft - contact.x, contact.x - fRight), 0.0f);
+							float dy = max(max(fTop - contact.y, contact.y - fBottom), 0.0f);
+							if (dx * dx + dy * dy > fLimit * fLimit)
+							{
+								continue;
+							}
+							if (bNearestOnly)
+							{
+								float fFarX = max(contact.x - fLeft, fRight - contact.x);
+								float fFarY = max(contact.y - fTop, fBottom - contact.y);
+								fLimit = min(fLimit, sqrt(fFarX * fFarX + fFarY * fFarY));
+							}
+							m_candidates.push_back(contact);
+						}
+					}
+				}
+			}
+
+			// The limit only shrinks, so the contacts listed before it did may be too far now
+			if (bNearestOnly)
+			{
+				int nEnd = nFirst;
+				for (int j = nFirst; j < (int)m_candidates.size(); j++)
+				{
+					float dx = max(max(fLeft - m_candidates[j].x, m_candidates[j].x - fRight), 0.0f);
+					float dy = max(max(fTop - m_candidates[j].y, m_candidates[j].y - fBottom), 0.0f);
+					if (dx * dx + dy * dy <= fLimit * fLimit)
+					{
+						m_candidates[nEnd++] = m_candidates[j];
+					}
+				}
+				m_candidates.resize(nEnd);
+			}
+		}
+	}
+	m_candidateStart[nNumCells] = m_candidates.size();
+}
+
+bool ofxParticleSystem::isSorted()
+{
+	int nNumCells = m_nGridCols * m_nGridRows;
+	for (int k = 0; k < nNumCells; k++)
+	{
+		int nCount = m_cellStart[k + 1] - m_cellStart[k];
+		if (nCount == 0)
+		{
+			continue;
+		}
+		float fLeft = (k % m_nGridCols) * PARTICLE_SYSTEM_CELL_SIZE - PARTICLE_SYSTEM_SORT_MARGIN;
+		float fTop = (k / m_nGridCols) * PARTICLE_SYSTEM_CELL_SIZE - PARTICLE_SYSTEM_SORT_MARGIN;
+		if (outsideKernel(&m_posX[m_cellStart[k]], &m_posY[m_cellStart[k]], nCount, fLeft, fTop,
+			fLeft + PARTICLE_SYSTEM_CELL_SIZE + 2.0f * PARTICLE_SYSTEM_SORT_MARGIN, fTop + PARTICLE_SYSTEM_CELL_SIZE + 2.0f * PARTICLE_SYSTEM_SORT_MARGIN))
+		{
+			return false;
+		}
+	}
+	return true;
+}
+
+void ofxParticleSystem::sortParticles()
+{
+	int nNumParticles = m_posX.size();
+	int nNumCells = m_nGridCols * m_nGridRows;
+
+	// 1 - count the particles of each cell
+	cellKernel(&m_posX[0], &m_posY[0], &m_particleCell[0], nNumParticles, m_nGridCols, m_nGridRows);
+	m_cellStart.assign(nNumCells + 1, 0);
+	for (int i = 0; i < nNumParticles; i++)
+	{
+		m_cellStart[m_particleCell[i] + 1]++;
+	}
+	for (int k = 0; k < nNumCells; k++)
+	{
+		m_cellStart[k + 1] += m_cellStart[k];
+	}
+
+	// 2 - turn the cell of each particle into its index once sorted, the order within a cell being kept
+	for (int i = 0; i < nNumParticles; i++)
+	{
+		m_particleCell[i] = m_cellStart[m_particleCell[i]]++;
+	}
+	for (int k = nNumCells; k > 0; k--)
+	{
+		m_cellStart[k] = m_cellStart[k - 1];
+	}
+	m_cellStart[0] = 0;
+
+	// 3 - move every property that outlives the frame
+	vector<float>* properties[] = { &m_posX, &m_posY, &m_velX, &m_velY, &m_drag, &m_uniqueVal };
+	for (size_t p = 0; p < sizeof(properties) / sizeof(properties[0]); p++)
+	{
+		const float* src = &(*properties[p])[0];
+		for (int i = 0; i < nNumParticles; i++)
+		{
+			m_sortBuffer[m_particleCell[i]] = src[i];
+		}
+		properties[p]->swap(m_sortBuffer);
+	}
+	m_bSorted = true;
+}
+
+/**
+* \param nBegin The index of the first particle.
+* \param nEnd The index after the last particle.
+*/
+void ofxParticleSystem::applyContacts(int nBegin, int nEnd)
+{
+	// The slice starts in the last cell beginning before it, and the cells are contiguous ranges of particles. Without
+	// the spatial hash, the slice is a single cell.
+	int nNumCells = m_frame.bHashed ? m_nGridCols * m_nGridRows : 1;
+	int nCell = m_frame.bHashed ? upper_bound(m_cellStart.begin(), m_cellStart.end(), nBegin) - m_cellStart.begin() - 1 : 0;
+	for (; nCell < nNumCells && (!m_frame.bHashed || m_cellStart[nCell] < nEnd); nCell++)
+	{
+		int nCellBegin = m_frame.bHashed ? max(nBegin, m_cellStart[nCell]) : nBegin;
+		int nCellEnd = m_frame.bHashed ? min(nEnd, m_cellStart[nCell + 1]) : nEnd;
+		if (nCellBegin >= nCellEnd)
+		{
+			continue;
+		}
+		switch (m_frame.mode)
+		{
+		case PARTICLE_MODE_ATTRACT:
+			applyPull(nCellBegin, nCellEnd, nCell, 0.6f);
+			break;
+		case PARTICLE_MODE_EMITTER:
+			applyPull(nCellBegin, nCellEnd, nCell, 2.0f);
+			break;
+		case PARTICLE_MODE_REPEL:
+			applyRepel(nCellBegin, nCellEnd, nCell);
+			break;
+		default:
+			applyNearestPoints(nCellBegin, nCellEnd, nCell);
+			break;
+		}
+	}
+}
+
+/**
+* \param nBegin The index of the first particle.
+* \param nEnd The index after the last particle.
+* \param nCell The cell of the particles.
+*/
+void ofxParticleSystem::findNearest(int nBegin, int nEnd, int nCell)
+{
+	fill(m_nearestX.begin() + nBegin, m_nearestX.begin() + nEnd, 0.0f);
+	fill(m_nearestY.begin() + nBegin, m_nearestY.begin() + nEnd, 0.0f);
+	fill(m_nearestDistSq.begin() + nBegin, m_nearestDistSq.begin() + nEnd, PARTICLE_SYSTEM_FAR_AWAY);
+	for (int j = m_candidateStart[nCell]; j < m_candidateStart[nCell + 1]; j++)
+	{
+		nearestKernel(&m_posX[nBegin], &m_posY[nBegin], &m_nearestX[nBegin], &m_nearestY[nBegin], &m_nearestDistSq[nBegin],
+			nEnd - nBegin, m_candidates[j].x, m_candidates[j].y);
+	}
+}
+
+/**
+* \param nBegin The index of the first particle.
+* \param nEnd The index after the last particle.
+* \param nCell The cell of the particles.
+* \param fStrength The acceleration towards the nearest contact.
+*/
+void ofxParticleSystem::applyPull(int nBegin, int nEnd, int nCell, float fStrength)
+{
+	dragKernel(&m_drag[nBegin], &m_velX[nBegin], &m_velY[nBegin], nEnd - nBegin);
+	if (m_candidateStart[nCell] == m_candidateStart[nCell + 1])
+	{
+		return;
+	}
+	findNearest(nBegin, nEnd, nCell);
+	pullKernel(&m_posX[nBegin], &m_posY[nBegin], &m_nearestX[nBegin], &m_nearestY[nBegin], &m_nearestDistSq[nBegin],
+		&m_velX[nBegin], &m_velY[nBegin], nEnd - nBegin, fStrength);
+}
+
+/**
+* \param nBegin The index of the first particle.
+* \param nEnd The index after the last particle.
+* \param nCell The cell of the particles.
+*/
+void ofxParticleSystem::applyRepel(int nBegin, int nEnd, int nCell)
+{
+	dragKernel(&m_drag[nBegin], &m_velX[nBegin], &m_velY[nBegin], nEnd - nBegin);
+	fill(m_wander.begin() + nBegin, m_wander.begin() + nEnd, 1.0f);
+	for (int j = m_candidateStart[nCell]; j < m_candidateStart[nCell + 1]; j++)
+	{
+		repelKernel(&m_posX[nBegin], &m_posY[nBegin], &m_velX[nBegin], &m_velY[nBegin], &m_wander[nBegin], nEnd - nBegin,
+			m_candidates[j].x, m_candidates[j].y);
+	}
+}
+
+/**
+* \param nBegin The index of the first particle.
+* \param nEnd The index after the last particle.
+* \param nCell The cell of the particles.
+*/
+void ofxParticleSystem::applyNearestPoints(int nBegin, int nEnd, int nCell)
+{
+	dragKernel(&m_drag[nBegin], &m_velX[nBegin], &m_velY[nBegin], nEnd - nBegin);
+	findNearest(nBegin, nEnd, nCell);
+	ringKernel(&m_posX[nBegin], &m_posY[nBegin], &m_nearestX[nBegin], &m_nearestY[nBegin], &m_nearestDistSq[nBegin],
+		&m_velX[nBegin], &m_velY[nBegin], &m_wander[nBegin], nEnd - nBegin, m_frame.bForceEnabled ? 1.0f : 0.0f);
+}
+
+/**
+* \param nBegin The index of the first particle.
+* \param nEnd The index after the last particle.
+*/
+void ofxParticleSystem::applySnow(int nBegin, int nEnd)
+{
+	float fHeight = m_frame.fHeight;
+	float flow[FLOW_CHANNEL_COUNT];
+	float ownFlow[FLOW_CHANNEL_COUNT];
+	for (int i = nBegin; i < nEnd; i++)
+	{
+		//the fake wind adds a shift to the particles based on where they are, the flow read at a position
+		//shifted by uniqueVal gives each particle its own sway
+		float x = m_posX[i];
+		float y = m_posY[i];
+		m_flowField.sample(x, y, flow);
+		m_flowField.sample(x + m_uniqueVal[i], y, ownFlow);
+		float frcX = flow[FLOW_WIND] * 0.25f + ownFlow[FLOW_WANDER_X] * 0.6f;
+		float frcY = ownFlow[FLOW_WANDER_Y] * 0.09f + 0.18f;
+		m_velX[i] = m_velX[i] * m_drag[i] + frcX * 0.4f;
+		m_velY[i] = m_velY[i] * m_drag[i] + frcY * 0.4f;
+
+		//we do this so as to skip the bounds check for the bottom and make the particles go back to the top of the screen
+		if (y + m_velY[i] > fHeight)
+		{
+			m_posY[i] -= fHeight;
+		}
+	}
+}
+
+/**
+* \param nBegin The index of the first particle.
+* \param nEnd The index after the last particle.
+* \param fStrength The scale of the noise added to the velocity.
+*/
+void ofxParticleSystem::applyWander(int nBegin, int nEnd, float fStrength)
+{
+	float ownFlow[FLOW_CHANNEL_COUNT];
+	for (int i = nBegin; i < nEnd; i++)
+	{
+		if (m_wander[i] != 0.0f)
+		{
+			//a little bit of random movement from the flow, where uniqueVal comes in handy
+			m_flowField.sample(m_posX[i] + m_uniqueVal[i], m_posY[i], ownFlow);
+			m_velX[i] += ownFlow[FLOW_WANDER_X] * fStrength;
+			m_velY[i] += ownFlow[FLOW_WANDER_Y] * fStrength;
+		}
+	}
+}
+
+/**
+* \param nBegin The index of the first particle.
+* \param nEnd The index after the last particle.
+*/
+void ofxParticleSystem::integrate(int nBegin, int nEnd)
+{
+	integrateKernel(&m_posX[nBegin], &m_posY[nBegin], &m_velX[nBegin], &m_velY[nBegin], &m_points[nBegin].x, nEnd - nBegin,
+		m_frame.fWidth, m_frame.fHeight);
+}
+
+void ofxParticleSystem::draw()
+{
+	int nNumParticles = m_points.size();
+	if (nNumParticles == 0 || m_mode == PARTICLE_MODE_ONSETS)
+	{
+		return;
+	}
+
+	if (m_mode == PARTICLE_MODE_ATTRACT)
+	{
+		ofSetColor(255, 63, 180);
+	}
+	else if (m_mode == PARTICLE_MODE_REPEL)
+	{
+		ofSetColor(208, 255, 63);
+	}
+	else if (m_mode == PARTICLE_MODE_NOISE)
+	{
+		// snow-like
+		ofSetHexColor(0xFFFFFF);
+	}
+	else if (m_mode == PARTICLE_MODE_NEAREST_POINTS)
+	{
+		ofSetColor(103, 160, 237);
+	}
+
+	// One round point per particle, in a single call
+	m_vbo.setVertexData(&m_points[0].x, 2, nNumParticles, GL_STREAM_DRAW, sizeof(ofVec2f));
+	glPointSize(PARTICLE_SYSTEM_POINT_SIZE);
+	glEnable(GL_POINT_SMOOTH);
+	m_vbo.draw(GL_POINTS, 0, nNumParticles);
+	glDisable(GL_POINT_SMOOTH);
+	glPointSize(1.0f);
+}
@@ -0,0 +1,175 @@
+#ifndef _OFX_PARTICLE_SYSTEM
+#define _OFX_PARTICLE_SYSTEM
+
+/**
+ * \class ofxParticleSystem
+ *
+ * \brief This class moves tens of thousands of particles with the forces of the OpenFrameworks particle example,
+ * as visual feedback on the table.
+ *
+ * The particles are stored as a structure of arrays (one array per coordinate and property), so that the force
+ * and integration loops read contiguous floats and can be vectorized by the compiler. The mouse, window size, time
+ * and attraction points are read once per frame into a particleFrame instead of once per particle.
+ *
+ * The particles are split into slices, one per core. Each slice but the first is updated by a worker thread, the
+ * first by the calling thread, and update() returns once all slices are done.
+ *
+ * The particles react to contacts: the live touches and the playing nodes, set every frame. The particles are
+ * reordered by cell of a grid with a counting sort, so that the particles of a cell are contiguous, and sorted
+ * again only once one of them has left its cell by more than a margin. Before the slices are sent, the contacts
+ * are binned into the same grid, and each cell lists the contacts that can act on its particles: those within
+ * range of the forces and, for the forces of the nearest contact, only those that can be the nearest. Each cell
+ * then runs the force loops over its particles against its own list, so that the cost grows with the number of
+ * particles plus the number of contacts, rather than with their product. With only a few contacts, every particle
+ * checks every contact instead. The noise that makes particles wander or fall like snow is read from an
+ * ofxFlowField, whose cost does not depend on the number of particles, in a separate scalar loop over only the
+ * particles that need it. The noise moves with the clock the system is set up with, the time of the application
+ * by default.
+ *
+ * The particles are drawn as points from a single vertex buffer, filled by the slices.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxFlowField.h"
+#include "ofxKitchenClock.h"
+
+#define PARTICLE_SYSTEM_MAX_THREADS 8 ///< The maximum number of threads updating the particles, the calling thread included.
+#define PARTICLE_SYSTEM_MIN_SLICE 4096 ///< The minimum number of particles per slice, below which waking a thread costs more than it saves.
+#define PARTICLE_SYSTEM_CELL_SIZE 64.0f ///< The size in pixels of the cells of the spatial hash.
+#define PARTICLE_SYSTEM_MIN_HASHED_CONTACTS 8 ///< The number of contacts below which every particle checks every contact, which is cheaper than sorting the particles.
+#define PARTICLE_SYSTEM_SORT_MARGIN 32.0f ///< How far in pixels a particle may leave its cell before the particles are sorted again.
+#define PARTICLE_SYSTEM_REPEL_RANGE 150.0f ///< The distance in pixels within which a contact repels the particles.
+#define PARTICLE_SYSTEM_PULL_RANGE 300.0f ///< The distance in pixels within which the nearest contact pulls the particles, in PARTICLE_MODE_NEAREST_POINTS.
+#define PARTICLE_SYSTEM_FAR_AWAY 1e15f ///< A distance, or square distance, farther than any contact.
+#define PARTICLE_SYSTEM_EPSILON 1e-6f ///< The square distance added before normalizing, so that a particle on the mouse is not divided by zero.
+#define PARTICLE_SYSTEM_WAIT_MS 50 ///< How long a worker waits for a slice before checking whether it should stop.
+#define PARTICLE_SYSTEM_POINT_SIZE 6.0f ///< The size in pixels of the drawn particles.
+
+enum particleMode{
+	PARTICLE_MODE_ATTRACT = 0,			// attracted to mouse
+	PARTICLE_MODE_REPEL,				// repel from mouse
+	PARTICLE_MODE_NEAREST_POINTS,		// attracted to a few spots
+	PARTICLE_MODE_NOISE,				// like snow
+	PARTICLE_MODE_EMITTER,				// emit particles that have a lifetime
+	PARTICLE_MODE_ONSETS			// bursts on the onsets of the music (ofxOnsetEmitter)
+};
+
+/// The inputs of the forces, read once per frame.
+struct particleFrame
+{
+	particleMode					mode; ///< The mode of the particles.
+	float							fWidth; ///< The width of the window.
+	float							fHeight; ///< The height of the window.
+	float							fTime; ///< The elapsed time in seconds.
+	bool							bForceEnabled; ///< Whether or not the contacts pull the particles in PARTICLE_MODE_NEAREST_POINTS.
+	bool							bHashed; ///< Whether the contacts are listed per cell of the spatial hash, or all in a single list.
+};
+
+class ofxParticleSystem;
+
+/// A thread updating slices of the particles.
+class particleWorkerThread : public ofThread
+{
+public:
+	particleWorkerThread() : m_system(NULL), m_nWorker(0) {} ///< Constructor
+
+	void							setup(ofxParticleSystem* system, int nWorker) { m_system = system; m_nWorker = nWorker; } ///< Sets the system updated by the thread. \param system The particle system. \param nWorker The index of the worker.
+
+protected:
+	void							threadedFunction(); ///< Updates the slices it receives.
+
+	ofxParticleSystem*				m_system; ///< The particle system.
+	int								m_nWorker; ///< The index of the worker.
+};
+
+/// A class that updates and draws many particles.
+class ofxParticleSystem
+{
+public:
+	ofxParticleSystem(); ///< Constructor
+	~ofxParticleSystem(); ///< Destructor
+
+	void							setup(int nNumParticles, int nNumThreads = 0, const ofxKitchenClock* clock = NULL); ///< Allocates the particles and starts the worker threads.
+	void							stop(); ///< Stops the worker threads.
+	int								getNumParticles() const { return m_posX.size(); } ///< Returns the number of particles. \return The number of particles.
+
+	void							setMode(particleMode mode) { m_mode = mode; } ///< Sets the forces applied to the particles. \param mode The mode.
+	particleMode					getMode() const { return m_mode; } ///< Returns the forces applied to the particles. \return The mode.
+	void							setContacts(const vector<ofPoint>& contacts); ///< Sets the points the particles react to.
+	void							setMinHashedContacts(int nNumContacts) { m_nMinHashedContacts = nNumContacts; } ///< Sets the number of contacts from which the spatial hash is used, PARTICLE_SYSTEM_MIN_HASHED_CONTACTS by default. \param nNumContacts The number of contacts.
+
+	void							reset(); ///< Scatters the particles over the window with random velocities.
+	void							update(); ///< Moves the particles by a frame.
+	void							draw(); ///< Draws the particles.
+	float							getUpdateUs() const { return m_fUpdateAvgUs; } ///< Returns the average time spent in update(). \return The time in microseconds.
+	const vector<float>&			getVelocitiesX() const { return m_velX; } ///< Returns the x velocities of the particles, in the order of the spatial hash. \return The x velocities.
+	const vector<float>&			getVelocitiesY() const { return m_velY; } ///< Returns the y velocities of the particles, in the order of the spatial hash. \return The y velocities.
+	const vector<float>&			getSeeds() const { return m_uniqueVal; } ///< Returns the seeds of the noise of the particles, in the order of the spatial hash. \return The seeds.
+	const vector<float>&			getDrags() const { return m_drag; } ///< Returns the drag factors of the particles, in the order of the spatial hash. \return The drag factors.
+
+	void							updateSlice(int nSlice); ///< Moves a slice of the particles by a frame, and fills its points.
+	ofThreadChannel<int>&			getSliceInput(int nWorker) { return m_sliceInput[nWorker]; } ///< Returns the channel of the slices waiting for a worker.
+	ofThreadChannel<int>&			getSliceDone() { return m_sliceDone; } ///< Returns the channel of the slices done by the workers.
+
+private:
+	void							hashContacts(float fRange, bool bNearestOnly); ///< Bins the contacts into the cells of the spatial hash, and lists the contacts that can act on each cell.
+	bool							isSorted(); ///< Checks that every particle is still within the margin of its cell.
+	void							sortParticles(); ///< Reorders the particles by cell of the spatial hash.
+	void							applyContacts(int nBegin, int nEnd); ///< Applies the forces of the contacts, cell by cell.
+	void							applyPull(int nBegin, int nEnd, int nCell, float fStrength); ///< Pulls the particles of a cell towards their nearest contact, at a constant strength.
+	void							applyRepel(int nBegin, int nEnd, int nCell); ///< Pushes the particles of a cell away from the contacts near them, and lets the others wander.
+	void							applyNearestPoints(int nBegin, int nEnd, int nCell); ///< Pulls the particles of a cell towards their nearest contact, and lets the others wander.
+	void							findNearest(int nBegin, int nEnd, int nCell); ///< Finds the nearest contact of the particles of a cell.
+	void							applySnow(int nBegin, int nEnd); ///< Lets the particles fall like snow.
+	void							applyWander(int nBegin, int nEnd, float fStrength); ///< Adds the flow to the velocity of the particles marked in m_wander.
+	void							integrate(int nBegin, int nEnd); ///< Moves the particles by their velocity and bounces them off the edges.
+
+	// Particles
+	vector<float>					m_posX; ///< The x coordinates.
+	vector<float>					m_posY; ///< The y coordinates.
+	vector<float>					m_velX; ///< The x velocities.
+	vector<float>					m_velY; ///< The y velocities.
+	vector<float>					m_drag; ///< The drag factors.
+	vector<float>					m_uniqueVal; ///< The seeds of the noise of each particle.
+	vector<float>					m_wander; ///< Whether (1) or not (0) each particle wanders with noise this frame.
+	vector<float>					m_nearestX; ///< The x coordinate of the nearest contact of each particle.
+	vector<float>					m_nearestY; ///< The y coordinate of the nearest contact of each particle.
+	vector<float>					m_nearestDistSq; ///< The square distance to the nearest contact of each particle.
+	vector<ofVec2f>					m_points; ///< The positions, interleaved for the vertex buffer.
+	particleMode					m_mode; ///< The mode of the particles.
+	particleFrame					m_frame; ///< The inputs of the current frame.
+	ofxFlowField					m_flowField; ///< The noise forces.
+	const ofxKitchenClock*			m_clock; ///< The clock that the noise forces move with.
+
+	// Spatial hash
+	vector<ofVec2f>					m_contacts; ///< The contacts of the next frame.
+	int								m_nMinHashedContacts; ///< The number of contacts from which the spatial hash is used.
+	int								m_nGridCols; ///< The number of columns of cells.
+	int								m_nGridRows; ///< The number of rows of cells.
+	vector<int>						m_contactStart; ///< The index in m_hashedContacts of the first contact of each cell, and the number of contacts.
+	vector<ofVec2f>					m_hashedContacts; ///< The contacts, sorted by cell.
+	vector<int>						m_candidateStart; ///< The index in m_candidates of the first contact near each cell, and the number of candidates.
+	vector<ofVec2f>					m_candidates; ///< The contacts of each cell and of its neighbours, cell by cell.
+	vector<int>						m_cellStart; ///< The index of the first particle of each cell, and the number of particles.
+	vector<int>						m_particleCell; ///< The cell of each particle, then its index once sorted.
+	vector<float>					m_sortBuffer; ///< The destination of the arrays being reordered.
+	bool							m_bSorted; ///< Whether or not the particles have been sorted since they were scattered.
+
+	// Threads
+	int								m_nNumSlices; ///< The number of slices, the one of the calling thread included.
+	int								m_nSliceSize; ///< The number of particles per slice (the last one may have fewer).
+	particleWorkerThread			m_workers[PARTICLE_SYSTEM_MAX_THREADS - 1]; ///< The worker threads.
+	ofThreadChannel<int>			m_sliceInput[PARTICLE_SYSTEM_MAX_THREADS - 1]; ///< The slices waiting for each worker.
+	ofThreadChannel<int>			m_sliceDone; ///< The slices done by the workers.
+
+	// Drawing and statistics
+	ofVbo							m_vbo; ///< The vertex buffer of the points.
+	float							m_fUpdateAvgUs; ///< The average time in microseconds spent in update().
+};
+
+#endif
@@ -1,33 +1,33 @@
 #include "ofxPot.h"
 #include "UI/ofxTactoSHPM.h"
-#include "ofApp.h"
 
 #include "TactosonixHelpers.h"
+#include "ofxProfiler.h"
+#include "ofxAllocationCounter.h"
 using namespace TactoHelpers;
 
 /** \param _color The colour in hexadecimal values of the pot.
 * \param _radius The radius in pixels of the pot.
 * \param _origin The point of origin of the pot.
 * \param _bpm The tempo in beats per minute of the pot's loops.
+* \param _clock The clock of the kitchen, or NULL for the time of the application.
 */
-ofxPot::ofxPot(int _color, int _radius, ofPoint _origin, int _bpm) :
-m_nColor(_color), m_ptOrigin(_origin), m_nRadius(_radius), m_ptOriginalPosition(_origin), m_nBPM(_bpm), m_bShowingLoopFeedback(false)
+ofxPot::ofxPot(int _color, int _radius, ofPoint _origin, int _bpm, const ofxKitchenClock* _clock) :
+m_nColor(_color), m_ptOrigin(_origin), m_ptOriginalPosition(_origin), m_nRadius(_radius), m_clock((_clock != NULL) ? _clock : ofxKitchenClock::getRealtime()), m_nBPM(_bpm), m_touchPredictor(NULL), m_bShowingLoopFeedback(false), m_bGeometryDirty(true)
 {
 	m_fVolume = 1.0f;
 	m_nPeriodSingleBeatMs = (int)(1000 * 60 / m_nBPM);
 	m_nCurrentBeat = 0;
-	m_nTimeOfCreationMs = ofGetElapsedTimeMillis();
+	m_nTimeOfCreationMs = m_clock->getElapsedTimeMillis();
 	
 #ifdef _DEBUG
-	m_infoText.init("fonts/arial.ttf", 40);
-	m_infoText.setText("");
-	m_infoText.wrapTextX(ofGetWidth() * 3/4);
+	m_infoText.setFont("fonts/arial.ttf", 40);
 #endif
 }
 
 void ofxPot::exit()
 {
-	vector<ofxCookableNode>::iterator It;
+	deque<ofxCookableNode>::iterator It;
 	// LOOPS 1
 	for (It = m_activeCookNodesLoop1.begin(); It != m_activeCookNodesLoop1.end(); ++It)
 	{
@@ -49,19 +49,21 @@ void ofxPot::exit()
 */
 void ofxPot::update(int nCurrentBeat)
 {
+	ALLOCATION_FREE_SCOPE("ofxPot::update");
 	// Figure out the current beat
 	bool bNewBeat = false;
 	if (m_nCurrentBeat != OFX_POT_NUMSEQUENCERSTEPS && nCurrentBeat != m_nCurrentBeat)
 	{
 		m_nCurrentBeat = nCurrentBeat;
 		bNewBeat = true;
+		m_bGeometryDirty = true;
 	}
 
 	if (bNewBeat)
 	{
 		// LOOPS 1
 		int numSoundsInVector = m_activeCookNodesLoop1.size();
-		vector<ofxCookableNode>::iterator It = m_activeCookNodesLoop1.begin();
+		deque<ofxCookableNode>::iterator It = m_activeCookNodesLoop1.begin();
 
 		if (numSoundsInVector == 1)
 		{
@@ -75,6 +77,7 @@ void ofxPot::update(int nCurrentBeat)
 		{
 			// There are more sounds than needed
 			It->stop(); // stop current sound
+			forgetDraggedNode(&*It);
 			It = m_activeCookNodesLoop1.erase(m_activeCookNodesLoop1.begin());
 			It->play(); // play next sound
 		}
@@ -94,6 +97,7 @@ void ofxPot::update(int nCurrentBeat)
 		{
 			// There are more sounds than needed
 			It->stop(); // stop current sound
+			forgetDraggedNode(&*It);
 			It = m_activeCookNodesLoop2.erase(m_activeCookNodesLoop2.begin());
 			It->play(); // play next sound
 		}
@@ -113,13 +117,16 @@ void ofxPot::update(int nCurrentBeat)
 		{
 			// There are more sounds than needed
 			It->stop(); // stop current sound
+			forgetDraggedNode(&*It);
 			It = m_activeCookNodesLoop3.erase(m_activeCookNodesLoop3.begin());
 			It->play(); // play next sound
 		}
 	}
 	
-	// Update the volume of all playing nodes
-	vector<ofxCookableNode>::iterator It;
+	// Update the volume of all playing nodes, which is all the audio work of the pot
+	PROFILER_SCOPE("ofxPot::update voices");
+	ALLOCATION_FREE_SCOPE("ofxPot::update voices");
+	deque<ofxCookableNode>::iterator It;
 	for (It = m_activeCookNodesLoop1.begin(); It != m_activeCookNodesLoop1.end(); ++It)
 	{
 		It->update(m_fVolume);
@@ -150,8 +157,8 @@ bool ofxPot::isPointInside(ofPoint pt)
 	bool returnValue = false;
 
 	// pt will always be [0;1], while the origin and most importantly radius will be in world coordinates
-	pt.x *= ofGetWidth();
-	pt.y *= ofGetHeight();
+	pt.x *= kitchenViewport::getWidth();
+	pt.y *= kitchenViewport::getHeight();
 
 	float fDistance = sqrt(pow(pt.x - m_ptOrigin.x, 2.0f) + pow(pt.y - m_ptOrigin.y, 2.0f));
 	if (fDistance <= m_nRadius)
@@ -161,19 +168,33 @@ bool ofxPot::isPointInside(ofPoint pt)
 	return returnValue;
 }
 
-void ofxPot::draw()
+/** \param unitDisc The retained batch of a white disc of radius 1 at (0, 0), without colours.
+*/
+void ofxPot::drawDisc(ofxBatchRenderer& unitDisc)
 {
-	// Draw a pot that follows the beat
-	ofFill();
+	// Draw a pot that follows the beat: only its tint changes from frame to frame
 	int r = (m_nColor & 0xFF0000) >> 16;
 	int g = (m_nColor & 0x00FF00) >> 8;
 	int b = m_nColor & 0x0000FF;
 	float fMaxAlpha = 255.0f;
 	float fMinAlpha = 128.0f;
 	float fDampingConstant = - m_nPeriodSingleBeatMs / (log(fMinAlpha / fMaxAlpha) / log(exp(1.0f))); // ln(x) = log10(x)/log10(e)
-	float fAlphaBPM = fMaxAlpha * exp(- (float)(ofGetElapsedTimeMillis() % m_nPeriodSingleBeatMs) / fDampingConstant);
+	float fAlphaBPM = fMaxAlpha * exp(- (float)(m_clock->getElapsedTimeMillis() % m_nPeriodSingleBeatMs) / fDampingConstant);
 	ofSetColor(r, g, b, (int)fAlphaBPM);
-	ofCircle(m_ptOrigin.x, m_ptOrigin.y, m_nRadius);
+	ofPushMatrix();
+	ofTranslate(m_ptOriginalPosition.x, m_ptOriginalPosition.y);
+	ofScale(m_nRadius, m_nRadius);
+	unitDisc.draw();
+	ofPopMatrix();
+}
+
+/** \param batch The batch to which the shapes are added.
+*/
+void ofxPot::addStaticShapes(ofxBatchRenderer& batch)
+{
+	int r = (m_nColor & 0xFF0000) >> 16;
+	int g = (m_nColor & 0x00FF00) >> 8;
+	int b = m_nColor & 0x0000FF;
 
 	// Draw the current beat around the pot, or as pot handle?
 	float fCurrBeatPct = (float)(m_nCurrentBeat % OFX_POT_NUMSEQUENCERSTEPS) / (float)OFX_POT_NUMSEQUENCERSTEPS; // [0;1]
@@ -181,74 +202,121 @@ void ofxPot::draw()
 	float fCurrBeatAngleRads = fCurrBeatPct * TWO_PI;
 	// Add 90 degrees to start at x,y=[0,1]
 	cartesianCoords currBeatOffset = polToCar(m_nRadius, PI/2 + fCurrBeatAngleRads);
-	ofPoint ptBeatOrigin(m_ptOrigin.x - currBeatOffset.x, m_ptOrigin.y - currBeatOffset.y);
-	ofSetColor(r, g, b, 255);
-	ofCircle(ptBeatOrigin, m_nRadius * 0.05);
+	ofPoint ptBeatOrigin(m_ptOriginalPosition.x - currBeatOffset.x, m_ptOriginalPosition.y - currBeatOffset.y);
+	batch.addCircle(ptBeatOrigin.x, ptBeatOrigin.y, m_nRadius * 0.05, ofColor(r, g, b, 255));
 
 	// Potentially show a crosshair for looping sections
 	if (m_bShowingLoopFeedback)
 	{
-		ofSetColor(185);
-		ofSetLineWidth(2.0f);
-		ofPoint pt1(m_ptOrigin + ofPoint(-m_nRadius/2, 0));
-		ofPoint pt2(m_ptOrigin + ofPoint(m_nRadius/2, 0));
-		ofPoint pt3(m_ptOrigin + ofPoint(0, -m_nRadius/2));
-		ofPoint pt4(m_ptOrigin + ofPoint(0, m_nRadius/2));
-		ofLine(pt1, pt2);
-		ofLine(pt3, pt4);
+		ofColor crosshairColor(185);
+		ofPoint pt1(m_ptOriginalPosition + ofPoint(-m_nRadius/2, 0));
+		ofPoint pt2(m_ptOriginalPosition + ofPoint(m_nRadius/2, 0));
+		ofPoint pt3(m_ptOriginalPosition + ofPoint(0, -m_nRadius/2));
+		ofPoint pt4(m_ptOriginalPosition + ofPoint(0, m_nRadius/2));
+		batch.addLine(pt1, pt2, 2.0f, crosshairColor);
+		batch.addLine(pt3, pt4, 2.0f, crosshairColor);
 	}
+}
 
-	// Draw the nodes
-	vector<ofxCookableNode>::iterator It;
-	// LOOPS 1
-	for (It = m_activeCookNodesLoop1.begin(); It != m_activeCookNodesLoop1.end(); ++It)
-	{
-		It->draw();
-	}
-	// LOOPS 2
-	for (It = m_activeCookNodesLoop2.begin(); It != m_activeCookNodesLoop2.end(); ++It)
-	{
-		It->draw();
-	}
-	// LOOPS 3
-	for (It = m_activeCookNodesLoop3.begin(); It != m_activeCookNodesLoop3.end(); ++It)
+/** \param batch The batch to which the shapes are added.
+*/
+void ofxPot::addNodeShapes(ofxBatchRenderer& batch)
+{
+	// The dragged nodes move every frame, so they are drawn with the overlay instead
+	addNodeShapes(m_activeCookNodesLoop1, batch);
+	addNodeShapes(m_activeCookNodesLoop2, batch);
+	addNodeShapes(m_activeCookNodesLoop3, batch);
+}
+
+/**
+* \param lane The nodes of the audio channel.
+* \param batch The batch to which the shapes are added.
+*/
+void ofxPot::addNodeShapes(deque<ofxCookableNode>& lane, ofxBatchRenderer& batch)
+{
+	for (deque<ofxCookableNode>::iterator It = lane.begin(); It != lane.end(); ++It)
 	{
-		It->draw();
+		if (!isDragged(&*It))
+		{
+			ofPoint ptNodeOrigin = It->getOriginInit();
+			ofxCookableNode::addNodeShape(batch, ptNodeOrigin.x, ptNodeOrigin.y, It->getRadius(), It->getColor(), It != lane.begin());
+		}
 	}
+}
 
-	vector<ofxCookableNode*>::iterator It2;
+/** \param batch The batch to which the shapes are added.
+*/
+void ofxPot::drawOverlay(ofxBatchRenderer& batch)
+{
+	vector<draggedBeat>::iterator It2;
 	for (It2 = m_draggedBeats.begin(); It2 != m_draggedBeats.end(); It2++)
 	{
-		float fRelVolume = (*It2)->getRelativeVolume();
-		ofNoFill();
+		ofxCookableNode* node = It2->node;
+		ofPoint offset = getDrawOffset(node);
+		ofPoint ptDrawn = node->getOrigin() + offset;
+		ofxCookableNode::addNodeShape(batch, ptDrawn.x, ptDrawn.y, node->getRadius(), node->getColor(), false);
+
+		float fRelVolume = node->getRelativeVolume();
 		// get distance from node to centre of pot
 		ofPoint potOrig = getOrigin();
-		ofPoint beatOrig = (*It2)->getOrigin();
-		ofPoint scaledDown(beatOrig.x / ofGetWidth(), beatOrig.y / ofGetHeight());
+		ofPoint beatOrig = node->getOrigin();
+		ofPoint scaledDown(beatOrig.x / kitchenViewport::getWidth(), beatOrig.y / kitchenViewport::getHeight());
 		if (isPointInside(scaledDown))
 		{
-			// Draw volume feedback
-			ofSetLineWidth(fRelVolume * 10.0f);
-			ofColor nodeColour = (*It2)->getColor();
-			ofSetColor((*It2)->getColor(), fRelVolume * 255);
+			// Draw volume feedback, which follows the measured position like the volume itself
 			float fDistance = sqrt(pow(potOrig.x - beatOrig.x, 2) + pow(potOrig.y - beatOrig.y, 2));
-			ofCircle(potOrig, fDistance);
+			batch.addRing(potOrig.x, potOrig.y, fDistance, fRelVolume * 10.0f, ofColor(node->getColor(), ofClamp(fRelVolume * 255, 0, 255)));
 
 			// Draw lowpass feedback
-			(*It2)->drawLowpass();
+			batch.pushOffset(offset.x, offset.y);
+			node->drawLowpass(batch);
+			batch.popOffset();
 		}
 	}
 
 #ifdef _DEBUG
 	// Draw some beat info
-	m_infoText.setText(ofToString(m_nCurrentBeat));
-	m_infoText.setColor(255, 0, 0, 255);
-	float debugWidth = m_infoText.getWidth();
-	float debugHeight = m_infoText.getHeight();
-	m_infoText.draw(m_ptOrigin.x - debugWidth/2.0f, m_ptOrigin.y - debugHeight/2.0f);
+	m_infoText.setNumber(m_nCurrentBeat);
+	ofSetColor(255, 0, 0, 255);
+	m_infoText.drawCenter(m_ptOrigin.x, m_ptOrigin.y);
 #endif
 }
 
+/** \param node A node of the pot.
+* \return Whether or not the node is being dragged.
+*/
+bool ofxPot::isDragged(const ofxCookableNode* node)
+{
+	for (vector<draggedBeat>::iterator It = m_draggedBeats.begin(); It != m_draggedBeats.end(); ++It)
+	{
+		if (It->node == node)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/** \param node A node of the pot.
+* \return The offset in pixels from the measured position of the node to the position at which it is drawn.
+*/
+ofPoint ofxPot::getDrawOffset(const ofxCookableNode* node)
+{
+	if (m_touchPredictor == NULL)
+	{
+		return ofPoint(0.0f, 0.0f);
+	}
+	for (vector<draggedBeat>::iterator It = m_draggedBeats.begin(); It != m_draggedBeats.end(); ++It)
+	{
+		if (It->node == node)
+		{
+			ofPoint offset = m_touchPredictor->getOffset(It->nTouchId);
+			return ofPoint(offset.x * kitchenViewport::getWidth(), offset.y * kitchenViewport::getHeight());
+		}
+	}
+	return ofPoint(0.0f, 0.0f);
+}
+
 /** \return The point of origin of the pot, including the dragged offset..
 */
 ofPoint ofxPot::getOrigin()
@@ -276,6 +344,7 @@ ofPoint ofxPot::getOriginInit()
 void ofxPot::setOriginInit(ofPoint _origin)
 {
 	m_ptOriginalPosition = _origin;
+	m_bGeometryDirty = true;
 }
 
 /** \return The radius in pixels of the pot.
@@ -290,6 +359,7 @@ int ofxPot::getRadius()
 void ofxPot::setRadius(int _nRadius)
 {
 	m_nRadius = _nRadius;
+	m_bGeometryDirty = true;
 }
 
 /**
@@ -323,7 +393,7 @@ void ofxPot::mouseReleased(int x, int y, int button)
 
 /** \param _nodeToCook A new cookable element of music to add to the pot.
 */
-void ofxPot::addCookElement(ofxCookableNode _nodeToCook)
+void ofxPot::addCookElement(const ofxCookableNode& _nodeToCook)
 {
 	switch (_nodeToCook.getSoundType())
 	{
@@ -337,6 +407,202 @@ void ofxPot::addCookElement(ofxCookableNode _nodeToCook)
 		m_activeCookNodesLoop3.push_back(_nodeToCook);
 		break;
 	}
+	m_bGeometryDirty = true;
+}
+
+/** \param nLane The index of the audio channel (0 for drums, 1 for bass, 2 for lead).
+* \return The nodes of the audio channel, or NULL if the index is not valid.
+*/
+deque<ofxCookableNode>* ofxPot::getLane(int nLane)
+{
+	switch (nLane)
+	{
+	case 0:
+		return &m_activeCookNodesLoop1;
+	case 1:
+		return &m_activeCookNodesLoop2;
+	case 2:
+		return &m_activeCookNodesLoop3;
+	default:
+		return NULL;
+	}
+}
+
+/** \param node The node, whose address is no longer valid once it is removed.
+*/
+void ofxPot::forgetDraggedNode(const ofxCookableNode* node)
+{
+	vector<draggedBeat>::iterator It = m_draggedBeats.begin();
+	while (It != m_draggedBeats.end())
+	{
+		if (It->node == node)
+		{
+			It = m_draggedBeats.erase(It);
+			m_bGeometryDirty = true;
+		}
+		else
+		{
+			++It;
+		}
+	}
+}
+
+/**
+* \param lane The nodes of the audio channel.
+* \param removed The node about to be removed.
+*/
+void ofxPot::forgetDraggedNodes(deque<ofxCookableNode>& lane, deque<ofxCookableNode>::iterator removed)
+{
+	// Only a removal from the middle of a deque moves the other nodes
+	if (removed == lane.begin() || removed + 1 == lane.end())
+	{
+		forgetDraggedNode(&*removed);
+		return;
+	}
+	for (deque<ofxCookableNode>::iterator It = lane.begin(); It != lane.end(); ++It)
+	{
+		forgetDraggedNode(&*It);
+	}
+}
+
+/** \param nLane The index of the audio channel (0 for drums, 1 for bass, 2 for lead).
+* \return The node at the front of the audio channel, or NULL if the channel is empty.
+*/
+ofxCookableNode* ofxPot::getPlayingNode(int nLane)
+{
+	deque<ofxCookableNode>* lane = getLane(nLane);
+	if (lane == NULL || lane->empty())
+	{
+		return NULL;
+	}
+	return &lane->front();
+}
+
+/** \param nLane The index of the audio channel (0 for drums, 1 for bass, 2 for lead).
+* \return Whether or not a node was removed.
+*/
+bool ofxPot::removePlayingNode(int nLane)
+{
+	deque<ofxCookableNode>* lane = getLane(nLane);
+	if (lane == NULL || lane->empty())
+	{
+		return false;
+	}
+
+	// The next node of the channel starts playing on the next beat
+	lane->front().stop();
+	forgetDraggedNode(&lane->front());
+	lane->erase(lane->begin());
+	m_bGeometryDirty = true;
+	return true;
+}
+
+/** \param nLoop The index of the loop in the loop configuration.
+* \return The node of the loop nearest to the front of its audio channel, or NULL if the pot has none.
+*/
+ofxCookableNode* ofxPot::findLoopNode(int nLoop)
+{
+	for (int nLane = 0; nLane < OFX_POT_NUMLANES; nLane++)
+	{
+		deque<ofxCookableNode>* lane = getLane(nLane);
+		for (deque<ofxCookableNode>::iterator It = lane->begin(); It != lane->end(); ++It)
+		{
+			if (It->getLoopIndex() == nLoop)
+			{
+				return &*It;
+			}
+		}
+	}
+	return NULL;
+}
+
+/** \param node The node, whose address is no longer valid once it is removed.
+* \return Whether or not the node was in the pot.
+*/
+bool ofxPot::removeNode(const ofxCookableNode* node)
+{
+	for (int nLane = 0; nLane < OFX_POT_NUMLANES; nLane++)
+	{
+		deque<ofxCookableNode>* lane = getLane(nLane);
+		for (deque<ofxCookableNode>::iterator It = lane->begin(); It != lane->end(); ++It)
+		{
+			if (&*It == node)
+			{
+				// A queued node has not started, and the next node of the channel starts playing on the next beat
+				if (It == lane->begin())
+				{
+					It->stop();
+				}
+				forgetDraggedNodes(*lane, It);
+				lane->erase(It);
+				m_bGeometryDirty = true;
+				return true;
+			}
+		}
+	}
+	return false;
+}
+
+/** \param state The state to fill, in kitchen coordinates.
+*/
+void ofxPot::fillSnapshot(kitchenPotState& state)
+{
+	state.x = m_ptOriginalPosition.x;
+	state.y = m_ptOriginalPosition.y;
+	state.fRadius = m_nRadius;
+	state.nColor = m_nColor;
+	state.fFocus = m_fVolume;
+	state.nCurrentBeat = m_nCurrentBeat;
+	state.nNumNodes = 0;
+	state.nNumDroppedNodes = 0;
+	ofPoint ptDrag = m_ptOrigin - m_ptOriginalPosition;
+
+	// The playing nodes first, then the queued ones, so that a full snapshot only leaves out queued nodes
+	for (int nPass = 0; nPass < 2; nPass++)
+	{
+		for (int nLane = 0; nLane < OFX_POT_NUMLANES; nLane++)
+		{
+			deque<ofxCookableNode>* lane = getLane(nLane);
+			size_t nBegin = (nPass == 0) ? 0 : 1;
+			size_t nEnd = (nPass == 0) ? min(lane->size(), (size_t)1) : lane->size();
+			for (size_t i = nBegin; i < nEnd; i++)
+			{
+				if (state.nNumNodes == KITCHEN_SNAPSHOT_MAX_NODES)
+				{
+					state.nNumDroppedNodes++;
+					continue;
+				}
+				ofxCookableNode& node = (*lane)[i];
+				kitchenNodeState& nodeState = state.nodes[state.nNumNodes++];
+				nodeState.nNodeId = node.getNodeId();
+				nodeState.nLane = nLane;
+				nodeState.nLoopIndex = node.getLoopIndex();
+				nodeState.bPlaying = (i == 0);
+				nodeState.bDragged = isDragged(&node);
+				nodeState.bInPot = false;
+				nodeState.fLeadX = 0.0f;
+				nodeState.fLeadY = 0.0f;
+				nodeState.x = node.getOriginInit().x;
+				nodeState.y = node.getOriginInit().y;
+				if (nodeState.bDragged)
+				{
+					// A dragged node is where the touch is, as in drawOverlay(), taken back to kitchen coordinates
+					ofPoint ptNode = node.getOrigin();
+					ofPoint offset = getDrawOffset(&node);
+					nodeState.bInPot = isPointInside(ofPoint(ptNode.x / kitchenViewport::getWidth(), ptNode.y / kitchenViewport::getHeight()));
+					nodeState.x = ptNode.x - ptDrag.x;
+					nodeState.y = ptNode.y - ptDrag.y;
+					nodeState.fLeadX = offset.x;
+					nodeState.fLeadY = offset.y;
+				}
+				nodeState.fRadius = node.getRadius();
+				nodeState.nColor = node.getColor().getHex();
+				nodeState.fVolume = node.getRelativeVolume();
+				nodeState.fLowpass = node.getLowpass();
+				nodeState.nLoopBeats = node.getLoopBeats();
+			}
+		}
+	}
 }
 
 /**
@@ -351,20 +617,20 @@ bool ofxPot::mouseTouchDown(float x, float y, bool fullRange, int button, int to
     ofPoint ptCompare(x, y);
     if (fullRange)
     {
-        ptCompare.x /= ofGetWidth();
-        ptCompare.y /= ofGetHeight();
+        ptCompare.x /= kitchenViewport::getWidth();
+        ptCompare.y /= kitchenViewport::getHeight();
     }
 
     bool bTouchIsInsidePot = isPointInside(ptCompare);
 
 	bool bFoundANodeToMove = false;
-	vector<ofxCookableNode>::iterator It;
+	deque<ofxCookableNode>::iterator It;
 	// LOOPS 1
 	for (It = m_activeCookNodesLoop1.begin(); It != m_activeCookNodesLoop1.end(); ++It)
 	{
 		if(It->isPointInside(ptCompare))
 		{
-			m_draggedBeats.push_back(&*It);
+			m_draggedBeats.push_back(draggedBeat(&*It, touchId));
 			bFoundANodeToMove = true;
 			break;
 		}
@@ -376,7 +642,7 @@ bool ofxPot::mouseTouchDown(float x, float y, bool fullRange, int button, int to
 		{
 			if(It->isPointInside(ptCompare))
 			{
-				m_draggedBeats.push_back(&*It);
+				m_draggedBeats.push_back(draggedBeat(&*It, touchId));
 				bFoundANodeToMove = true;
 				break;
 			}
@@ -390,13 +656,18 @@ bool ofxPot::mouseTouchDown(float x, float y, bool fullRange, int button, int to
 		{
 			if(It->isPointInside(ptCompare))
 			{
-				m_draggedBeats.push_back(&*It);
+				m_draggedBeats.push_back(draggedBeat(&*It, touchId));
 				bFoundANodeToMove = true;
 				break;
 			}
 		}
 	}
 
+	if (bFoundANodeToMove)
+	{
+		// The node leaves the static shapes while it is dragged
+		m_bGeometryDirty = true;
+	}
 	return bFoundANodeToMove | bTouchIsInsidePot;
 }
 
@@ -415,13 +686,13 @@ bool ofxPot::mouseTouchMoved(float x, float y, bool fullRange, int button, int t
     ofPoint ptCompare(x, y);
     if (fullRange)
     {
-        ptCompare.x /= ofGetWidth();
-        ptCompare.y /= ofGetHeight();
+        ptCompare.x /= kitchenViewport::getWidth();
+        ptCompare.y /= kitchenViewport::getHeight();
     }
 	
 	// Figure out if we have to show the crosshair
 	bool bShowLoopFeedback = false;
-	for (vector<ofxCookableNode>::iterator It = m_activeCookNodesLoop1.begin(); It != m_activeCookNodesLoop1.end(); ++It)
+	for (deque<ofxCookableNode>::iterator It = m_activeCookNodesLoop1.begin(); It != m_activeCookNodesLoop1.end(); ++It)
 	{
 		float fDistFromCenter = sqrtf(pow(m_ptOrigin.x - It->getOrigin().x, 2.0f) + pow(m_ptOrigin.y - It->getOrigin().y, 2.0f));
 		if (fDistFromCenter / m_nRadius < RADIUS_LOOP_PCT)
@@ -432,7 +703,7 @@ bool ofxPot::mouseTouchMoved(float x, float y, bool fullRange, int button, int t
 	}
 	if (!bShowLoopFeedback)
 	{
-		for (vector<ofxCookableNode>::iterator It = m_activeCookNodesLoop2.begin(); It != m_activeCookNodesLoop2.end(); ++It)
+		for (deque<ofxCookableNode>::iterator It = m_activeCookNodesLoop2.begin(); It != m_activeCookNodesLoop2.end(); ++It)
 		{
 			float fDistFromCenter = sqrtf(pow(m_ptOrigin.x - It->getOrigin().x, 2.0f) + pow(m_ptOrigin.y - It->getOrigin().y, 2.0f));
 			if (fDistFromCenter / m_nRadius < RADIUS_LOOP_PCT)
@@ -444,7 +715,7 @@ bool ofxPot::mouseTouchMoved(float x, float y, bool fullRange, int button, int t
 	}
 	if (!bShowLoopFeedback)
 	{
-		for (vector<ofxCookableNode>::iterator It = m_activeCookNodesLoop3.begin(); It != m_activeCookNodesLoop3.end(); ++It)
+		for (deque<ofxCookableNode>::iterator It = m_activeCookNodesLoop3.begin(); It != m_activeCookNodesLoop3.end(); ++It)
 		{
 			float fDistFromCenter = sqrtf(pow(m_ptOrigin.x - It->getOrigin().x, 2.0f) + pow(m_ptOrigin.y - It->getOrigin().y, 2.0f));
 			if (fDistFromCenter / m_nRadius < RADIUS_LOOP_PCT)
@@ -454,37 +725,41 @@ bool ofxPot::mouseTouchMoved(float x, float y, bool fullRange, int button, int t
 			}
 		}
 	}
-	m_bShowingLoopFeedback = bShowLoopFeedback;
+	if (m_bShowingLoopFeedback != bShowLoopFeedback)
+	{
+		m_bShowingLoopFeedback = bShowLoopFeedback;
+		m_bGeometryDirty = true;
+	}
 
-	vector<ofxCookableNode*>::iterator It;
+	vector<draggedBeat>::iterator It;
 	for (It = m_draggedBeats.begin(); It != m_draggedBeats.end(); It++)
 	{
-		if ((*It)->isPointInside(ptCompare))
+		ofxCookableNode* node = It->node;
+		if (node->isPointInside(ptCompare))
 	    {
 			// Move the node, don't forget the offset
 			ofPoint ptWithOffset(ptCompare.x, ptCompare.y);
-			ofPoint offset = ((ofApp*)ofGetAppPtr())->getKitchen()->getDragOffset();
-			ptWithOffset -= offset;
-			(*It)->setOriginInit(ptWithOffset, false);
-			(*It)->setOrigin(ofPoint(ptCompare.x, ptCompare.y), false);
+			ptWithOffset -= m_kitchenDragOffset;
+			node->setOriginInit(ptWithOffset, false);
+			node->setOrigin(ofPoint(ptCompare.x, ptCompare.y), false);
 			
 			// Change volume
-			float fDistFromCenter = sqrtf(pow(m_ptOrigin.x - ptCompare.x*ofGetWidth(), 2.0f) + pow(m_ptOrigin.y - ptCompare.y*ofGetHeight(), 2.0f));
+			float fDistFromCenter = sqrtf(pow(m_ptOrigin.x - ptCompare.x*kitchenViewport::getWidth(), 2.0f) + pow(m_ptOrigin.y - ptCompare.y*kitchenViewport::getHeight(), 2.0f));
 			float fVolume = 1.0f - fDistFromCenter / m_nRadius;
-			(*It)->setRelativeVolume(fVolume*1.5f);
+			node->setRelativeVolume(fVolume*1.5f);
 
 			// Change lowpass
 			float yStart = m_ptOrigin.y + getRadius(); // lowest point in the pot
-			float tmp1 = ptCompare.y*ofGetHeight();
+			float tmp1 = ptCompare.y*kitchenViewport::getHeight();
 			float fRelHeight = (yStart - tmp1)/(2*getRadius());
-			(*It)->setLowpass(fRelHeight);
+			node->setLowpass(fRelHeight);
 
 			// Change loop
 			int nLoopLength = 0;
 			if (fDistFromCenter / m_nRadius < RADIUS_LOOP_PCT)
 			{
 				// Node is close enough to center, figure out in which quadrant it is
-				ofVec2f v1(ptCompare.x - m_ptOrigin.x/ofGetWidth(), ptCompare.y - m_ptOrigin.y/ofGetHeight());
+				ofVec2f v1(ptCompare.x - m_ptOrigin.x/kitchenViewport::getWidth(), ptCompare.y - m_ptOrigin.y/kitchenViewport::getHeight());
 				if (v1.x > 0.0f && v1.y > 0.0f)
 				{
 					// Lower right
@@ -506,7 +781,7 @@ bool ofxPot::mouseTouchMoved(float x, float y, bool fullRange, int button, int t
 					nLoopLength = 8;
 				}
 			}
-			(*It)->setLoopBeats(nLoopLength);
+			node->setLoopBeats(nLoopLength);
 		}
 	}
 	return bFoundANodeToMove;
@@ -524,18 +799,19 @@ void ofxPot::mouseTouchUp(float x, float y, bool fullRange, int button, int touc
     ofPoint ptCompare(x, y);
     if (fullRange)
     {
-        ptCompare.x /= ofGetWidth();
-        ptCompare.y /= ofGetHeight();
+        ptCompare.x /= kitchenViewport::getWidth();
+        ptCompare.y /= kitchenViewport::getHeight();
     }
 
 	// Remove the dragged beats
-	vector<ofxCookableNode*>::iterator It1 = m_draggedBeats.begin();
+	vector<draggedBeat>::iterator It1 = m_draggedBeats.begin();
 	while (It1 != m_draggedBeats.end())
 	{
-		if ((*It1)->isPointInside(ptCompare))
+		if (It1->node->isPointInside(ptCompare))
 	    {
-			// Remove this dragged beat
+			// Remove this dragged beat, which joins the static shapes again
 			It1 = m_draggedBeats.erase(It1);
+			m_bGeometryDirty = true;
 	    }
 		else
 		{
@@ -545,7 +821,7 @@ void ofxPot::mouseTouchUp(float x, float y, bool fullRange, int button, int touc
 	
 	// Remove the loops when dragged outside pot
 	// LOOPS 1
-	vector<ofxCookableNode>::iterator It = m_activeCookNodesLoop1.begin();
+	deque<ofxCookableNode>::iterator It = m_activeCookNodesLoop1.begin();
 	while (It != m_activeCookNodesLoop1.end())
 	{
 		if ((*It).isPointInside(ptCompare))
@@ -554,7 +830,9 @@ void ofxPot::mouseTouchUp(float x, float y, bool fullRange, int button, int touc
 			if (!isPointInside(ptCompare))
 			{
 				// Point is not on this pot anymore!
+				forgetDraggedNodes(m_activeCookNodesLoop1, It);
 				It = m_activeCookNodesLoop1.erase(It);
+				m_bGeometryDirty = true;
 			}
 			else
 			{
@@ -577,7 +855,9 @@ void ofxPot::mouseTouchUp(float x, float y, bool fullRange, int button, int touc
 			if (!isPointInside(ptCompare))
 			{
 				// Point is not on this pot anymore!
+				forgetDraggedNodes(m_activeCookNodesLoop2, It);
 				It = m_activeCookNodesLoop2.erase(It);
+				m_bGeometryDirty = true;
 			}
 			else
 			{
@@ -600,7 +880,9 @@ void ofxPot::mouseTouchUp(float x, float y, bool fullRange, int button, int touc
 			if (!isPointInside(ptCompare))
 			{
 				// Point is not on this pot anymore!
+				forgetDraggedNodes(m_activeCookNodesLoop3, It);
 				It = m_activeCookNodesLoop3.erase(It);
+				m_bGeometryDirty = true;
 			}
 			else
 			{
@@ -651,7 +933,7 @@ void ofxPot::drag(ofPoint deltaDrag)
 	m_ptOrigin = m_ptOriginalPosition + deltaDrag;
 
 	// Drag pot elements
-	vector<ofxCookableNode>::iterator It;
+	deque<ofxCookableNode>::iterator It;
 	// LOOPS 1
 	for (It = m_activeCookNodesLoop1.begin(); It != m_activeCookNodesLoop1.end(); ++It)
 	{
@@ -15,21 +15,32 @@
  */
 
 #include "ofMain.h"
-#include "ofxTextSuite.h"
+#include "ofxCachedText.h"
 #include "UI/ofxTactoSHPMNode.h"
 #include "ofxCookableNode.h"
+#include "kitchenSnapshot.h"
+#include "kitchenViewport.h"
+#include "ofxTouchPredictor.h"
+#include "ofxKitchenClock.h"
+
+#define OFX_POT_NUMLANES 3 ///< The number of audio channels (drums, bass, lead) of a pot.
 
 /// A class that implements a pot (or burner) in a stove top.
 class ofxPot : public ofBaseApp
 {
 public:
-	ofxPot(int _color, int _radius, ofPoint _origin, int _bpm); ///< Constructor
+	ofxPot(int _color, int _radius, ofPoint _origin, int _bpm, const ofxKitchenClock* _clock = NULL); ///< Constructor
 	ofxPot() :
-		m_nColor(0), m_nRadius(1), m_ptOrigin(0,0), m_ptOriginalPosition(0,0), m_nBPM(120) {}; ///< Default constructor
+		m_nColor(0), m_ptOrigin(0,0), m_ptOriginalPosition(0,0), m_nRadius(1), m_clock(ofxKitchenClock::getRealtime()), m_nBPM(120), m_touchPredictor(NULL), m_bGeometryDirty(true) {}; ///< Default constructor
 
 	void									update(int nCurrentBeat); ///< Regular OpenFrameworks function.
 	void									exit(); ///< Regular OpenFrameworks function.
-	void									draw(); ///< Regular OpenFrameworks function.
+	void									drawDisc(ofxBatchRenderer& unitDisc); ///< Draws the pot, pulsing with the beat.
+	void									addStaticShapes(ofxBatchRenderer& batch); ///< Adds the beat and the loop crosshair of the pot, without the dragged offset.
+	bool									isGeometryDirty() { return m_bGeometryDirty; } ///< Returns whether or not the static shapes or the nodes of the pot changed since clearGeometryDirty(). \return Whether or not the static shapes have to be rebuilt.
+	void									clearGeometryDirty() { m_bGeometryDirty = false; } ///< Marks the static shapes of the pot as rebuilt.
+	void									addNodeShapes(ofxBatchRenderer& batch); ///< Adds the nodes that are not being dragged, without the dragged offset.
+	void									drawOverlay(ofxBatchRenderer& batch); ///< Draws the dragged nodes, ahead of their touches, and their volume and lowpass feedback.
 
 	int										getColor(); ///< Returns the colour of the pot.
 	bool									isPointInside(ofPoint pt); ///< Returns true if and only if the queried point is inside the pot.
@@ -39,8 +50,18 @@ public:
 	void									setOriginInit(ofPoint _origin); ///< Sets the point of origin of the pot, without the dragged offset.
 	int										getRadius(); ///< Returns the radius in pixels of the pot.
 	void									setRadius(int _nRadius); ///< Sets the radius in pixels of the pot.
-	void									addCookElement(ofxCookableNode _nodeToCook); ///< Adds an element to cook in the pot.
+	void									addCookElement(const ofxCookableNode& _nodeToCook); ///< Adds an element to cook in the pot.
 	void									setFocusVolume(float _fVolume) { m_fVolume = _fVolume; } ///< Sets the amount of focus of the pot in the current view. \param _fVolume The volume of the pot
+	float									getFocusVolume() { return m_fVolume; } ///< Returns the amount of focus of the pot in the current view. \return The volume of the pot.
+	int										getCurrentBeat() { return m_nCurrentBeat; } ///< Returns the current beat in the sequencer. \return The current beat.
+	const ofxKitchenClock*					getClock() { return m_clock; } ///< Returns the clock of the kitchen. \return The clock.
+	ofxCookableNode*						getPlayingNode(int nLane); ///< Returns the node at the front of an audio channel, which is the one playing.
+	bool									removePlayingNode(int nLane); ///< Removes the node at the front of an audio channel.
+	ofxCookableNode*						findLoopNode(int nLoop); ///< Returns the node of a loop nearest to the front of its audio channel, playing or queued.
+	bool									removeNode(const ofxCookableNode* node); ///< Removes a node, playing or queued.
+	void									fillSnapshot(kitchenPotState& state); ///< Copies the state of the pot and of its nodes.
+	void									setKitchenDragOffset(ofPoint offset) { m_kitchenDragOffset = offset; } ///< Sets the normalized drag offset of the kitchen, from which dragged nodes are placed. \param offset The drag offset.
+	void									setTouchPredictor(const ofxTouchPredictor* predictor) { m_touchPredictor = predictor; } ///< Sets the predictor of the touches, with which dragged nodes are drawn ahead of the measured touches. \param predictor The predictor, or NULL.
 	
 	void									mouseDragged(int x, int y, int button); ///< Regular OpenFrameworks function.
 	void									mousePressed(int x, int y, int button); ///< Regular OpenFrameworks function.
@@ -55,25 +76,45 @@ public:
 	void									drag(ofPoint deltaDrag); ///< Drags the pot by the specified offset.
 
 private:
+	/// A node being dragged.
+	struct draggedBeat
+	{
+		draggedBeat(ofxCookableNode* _node, int _nTouchId) : node(_node), nTouchId(_nTouchId) {} ///< Constructor
+		ofxCookableNode*					node; ///< The node.
+		int									nTouchId; ///< The ID of the touch dragging the node.
+	};
+
+	deque<ofxCookableNode>*					getLane(int nLane); ///< Returns the nodes of an audio channel.
+	void									forgetDraggedNode(const ofxCookableNode* node); ///< Stops dragging a node that is about to be removed.
+	void									forgetDraggedNodes(deque<ofxCookableNode>& lane, deque<ofxCookableNode>::iterator removed); ///< Stops dragging the nodes that a removal from an audio channel moves.
+	bool									isDragged(const ofxCookableNode* node); ///< Returns whether or not a node is being dragged.
+	ofPoint									getDrawOffset(const ofxCookableNode* node); ///< Returns the offset in pixels at which a node is drawn.
+	void									addNodeShapes(deque<ofxCookableNode>& lane, ofxBatchRenderer& batch); ///< Adds the nodes of an audio channel that are not being dragged.
+
 	int										m_nColor; ///< The color of the menu option.
 	ofPoint									m_ptOrigin; ///< The point of origin of the stove top information, including the dragged offset.
 	ofPoint									m_ptOriginalPosition; ///< The initial point of origin of the stove top information.
 	int										m_nRadius; ///< The radius of the node.
-	vector<ofxCookableNode>					m_activeCookNodesLoop1; ///< The first audio channel of nodes being cooked in this pot.
-	vector<ofxCookableNode>					m_activeCookNodesLoop2; ///< The second audio channel of nodes being cooked in this pot.
-	vector<ofxCookableNode>					m_activeCookNodesLoop3; ///< The third audio channel of nodes being cooked in this pot.
+	// The front node of a channel plays: a deque drops it and adds nodes without moving the others, which may be dragged
+	deque<ofxCookableNode>					m_activeCookNodesLoop1; ///< The first audio channel of nodes being cooked in this pot.
+	deque<ofxCookableNode>					m_activeCookNodesLoop2; ///< The second audio channel of nodes being cooked in this pot.
+	deque<ofxCookableNode>					m_activeCookNodesLoop3; ///< The third audio channel of nodes being cooked in this pot.
 
 	// Necessary for beat tracking
 	int										m_nTimeOfCreationMs; ///< The time at which this pot was created.
+	const ofxKitchenClock*					m_clock; ///< The clock of the kitchen, which the pot pulses with and passes to its nodes.
 	int										m_nBPM; ///< The tempo in beats per minute of the sequencer.
 	int										m_nPeriodSingleBeatMs; ///< The period of each beat in milliseconds.
 	int										m_nCurrentBeat; ///< The current beat in the sequencer.
 	float									m_fVolume; ///< The volume of the pot (it affects individual the volume of individual sounds).
 #ifdef _DEBUG
-	ofxTextBlock							m_infoText; ///< A text block of information about the pot.
+	ofxCachedText							m_infoText; ///< A text block of information about the pot.
 #endif
-	vector<ofxCookableNode*>				m_draggedBeats; ///< A vector of musical loops that are being dragged.
+	vector<draggedBeat>						m_draggedBeats; ///< A vector of musical loops that are being dragged.
+	ofPoint									m_kitchenDragOffset; ///< The normalized drag offset of the kitchen.
+	const ofxTouchPredictor*				m_touchPredictor; ///< The predictor of the touches, if any.
 	bool									m_bShowingLoopFeedback; ///< Whether or not we are showing feedback about looping nodes.
+	bool									m_bGeometryDirty; ///< Whether or not the static shapes or the nodes changed since they were last built.
 };
 
 #endif
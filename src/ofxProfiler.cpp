@@ -0,0 +1,222 @@
+#include "ofxProfiler.h"
+
+profileRing* ofxProfiler::s_rings[PROFILER_MAX_THREADS] = {};
+std::atomic<int> ofxProfiler::s_nNumRings(0);
+std::mutex ofxProfiler::s_ringsMutex;
+std::atomic<bool> ofxProfiler::s_bEnabled(true);
+uint64_t ofxProfiler::s_nLastReportUs = 0;
+string ofxProfiler::s_sReport;
+
+/// The ring of a thread, given back when the thread ends.
+struct profileRingHandle
+{
+	profileRingHandle() : ring(NULL) {} ///< Constructor
+	~profileRingHandle() { if (ring != NULL) { ring->bInUse = false; } } ///< Destructor, at the end of the thread.
+	profileRing*					ring; ///< The ring of the thread, or NULL before its first scope.
+};
+
+static thread_local profileRingHandle s_threadRing; ///< The ring of the calling thread.
+
+/** \return The ring of the calling thread, or NULL when every ring is taken.
+*/
+profileRing* ofxProfiler::getThreadRing()
+{
+	if (s_threadRing.ring != NULL)
+	{
+		return s_threadRing.ring;
+	}
+
+	std::lock_guard<std::mutex> lock(s_ringsMutex);
+	int nNumRings = s_nNumRings;
+	int nRing = 0;
+	while (nRing < nNumRings && s_rings[nRing]->bInUse)
+	{
+		nRing++;
+	}
+	if (nRing == PROFILER_MAX_THREADS)
+	{
+		return NULL;
+	}
+	if (nRing == nNumRings)
+	{
+		s_rings[nRing] = new profileRing();
+		s_rings[nRing]->nHead = 0;
+		s_nNumRings = nNumRings + 1;
+	}
+	profileRing* ring = s_rings[nRing];
+	ring->bInUse = true;
+	snprintf(ring->sThreadName, sizeof(ring->sThreadName), "Thread %d", nRing);
+	s_threadRing.ring = ring;
+	return ring;
+}
+
+/** \param sName The name of the thread, shown in traces.
+*/
+void ofxProfiler::setThreadName(const char* sName)
+{
+	profileRing* ring = getThreadRing();
+	if (ring != NULL)
+	{
+		snprintf(ring->sThreadName, sizeof(ring->sThreadName), "%s", sName);
+	}
+}
+
+/**
+* \param sName The name of the scope.
+* \param nStartUs The time in microseconds at which the scope started.
+* \param nEndUs The time in microseconds at which the scope ended.
+*/
+void ofxProfiler::record(const char* sName, uint64_t nStartUs, uint64_t nEndUs)
+{
+	profileRing* ring = getThreadRing();
+	if (ring == NULL)
+	{
+		return;
+	}
+	// Only this thread writes the ring: the head is published after the event, for the readers
+	uint64_t nHead = ring->nHead.load(std::memory_order_relaxed);
+	profileEvent& event = ring->events[nHead & (PROFILER_RING_SIZE - 1)];
+	event.sName = sName;
+	event.nStartUs = nStartUs;
+	event.nDurationUs = nEndUs - nStartUs;
+	ring->nHead.store(nHead + 1, std::memory_order_release);
+}
+
+/**
+* \param nRing The index of the ring.
+* \param nSinceUs The time in microseconds from which the timings are copied.
+* \param events The timings, to which those of the ring are appended.
+* \return The number of timings copied.
+*/
+int ofxProfiler::copyEvents(int nRing, uint64_t nSinceUs, vector<profileEvent>& events)
+{
+	profileRing* ring = s_rings[nRing];
+	uint64_t nHead = ring->nHead.load(std::memory_order_acquire);
+	uint64_t nFirst = (nHead > PROFILER_RING_SIZE) ? nHead - PROFILER_RING_SIZE : 0;
+	size_t nStart = events.size();
+
+	// From the newest back, until the timings get too old
+	for (uint64_t n = nHead; n > nFirst; n--)
+	{
+		const profileEvent& event = ring->events[(n - 1) & (PROFILER_RING_SIZE - 1)];
+		if (event.nStartUs < nSinceUs)
+		{
+			break;
+		}
+		events.push_back(event);
+	}
+
+	// The slots the writer reached while they were copied, and the one it may be writing, may be torn.
+	// They hold the oldest timings copied, at the end of the vector.
+	uint64_t nHeadAfter = ring->nHead.load(std::memory_order_acquire);
+	uint64_t nSafeFirst = (nHeadAfter + 1 > PROFILER_RING_SIZE) ? nHeadAfter + 1 - PROFILER_RING_SIZE : 0;
+	uint64_t nCopiedFirst = nHead - (events.size() - nStart);
+	if (nSafeFirst > nCopiedFirst)
+	{
+		size_t nTorn = (size_t)min<uint64_t>(nSafeFirst - nCopiedFirst, events.size() - nStart);
+		events.resize(events.size() - nTorn);
+	}
+	return events.size() - nStart;
+}
+
+/** \param nNowUs The time in microseconds of the frame.
+* \return One line per scope and thread: the number of timings, their mean and longest durations in microseconds.
+*/
+string ofxProfiler::getReport(uint64_t nNowUs)
+{
+	if (nNowUs < s_nLastReportUs + PROFILER_REPORT_MS * 1000)
+	{
+		return s_sReport;
+	}
+	uint64_t nSinceUs = (nNowUs > PROFILER_REPORT_MS * 1000) ? nNowUs - PROFILER_REPORT_MS * 1000 : 0;
+	s_nLastReportUs = nNowUs;
+
+	string sReport;
+	vector<profileEvent> events;
+	int nNumRings = s_nNumRings;
+	for (int nRing = 0; nRing < nNumRings; nRing++)
+	{
+		events.clear();
+		if (copyEvents(nRing, nSinceUs, events) == 0)
+		{
+			continue;
+		}
+		// The scopes are gathered by name, in the order they were first seen
+		map<const char*, int> scopes;
+		vector<const char*> names;
+		vector<uint64_t> totalUs, maxUs;
+		vector<int> counts;
+		for (size_t i = 0; i < events.size(); i++)
+		{
+			map<const char*, int>::iterator It = scopes.find(events[i].sName);
+			int nScope;
+			if (It == scopes.end())
+			{
+				nScope = names.size();
+				scopes[events[i].sName] = nScope;
+				names.push_back(events[i].sName);
+				totalUs.push_back(0);
+				maxUs.push_back(0);
+				counts.push_back(0);
+			}
+			else
+			{
+				nScope = It->second;
+			}
+			totalUs[nScope] += events[i].nDurationUs;
+			maxUs[nScope] = max(maxUs[nScope], events[i].nDurationUs);
+			counts[nScope]++;
+		}
+		sReport += string(s_rings[nRing]->sThreadName) + "\n";
+		for (size_t i = 0; i < names.size(); i++)
+		{
+			char sLine[160];
+			snprintf(sLine, sizeof(sLine), "  %-28s %5d x %7.1f us, max %6d us\n", names[i], counts[i],
+				(double)totalUs[i] / counts[i], (int)maxUs[i]);
+			sReport += sLine;
+		}
+	}
+	s_sReport = sReport;
+	return s_sReport;
+}
+
+/**
+* \param sPath The path of the JSON file.
+* \param nSeconds The number of seconds before now to write.
+* \return Whether or not the file was written.
+*/
+bool ofxProfiler::writeChromeTrace(const string& sPath, int nSeconds)
+{
+	uint64_t nNowUs = ofGetElapsedTimeMicros();
+	uint64_t nSpanUs = (uint64_t)max(nSeconds, 1) * 1000000;
+	uint64_t nSinceUs = (nNowUs > nSpanUs) ? nNowUs - nSpanUs : 0;
+
+	std::ofstream file(ofToDataPath(sPath).c_str());
+	if (!file.is_open())
+	{
+		ofLogError("ofxProfiler", "Could not write the trace " + sPath);
+		return false;
+	}
+
+	// Complete events ("X") per thread, named by metadata events ("M")
+	file << "{\"traceEvents\":[\n";
+	bool bFirst = true;
+	vector<profileEvent> events;
+	int nNumRings = s_nNumRings;
+	for (int nRing = 0; nRing < nNumRings; nRing++)
+	{
+		events.clear();
+		copyEvents(nRing, nSinceUs, events);
+		file << (bFirst ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << nRing
+			<< ",\"args\":{\"name\":\"" << s_rings[nRing]->sThreadName << "\"}}";
+		bFirst = false;
+		for (size_t i = events.size(); i > 0; i--)
+		{
+			const profileEvent& event = events[i - 1];
+			file << ",\n{\"name\":\"" << event.sName << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << nRing
+				<< ",\"ts\":" << event.nStartUs << ",\"dur\":" << event.nDurationUs << "}";
+		}
+	}
+	file << "\n],\"displayTimeUnit\":\"ms\"}\n";
+	return file.good();
+}
@@ -0,0 +1,91 @@
+#ifndef _OFX_PROFILER
+#define _OFX_PROFILER
+
+/**
+ * \class ofxProfiler
+ *
+ * \brief This class times the scopes of the frame on every thread, for an overlay of rolling timings and for a
+ * trace of the last seconds that opens in chrome://tracing.
+ *
+ * A scope is timed by PROFILER_SCOPE("name") at its top, which records its start and duration when it ends. Every
+ * thread records into a ring of its own, taken on its first scope, so that recording takes no lock and never waits
+ * for the readers: the ring wraps around and the oldest timings are overwritten. Taking a ring may allocate it, so
+ * threads that run allocation-free scopes take theirs first, through setThreadName(). The render thread reads the
+ * rings for the overlay once per report period, and for a trace on demand. A read discards the entries that the
+ * writer may have overwritten while they were copied. The ring of a thread that ends goes to the next thread that
+ * records.
+ *
+ * The names of the scopes are not copied: they must be string literals, or strings that live as long as the
+ * application.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define PROFILER_RING_SIZE 32768 ///< The number of timings kept per thread, a power of two: about 10 seconds of a busy thread.
+#define PROFILER_MAX_THREADS 32 ///< The maximum number of threads recording at once.
+#define PROFILER_REPORT_MS 1000 ///< The period in milliseconds over which the overlay averages the scopes.
+#define PROFILER_DUMP_SECONDS 10 ///< The default number of seconds written in a trace.
+
+#define PROFILER_CONCAT_INNER(a, b) a##b
+#define PROFILER_CONCAT(a, b) PROFILER_CONCAT_INNER(a, b)
+#define PROFILER_SCOPE(name) ofxProfileScope PROFILER_CONCAT(profileScope, __LINE__)(name) ///< Times the rest of the enclosing scope under a name.
+
+/// A timed scope, as recorded in a ring.
+struct profileEvent
+{
+	const char*						sName; ///< The name of the scope.
+	uint64_t						nStartUs; ///< The time in microseconds at which the scope started.
+	uint64_t						nDurationUs; ///< The duration in microseconds of the scope.
+};
+
+/// The ring of the timings of a thread.
+struct profileRing
+{
+	profileEvent					events[PROFILER_RING_SIZE]; ///< The timings, overwritten once the ring wraps around.
+	std::atomic<uint64_t>			nHead; ///< The number of timings ever recorded in the ring.
+	std::atomic<bool>				bInUse; ///< Whether or not a thread records into the ring.
+	char							sThreadName[32]; ///< The name of the thread in traces.
+};
+
+/// A class that gathers the timings of the scopes of every thread.
+class ofxProfiler
+{
+public:
+	static void						setEnabled(bool bEnabled) { s_bEnabled = bEnabled; } ///< Turns the recording on or off. \param bEnabled Whether or not the scopes are timed.
+	static bool						isEnabled() { return s_bEnabled; } ///< Returns whether or not the scopes are timed. \return Whether or not the profiler records.
+	static void						setThreadName(const char* sName); ///< Names the calling thread in traces.
+	static void						record(const char* sName, uint64_t nStartUs, uint64_t nEndUs); ///< Records a timing into the ring of the calling thread.
+
+	static string					getReport(uint64_t nNowUs); ///< Returns the timings of the scopes over the last report period, computed once per period.
+	static bool						writeChromeTrace(const string& sPath, int nSeconds = PROFILER_DUMP_SECONDS); ///< Writes the timings of the last seconds as Chrome trace events.
+
+private:
+	static profileRing*				getThreadRing(); ///< Returns the ring of the calling thread, taken on first use.
+	static int						copyEvents(int nRing, uint64_t nSinceUs, vector<profileEvent>& events); ///< Copies the timings of a ring that started after a time.
+
+	static profileRing*				s_rings[PROFILER_MAX_THREADS]; ///< The rings, allocated as threads first record and reused once their thread ends.
+	static std::atomic<int>			s_nNumRings; ///< The number of rings allocated.
+	static std::mutex				s_ringsMutex; ///< The lock of the allocation of the rings.
+	static std::atomic<bool>		s_bEnabled; ///< Whether or not the scopes are timed.
+	static uint64_t					s_nLastReportUs; ///< The time in microseconds of the last report.
+	static string					s_sReport; ///< The last report.
+};
+
+/// A scope timed by \link ofxProfiler from its construction to its destruction.
+class ofxProfileScope
+{
+public:
+	ofxProfileScope(const char* sName) : m_sName(sName), m_nStartUs(ofxProfiler::isEnabled() ? ofGetElapsedTimeMicros() : 0) {} ///< Constructor \param sName The name of the scope.
+	~ofxProfileScope() { if (m_nStartUs != 0) { ofxProfiler::record(m_sName, m_nStartUs, ofGetElapsedTimeMicros()); } } ///< Destructor, which records the timing.
+
+private:
+	const char*						m_sName; ///< The name of the scope.
+	uint64_t						m_nStartUs; ///< The time in microseconds at which the scope started, or 0 when the profiler is off.
+};
+
+#endif
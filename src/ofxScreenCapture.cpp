@@ -0,0 +1,293 @@
+#include "ofxScreenCapture.h"
+
+ofxScreenCapture::ofxScreenCapture() :
+	m_nNextSlot(0),
+	m_nWidth(0),
+	m_nHeight(0),
+	m_nNumFrames(0),
+	m_bScreenshotRequested(false),
+	m_bRecording(false),
+	m_nFramePeriodUs(1000000 / SCREEN_CAPTURE_SEQUENCE_FPS),
+	m_nNextFrameUs(0),
+	m_nNextFrameNumber(0),
+	m_nDroppedFirstFrame(0),
+	m_nNumDroppedFrames(0),
+	m_nNumFramesWritten(0),
+	m_nNumDropped(0)
+{
+	for (int i = 0; i < SCREEN_CAPTURE_RING_SIZE; i++)
+	{
+		m_slots[i].bPending = false;
+		m_slots[i].nFrame = 0;
+	}
+}
+
+ofxScreenCapture::~ofxScreenCapture()
+{
+	stop();
+}
+
+void ofxScreenCapture::setup()
+{
+	stop();
+	int nPixels;
+	while (m_freePixels.tryReceive(nPixels))
+	{
+	}
+	for (int i = 0; i < SCREEN_CAPTURE_POOL_SIZE; i++)
+	{
+		m_freePixels.send(i);
+	}
+	m_nNumFrames = 0;
+	m_nNumFramesWritten = 0;
+	m_nNumDropped = 0;
+	m_nNumDroppedFrames = 0;
+	startThread();
+}
+
+void ofxScreenCapture::stop()
+{
+	if (!isThreadRunning())
+	{
+		return;
+	}
+	// The readbacks in flight are handed over and encoded before the worker stops
+	for (int i = 0; i < SCREEN_CAPTURE_RING_SIZE; i++)
+	{
+		int nSlot = (m_nNextSlot + i) % SCREEN_CAPTURE_RING_SIZE;
+		if (m_slots[nSlot].bPending)
+		{
+			handOver(m_slots[nSlot]);
+		}
+	}
+	m_bRecording = false;
+	waitForThread(true);
+}
+
+/**
+* \param sPath The path of the PNG file.
+* \param nWidth The width in pixels of the screenshot, or 0 for the width of the window.
+* \param nHeight The height in pixels of the screenshot, or 0 for the height of the window.
+*/
+void ofxScreenCapture::requestScreenshot(string sPath, int nWidth, int nHeight)
+{
+	m_screenshot.sPath = sPath;
+	m_screenshot.nFirstFrame = -1;
+	m_screenshot.nNumFrames = 1;
+	m_screenshot.nWidth = nWidth;
+	m_screenshot.nHeight = nHeight;
+	m_bScreenshotRequested = true;
+}
+
+/**
+* \param sDirectory The directory of the frames, created if needed.
+* \param nFps The frame rate of the sequence.
+*/
+void ofxScreenCapture::startSequence(string sDirectory, int nFps)
+{
+	if (!ofDirectory::doesDirectoryExist(sDirectory))
+	{
+		ofDirectory::createDirectory(sDirectory, true, true);
+	}
+	m_sDirectory = sDirectory;
+	m_nFramePeriodUs = 1000000 / max(nFps, 1);
+	m_nNextFrameUs = ofGetElapsedTimeMicros();
+	m_nNextFrameNumber = 0;
+	m_bRecording = true;
+}
+
+void ofxScreenCapture::capture()
+{
+	m_nNumFrames++;
+
+	// Readbacks issued a full ring ago are done, and mapping them does not wait for the GPU
+	for (int i = 0; i < SCREEN_CAPTURE_RING_SIZE; i++)
+	{
+		captureSlot& slot = m_slots[i];
+		if (slot.bPending && slot.nFrame + SCREEN_CAPTURE_RING_SIZE - 1 <= m_nNumFrames)
+		{
+			handOver(slot);
+		}
+	}
+
+	if (m_bScreenshotRequested)
+	{
+		m_bScreenshotRequested = false;
+		read(m_screenshot);
+	}
+	else if (m_bRecording)
+	{
+		uint64_t nNowUs = ofGetElapsedTimeMicros();
+		if (nNowUs >= m_nNextFrameUs)
+		{
+			// The frames whose due time went by are written with this one, to keep the rate of the sequence
+			int nNumFrames = 1 + (int)((nNowUs - m_nNextFrameUs) / m_nFramePeriodUs);
+			screenCaptureJob job;
+			job.sPath = m_sDirectory;
+			job.nFirstFrame = m_nNextFrameNumber;
+			job.nNumFrames = nNumFrames;
+			job.nWidth = 0;
+			job.nHeight = 0;
+			read(job);
+			m_nNextFrameNumber += nNumFrames;
+			m_nNextFrameUs += nNumFrames * m_nFramePeriodUs;
+		}
+	}
+}
+
+/**
+* \param nWidth The width in pixels of the window.
+* \param nHeight The height in pixels of the window.
+*/
+void ofxScreenCapture::allocate(int nWidth, int nHeight)
+{
+	// The readbacks of the old size are handed over first, oldest first
+	for (int i = 0; i < SCREEN_CAPTURE_RING_SIZE; i++)
+	{
+		int nSlot = (m_nNextSlot + i) % SCREEN_CAPTURE_RING_SIZE;
+		if (m_slots[nSlot].bPending)
+		{
+			handOver(m_slots[nSlot]);
+		}
+	}
+	m_nWidth = nWidth;
+	m_nHeight = nHeight;
+	for (int i = 0; i < SCREEN_CAPTURE_RING_SIZE; i++)
+	{
+		m_slots[i].buffer.allocate(m_nWidth * m_nHeight * 3, GL_STREAM_READ);
+	}
+}
+
+/** \param job What to write with the pixels.
+*/
+void ofxScreenCapture::read(const screenCaptureJob& job)
+{
+	if (ofGetWidth() != m_nWidth || ofGetHeight() != m_nHeight)
+	{
+		allocate(ofGetWidth(), ofGetHeight());
+	}
+
+	// With a ring too short for the frame rate, the oldest readback is waited for
+	captureSlot& slot = m_slots[m_nNextSlot];
+	if (slot.bPending)
+	{
+		handOver(slot);
+	}
+
+	glPixelStorei(GL_PACK_ALIGNMENT, 1);
+	slot.buffer.bind(GL_PIXEL_PACK_BUFFER);
+	glReadPixels(0, 0, m_nWidth, m_nHeight, GL_RGB, GL_UNSIGNED_BYTE, 0);
+	slot.buffer.unbind(GL_PIXEL_PACK_BUFFER);
+	slot.bPending = true;
+	slot.nFrame = m_nNumFrames;
+	slot.job = job;
+	m_nNextSlot = (m_nNextSlot + 1) % SCREEN_CAPTURE_RING_SIZE;
+}
+
+/** \param slot The slot of the readback.
+*/
+void ofxScreenCapture::handOver(captureSlot& slot)
+{
+	slot.bPending = false;
+	int nPixels;
+	if (!m_freePixels.tryReceive(nPixels))
+	{
+		m_nNumDropped++;
+		if (slot.job.nFirstFrame < 0)
+		{
+			ofLogWarning("ofxScreenCapture", "Dropped screenshot " + slot.job.sPath + ", the encoder is busy");
+		}
+		else if (m_nNumDroppedFrames > 0 && slot.job.nFirstFrame == m_nDroppedFirstFrame + m_nNumDroppedFrames)
+		{
+			m_nNumDroppedFrames += slot.job.nNumFrames;
+		}
+		else
+		{
+			m_nDroppedFirstFrame = slot.job.nFirstFrame;
+			m_nNumDroppedFrames = slot.job.nNumFrames;
+		}
+		return;
+	}
+
+	ofPixels& pixels = m_pool[nPixels];
+	if ((int)pixels.getWidth() != m_nWidth || (int)pixels.getHeight() != m_nHeight)
+	{
+		pixels.allocate(m_nWidth, m_nHeight, OF_PIXELS_RGB);
+	}
+	const unsigned char* data = (const unsigned char*)slot.buffer.map(GL_READ_ONLY);
+	if (data != NULL)
+	{
+		memcpy(pixels.getData(), data, pixels.getTotalBytes());
+	}
+	slot.buffer.unmap();
+
+	screenCaptureJob job = slot.job;
+	job.nPixels = nPixels;
+	if (job.nFirstFrame >= 0 && m_nNumDroppedFrames > 0)
+	{
+		// The frames dropped just before are copies of this one, as missed frames are, unless they ended another sequence
+		if (job.nFirstFrame == m_nDroppedFirstFrame + m_nNumDroppedFrames)
+		{
+			job.nFirstFrame = m_nDroppedFirstFrame;
+			job.nNumFrames += m_nNumDroppedFrames;
+		}
+		m_nNumDroppedFrames = 0;
+	}
+	m_jobs.send(job);
+}
+
+void ofxScreenCapture::threadedFunction()
+{
+	// Wake up regularly to notice when the worker is asked to stop, after the last frame handed over
+	screenCaptureJob job;
+	while (true)
+	{
+		if (m_jobs.tryReceive(job, SCREEN_CAPTURE_WAIT_MS))
+		{
+			encode(job);
+			m_freePixels.send(job.nPixels);
+		}
+		else if (!isThreadRunning())
+		{
+			break;
+		}
+	}
+}
+
+/** \param job The frame.
+*/
+void ofxScreenCapture::encode(const screenCaptureJob& job)
+{
+	// OpenGL reads the framebuffer from the bottom row up
+	ofPixels& pixels = m_pool[job.nPixels];
+	pixels.mirror(true, false);
+	ofPixels* image = &pixels;
+	if (job.nWidth > 0 && job.nHeight > 0 && (job.nWidth != (int)pixels.getWidth() || job.nHeight != (int)pixels.getHeight()))
+	{
+		if ((int)m_scaled.getWidth() != job.nWidth || (int)m_scaled.getHeight() != job.nHeight)
+		{
+			m_scaled.allocate(job.nWidth, job.nHeight, OF_PIXELS_RGB);
+		}
+		pixels.resizeTo(m_scaled);
+		image = &m_scaled;
+	}
+
+	if (job.nFirstFrame < 0)
+	{
+		ofSaveImage(*image, job.sPath);
+		m_nNumFramesWritten++;
+		return;
+	}
+
+	// The frames the application missed or the worker dropped are copies of this one
+	char sFirstPath[1024];
+	snprintf(sFirstPath, sizeof(sFirstPath), "%s/frame_%06d.png", job.sPath.c_str(), job.nFirstFrame);
+	ofSaveImage(*image, sFirstPath);
+	for (int i = 1; i < job.nNumFrames; i++)
+	{
+		char sPath[1024];
+		snprintf(sPath, sizeof(sPath), "%s/frame_%06d.png", job.sPath.c_str(), job.nFirstFrame + i);
+		ofFile::copyFromTo(sFirstPath, sPath, true, true);
+	}
+	m_nNumFramesWritten += job.nNumFrames;
+}
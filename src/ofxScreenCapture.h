@@ -0,0 +1,108 @@
+#ifndef _OFX_SCREEN_CAPTURE
+#define _OFX_SCREEN_CAPTURE
+
+/**
+ * \class ofxScreenCapture
+ *
+ * \brief This class saves screenshots and frame sequences of the window without stalling the render thread.
+ *
+ * The framebuffer is read into a ring of pixel buffer objects, so that glReadPixels() returns at once and the copy
+ * happens on the GPU. A buffer is only mapped a couple of frames later, once its copy is done, and its pixels are
+ * handed to a worker thread that flips them, scales them and encodes them as PNG. The worker takes its pixels from
+ * a pool allocated once: when encoding falls behind and the pool runs out, frames are dropped rather than delaying
+ * the render thread.
+ *
+ * A frame sequence is captured at a steady rate on the clock, whatever the frame rate of the application. When the
+ * application misses the due time of some frames, or the worker drops them, the next capture handed over is written
+ * under all of their numbers, so that the sequence has no holes and still plays back at its rate.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define SCREEN_CAPTURE_RING_SIZE 3 ///< The number of pixel buffer objects, that is the number of frames a readback has to complete.
+#define SCREEN_CAPTURE_POOL_SIZE 8 ///< The number of frames waiting for the worker, beyond which frames are dropped.
+#define SCREEN_CAPTURE_WAIT_MS 100 ///< The longest time in milliseconds the worker waits for a frame before checking whether to stop.
+#define SCREEN_CAPTURE_SCREENSHOT_WIDTH 400 ///< The width in pixels of a screenshot.
+#define SCREEN_CAPTURE_SCREENSHOT_HEIGHT 300 ///< The height in pixels of a screenshot.
+#define SCREEN_CAPTURE_SEQUENCE_FPS 30 ///< The default frame rate of a frame sequence.
+
+/// A frame to encode, from the render thread to the worker.
+struct screenCaptureJob
+{
+	int								nPixels; ///< The index of the pixels in the pool.
+	string							sPath; ///< The path of a screenshot, or the directory of a frame sequence.
+	int								nFirstFrame; ///< The number of the first frame of a sequence written, or -1 for a screenshot.
+	int								nNumFrames; ///< The number of frames of the sequence written with these pixels.
+	int								nWidth; ///< The width in pixels of the image written, or 0 for the size of the window.
+	int								nHeight; ///< The height in pixels of the image written, or 0 for the size of the window.
+};
+
+/// A class that captures the window on a worker thread.
+class ofxScreenCapture : public ofThread
+{
+public:
+	ofxScreenCapture(); ///< Constructor
+	~ofxScreenCapture(); ///< Destructor
+
+	void							setup(); ///< Starts the worker.
+	void							stop(); ///< Encodes the frames already read and stops the worker.
+
+	void							requestScreenshot(string sPath, int nWidth = SCREEN_CAPTURE_SCREENSHOT_WIDTH,
+										int nHeight = SCREEN_CAPTURE_SCREENSHOT_HEIGHT); ///< Saves the next frame drawn.
+	void							startSequence(string sDirectory, int nFps = SCREEN_CAPTURE_SEQUENCE_FPS); ///< Starts saving a numbered frame sequence.
+	void							stopSequence() { m_bRecording = false; } ///< Stops saving the frame sequence.
+	bool							isRecording() const { return m_bRecording; } ///< Returns whether or not a frame sequence is being saved. \return Whether or not frames are recorded.
+
+	void							capture(); ///< Reads the frame just drawn if it is due, and hands the finished readbacks over, at the end of ofApp::draw().
+
+	int								getNumFramesWritten() const { return m_nNumFramesWritten; } ///< Returns the number of images written since setup(). \return The number of images.
+	int								getNumDropped() const { return m_nNumDropped; } ///< Returns the number of frames dropped because the worker fell behind. \return The number of dropped frames.
+
+protected:
+	void							threadedFunction(); ///< Encodes the frames handed over.
+
+private:
+	/// A readback of the framebuffer into a pixel buffer object.
+	struct captureSlot
+	{
+		ofBufferObject				buffer; ///< The pixel buffer object.
+		bool						bPending; ///< Whether or not the readback was not handed over yet.
+		uint64_t					nFrame; ///< The number of the frame of the readback.
+		screenCaptureJob			job; ///< What to write with the pixels.
+	};
+
+	void							allocate(int nWidth, int nHeight); ///< Sizes the pixel buffer objects for the window.
+	void							read(const screenCaptureJob& job); ///< Reads the framebuffer into the next pixel buffer object.
+	void							handOver(captureSlot& slot); ///< Copies the pixels of a finished readback for the worker.
+	void							encode(const screenCaptureJob& job); ///< Writes the images of a frame, on the worker.
+
+	captureSlot						m_slots[SCREEN_CAPTURE_RING_SIZE]; ///< The ring of readbacks.
+	int								m_nNextSlot; ///< The slot of the next readback.
+	int								m_nWidth; ///< The width in pixels of the readbacks.
+	int								m_nHeight; ///< The height in pixels of the readbacks.
+	uint64_t						m_nNumFrames; ///< The number of frames drawn since setup().
+
+	bool							m_bScreenshotRequested; ///< Whether or not the next frame is a screenshot.
+	screenCaptureJob				m_screenshot; ///< The screenshot requested.
+	bool							m_bRecording; ///< Whether or not a frame sequence is being saved.
+	string							m_sDirectory; ///< The directory of the frame sequence.
+	uint64_t						m_nFramePeriodUs; ///< The time in microseconds between two frames of the sequence.
+	uint64_t						m_nNextFrameUs; ///< The due time in microseconds of the next frame of the sequence.
+	int								m_nNextFrameNumber; ///< The number of the next frame of the sequence.
+	int								m_nDroppedFirstFrame; ///< The number of the first frame of the sequence dropped since the last one handed over.
+	int								m_nNumDroppedFrames; ///< The number of frames of the sequence dropped since the last one handed over.
+
+	ofPixels						m_pool[SCREEN_CAPTURE_POOL_SIZE]; ///< The pixels of the frames handed over.
+	ofThreadChannel<int>			m_freePixels; ///< The indices of the pixels of the pool that the worker is done with.
+	ofThreadChannel<screenCaptureJob>	m_jobs; ///< The frames handed over to the worker.
+	ofPixels						m_scaled; ///< The scaled image, on the worker.
+	std::atomic<int>				m_nNumFramesWritten; ///< The number of images written.
+	int								m_nNumDropped; ///< The number of frames dropped.
+};
+
+#endif
@@ -21,66 +21,66 @@ void stoveInformation::setOrigin(ofPoint ptOrigin)
 void stoveInformation::setOriginInit(ofPoint _origin)
 {
 	m_ptOriginalPosition = _origin;
+	m_bGeometryDirty = true;
 }
 
 
-void stoveInformation::draw()
+/**
+* \param batch The batch to which the shapes are added.
+* \param stoveId The ID of the stove top.
+* \param ptOrigin The point of origin of the stove top information.
+*/
+void stoveInformation::addShapes(ofxBatchRenderer& batch, tactoStove stoveId, ofPoint ptOrigin)
 {
-	ofSetColor(0xFF, 0xFF, 0xFF, 100);
-	ofNoFill();
-	float infoBoxWidth = 0.1f * ofGetWidth();
-	float infoBoxHeight = 0.1f * ofGetHeight();
-	ofSetLineWidth(4.0f);
-	ofRect(m_ptOrigin, infoBoxWidth, infoBoxHeight);
-	ofPoint ptInfoBoxTopCentre(m_ptOrigin.x + infoBoxWidth / 2, m_ptOrigin.y);
-	ofPoint ptInfoBoxBottomCentre(m_ptOrigin.x + infoBoxWidth / 2, m_ptOrigin.y + infoBoxHeight);
-	ofPoint ptInfoBoxLeftCentre(m_ptOrigin.x, m_ptOrigin.y + infoBoxHeight / 2);
-	ofPoint ptInfoBoxRightCentre(m_ptOrigin.x + infoBoxWidth, m_ptOrigin.y + infoBoxHeight / 2);
-	ofLine(ptInfoBoxTopCentre, ptInfoBoxBottomCentre);
-	ofLine(ptInfoBoxLeftCentre, ptInfoBoxRightCentre);
+	ofColor color(0xFF, 0xFF, 0xFF, 100);
+	float infoBoxWidth = 0.1f * kitchenViewport::getWidth();
+	float infoBoxHeight = 0.1f * kitchenViewport::getHeight();
+	batch.addFrame(ptOrigin.x, ptOrigin.y, infoBoxWidth, infoBoxHeight, 4.0f, color);
+	ofPoint ptInfoBoxTopCentre(ptOrigin.x + infoBoxWidth / 2, ptOrigin.y);
+	ofPoint ptInfoBoxBottomCentre(ptOrigin.x + infoBoxWidth / 2, ptOrigin.y + infoBoxHeight);
+	ofPoint ptInfoBoxLeftCentre(ptOrigin.x, ptOrigin.y + infoBoxHeight / 2);
+	ofPoint ptInfoBoxRightCentre(ptOrigin.x + infoBoxWidth, ptOrigin.y + infoBoxHeight / 2);
+	batch.addLine(ptInfoBoxTopCentre, ptInfoBoxBottomCentre, 4.0f, color);
+	batch.addLine(ptInfoBoxLeftCentre, ptInfoBoxRightCentre, 4.0f, color);
 	// Draw circle for the stove
 	ofPoint ptStoveCentre;
 	float miniStoveRadius = min(infoBoxWidth / 4, infoBoxHeight / 4);
 	miniStoveRadius *= 0.8f; // make a bit smaller
-	switch (m_stoveId)
+	switch (stoveId)
 	{
 	case FRONT_RIGHT:
-		ptStoveCentre.x = m_ptOrigin.x + 0.75f * infoBoxWidth;
-		ptStoveCentre.y = m_ptOrigin.y + 0.75f * infoBoxHeight;
-		ofFill();
-		ofCircle(ptStoveCentre, miniStoveRadius);
+		ptStoveCentre.x = ptOrigin.x + 0.75f * infoBoxWidth;
+		ptStoveCentre.y = ptOrigin.y + 0.75f * infoBoxHeight;
+		batch.addCircle(ptStoveCentre.x, ptStoveCentre.y, miniStoveRadius, color);
 		break;
 	case FRONT_LEFT:
-		ptStoveCentre.x = m_ptOrigin.x + 0.25f * infoBoxWidth;
-		ptStoveCentre.y = m_ptOrigin.y + 0.75f * infoBoxHeight;
-		ofFill();
-		ofCircle(ptStoveCentre, miniStoveRadius);
+		ptStoveCentre.x = ptOrigin.x + 0.25f * infoBoxWidth;
+		ptStoveCentre.y = ptOrigin.y + 0.75f * infoBoxHeight;
+		batch.addCircle(ptStoveCentre.x, ptStoveCentre.y, miniStoveRadius, color);
 		break;
 	case REAR_LEFT:
-		ptStoveCentre.x = m_ptOrigin.x + 0.25f * infoBoxWidth;
-		ptStoveCentre.y = m_ptOrigin.y + 0.25f * infoBoxHeight;
-		ofFill();
-		ofCircle(ptStoveCentre, miniStoveRadius);
+		ptStoveCentre.x = ptOrigin.x + 0.25f * infoBoxWidth;
+		ptStoveCentre.y = ptOrigin.y + 0.25f * infoBoxHeight;
+		batch.addCircle(ptStoveCentre.x, ptStoveCentre.y, miniStoveRadius, color);
 		break;
 	case REAR_RIGHT:
-		ptStoveCentre.x = m_ptOrigin.x + 0.75f * infoBoxWidth;
-		ptStoveCentre.y = m_ptOrigin.y + 0.25f * infoBoxHeight;
-		ofFill();
-		ofCircle(ptStoveCentre, miniStoveRadius);
+		ptStoveCentre.x = ptOrigin.x + 0.75f * infoBoxWidth;
+		ptStoveCentre.y = ptOrigin.y + 0.25f * infoBoxHeight;
+		batch.addCircle(ptStoveCentre.x, ptStoveCentre.y, miniStoveRadius, color);
 		break;
 	}
-	ofSetLineWidth(1.0f);
 }
 
 // ****************************************************************************************
 /** \param _id The ID of the stove top.
 * \param _origin The point of origin of the stove top.
 * \param _bpm The tempo in beats per minute of the stove top's music.
+* \param _clock The clock of the kitchen, or NULL for the time of the application.
 */
-ofxStovetop::ofxStovetop(stoveInformation::tactoStove _id, ofPoint _origin, int _bpm) :
+ofxStovetop::ofxStovetop(stoveInformation::tactoStove _id, ofPoint _origin, int _bpm, const ofxKitchenClock* _clock) :
 	m_ptOrigin(_origin), m_ptOriginalPosition(_origin), m_stoveId(_id), m_ptTotalDrag(0, 0)
 {
-	int nRadius = ofGetHeight()/3;
+	int nRadius = kitchenViewport::getHeight()/3;
 	m_stoveInfo = stoveInformation();
 	
 	ofPoint ptPotOrigin = ofPoint(0, 0);
@@ -88,25 +88,25 @@ ofxStovetop::ofxStovetop(stoveInformation::tactoStove _id, ofPoint _origin, int
 	switch (m_stoveId)
 	{
 	case stoveInformation::FRONT_RIGHT:
-		m_pot = ofxPot(STOVE_COLOR, nRadius, _origin, _bpm);
+		m_pot = ofxPot(STOVE_COLOR, nRadius, _origin, _bpm, _clock);
 		ptPotOrigin += 2;
 		m_stoveInfo = stoveInformation(_id, ptPotOrigin);
 		break;
 	case stoveInformation::FRONT_LEFT:
-		m_pot = ofxPot(STOVE_COLOR, nRadius, _origin, _bpm);
-		ptPotOrigin = ofPoint(- ofGetWidth(), 0);
+		m_pot = ofxPot(STOVE_COLOR, nRadius, _origin, _bpm, _clock);
+		ptPotOrigin = ofPoint(- kitchenViewport::getWidth(), 0);
 		ptPotOrigin += 2;
 		m_stoveInfo = stoveInformation(_id, ptPotOrigin);
 		break;
 	case stoveInformation::REAR_LEFT:
-		m_pot = ofxPot(STOVE_COLOR, nRadius, _origin, _bpm);
-		ptPotOrigin = ofPoint(- ofGetWidth(), -ofGetHeight());
+		m_pot = ofxPot(STOVE_COLOR, nRadius, _origin, _bpm, _clock);
+		ptPotOrigin = ofPoint(- kitchenViewport::getWidth(), -kitchenViewport::getHeight());
 		ptPotOrigin += 2;
 		m_stoveInfo = stoveInformation(_id, ptPotOrigin);
 		break;
 	case stoveInformation::REAR_RIGHT:
-		m_pot = ofxPot(STOVE_COLOR, nRadius, _origin, _bpm);
-		ptPotOrigin = ofPoint(0, - ofGetHeight());
+		m_pot = ofxPot(STOVE_COLOR, nRadius, _origin, _bpm, _clock);
+		ptPotOrigin = ofPoint(0, - kitchenViewport::getHeight());
 		ptPotOrigin += 2;
 		m_stoveInfo = stoveInformation(_id, ptPotOrigin);
 		break;
@@ -125,16 +125,27 @@ void ofxStovetop::exit()
 	m_pot.exit();
 }
 
-void ofxStovetop::draw()
+/** \param batch The batch to which the shapes are added.
+*/
+void ofxStovetop::addStaticShapes(ofxBatchRenderer& batch)
+{
+	m_pot.addStaticShapes(batch);
+	m_stoveInfo.draw(batch);
+}
+
+/** \param state The state to fill, in kitchen coordinates.
+*/
+void ofxStovetop::fillSnapshot(kitchenPotState& state)
 {
-	m_pot.draw();
-	m_stoveInfo.draw();
+	m_pot.fillSnapshot(state);
+	state.fInfoX = m_stoveInfo.getOriginInit().x;
+	state.fInfoY = m_stoveInfo.getOriginInit().y;
 }
 
 void ofxStovetop::windowResized(int w, int h)
 {
 	ofPoint ptPotOrigin(0, 0);
-	ofPoint ptPotOffset(ofGetWidth()/2, ofGetHeight()/3);
+	ofPoint ptPotOffset(kitchenViewport::getWidth()/2, kitchenViewport::getHeight()/3);
 	ofPoint ptPotOriginInfo(0, 0);
 	
 	switch (m_stoveId)
@@ -143,8 +154,8 @@ void ofxStovetop::windowResized(int w, int h)
 		// Reset the coordinates of the pot.
 		ptPotOrigin = ptPotOffset;
 		m_pot.setOriginInit(ptPotOrigin);
-		ptPotOrigin.x += m_ptTotalDrag.x * ofGetWidth();
-		ptPotOrigin.y += m_ptTotalDrag.y * ofGetHeight();
+		ptPotOrigin.x += m_ptTotalDrag.x * kitchenViewport::getWidth();
+		ptPotOrigin.y += m_ptTotalDrag.y * kitchenViewport::getHeight();
 		m_pot.setOrigin(ptPotOrigin);
 		// Reset the coordinates of the stove top information.
 		ptPotOriginInfo = ofPoint(0, 0);
@@ -152,55 +163,55 @@ void ofxStovetop::windowResized(int w, int h)
 		m_stoveInfo.setOrigin(ptPotOriginInfo);
 		m_stoveInfo.setOriginInit(ptPotOriginInfo);
 		// Apply the offset
-		drag(m_ptTotalDrag * ofGetWidth());
+		drag(m_ptTotalDrag * kitchenViewport::getWidth());
 		break;
 	case stoveInformation::FRONT_LEFT:
 		// Reset the coordinates of the pot.
-		ptPotOrigin = ofPoint(-ofGetWidth(), 0);
+		ptPotOrigin = ofPoint(-kitchenViewport::getWidth(), 0);
 		ptPotOrigin += ptPotOffset;
 		m_pot.setOriginInit(ptPotOrigin);
-		ptPotOrigin.x += m_ptTotalDrag.x * ofGetWidth();
-		ptPotOrigin.y += m_ptTotalDrag.y * ofGetHeight();
+		ptPotOrigin.x += m_ptTotalDrag.x * kitchenViewport::getWidth();
+		ptPotOrigin.y += m_ptTotalDrag.y * kitchenViewport::getHeight();
 		m_pot.setOrigin(ptPotOrigin);
 		// Reset the coordinates of the stove top information.
-		ptPotOriginInfo = ofPoint(-ofGetWidth(), 0);
+		ptPotOriginInfo = ofPoint(-kitchenViewport::getWidth(), 0);
 		ptPotOriginInfo += 2;
 		m_stoveInfo.setOrigin(ptPotOriginInfo);
 		m_stoveInfo.setOriginInit(ptPotOriginInfo);
 		// Apply the offset
-		drag(m_ptTotalDrag * ofGetWidth());
+		drag(m_ptTotalDrag * kitchenViewport::getWidth());
 		break;
 	case stoveInformation::REAR_LEFT:
 		// Reset the coordinates of the pot.
-		ptPotOrigin = ofPoint(-ofGetWidth(), -ofGetHeight());
+		ptPotOrigin = ofPoint(-kitchenViewport::getWidth(), -kitchenViewport::getHeight());
 		ptPotOrigin += ptPotOffset;
 		m_pot.setOriginInit(ptPotOrigin);
-		ptPotOrigin.x += m_ptTotalDrag.x * ofGetWidth();
-		ptPotOrigin.y += m_ptTotalDrag.y * ofGetHeight();
+		ptPotOrigin.x += m_ptTotalDrag.x * kitchenViewport::getWidth();
+		ptPotOrigin.y += m_ptTotalDrag.y * kitchenViewport::getHeight();
 		m_pot.setOrigin(ptPotOrigin);
 		// Reset the coordinates of the stove top information.
-		ptPotOriginInfo = ofPoint(-ofGetWidth(), -ofGetHeight());
+		ptPotOriginInfo = ofPoint(-kitchenViewport::getWidth(), -kitchenViewport::getHeight());
 		ptPotOriginInfo += 2;
 		m_stoveInfo.setOrigin(ptPotOriginInfo);
 		m_stoveInfo.setOriginInit(ptPotOriginInfo);
 		// Apply the offset
-		drag(m_ptTotalDrag * ofGetWidth());
+		drag(m_ptTotalDrag * kitchenViewport::getWidth());
 		break;
 	case stoveInformation::REAR_RIGHT:
 		// Reset the coordinates of the pot.
-		ptPotOrigin = ofPoint(0, -ofGetHeight());
+		ptPotOrigin = ofPoint(0, -kitchenViewport::getHeight());
 		ptPotOrigin += ptPotOffset;
 		m_pot.setOriginInit(ptPotOrigin);
-		ptPotOrigin.x += m_ptTotalDrag.x * ofGetWidth();
-		ptPotOrigin.y += m_ptTotalDrag.y * ofGetHeight();
+		ptPotOrigin.x += m_ptTotalDrag.x * kitchenViewport::getWidth();
+		ptPotOrigin.y += m_ptTotalDrag.y * kitchenViewport::getHeight();
 		m_pot.setOrigin(ptPotOrigin);
 		// Reset the coordinates of the stove top information.
-		ptPotOriginInfo = ofPoint(0, -ofGetHeight());
+		ptPotOriginInfo = ofPoint(0, -kitchenViewport::getHeight());
 		ptPotOriginInfo += 2;
 		m_stoveInfo.setOrigin(ptPotOriginInfo);
 		m_stoveInfo.setOriginInit(ptPotOriginInfo);
 		// Apply the offset
-		drag(m_ptTotalDrag * ofGetWidth());
+		drag(m_ptTotalDrag * kitchenViewport::getWidth());
 		break;
 	}
 }
@@ -292,8 +303,8 @@ void ofxStovetop::touchUp(float x, float y, int touchId)
 */
 void ofxStovetop::drag(ofPoint deltaDrag)
 {
-	m_ptTotalDrag.x = deltaDrag.x / ofGetWidth();
-	m_ptTotalDrag.y = deltaDrag.y / ofGetWidth();
+	m_ptTotalDrag.x = deltaDrag.x / kitchenViewport::getWidth();
+	m_ptTotalDrag.y = deltaDrag.y / kitchenViewport::getWidth();
 	m_ptOrigin = m_ptOriginalPosition + deltaDrag;
 
 	m_pot.drag(deltaDrag);
@@ -323,8 +334,8 @@ bool ofxStovetop::isPointInPot(float x, float y, bool fullRange)
     ofPoint ptCompare(x, y);
     if (fullRange)
     {
-        ptCompare.x /= ofGetWidth();
-        ptCompare.y /= ofGetHeight();
+        ptCompare.x /= kitchenViewport::getWidth();
+        ptCompare.y /= kitchenViewport::getHeight();
     }
 
 	return m_pot.isPointInside(ptCompare);
@@ -332,7 +343,7 @@ bool ofxStovetop::isPointInPot(float x, float y, bool fullRange)
 
 /** \param _nodeToCook The node to add to the stove top's pot (or burner).
 */
-void ofxStovetop::addCookElement(ofxCookableNode _nodeToCook)
+void ofxStovetop::addCookElement(const ofxCookableNode& _nodeToCook)
 {
 	m_pot.addCookElement(_nodeToCook);
 }
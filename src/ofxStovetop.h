@@ -15,7 +15,6 @@
  */
 
 #include "ofMain.h"
-#include "ofxTextSuite.h"
 #include "ofxPot.h"
 
 #define STOVE_COLOR 0x323232
@@ -40,16 +39,21 @@ public:
 	stoveInformation(tactoStove stoveId, ofPoint origin) :
 	  m_ptOrigin(origin),
 	  m_ptOriginalPosition(origin),
-	  m_stoveId(stoveId)
+	  m_stoveId(stoveId),
+	  m_bGeometryDirty(true)
 		{};
 	
 	/// Default constructor
 	stoveInformation() :
 	  m_ptOrigin(),
 	  m_ptOriginalPosition(),
-	  m_stoveId(INVALID)
+	  m_stoveId(INVALID),
+	  m_bGeometryDirty(true)
 		{};
-	void							draw(); ///< Regular OpenFrameworks function.
+	void							draw(ofxBatchRenderer& batch) { addShapes(batch, m_stoveId, m_ptOriginalPosition); } ///< Adds the stove top information, without the dragged offset, to a batch. \param batch The batch to which the shapes are added.
+	static void						addShapes(ofxBatchRenderer& batch, tactoStove stoveId, ofPoint ptOrigin); ///< Adds the information of a stove top at a point of origin to a batch.
+	bool							isGeometryDirty() { return m_bGeometryDirty; } ///< Returns whether or not the shapes changed since clearGeometryDirty(). \return Whether or not the shapes have to be rebuilt.
+	void							clearGeometryDirty() { m_bGeometryDirty = false; } ///< Marks the shapes as rebuilt.
 	void							drag(ofPoint deltaDrag); ///< Drags the stove top information according to the specified offset.
 	void							setOrigin(ofPoint ptOrigin); ///< Sets the point of origin of the stove top information, without the dragged offset.
 	ofPoint							getOrigin() { return m_ptOrigin; } ///< Returns the point of origin of the stove top information, without the dragged offset. \return The point of origin of the stove top information, including the dragged offset.
@@ -59,19 +63,26 @@ private:
 	ofPoint							m_ptOrigin; ///< The point of origin of the stove top information, including the dragged offset.
  	ofPoint							m_ptOriginalPosition; ///< The initial point of origin of the stove top information.
 	tactoStove						m_stoveId; ///< The ID of the stove top.
+	bool							m_bGeometryDirty; ///< Whether or not the shapes changed since they were last built.
 };
 
 /// A class that implements a stove top.
 class ofxStovetop : public ofBaseApp
 {
 public:
-	ofxStovetop(stoveInformation::tactoStove _id, ofPoint _origin, int _bpm); ///< Constructor
+	ofxStovetop(stoveInformation::tactoStove _id, ofPoint _origin, int _bpm, const ofxKitchenClock* _clock = NULL); ///< Constructor
 	ofxStovetop() :
 		m_ptOrigin(0,0), m_ptOriginalPosition(0,0), m_stoveId(stoveInformation::INVALID) {}; ///< Default constructor
 
 	void									update(int nCurrentBeat); ///< Regular OpenFrameworks function.
 	void									exit(); ///< Regular OpenFrameworks function.
-	void									draw(); ///< Regular OpenFrameworks function.
+	void									drawDisc(ofxBatchRenderer& unitDisc) { m_pot.drawDisc(unitDisc); } ///< Draws the pot, pulsing with the beat. \param unitDisc The retained batch of a white disc of radius 1.
+	void									addStaticShapes(ofxBatchRenderer& batch); ///< Adds the static shapes of the pot and of the stove top information, without the dragged offset, to a batch.
+	bool									isGeometryDirty() { return m_pot.isGeometryDirty() || m_stoveInfo.isGeometryDirty(); } ///< Returns whether or not the static shapes changed. \return Whether or not the static shapes have to be rebuilt.
+	void									clearGeometryDirty() { m_pot.clearGeometryDirty(); m_stoveInfo.clearGeometryDirty(); } ///< Marks the static shapes as rebuilt.
+	void									addNodeShapes(ofxBatchRenderer& batch) { m_pot.addNodeShapes(batch); } ///< Adds the nodes of the pot that are not being dragged, without the dragged offset, to a batch. \param batch The batch to which the shapes are added.
+	void									drawOverlay(ofxBatchRenderer& batch) { m_pot.drawOverlay(batch); } ///< Draws the nodes dragged in the pot and their feedback. \param batch The batch to which the shapes are added.
+	void									fillSnapshot(kitchenPotState& state); ///< Copies the state of the pot, of its nodes and of the stove top information.
 	void									windowResized(int w, int h); ///< Regular OpenFrameworks function.
 
 	ofPoint									getOrigin(); ///< Returns the point of origin of the stove top.
@@ -81,7 +92,7 @@ public:
 	ofPoint									getTotalDrag() { return m_ptTotalDrag; } ///< Returns the total offset caused by dragging.
  	void									moveOffset(ofPoint offset); ///< Move all elements by the specified offset.
 	bool									isPointInPot(float x, float y, bool fullRange); ///< Returns true if and only if the queried coordinates are inside the stove top.
-	void									addCookElement(ofxCookableNode _nodeToCook); ///< Adds a cook element to the pot (or burner).
+	void									addCookElement(const ofxCookableNode& _nodeToCook); ///< Adds a cook element to the pot (or burner).
 	stoveInformation::tactoStove			getID() { return m_stoveId; } ///< Returns the ID of the stove. \retun The ID of the stove top.
 	float									getCrossfadeVolume(ofPoint pt); ///< Returns the crossfade volume of the stove top at the queried position.
 
@@ -0,0 +1,124 @@
+#include "ofxTouchPredictor.h"
+
+ofxTouchPredictor::ofxTouchPredictor() :
+	m_nNumTracks(0), m_fLead(1.0f / 60.0f), m_bEnabled(true)
+{
+}
+
+/**
+* \param nTouchId The ID of the touch.
+* \param x The measured normalized x coordinate.
+* \param y The measured normalized y coordinate.
+*/
+void ofxTouchPredictor::touchMeasured(int nTouchId, float x, float y)
+{
+	int t = findTrack(nTouchId);
+	if (t < 0)
+	{
+		if (m_nNumTracks == TOUCH_PREDICTOR_MAX_TOUCHES)
+		{
+			return;
+		}
+		t = m_nNumTracks++;
+		m_tracks[t].nTouchId = nTouchId;
+		m_tracks[t].bNew = true;
+	}
+	touchTrack& track = m_tracks[t];
+	track.fMeasuredX = x;
+	track.fMeasuredY = y;
+	track.bMeasured = true;
+}
+
+/** \param nTouchId The ID of the touch.
+*/
+void ofxTouchPredictor::touchRemoved(int nTouchId)
+{
+	int t = findTrack(nTouchId);
+	if (t >= 0)
+	{
+		m_tracks[t] = m_tracks[--m_nNumTracks];
+	}
+}
+
+/** \param fDt The time in seconds since the last frame.
+*/
+void ofxTouchPredictor::update(float fDt)
+{
+	for (int t = 0; t < m_nNumTracks; t++)
+	{
+		touchTrack& track = m_tracks[t];
+		if (track.bNew)
+		{
+			track.bNew = false;
+			track.bMeasured = false;
+			track.fSinceCorrection = 0.0f;
+			track.x = track.fMeasuredX;
+			track.y = track.fMeasuredY;
+			track.vx = track.vy = 0.0f;
+			track.ax = track.ay = 0.0f;
+			continue;
+		}
+
+		track.fSinceCorrection += fDt;
+		float dt = track.fSinceCorrection;
+		if ((!track.bMeasured && dt < TOUCH_PREDICTOR_MAX_COAST) || dt <= 0.0f)
+		{
+			continue;
+		}
+
+		// Predict the state at the time of the measurement, then correct it with the residual
+		float fHalfDt2 = 0.5f * dt * dt;
+		float px = track.x + track.vx * dt + track.ax * fHalfDt2;
+		float py = track.y + track.vy * dt + track.ay * fHalfDt2;
+		float rx = track.fMeasuredX - px;
+		float ry = track.fMeasuredY - py;
+		track.x = px + TOUCH_PREDICTOR_ALPHA * rx;
+		track.y = py + TOUCH_PREDICTOR_ALPHA * ry;
+		track.vx += track.ax * dt + TOUCH_PREDICTOR_BETA * rx / dt;
+		track.vy += track.ay * dt + TOUCH_PREDICTOR_BETA * ry / dt;
+		track.ax += TOUCH_PREDICTOR_GAMMA * rx / fHalfDt2;
+		track.ay += TOUCH_PREDICTOR_GAMMA * ry / fHalfDt2;
+		track.bMeasured = false;
+		track.fSinceCorrection = 0.0f;
+	}
+}
+
+/** \param nTouchId The ID of the touch.
+* \return The normalized offset from the measured position to the predicted position, or (0, 0) for an unknown touch.
+*/
+ofPoint ofxTouchPredictor::getOffset(int nTouchId) const
+{
+	int t = findTrack(nTouchId);
+	if (!m_bEnabled || t < 0 || m_tracks[t].bNew)
+	{
+		return ofPoint(0.0f, 0.0f);
+	}
+	const touchTrack& track = m_tracks[t];
+	float fLead = track.fSinceCorrection + m_fLead;
+	float fHalfLead2 = 0.5f * fLead * fLead;
+	ofPoint offset(track.x + track.vx * fLead + track.ax * fHalfLead2 - track.fMeasuredX,
+		track.y + track.vy * fLead + track.ay * fHalfLead2 - track.fMeasuredY);
+
+	// A wrong guess must not throw the drawing far from the finger
+	float fLength = offset.length();
+	if (fLength > TOUCH_PREDICTOR_MAX_OFFSET)
+	{
+		offset *= TOUCH_PREDICTOR_MAX_OFFSET / fLength;
+	}
+	return offset;
+}
+
+/** \param nTouchId The ID of the touch.
+* \return The index of the track of the touch, or -1 if the touch is not followed.
+*/
+int ofxTouchPredictor::findTrack(int nTouchId) const
+{
+	for (int t = 0; t < m_nNumTracks; t++)
+	{
+		if (m_tracks[t].nTouchId == nTouchId)
+		{
+			return t;
+		}
+	}
+	return -1;
+}
@@ -0,0 +1,74 @@
+#ifndef _OFX_TOUCH_PREDICTOR
+#define _OFX_TOUCH_PREDICTOR
+
+/**
+ * \class ofxTouchPredictor
+ *
+ * \brief This class estimates where each finger will be when the next frame reaches the display.
+ *
+ * Each touch runs an alpha-beta-gamma filter (a steady-state Kalman filter for position, velocity and
+ * acceleration) on its measured positions, once per frame. The prediction extrapolates the filtered motion by the
+ * time elapsed since the last measurement plus the lead time, which defaults to one frame. A finger that stops
+ * sending events keeps its last measurement, so its velocity decays instead of drifting away.
+ *
+ * The prediction is only meant for drawing: audio parameters keep using the measured positions.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define TOUCH_PREDICTOR_MAX_TOUCHES 32 ///< The maximum number of touches followed at once.
+#define TOUCH_PREDICTOR_ALPHA 0.85f ///< The position gain of the filter.
+#define TOUCH_PREDICTOR_BETA 0.5f ///< The velocity gain of the filter.
+#define TOUCH_PREDICTOR_GAMMA 0.05f ///< The acceleration gain of the filter.
+#define TOUCH_PREDICTOR_MAX_COAST 0.05f ///< The time (in seconds) after which a touch without new measurements is corrected with its last one.
+#define TOUCH_PREDICTOR_MAX_OFFSET 0.05f ///< The largest distance (normalized) between a prediction and its measurement.
+
+/// A class that predicts the positions of touches.
+class ofxTouchPredictor
+{
+public:
+	ofxTouchPredictor(); ///< Constructor
+
+	void							setLead(float fLead) { m_fLead = fLead; } ///< Sets how far (in seconds) beyond the last measurement positions are predicted, besides the time elapsed since then. \param fLead The lead time.
+	float							getLead() const { return m_fLead; } ///< Returns the lead time. \return The lead time in seconds.
+	void							setEnabled(bool bEnabled) { m_bEnabled = bEnabled; } ///< Turns the prediction on or off. \param bEnabled Whether or not positions are predicted.
+	bool							isEnabled() const { return m_bEnabled; } ///< Returns whether or not positions are predicted. \return Whether or not positions are predicted.
+
+	void							touchMeasured(int nTouchId, float x, float y); ///< Records the measured position of a touch.
+	void							touchRemoved(int nTouchId); ///< Forgets a touch.
+	void							update(float fDt); ///< Runs the filters for a frame.
+	ofPoint							getOffset(int nTouchId) const; ///< Returns the difference between the predicted and measured positions of a touch.
+	void							clear() { m_nNumTracks = 0; } ///< Forgets all touches.
+
+private:
+	/// The filter of a touch.
+	struct touchTrack
+	{
+		int							nTouchId; ///< The ID of the touch.
+		bool						bNew; ///< Whether or not the filter still has to start.
+		bool						bMeasured; ///< Whether or not a measurement arrived since the last correction.
+		float						fSinceCorrection; ///< The time (in seconds) since the last correction.
+		float						fMeasuredX; ///< The last measured x coordinate.
+		float						fMeasuredY; ///< The last measured y coordinate.
+		float						x; ///< The filtered x coordinate.
+		float						y; ///< The filtered y coordinate.
+		float						vx; ///< The filtered x velocity.
+		float						vy; ///< The filtered y velocity.
+		float						ax; ///< The filtered x acceleration.
+		float						ay; ///< The filtered y acceleration.
+	};
+
+	int								findTrack(int nTouchId) const; ///< Returns the index of the track of a touch, or -1.
+
+	touchTrack						m_tracks[TOUCH_PREDICTOR_MAX_TOUCHES]; ///< The filters of the touches.
+	int								m_nNumTracks; ///< The number of touches followed.
+	float							m_fLead; ///< The lead time in seconds.
+	bool							m_bEnabled; ///< Whether or not positions are predicted.
+};
+
+#endif
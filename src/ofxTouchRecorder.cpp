@@ -0,0 +1,180 @@
+#include "ofxTouchRecorder.h"
+
+// ****************************************************************************************
+/** \param sFilePath The path of the session file, relative to the data folder.
+* \param nNowMs The current time in milliseconds.
+* \return Whether or not the session file could be opened.
+*/
+bool ofxTouchRecorder::start(const string& sFilePath, uint64_t nNowMs)
+{
+	stop();
+
+	m_sFilePath = sFilePath;
+	m_file.open(ofToDataPath(m_sFilePath, true).c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!m_file.is_open())
+	{
+		ofLog(OF_LOG_ERROR, "ofxTouchRecorder::start() - failed to open " + m_sFilePath);
+		return false;
+	}
+
+	tactoTouchSessionHeader header;
+	memcpy(header.magic, TOUCH_SESSION_MAGIC, 4);
+	header.version = TOUCH_SESSION_VERSION;
+	header.recordSize = sizeof(tactoTouchRecord);
+	m_file.write((const char*)&header, sizeof(header));
+
+	m_pendingRecords.clear();
+	m_pendingRecords.reserve(TOUCH_SESSION_WRITE_CHUNK);
+	m_nStartTimeMs = nNowMs;
+	m_bRecording = true;
+	return true;
+}
+
+void ofxTouchRecorder::stop()
+{
+	if (!m_bRecording)
+	{
+		return;
+	}
+	flush();
+	m_file.close();
+	m_bRecording = false;
+}
+
+/**
+* \param type The type of the event.
+* \param x The x coordinate of the point.
+* \param y The y coordinate of the point.
+* \param fullRange Whether or not the coordinates of the point are in pixels (false means [0-1]).
+* \param button The ID of the mouse button, in the case of mouse input.
+* \param touchId The ID of the touch event, in the case of touch input.
+* \param nNowMs The current time in milliseconds.
+*/
+void ofxTouchRecorder::record(tactoTouchEventType type, float x, float y, bool fullRange, int button, int touchId, uint64_t nNowMs)
+{
+	if (!m_bRecording)
+	{
+		return;
+	}
+
+	tactoTouchRecord rec;
+	rec.timeMs = (uint32_t)(nNowMs - m_nStartTimeMs);
+	rec.type = (uint8_t)type;
+	rec.fullRange = fullRange ? 1 : 0;
+	rec.button = (int16_t)button;
+	rec.touchId = touchId;
+	rec.x = x;
+	rec.y = y;
+	m_pendingRecords.push_back(rec);
+
+	// Only touch the disk once in a while
+	if (m_pendingRecords.size() >= TOUCH_SESSION_WRITE_CHUNK)
+	{
+		flush();
+	}
+}
+
+void ofxTouchRecorder::flush()
+{
+	if (!m_pendingRecords.empty())
+	{
+		m_file.write((const char*)&m_pendingRecords[0], m_pendingRecords.size() * sizeof(tactoTouchRecord));
+		m_pendingRecords.clear();
+	}
+	m_file.flush();
+}
+
+// ****************************************************************************************
+/** \param sFilePath The path of the session file, relative to the data folder.
+* \return Whether or not the session file was loaded.
+*/
+bool ofxTouchPlayer::load(const string& sFilePath)
+{
+	m_bPlaying = false;
+	m_nNextRecord = 0;
+	m_records.clear();
+
+	ofBuffer buffer = ofBufferFromFile(sFilePath, true);
+	if (buffer.size() < sizeof(tactoTouchSessionHeader))
+	{
+		ofLog(OF_LOG_ERROR, "ofxTouchPlayer::load() - failed to read " + sFilePath);
+		return false;
+	}
+
+	tactoTouchSessionHeader header;
+	memcpy(&header, buffer.getData(), sizeof(header));
+	if (memcmp(header.magic, TOUCH_SESSION_MAGIC, 4) != 0 || header.version != TOUCH_SESSION_VERSION
+		|| header.recordSize != sizeof(tactoTouchRecord))
+	{
+		ofLog(OF_LOG_ERROR, "ofxTouchPlayer::load() - " + sFilePath + " is not a valid session file");
+		return false;
+	}
+
+	size_t nNumRecords = (buffer.size() - sizeof(header)) / sizeof(tactoTouchRecord);
+	m_records.resize(nNumRecords);
+	if (nNumRecords > 0)
+	{
+		memcpy(&m_records[0], buffer.getData() + sizeof(header), nNumRecords * sizeof(tactoTouchRecord));
+	}
+	return true;
+}
+
+/** \param nNowMs The current time in milliseconds.
+* \param bRealTime Whether the replay should follow the recorded timing (true) or run as fast as possible (false).
+*/
+void ofxTouchPlayer::start(uint64_t nNowMs, bool bRealTime)
+{
+	m_nStartTimeMs = nNowMs;
+	m_bRealTime = bRealTime;
+	m_nNextRecord = 0;
+	m_bPlaying = !m_records.empty();
+}
+
+/** A replay that runs as fast as possible dispatches at most TOUCH_REPLAY_FAST_EVENTS_PER_UPDATE events per call, so
+* that the kitchen updates and its beats run between the events.
+* \param nNowMs The current time in milliseconds. It is only used for real-time replays.
+* \return The number of events dispatched.
+*/
+int ofxTouchPlayer::update(uint64_t nNowMs)
+{
+	int nDispatched = 0;
+	while (m_bPlaying)
+	{
+		if (m_bRealTime && m_records[m_nNextRecord].timeMs > nNowMs - m_nStartTimeMs)
+		{
+			break;
+		}
+		if (!m_bRealTime && nDispatched == TOUCH_REPLAY_FAST_EVENTS_PER_UPDATE)
+		{
+			break;
+		}
+		dispatchNext();
+		nDispatched++;
+	}
+	return nDispatched;
+}
+
+/** \return Whether or not an event was dispatched.
+*/
+bool ofxTouchPlayer::dispatchNext()
+{
+	if (!m_bPlaying)
+	{
+		return false;
+	}
+
+	tactoTouchRecord rec = m_records[m_nNextRecord++];
+	if (m_nNextRecord >= m_records.size())
+	{
+		m_bPlaying = false;
+	}
+	ofNotifyEvent(recordEvent, rec, this);
+	return true;
+}
+
+/** \return The duration in milliseconds of the loaded session.
+*/
+uint32_t ofxTouchPlayer::getDurationMs() const
+{
+	return m_records.empty() ? 0 : m_records.back().timeMs;
+}
@@ -0,0 +1,104 @@
+#ifndef _OFX_TOUCH_RECORDER
+#define _OFX_TOUCH_RECORDER
+
+/**
+ * \class ofxTouchRecorder
+ *
+ * \brief This class records the touch and mouse events of a performance into a compact binary session file,
+ * and \link ofxTouchPlayer replays them so that a session can be repeated exactly for profiling.
+ *
+ * A session file is a small header followed by fixed-size \link tactoTouchRecord records.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+
+#define TOUCH_SESSION_MAGIC "TSXS"
+#define TOUCH_SESSION_VERSION 1
+#define TOUCH_SESSION_WRITE_CHUNK 1024
+#define TOUCH_REPLAY_FAST_EVENTS_PER_UPDATE 32 ///< The number of events dispatched per update when a replay runs as fast as possible.
+
+/// The type of an input event in a session file.
+enum tactoTouchEventType
+{
+	TACTO_TOUCH_DOWN = 0, ///< A touch down or mouse press.
+	TACTO_TOUCH_MOVED = 1, ///< A touch motion, mouse motion or mouse drag.
+	TACTO_TOUCH_UP = 2 ///< A touch up or mouse release.
+};
+
+#pragma pack(push, 1)
+/// A single recorded input event, as written in a session file (20 bytes).
+struct tactoTouchRecord
+{
+	uint32_t						timeMs; ///< The time in milliseconds of the event, relative to the start of the recording.
+	uint8_t							type; ///< The type of the event (see \link tactoTouchEventType).
+	uint8_t							fullRange; ///< Whether or not the coordinates are in pixels (0 means [0-1]).
+	int16_t							button; ///< The ID of the mouse button, in the case of mouse input.
+	int32_t							touchId; ///< The ID of the touch event, in the case of touch input.
+	float							x; ///< The x coordinate of the event.
+	float							y; ///< The y coordinate of the event.
+};
+
+/// The header of a session file.
+struct tactoTouchSessionHeader
+{
+	char							magic[4]; ///< Always TOUCH_SESSION_MAGIC.
+	uint16_t						version; ///< The version of the file format.
+	uint16_t						recordSize; ///< The size in bytes of a single record.
+};
+#pragma pack(pop)
+
+/// A class that records input events into a session file.
+class ofxTouchRecorder
+{
+public:
+	ofxTouchRecorder() : m_bRecording(false), m_nStartTimeMs(0) {} ///< Default constructor
+	~ofxTouchRecorder() { stop(); } ///< Destructor
+
+	bool							start(const string& sFilePath, uint64_t nNowMs); ///< Starts recording into the specified file.
+	void							stop(); ///< Stops recording and flushes the pending records.
+	bool							isRecording() const { return m_bRecording; } ///< Returns true if and only if a recording is in progress.
+	void							record(tactoTouchEventType type, float x, float y, bool fullRange, int button, int touchId, uint64_t nNowMs); ///< Records a single input event.
+	string							getFilePath() const { return m_sFilePath; } ///< Returns the path of the current (or last) session file.
+
+private:
+	void							flush(); ///< Writes the pending records to the session file.
+
+	bool							m_bRecording; ///< Whether or not a recording is in progress.
+	uint64_t						m_nStartTimeMs; ///< The time in milliseconds at which the recording started.
+	string							m_sFilePath; ///< The path of the session file.
+	std::ofstream					m_file; ///< The session file.
+	vector<tactoTouchRecord>		m_pendingRecords; ///< The records that have not been written to the file yet.
+};
+
+/// A class that replays the input events of a session file.
+class ofxTouchPlayer
+{
+public:
+	ofxTouchPlayer() : m_bPlaying(false), m_bRealTime(true), m_nStartTimeMs(0), m_nNextRecord(0) {} ///< Default constructor
+
+	bool							load(const string& sFilePath); ///< Loads all the records of a session file.
+	void							start(uint64_t nNowMs, bool bRealTime = true); ///< Starts the replay at the specified time.
+	void							stop() { m_bPlaying = false; } ///< Stops the replay.
+	int								update(uint64_t nNowMs); ///< Dispatches the events that are due at the specified time, or the next few when the replay runs as fast as possible.
+	bool							dispatchNext(); ///< Dispatches the next event, regardless of its time.
+	bool							isPlaying() const { return m_bPlaying; } ///< Returns true if and only if a replay is in progress.
+	bool							isRealTime() const { return m_bRealTime; } ///< Returns true if the replay follows the recorded timing, false if it runs as fast as possible.
+	size_t							getNumRecords() const { return m_records.size(); } ///< Returns the number of records in the loaded session.
+	uint32_t						getDurationMs() const; ///< Returns the duration in milliseconds of the loaded session.
+
+	ofEvent<tactoTouchRecord>		recordEvent; ///< The event notified for every replayed record.
+
+private:
+	bool							m_bPlaying; ///< Whether or not a replay is in progress.
+	bool							m_bRealTime; ///< Whether the replay follows the recorded timing (true) or runs as fast as possible (false).
+	uint64_t						m_nStartTimeMs; ///< The time in milliseconds at which the replay started.
+	size_t							m_nNextRecord; ///< The index of the next record to dispatch.
+	vector<tactoTouchRecord>		m_records; ///< The records of the loaded session.
+};
+
+#endif
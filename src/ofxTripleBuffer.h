@@ -0,0 +1,58 @@
+#ifndef _OFX_TRIPLE_BUFFER
+#define _OFX_TRIPLE_BUFFER
+
+/**
+ * \class ofxTripleBuffer
+ *
+ * \brief This class hands the latest of a stream of values from one writer thread to one reader thread, without locks.
+ *
+ * Of the three buffers, one is written by the writer, one is read by the reader, and the third holds the latest
+ * published value. Publishing swaps the written buffer with the third one, and reading swaps the read buffer with it
+ * if it is newer, both with a single atomic exchange. Neither thread ever waits for the other: the writer never
+ * blocks on a slow reader, and the reader skips the values published between two of its reads.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include <atomic>
+
+#define TRIPLE_BUFFER_INDEX 3 ///< The bits of the shared index that hold the buffer.
+#define TRIPLE_BUFFER_NEW 4 ///< The bit of the shared index set when the buffer was published and not read yet.
+
+/// A class that hands values from one thread to another.
+template <class T>
+class ofxTripleBuffer
+{
+public:
+	ofxTripleBuffer() : m_nWrite(0), m_nShared(1), m_nRead(2) {} ///< Constructor
+
+	T&								getWriteBuffer() { return m_buffers[m_nWrite]; } ///< Returns the buffer to fill, on the writer thread. \return The buffer.
+	void							publish() { m_nWrite = m_nShared.exchange(m_nWrite | TRIPLE_BUFFER_NEW) & TRIPLE_BUFFER_INDEX; } ///< Makes the filled buffer the latest value, on the writer thread.
+
+	bool							update(); ///< Takes the latest value if it is newer than the read one, on the reader thread.
+	const T&						getReadBuffer() const { return m_buffers[m_nRead]; } ///< Returns the value taken by the last update(), on the reader thread. \return The value.
+
+private:
+	T								m_buffers[3]; ///< The buffers.
+	int								m_nWrite; ///< The index of the buffer of the writer.
+	std::atomic<int>				m_nShared; ///< The index of the latest buffer published, and whether it is new.
+	int								m_nRead; ///< The index of the buffer of the reader.
+};
+
+/** \return Whether or not a newer value was taken.
+*/
+template <class T>
+bool ofxTripleBuffer<T>::update()
+{
+	if ((m_nShared.load() & TRIPLE_BUFFER_NEW) == 0)
+	{
+		return false;
+	}
+	m_nRead = m_nShared.exchange(m_nRead) & TRIPLE_BUFFER_INDEX;
+	return true;
+}
+
+#endif
@@ -0,0 +1,331 @@
+#include "ofxTuioParser.h"
+#include <string.h>
+
+/** \param p The first of 4 big-endian bytes.
+* \return The 32-bit integer.
+*/
+static inline int32_t readInt32(const char* p)
+{
+	const unsigned char* u = (const unsigned char*)p;
+	return (int32_t)(((uint32_t)u[0] << 24) | ((uint32_t)u[1] << 16) | ((uint32_t)u[2] << 8) | (uint32_t)u[3]);
+}
+
+/** \param p The first of 4 big-endian bytes.
+* \return The 32-bit float.
+*/
+static inline float readFloat(const char* p)
+{
+	int32_t n = readInt32(p);
+	float f;
+	memcpy(&f, &n, sizeof(f));
+	return f;
+}
+
+/**
+* \param p The start of a null-terminated OSC string.
+* \param end The end of the buffer.
+* \return The size of the string with its padding to 4 bytes, or -1 if it is not terminated within the buffer.
+*/
+static inline int getPaddedLength(const char* p, const char* end)
+{
+	const char* zero = (const char*)memchr(p, 0, end - p);
+	if (zero == NULL)
+	{
+		return -1;
+	}
+	return ((zero - p) / 4 + 1) * 4;
+}
+
+/// Reads the arguments of an OSC message in place, following its type tags.
+struct oscArgReader
+{
+	const char*						tag; ///< The type tag of the next argument.
+	const char*						arg; ///< The next argument.
+	const char*						end; ///< The end of the message.
+
+	bool							atEnd() const { return *tag == 0; } ///< Returns whether or not all the arguments were read.
+
+	/** \param n Set to the value of the argument. \return Whether or not the next argument is an integer. */
+	bool							readInt(int32_t& n)
+	{
+		if (*tag != 'i' || end - arg < 4)
+		{
+			return false;
+		}
+		n = readInt32(arg);
+		tag++;
+		arg += 4;
+		return true;
+	}
+
+	/** \param f Set to the value of the argument. \return Whether or not the next argument is a float. */
+	bool							readFloat(float& f)
+	{
+		if (*tag != 'f' || end - arg < 4)
+		{
+			return false;
+		}
+		f = ::readFloat(arg);
+		tag++;
+		arg += 4;
+		return true;
+	}
+
+	/** \param s Set to the string, within the buffer. \return Whether or not the next argument is a string. */
+	bool							readString(const char*& s)
+	{
+		if (*tag != 's')
+		{
+			return false;
+		}
+		int nLength = getPaddedLength(arg, end);
+		if (nLength < 0)
+		{
+			return false;
+		}
+		s = arg;
+		tag++;
+		arg += nLength;
+		return true;
+	}
+
+	/** \return Whether or not the next argument could be skipped. */
+	bool							skip()
+	{
+		int nLength = 0;
+		switch (*tag)
+		{
+		case 'i': case 'f': case 'c': case 'r': case 'm':
+			nLength = 4;
+			break;
+		case 'h': case 't': case 'd':
+			nLength = 8;
+			break;
+		case 's': case 'S':
+			nLength = getPaddedLength(arg, end);
+			break;
+		case 'b':
+			// The size of a blob comes from the network: it is checked against the buffer before it is padded
+			nLength = -1;
+			if (end - arg >= 4)
+			{
+				int32_t nBlobSize = readInt32(arg);
+				if (nBlobSize >= 0 && nBlobSize <= end - arg - 4)
+				{
+					nLength = 4 + ((nBlobSize + 3) / 4) * 4;
+				}
+			}
+			break;
+		case 'T': case 'F': case 'N': case 'I':
+			break;
+		default:
+			return false;
+		}
+		if (nLength < 0 || end - arg < nLength)
+		{
+			return false;
+		}
+		tag++;
+		arg += nLength;
+		return true;
+	}
+};
+
+/**
+* \param data The datagram.
+* \param nSize The size in bytes of the datagram.
+* \param frame The frame to which the content of the datagram is added.
+* \return Whether or not the datagram is well-formed.
+*/
+bool ofxTuioParser::parsePacket(const char* data, int nSize, tuioFrame& frame)
+{
+	return parseElement(data, nSize, frame, 0);
+}
+
+/**
+* \param data The start of the element.
+* \param nSize The size in bytes of the element.
+* \param frame The frame to which the content of the element is added.
+* \param nDepth The nesting depth of the element.
+* \return Whether or not the element is well-formed.
+*/
+bool ofxTuioParser::parseElement(const char* data, int nSize, tuioFrame& frame, int nDepth)
+{
+	if (nSize < 4 || nSize % 4 != 0)
+	{
+		return false;
+	}
+	if (data[0] != '#')
+	{
+		return parseMessage(data, nSize, frame);
+	}
+
+	// "#bundle", then the time tag, then the elements, each preceded by its size
+	if (nSize < 16 || memcmp(data, "#bundle", 8) != 0 || nDepth >= TUIO_MAX_BUNDLE_DEPTH)
+	{
+		return false;
+	}
+	const char* p = data + 16;
+	const char* end = data + nSize;
+	while (p < end)
+	{
+		if (end - p < 4)
+		{
+			return false;
+		}
+		int32_t nElementSize = readInt32(p);
+		p += 4;
+		if (nElementSize < 0 || nElementSize > end - p || !parseElement(p, nElementSize, frame, nDepth + 1))
+		{
+			return false;
+		}
+		p += nElementSize;
+	}
+	return true;
+}
+
+/**
+* \param data The start of the message.
+* \param nSize The size in bytes of the message.
+* \param frame The frame to which the content of the message is added.
+* \return Whether or not the message is well-formed.
+*/
+bool ofxTuioParser::parseMessage(const char* data, int nSize, tuioFrame& frame)
+{
+	const char* end = data + nSize;
+	int nAddressLength = getPaddedLength(data, end);
+	if (nAddressLength < 0)
+	{
+		return false;
+	}
+	const char* tags = data + nAddressLength;
+	if (tags >= end || *tags != ',')
+	{
+		return false;
+	}
+	int nTagsLength = getPaddedLength(tags, end);
+	if (nTagsLength < 0)
+	{
+		return false;
+	}
+
+	oscArgReader reader;
+	reader.tag = tags + 1;
+	reader.arg = tags + nTagsLength;
+	reader.end = end;
+
+	if (strcmp(data, "/tuio/2Dcur") == 0)
+	{
+		frame.nVersion = 1;
+		const char* sCommand;
+		if (!reader.readString(sCommand))
+		{
+			return false;
+		}
+		if (strcmp(sCommand, "set") == 0)
+		{
+			tuioCursor cursor;
+			if (!reader.readInt(cursor.nSessionId) || !reader.readFloat(cursor.x) || !reader.readFloat(cursor.y)
+				|| !reader.readFloat(cursor.fSpeedX) || !reader.readFloat(cursor.fSpeedY) || !reader.readFloat(cursor.fAccel))
+			{
+				return false;
+			}
+			if (frame.nNumCursors < TUIO_MAX_CURSORS)
+			{
+				frame.cursors[frame.nNumCursors++] = cursor;
+			}
+		}
+		else if (strcmp(sCommand, "alive") == 0)
+		{
+			frame.bHasAlive = true;
+			frame.nNumAlive = 0;
+			int32_t nSessionId;
+			while (!reader.atEnd())
+			{
+				if (!reader.readInt(nSessionId))
+				{
+					return false;
+				}
+				if (frame.nNumAlive < TUIO_MAX_CURSORS)
+				{
+					frame.alive[frame.nNumAlive++] = nSessionId;
+				}
+			}
+		}
+		else if (strcmp(sCommand, "fseq") == 0)
+		{
+			if (!reader.readInt(frame.nFrameId))
+			{
+				return false;
+			}
+			frame.bComplete = true;
+		}
+		// "source" and unknown commands carry nothing for the cursors
+	}
+	else if (strcmp(data, "/tuio2/frm") == 0)
+	{
+		frame.nVersion = 2;
+		if (!reader.readInt(frame.nFrameId))
+		{
+			return false;
+		}
+	}
+	else if (strcmp(data, "/tuio2/ptr") == 0)
+	{
+		// s_id tu_id c_id x y angle shear radius pressure [x_vel y_vel p_vel m_acc p_acc]
+		tuioCursor cursor;
+		int32_t nTypeUser, nComponent;
+		float fAngle, fShear, fRadius, fPressure;
+		if (!reader.readInt(cursor.nSessionId) || !reader.readInt(nTypeUser) || !reader.readInt(nComponent)
+			|| !reader.readFloat(cursor.x) || !reader.readFloat(cursor.y) || !reader.readFloat(fAngle)
+			|| !reader.readFloat(fShear) || !reader.readFloat(fRadius) || !reader.readFloat(fPressure))
+		{
+			return false;
+		}
+		float fPressureSpeed;
+		if (reader.atEnd())
+		{
+			cursor.fSpeedX = 0.0f;
+			cursor.fSpeedY = 0.0f;
+			cursor.fAccel = 0.0f;
+		}
+		else if (!reader.readFloat(cursor.fSpeedX) || !reader.readFloat(cursor.fSpeedY)
+			|| !reader.readFloat(fPressureSpeed) || !reader.readFloat(cursor.fAccel))
+		{
+			return false;
+		}
+		if (frame.nNumCursors < TUIO_MAX_CURSORS)
+		{
+			frame.cursors[frame.nNumCursors++] = cursor;
+		}
+	}
+	else if (strcmp(data, "/tuio2/alv") == 0)
+	{
+		frame.nVersion = 2;
+		frame.bHasAlive = true;
+		frame.nNumAlive = 0;
+		int32_t nSessionId;
+		while (!reader.atEnd())
+		{
+			if (!reader.readInt(nSessionId))
+			{
+				return false;
+			}
+			if (frame.nNumAlive < TUIO_MAX_CURSORS)
+			{
+				frame.alive[frame.nNumAlive++] = nSessionId;
+			}
+		}
+		frame.bComplete = true;
+	}
+
+	// The remaining arguments (and other profiles) only need to be well-formed
+	while (!reader.atEnd())
+	{
+		if (!reader.skip())
+		{
+			return false;
+		}
+	}
+	return true;
+}
@@ -0,0 +1,65 @@
+#ifndef _OFX_TUIO_PARSER
+#define _OFX_TUIO_PARSER
+
+/**
+ * \class ofxTuioParser
+ *
+ * \brief This class decodes TUIO 1.1 (/tuio/2Dcur) and TUIO 2.0 (/tuio2/frm, /tuio2/ptr, /tuio2/alv) cursors
+ * straight from the bytes of a UDP datagram.
+ *
+ * OSC bundles and messages are walked in place: addresses are compared where they lie in the buffer, arguments
+ * are read from the type tags without any intermediate message object, and the cursors land in the fixed-size
+ * records of a tuioFrame. Nothing is allocated while parsing. Malformed packets are rejected as a whole,
+ * and messages of other profiles are skipped.
+ *
+ * A TUIO 1.1 frame ends with its fseq message, a TUIO 2.0 frame with its alv message.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include <stdint.h>
+
+#define TUIO_MAX_CURSORS 128 ///< The maximum number of cursors in a frame.
+#define TUIO_MAX_BUNDLE_DEPTH 4 ///< The maximum nesting of OSC bundles.
+
+/// A cursor of a TUIO frame.
+struct tuioCursor
+{
+	int32_t							nSessionId; ///< The session ID of the cursor.
+	float							x; ///< The normalized x coordinate.
+	float							y; ///< The normalized y coordinate.
+	float							fSpeedX; ///< The x velocity.
+	float							fSpeedY; ///< The y velocity.
+	float							fAccel; ///< The motion acceleration.
+};
+
+/// The content of a TUIO frame.
+struct tuioFrame
+{
+	int								nVersion; ///< The TUIO version of the frame (1 or 2, 0 while unknown).
+	int32_t							nFrameId; ///< The frame sequence number (-1 while unknown).
+	bool							bComplete; ///< Whether or not the end of the frame was parsed.
+	bool							bHasAlive; ///< Whether or not the frame holds an alive message.
+	int								nNumAlive; ///< The number of alive session IDs.
+	int32_t							alive[TUIO_MAX_CURSORS]; ///< The session IDs of the cursors on the surface.
+	int								nNumCursors; ///< The number of cursors set in the frame.
+	tuioCursor						cursors[TUIO_MAX_CURSORS]; ///< The cursors set in the frame.
+
+	void							clear() { nVersion = 0; nFrameId = -1; bComplete = false; bHasAlive = false; nNumAlive = 0; nNumCursors = 0; } ///< Empties the frame.
+};
+
+/// A class that decodes TUIO packets.
+class ofxTuioParser
+{
+public:
+	static bool						parsePacket(const char* data, int nSize, tuioFrame& frame); ///< Adds the content of a datagram to a frame.
+
+private:
+	static bool						parseElement(const char* data, int nSize, tuioFrame& frame, int nDepth); ///< Parses a bundle or a message.
+	static bool						parseMessage(const char* data, int nSize, tuioFrame& frame); ///< Parses a message.
+};
+
+#endif
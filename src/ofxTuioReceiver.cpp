@@ -0,0 +1,284 @@
+#include "ofxTuioReceiver.h"
+#include "osc/OscOutboundPacketStream.h"
+
+ofxTuioReceiver::ofxTuioReceiver() :
+	m_socket(NULL), m_nLastFrameId(-1), m_nNumActive(0), m_bBenchmark(false), m_nNumReceived(0)
+{
+	m_frame.clear();
+}
+
+ofxTuioReceiver::~ofxTuioReceiver()
+{
+	stop();
+}
+
+/** \param nPort The UDP port of the TUIO tracker.
+* \return Whether or not the port could be opened.
+*/
+bool ofxTuioReceiver::setup(int nPort)
+{
+	stop();
+	m_frame.clear();
+	m_nLastFrameId = -1;
+	m_nNumActive = 0;
+	try
+	{
+		m_socket = new UdpListeningReceiveSocket(IpEndpointName(IpEndpointName::ANY_ADDRESS, nPort), this);
+	}
+	catch (std::exception& e)
+	{
+		ofLogError("ofxTuioReceiver", "Cannot listen on port " + ofToString(nPort) + ": " + e.what());
+		m_socket = NULL;
+		return false;
+	}
+	startThread();
+	return true;
+}
+
+void ofxTuioReceiver::stop()
+{
+	if (m_socket == NULL)
+	{
+		return;
+	}
+	m_socket->AsynchronousBreak();
+	waitForThread(true);
+	delete m_socket;
+	m_socket = NULL;
+
+	// The cursors still on the surface are released, rather than held until the next tracker
+	for (int a = 0; a < m_nNumActive; a++)
+	{
+		sendTouch(ofTouchEventArgs::up, m_active[a]);
+	}
+	m_nNumActive = 0;
+	m_nLastFrameId = -1;
+	m_frame.clear();
+}
+
+void ofxTuioReceiver::threadedFunction()
+{
+	m_socket->Run();
+}
+
+/**
+* \param data The datagram, in the receive buffer of the socket.
+* \param size The size in bytes of the datagram.
+*/
+void ofxTuioReceiver::ProcessPacket(const char* data, int size, const IpEndpointName&)
+{
+	if (!ofxTuioParser::parsePacket(data, size, m_frame))
+	{
+		// A malformed datagram spoils the frame it belongs to
+		m_frame.clear();
+		return;
+	}
+	if (!m_frame.bComplete)
+	{
+		return;
+	}
+
+	// A frame ID of -1 is a redundant TUIO 1.1 frame, which is never late
+	int32_t nFrameId = m_frame.nFrameId;
+	bool bLate = nFrameId >= 0 && m_nLastFrameId >= 0
+		&& nFrameId <= m_nLastFrameId && m_nLastFrameId - nFrameId < TUIO_FRAME_ID_WINDOW;
+	if (!bLate)
+	{
+		if (nFrameId >= 0)
+		{
+			m_nLastFrameId = nFrameId;
+		}
+		applyFrame();
+		if (m_bBenchmark && nFrameId >= 0 && (size_t)nFrameId < m_arrivalUs.size())
+		{
+			m_arrivalUs[nFrameId] = ofGetElapsedTimeMicros();
+			m_nNumReceived++;
+		}
+	}
+	m_frame.clear();
+}
+
+void ofxTuioReceiver::applyFrame()
+{
+	// Cursors that left the surface
+	if (m_frame.bHasAlive)
+	{
+		for (int a = m_nNumActive - 1; a >= 0; a--)
+		{
+			if (!isAlive(m_active[a].nSessionId))
+			{
+				sendTouch(ofTouchEventArgs::up, m_active[a]);
+				m_active[a] = m_active[--m_nNumActive];
+			}
+		}
+	}
+
+	// Cursors that were set
+	for (int c = 0; c < m_frame.nNumCursors; c++)
+	{
+		const tuioCursor& cursor = m_frame.cursors[c];
+		if (m_frame.bHasAlive && !isAlive(cursor.nSessionId))
+		{
+			continue;
+		}
+		int a = 0;
+		while (a < m_nNumActive && m_active[a].nSessionId != cursor.nSessionId)
+		{
+			a++;
+		}
+		if (a < m_nNumActive)
+		{
+			if (m_active[a].x != cursor.x || m_active[a].y != cursor.y)
+			{
+				m_active[a].x = cursor.x;
+				m_active[a].y = cursor.y;
+				sendTouch(ofTouchEventArgs::move, m_active[a]);
+			}
+		}
+		else if (m_nNumActive < TUIO_MAX_CURSORS)
+		{
+			activeCursor& added = m_active[m_nNumActive++];
+			added.nSessionId = cursor.nSessionId;
+			added.x = cursor.x;
+			added.y = cursor.y;
+			sendTouch(ofTouchEventArgs::down, added);
+		}
+	}
+}
+
+/**
+* \param type The type of the event.
+* \param cursor The cursor.
+*/
+void ofxTuioReceiver::sendTouch(ofTouchEventArgs::Type type, const activeCursor& cursor)
+{
+	if (m_bBenchmark)
+	{
+		return;
+	}
+	ofTouchEventArgs args;
+	args.type = type;
+	args.id = cursor.nSessionId;
+	args.x = cursor.x;
+	args.y = cursor.y;
+	m_touches.send(args);
+}
+
+/** \param nSessionId The session ID.
+* \return Whether or not the session ID is in the alive list of the frame.
+*/
+bool ofxTuioReceiver::isAlive(int32_t nSessionId) const
+{
+	for (int a = 0; a < m_frame.nNumAlive; a++)
+	{
+		if (m_frame.alive[a] == nSessionId)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+/**
+* \param stream The stream to which the bundle is written.
+* \param nFrameId The ID of the frame.
+* \param nCursors The number of cursors.
+*/
+static void writeTuioBundle(osc::OutboundPacketStream& stream, int nFrameId, int nCursors)
+{
+	stream.Clear();
+	stream << osc::BeginBundleImmediate;
+	stream << osc::BeginMessage("/tuio/2Dcur") << "alive";
+	for (int c = 0; c < nCursors; c++)
+	{
+		stream << (osc::int32)c;
+	}
+	stream << osc::EndMessage;
+	for (int c = 0; c < nCursors; c++)
+	{
+		float fPhase = (nFrameId + c * 7) * 0.01f;
+		stream << osc::BeginMessage("/tuio/2Dcur") << "set" << (osc::int32)c
+			<< 0.5f + 0.4f * cos(fPhase) << 0.5f + 0.4f * sin(fPhase) << 0.1f << 0.1f << 0.0f << osc::EndMessage;
+	}
+	stream << osc::BeginMessage("/tuio/2Dcur") << "fseq" << (osc::int32)nFrameId << osc::EndMessage;
+	stream << osc::EndBundle;
+}
+
+/**
+* \param nPackets The number of packets of each measure.
+* \param nCursors The number of cursors in each packet.
+* \return The report of the benchmark.
+*/
+string ofxTuioReceiver::benchmark(int nPackets, int nCursors)
+{
+	static char buffer[8192];
+	osc::OutboundPacketStream stream(buffer, sizeof(buffer));
+	nCursors = ofClamp(nCursors, 1, TUIO_MAX_CURSORS);
+
+	// Parser alone, on one bundle
+	writeTuioBundle(stream, 0, nCursors);
+	tuioFrame frame;
+	int nNumParsed = 0;
+	uint64_t nStartUs = ofGetElapsedTimeMicros();
+	for (int p = 0; p < nPackets; p++)
+	{
+		frame.clear();
+		nNumParsed += ofxTuioParser::parsePacket(stream.Data(), stream.Size(), frame) && frame.nNumCursors == nCursors;
+	}
+	uint64_t nParseUs = ofGetElapsedTimeMicros() - nStartUs;
+	string sReport = "TUIO bundle of " + ofToString(nCursors) + " cursors, " + ofToString(stream.Size()) + " bytes\n";
+	sReport += "Parse: " + ofToString(nParseUs * 1000.0 / nPackets, 1) + " ns/packet ("
+		+ ofToString(nNumParsed) + "/" + ofToString(nPackets) + " parsed)\n";
+
+	// Loopback UDP, frames and events included
+	ofxTuioReceiver receiver;
+	receiver.m_bBenchmark = true;
+	receiver.m_arrivalUs.assign(nPackets, 0);
+	if (!receiver.setup(TUIO_BENCHMARK_PORT))
+	{
+		return sReport + "Loopback: cannot listen on port " + ofToString(TUIO_BENCHMARK_PORT) + "\n";
+	}
+	vector<uint64_t> sentUs(nPackets, 0);
+	{
+		UdpTransmitSocket socket(IpEndpointName("127.0.0.1", TUIO_BENCHMARK_PORT));
+		for (int p = 0; p < nPackets; p++)
+		{
+			writeTuioBundle(stream, p, nCursors);
+			sentUs[p] = ofGetElapsedTimeMicros();
+			socket.Send(stream.Data(), stream.Size());
+		}
+	}
+
+	// Waits for the receiver to drain the socket
+	int nLastReceived = -1;
+	while (receiver.m_nNumReceived != nLastReceived && receiver.m_nNumReceived < nPackets)
+	{
+		nLastReceived = receiver.m_nNumReceived;
+		ofSleepMillis(100);
+	}
+	receiver.stop();
+
+	int nNumReceived = 0;
+	uint64_t nTotalLatencyUs = 0;
+	uint64_t nMaxLatencyUs = 0;
+	uint64_t nLastArrivalUs = sentUs[0];
+	for (int p = 0; p < nPackets; p++)
+	{
+		if (receiver.m_arrivalUs[p] == 0)
+		{
+			continue;
+		}
+		uint64_t nLatencyUs = receiver.m_arrivalUs[p] - sentUs[p];
+		nTotalLatencyUs += nLatencyUs;
+		nMaxLatencyUs = max(nMaxLatencyUs, nLatencyUs);
+		nLastArrivalUs = max(nLastArrivalUs, receiver.m_arrivalUs[p]);
+		nNumReceived++;
+	}
+	sReport += "Loopback: " + ofToString(nNumReceived) + "/" + ofToString(nPackets) + " received";
+	if (nNumReceived > 0)
+	{
+		sReport += ", " + ofToString(nNumReceived * 1000000.0 / max<uint64_t>(nLastArrivalUs - sentUs[0], 1), 0) + " packets/s, latency "
+			+ ofToString(nTotalLatencyUs / (float)nNumReceived, 1) + " us average, " + ofToString(nMaxLatencyUs) + " us max";
+	}
+	return sReport + "\n";
+}
@@ -0,0 +1,77 @@
+#ifndef _OFX_TUIO_RECEIVER
+#define _OFX_TUIO_RECEIVER
+
+/**
+ * \class ofxTuioReceiver
+ *
+ * \brief This class receives TUIO 1.1 and TUIO 2.0 cursors on a UDP port and turns them into touch events.
+ *
+ * A thread blocks on the socket and decodes each datagram with ofxTuioParser, straight from the receive buffer of
+ * the socket into a reused tuioFrame. When a frame is complete, its cursors are compared with the cursors on the
+ * surface (a fixed-size array), and the touch events (in normalized coordinates) are queued for the main thread,
+ * which reads them with getNextTouch(). Frames older than the last one are dropped.
+ *
+ * It replaces ofxTactoHandler when USE_FAST_TUIO is defined in ofApp.cpp. benchmark() measures the parser alone
+ * and a loopback UDP stream of TUIO bundles.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxTuioParser.h"
+#include "ip/UdpSocket.h"
+#include "ip/PacketListener.h"
+
+#define TUIO_DEFAULT_PORT 3333 ///< The standard TUIO port.
+#define TUIO_BENCHMARK_PORT 3334 ///< The port of the loopback benchmark.
+#define TUIO_FRAME_ID_WINDOW 1000 ///< How far back a frame ID counts as late rather than as a restart of the tracker.
+
+/// A class that receives TUIO cursors as touch events.
+class ofxTuioReceiver : public ofThread, public PacketListener
+{
+public:
+	ofxTuioReceiver(); ///< Constructor
+	~ofxTuioReceiver(); ///< Destructor
+
+	bool							setup(int nPort = TUIO_DEFAULT_PORT); ///< Starts listening on a port.
+	void							stop(); ///< Stops listening and releases the cursors still on the surface.
+	bool							isRunning() const { return m_socket != NULL; } ///< Returns whether or not the receiver is listening.
+	bool							getNextTouch(ofTouchEventArgs& args) { return m_touches.tryReceive(args); } ///< Reads the next touch event, if any. \param args Set to the touch event. \return Whether or not there was an event.
+
+	static string					benchmark(int nPackets = 20000, int nCursors = 10); ///< Measures the parser and a loopback UDP stream.
+
+	virtual void					ProcessPacket(const char* data, int size, const IpEndpointName& remoteEndpoint); ///< Decodes a datagram (receiver thread), whatever its sender.
+
+protected:
+	void							threadedFunction(); ///< Runs the socket.
+
+private:
+	/// A cursor on the surface.
+	struct activeCursor
+	{
+		int32_t						nSessionId; ///< The session ID of the cursor.
+		float						x; ///< The normalized x coordinate.
+		float						y; ///< The normalized y coordinate.
+	};
+
+	void							applyFrame(); ///< Turns a complete frame into touch events.
+	void							sendTouch(ofTouchEventArgs::Type type, const activeCursor& cursor); ///< Queues a touch event.
+	bool							isAlive(int32_t nSessionId) const; ///< Returns whether or not a session ID is in the alive list of the frame.
+
+	UdpListeningReceiveSocket*		m_socket; ///< The socket, while listening.
+	tuioFrame						m_frame; ///< The frame being received.
+	int32_t							m_nLastFrameId; ///< The ID of the last frame applied (-1 before the first one).
+	activeCursor					m_active[TUIO_MAX_CURSORS]; ///< The cursors on the surface.
+	int								m_nNumActive; ///< The number of cursors on the surface.
+	ofThreadChannel<ofTouchEventArgs>	m_touches; ///< The touch events waiting for the main thread.
+
+	// Benchmark
+	bool							m_bBenchmark; ///< Whether or not arrival times are recorded instead of queuing events.
+	vector<uint64_t>				m_arrivalUs; ///< The arrival time (in µs) of each frame ID, in benchmark mode.
+	std::atomic<int>				m_nNumReceived; ///< The number of frames received, in benchmark mode.
+};
+
+#endif
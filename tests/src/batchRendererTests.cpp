@@ -0,0 +1,149 @@
+/**
+ * The tests of the CPU tessellation of ofxBatchRenderer: the number of triangles of each shape, the colour of each
+ * vertex, the offsets and the retained batches. Nothing here reaches the vertex buffer but an empty upload, so the
+ * tests run without a window.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxBatchRenderer.h"
+#include <gtest/gtest.h>
+
+#define BATCH_TEST_RESOLUTION 12 ///< The number of segments of the circles and rings under test.
+
+/**
+* \param batch The batch.
+* \param nFirst The index of the first vertex to check.
+* \param nCount The number of vertices to check.
+* \param color The colour that the vertices should have.
+*/
+static void expectColors(const ofxBatchRenderer& batch, int nFirst, int nCount, const ofColor& color)
+{
+	ofFloatColor expected(color);
+	for (int i = nFirst; i < nFirst + nCount; i++)
+	{
+		const ofFloatColor& actual = batch.getColors()[i];
+		EXPECT_FLOAT_EQ(expected.r, actual.r) << "vertex " << i;
+		EXPECT_FLOAT_EQ(expected.g, actual.g) << "vertex " << i;
+		EXPECT_FLOAT_EQ(expected.b, actual.b) << "vertex " << i;
+		EXPECT_FLOAT_EQ(expected.a, actual.a) << "vertex " << i;
+	}
+}
+
+TEST(ofxBatchRenderer, CircleIsAFanOfOneTrianglePerSegment)
+{
+	ofxBatchRenderer batch(BATCH_TEST_RESOLUTION);
+	ofColor color(255, 128, 0, 64);
+	batch.addCircle(100.0f, 50.0f, 10.0f, color);
+
+	ASSERT_EQ(3 * BATCH_TEST_RESOLUTION, batch.getNumVertices());
+	ASSERT_EQ(batch.getVertices().size(), batch.getColors().size());
+	expectColors(batch, 0, batch.getNumVertices(), color);
+	for (int t = 0; t < BATCH_TEST_RESOLUTION; t++)
+	{
+		// The centre, then two points of the circle
+		const ofVec2f* v = &batch.getVertices()[3 * t];
+		EXPECT_FLOAT_EQ(100.0f, v[0].x);
+		EXPECT_FLOAT_EQ(50.0f, v[0].y);
+		EXPECT_NEAR(10.0f, ofVec2f(v[1].x - 100.0f, v[1].y - 50.0f).length(), 1e-4f);
+		EXPECT_NEAR(10.0f, ofVec2f(v[2].x - 100.0f, v[2].y - 50.0f).length(), 1e-4f);
+	}
+}
+
+TEST(ofxBatchRenderer, RingIsTwoTrianglesPerSegment)
+{
+	ofxBatchRenderer batch(BATCH_TEST_RESOLUTION);
+	ofColor color(10, 20, 30);
+	batch.addRing(0.0f, 0.0f, 20.0f, 4.0f, color);
+
+	ASSERT_EQ(6 * BATCH_TEST_RESOLUTION, batch.getNumVertices());
+	expectColors(batch, 0, batch.getNumVertices(), color);
+	for (int i = 0; i < batch.getNumVertices(); i++)
+	{
+		// Every vertex is on the inner or the outer edge of the line
+		float fRadius = batch.getVertices()[i].length();
+		EXPECT_TRUE(fabs(fRadius - 18.0f) < 1e-4f || fabs(fRadius - 22.0f) < 1e-4f) << "vertex " << i << " at " << fRadius;
+	}
+}
+
+TEST(ofxBatchRenderer, StarIsTwoTrianglesPerTip)
+{
+	ofxBatchRenderer batch(BATCH_TEST_RESOLUTION);
+	ofColor color(0, 255, 0, 200);
+	batch.addStar(0.0f, 0.0f, 5.0f, 15.0f, 5, color);
+
+	ASSERT_EQ(3 * 2 * 5, batch.getNumVertices());
+	expectColors(batch, 0, batch.getNumVertices(), color);
+}
+
+TEST(ofxBatchRenderer, ShapesKeepTheirOrderAndColors)
+{
+	ofxBatchRenderer batch(BATCH_TEST_RESOLUTION);
+	ofColor red(255, 0, 0);
+	ofColor blue(0, 0, 255, 128);
+	ofColor white(255);
+	batch.addCircle(0.0f, 0.0f, 1.0f, red);
+	batch.addStar(0.0f, 0.0f, 1.0f, 2.0f, 3, blue);
+	batch.addRing(0.0f, 0.0f, 1.0f, 0.5f, white);
+
+	int nCircle = 3 * BATCH_TEST_RESOLUTION;
+	int nStar = 3 * 2 * 3;
+	int nRing = 6 * BATCH_TEST_RESOLUTION;
+	ASSERT_EQ(nCircle + nStar + nRing, batch.getNumVertices());
+	expectColors(batch, 0, nCircle, red);
+	expectColors(batch, nCircle, nStar, blue);
+	expectColors(batch, nCircle + nStar, nRing, white);
+}
+
+TEST(ofxBatchRenderer, CircleResolutionSetsTheTriangles)
+{
+	ofxBatchRenderer batch(BATCH_TEST_RESOLUTION);
+	batch.setCircleResolution(2);
+	EXPECT_EQ(3, batch.getCircleResolution());
+	batch.setCircleResolution(40);
+	batch.addCircle(0.0f, 0.0f, 1.0f, ofColor(255));
+	EXPECT_EQ(3 * 40, batch.getNumVertices());
+}
+
+TEST(ofxBatchRenderer, OffsetsMoveTheShapesAddedUnderThem)
+{
+	ofxBatchRenderer batch(BATCH_TEST_RESOLUTION);
+	batch.pushOffset(10.0f, 20.0f);
+	batch.pushOffset(1.0f, 2.0f);
+	batch.addCircle(0.0f, 0.0f, 1.0f, ofColor(255));
+	batch.popOffset();
+	batch.addCircle(0.0f, 0.0f, 1.0f, ofColor(255));
+	batch.popOffset();
+	batch.addCircle(0.0f, 0.0f, 1.0f, ofColor(255));
+
+	// The first vertex of each circle is its centre
+	int nPerCircle = 3 * BATCH_TEST_RESOLUTION;
+	EXPECT_FLOAT_EQ(11.0f, batch.getVertices()[0].x);
+	EXPECT_FLOAT_EQ(22.0f, batch.getVertices()[0].y);
+	EXPECT_FLOAT_EQ(10.0f, batch.getVertices()[nPerCircle].x);
+	EXPECT_FLOAT_EQ(20.0f, batch.getVertices()[nPerCircle].y);
+	EXPECT_FLOAT_EQ(0.0f, batch.getVertices()[2 * nPerCircle].x);
+	EXPECT_FLOAT_EQ(0.0f, batch.getVertices()[2 * nPerCircle].y);
+}
+
+TEST(ofxBatchRenderer, ClearForgetsTheShapes)
+{
+	ofxBatchRenderer batch(BATCH_TEST_RESOLUTION);
+	batch.addRing(0.0f, 0.0f, 1.0f, 0.5f, ofColor(255));
+	batch.clear();
+	EXPECT_EQ(0, batch.getNumVertices());
+	EXPECT_TRUE(batch.getColors().empty());
+}
+
+TEST(ofxBatchRenderer, EmptyRetainedBatchIsBuilt)
+{
+	// An empty batch makes no OpenGL call, and must not be rebuilt every frame
+	ofxBatchRenderer batch(BATCH_TEST_RESOLUTION);
+	EXPECT_FALSE(batch.isUploaded());
+	batch.upload();
+	EXPECT_TRUE(batch.isUploaded());
+}
@@ -0,0 +1,20 @@
+#include "ofMain.h"
+#include "ofAppNoWindow.h"
+#include "kitchenViewport.h"
+#include <gtest/gtest.h>
+
+/**
+* The entry point of the unit tests, which take the arguments of GoogleTest and run without a window.
+* \param argc The number of arguments.
+* \param argv The arguments.
+* \return 0 if every test passed, 1 otherwise.
+*/
+int main(int argc, char* argv[])
+{
+	ofAppNoWindow window;
+	ofSetupOpenGL(&window, KITCHEN_VIEWPORT_DEFAULT_WIDTH, KITCHEN_VIEWPORT_DEFAULT_HEIGHT, OF_WINDOW);
+	ofSetLogLevel(OF_LOG_ERROR);
+
+	testing::InitGoogleTest(&argc, argv);
+	return RUN_ALL_TESTS();
+}
@@ -0,0 +1,123 @@
+/**
+ * The tests of the spatial hash of ofxParticleSystem: in every mode that reacts to contacts, a frame of 50000
+ * particles against 8 to 512 contacts moves the particles as checking every contact would. The reference system is
+ * the same one with the spatial hash turned off, from the same particles and on the same manual clock, so that both
+ * read the same flow field.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxParticleSystem.h"
+#include "ofxKitchenClock.h"
+#include <gtest/gtest.h>
+
+#define PARTICLE_TEST_NUM_PARTICLES 50000 ///< The number of particles, as in the application.
+#define PARTICLE_TEST_NUM_THREADS 4 ///< The number of slices, whose boundaries fall within cells.
+#define PARTICLE_TEST_SEED 1234 ///< The seed of the particles and of the contacts.
+#define PARTICLE_TEST_TIME_US 12345678 ///< The time of the clock of both systems, at which their flow fields are evaluated.
+#define PARTICLE_TEST_TOLERANCE 1e-5f ///< The largest difference of velocity, from the order in which the forces of the contacts are summed.
+
+/// A particle, identified by its seed and drag, which the spatial hash moves around in the arrays.
+struct particleTestState
+{
+	float							fSeed; ///< The seed of the noise of the particle.
+	float							fDrag; ///< The drag factor of the particle.
+	float							fVelX; ///< The x velocity after the frame.
+	float							fVelY; ///< The y velocity after the frame.
+
+	bool operator<(const particleTestState& other) const { return fSeed < other.fSeed || (fSeed == other.fSeed && fDrag < other.fDrag); } ///< Orders the particles by identity.
+};
+
+/**
+* \param system The particle system.
+* \return The particles, ordered by their seed and drag.
+*/
+static vector<particleTestState> getStates(const ofxParticleSystem& system)
+{
+	vector<particleTestState> states(system.getNumParticles());
+	for (size_t i = 0; i < states.size(); i++)
+	{
+		states[i].fSeed = system.getSeeds()[i];
+		states[i].fDrag = system.getDrags()[i];
+		states[i].fVelX = system.getVelocitiesX()[i];
+		states[i].fVelY = system.getVelocitiesY()[i];
+	}
+	std::sort(states.begin(), states.end());
+	return states;
+}
+
+/**
+* \param mode The mode of the particles.
+* \param nNumContacts The number of contacts.
+*/
+static void expectHashMatchesEveryContact(particleMode mode, int nNumContacts)
+{
+	ofSeedRandom(PARTICLE_TEST_SEED);
+	vector<ofPoint> contacts;
+	for (int j = 0; j < nNumContacts; j++)
+	{
+		contacts.push_back(ofPoint(ofRandomWidth(), ofRandomHeight()));
+	}
+
+	// Both systems scatter the same particles, and the clock stands still so that their flow is the same
+	ofxManualClock clock(PARTICLE_TEST_TIME_US);
+	ofxParticleSystem hashed;
+	ofxParticleSystem everyContact;
+	hashed.setup(PARTICLE_TEST_NUM_PARTICLES, PARTICLE_TEST_NUM_THREADS, &clock);
+	everyContact.setup(PARTICLE_TEST_NUM_PARTICLES, PARTICLE_TEST_NUM_THREADS, &clock);
+	everyContact.setMinHashedContacts(nNumContacts + 1);
+	ofxParticleSystem* systems[] = { &hashed, &everyContact };
+	for (int s = 0; s < 2; s++)
+	{
+		systems[s]->setMode(mode);
+		ofSeedRandom(PARTICLE_TEST_SEED + 1);
+		systems[s]->reset();
+		systems[s]->setContacts(contacts);
+		systems[s]->update();
+	}
+
+	vector<particleTestState> expected = getStates(everyContact);
+	vector<particleTestState> actual = getStates(hashed);
+	ASSERT_EQ(expected.size(), actual.size());
+	int nNumDifferent = 0;
+	for (size_t i = 0; i < expected.size(); i++)
+	{
+		ASSERT_EQ(expected[i].fSeed, actual[i].fSeed);
+		ASSERT_EQ(expected[i].fDrag, actual[i].fDrag);
+		if (fabs(expected[i].fVelX - actual[i].fVelX) > PARTICLE_TEST_TOLERANCE || fabs(expected[i].fVelY - actual[i].fVelY) > PARTICLE_TEST_TOLERANCE)
+		{
+			// Only the first few differences are worth reading
+			if (nNumDifferent++ < 5)
+			{
+				ADD_FAILURE() << "particle " << i << " moves at " << actual[i].fVelX << ", " << actual[i].fVelY << " instead of "
+					<< expected[i].fVelX << ", " << expected[i].fVelY;
+			}
+		}
+	}
+	EXPECT_EQ(0, nNumDifferent) << "of " << expected.size() << " particles, with " << nNumContacts << " contacts";
+
+	hashed.stop();
+	everyContact.stop();
+}
+
+/// The modes that react to contacts.
+class ofxParticleSystemHash : public ::testing::TestWithParam<particleMode>
+{
+};
+
+TEST_P(ofxParticleSystemHash, MatchesEveryContact)
+{
+	int contactCounts[] = { 8, 32, 128, 512 };
+	for (size_t k = 0; k < sizeof(contactCounts) / sizeof(contactCounts[0]); k++)
+	{
+		SCOPED_TRACE(contactCounts[k]);
+		expectHashMatchesEveryContact(GetParam(), contactCounts[k]);
+	}
+}
+
+INSTANTIATE_TEST_CASE_P(ContactModes, ofxParticleSystemHash, ::testing::Values(PARTICLE_MODE_ATTRACT, PARTICLE_MODE_REPEL,
+	PARTICLE_MODE_NEAREST_POINTS, PARTICLE_MODE_EMITTER));
@@ -0,0 +1,115 @@
+/**
+ * The tests of the deltas of ofxKitchenStatePublisher: a visualizer that applies the bundles sent ends up with the
+ * state of the kitchen, even when the kitchen drifts by less than the epsilons on every update, without waiting for a
+ * keyframe. The bundles are read from the event of the publisher, so nothing has to arrive over the network.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxKitchenStatePublisher.h"
+#include <gtest/gtest.h>
+
+#define PUBLISHER_TEST_PORT 9102 ///< The port to which the bundles are sent, where nothing listens.
+#define PUBLISHER_TEST_NODE_ID 7 ///< The ID of the drifting node.
+#define PUBLISHER_TEST_NUM_UPDATES 400 ///< The number of updates of the drift.
+#define PUBLISHER_TEST_UPDATE_MS 16 ///< The time in milliseconds between two updates.
+
+/// The state of the kitchen as a visualizer rebuilds it from the bundles.
+class vizMirror
+{
+public:
+	vizMirror() : nNumKeyframes(0), fFocus(0.0f), x(0.0f), y(0.0f), fVolume(0.0f), fLowpass(0.0f) {} ///< Constructor
+
+	/** Applies the messages of a bundle, as a visualizer would.
+	* \param bundle The bundle sent.
+	*/
+	void bundleSent(ofxOscBundle& bundle)
+	{
+		for (int i = 0; i < bundle.getMessageCount(); i++)
+		{
+			const ofxOscMessage& msg = bundle.getMessageAt(i);
+			string sAddress = msg.getAddress();
+			if (sAddress == "/tactosonix/viz/keyframe")
+			{
+				nNumKeyframes++;
+			}
+			else if (sAddress == "/tactosonix/viz/pot/focus" && msg.getArgAsInt32(0) == 0)
+			{
+				fFocus = msg.getArgAsFloat(1);
+			}
+			else if (sAddress == "/tactosonix/viz/node/add" && msg.getArgAsInt32(0) == PUBLISHER_TEST_NODE_ID)
+			{
+				x = msg.getArgAsFloat(4);
+				y = msg.getArgAsFloat(5);
+				fVolume = msg.getArgAsFloat(8);
+				fLowpass = msg.getArgAsFloat(9);
+			}
+			else if (sAddress == "/tactosonix/viz/node/pos" && msg.getArgAsInt32(0) == PUBLISHER_TEST_NODE_ID)
+			{
+				x = msg.getArgAsFloat(1);
+				y = msg.getArgAsFloat(2);
+			}
+			else if (sAddress == "/tactosonix/viz/node/volume" && msg.getArgAsInt32(0) == PUBLISHER_TEST_NODE_ID)
+			{
+				fVolume = msg.getArgAsFloat(1);
+			}
+			else if (sAddress == "/tactosonix/viz/node/lowpass" && msg.getArgAsInt32(0) == PUBLISHER_TEST_NODE_ID)
+			{
+				fLowpass = msg.getArgAsFloat(1);
+			}
+		}
+	}
+
+	int								nNumKeyframes; ///< The number of keyframes received.
+	float							fFocus; ///< The focus of the first pot.
+	float							x; ///< The x coordinate of the node.
+	float							y; ///< The y coordinate of the node.
+	float							fVolume; ///< The volume of the node.
+	float							fLowpass; ///< The lowpass of the node.
+};
+
+TEST(ofxKitchenStatePublisher, SlowDriftReachesTheVisualizerWithoutKeyframe)
+{
+	kitchenSnapshot snapshot = kitchenSnapshot();
+	kitchenPotState& pot = snapshot.pots[0];
+	pot.fRadius = 100.0f;
+	pot.fFocus = 0.5f;
+	pot.nNumNodes = 1;
+	kitchenNodeState& node = pot.nodes[0];
+	node.nNodeId = PUBLISHER_TEST_NODE_ID;
+	node.bPlaying = true;
+	node.x = 100.0f;
+	node.y = 100.0f;
+	node.fVolume = 0.5f;
+	node.fLowpass = 0.5f;
+
+	// No rate limit, and no keyframe but the first one during the test
+	ofxKitchenStatePublisher publisher;
+	vizMirror mirror;
+	ofAddListener(publisher.bundleEvent, &mirror, &vizMirror::bundleSent);
+	publisher.setup("localhost", PUBLISHER_TEST_PORT, 0.0f, PUBLISHER_TEST_NUM_UPDATES * PUBLISHER_TEST_UPDATE_MS * 10);
+	publisher.update(snapshot, 0);
+
+	// Every update moves everything by a fifth of its epsilon
+	for (int i = 1; i <= PUBLISHER_TEST_NUM_UPDATES; i++)
+	{
+		node.x += KITCHEN_VIZ_POSITION_EPSILON / 5.0f;
+		node.y -= KITCHEN_VIZ_POSITION_EPSILON / 5.0f;
+		node.fVolume += KITCHEN_VIZ_VALUE_EPSILON / 5.0f;
+		node.fLowpass -= KITCHEN_VIZ_VALUE_EPSILON / 5.0f;
+		pot.fFocus += KITCHEN_VIZ_VALUE_EPSILON / 5.0f;
+		publisher.update(snapshot, i * PUBLISHER_TEST_UPDATE_MS);
+	}
+
+	EXPECT_EQ(1, mirror.nNumKeyframes);
+	EXPECT_NEAR(node.x, mirror.x, KITCHEN_VIZ_POSITION_EPSILON);
+	EXPECT_NEAR(node.y, mirror.y, KITCHEN_VIZ_POSITION_EPSILON);
+	EXPECT_NEAR(node.fVolume, mirror.fVolume, KITCHEN_VIZ_VALUE_EPSILON);
+	EXPECT_NEAR(node.fLowpass, mirror.fLowpass, KITCHEN_VIZ_VALUE_EPSILON);
+	EXPECT_NEAR(pot.fFocus, mirror.fFocus, KITCHEN_VIZ_VALUE_EPSILON);
+	ofRemoveListener(publisher.bundleEvent, &mirror, &vizMirror::bundleSent);
+}
@@ -0,0 +1,11 @@
+#include "ofMain.h"
+#include "ofApp.h"
+#include "ofAppGlutWindow.h"
+
+/// The entry point of the load generator.
+int main()
+{
+	ofAppGlutWindow window;
+	ofSetupOpenGL(&window, 640, 480, OF_WINDOW);
+	ofRunApp(new ofApp());
+}
@@ -0,0 +1,278 @@
+#include "ofApp.h"
+
+// The layout of the kitchen when it is not dragged, for a 1024x768 TactoSonix window.
+#define TARGET_ASPECT (1024.0f / 768.0f) ///< The aspect ratio of the TactoSonix window.
+#define POT_CENTRE_X 0.5f
+#define POT_CENTRE_Y (1.0f / 3.0f)
+#define POT_RADIUS_Y (1.0f / 3.0f) ///< The pot radius is a third of the window height.
+#define MENU_RADIUS_Y (150.0f / 768.0f) ///< The menu radius is 150 pixels.
+
+static const char* scenarioNames[LOADGEN_NUM_SCENARIOS] = { "drag nodes", "swipe kitchen", "hammer menu", "mixed" };
+
+//--------------------------------------------------------------
+void ofApp::setup(){
+	ofBackground(0, 0, 0);
+	ofSetCircleResolution(20);
+
+	m_sHost = LOADGEN_DEFAULT_HOST;
+	m_nPort = LOADGEN_DEFAULT_PORT;
+	m_nNumFingers = LOADGEN_DEFAULT_FINGERS;
+	m_nRate = LOADGEN_DEFAULT_RATE;
+	m_nScenario = LOADGEN_MIXED;
+	m_bRunning = true;
+	m_nNextSessionId = 1;
+	m_nFrameSeq = 0;
+	m_fLastFrameTime = 0.0f;
+	m_nPacketsSent = 0;
+
+	m_sender.setup(m_sHost, m_nPort);
+	ofSetFrameRate(m_nRate);
+
+	m_fingers.resize(LOADGEN_MAX_FINGERS);
+	for (size_t i = 0; i < m_fingers.size(); i++)
+	{
+		m_fingers[i].bInPot = false;
+		startGesture(m_fingers[i], 0.0f);
+	}
+}
+
+/** \param finger The finger whose next gesture is planned.
+* \param fNow The current time in seconds.
+*/
+void ofApp::startGesture(syntheticFinger& finger, float fNow)
+{
+	int nIndex = &finger - &m_fingers[0];
+	int nScenario = m_nScenario;
+	if (nScenario == LOADGEN_MIXED)
+	{
+		nScenario = nIndex % LOADGEN_MIXED;
+	}
+
+	finger.sessionId = -1;
+	finger.vel = ofPoint(0, 0);
+	finger.fStartTime = fNow + ofRandom(0.02f, 0.15f); // lift the finger for a moment
+	switch (nScenario)
+	{
+	case LOADGEN_DRAG_NODES:
+		if (!finger.bInPot)
+		{
+			// From the menu into the pot
+			finger.from = randomMenuPoint();
+			finger.to = randomPotPoint();
+		}
+		else
+		{
+			// From the pot to the background, which removes the node
+			finger.from = finger.to;
+			finger.to = randomBackgroundPoint();
+		}
+		finger.bInPot = !finger.bInPot;
+		finger.fDuration = ofRandom(0.4f, 1.0f);
+		break;
+	case LOADGEN_SWIPE_KITCHEN:
+		finger.from = randomBackgroundPoint();
+		finger.to = randomBackgroundPoint();
+		finger.fDuration = ofRandom(0.2f, 0.6f);
+		break;
+	case LOADGEN_HAMMER_MENU:
+	default:
+		finger.from = randomMenuPoint();
+		finger.to = finger.from + ofPoint(ofRandom(-0.002f, 0.002f), ofRandom(-0.002f, 0.002f));
+		finger.fDuration = ofRandom(0.03f, 0.08f);
+		break;
+	}
+	finger.pos = finger.from;
+}
+
+/** \return A random normalized point in the menu.
+*/
+ofPoint ofApp::randomMenuPoint()
+{
+	// The menu is a half-disc centred at the bottom of the window
+	float fAngle = ofRandom(PI + 0.2f, TWO_PI - 0.2f);
+	float fRadius = ofRandom(0.3f, 0.9f) * MENU_RADIUS_Y;
+	return ofPoint(0.5f + fRadius * cos(fAngle) / TARGET_ASPECT, 1.0f + fRadius * sin(fAngle));
+}
+
+/** \return A random normalized point in the visible pot.
+*/
+ofPoint ofApp::randomPotPoint()
+{
+	float fAngle = ofRandom(0.0f, TWO_PI);
+	float fRadius = sqrt(ofRandom(0.0f, 1.0f)) * 0.8f * POT_RADIUS_Y;
+	return ofPoint(POT_CENTRE_X + fRadius * cos(fAngle) / TARGET_ASPECT, POT_CENTRE_Y + fRadius * sin(fAngle));
+}
+
+/** \return A random normalized point away from the pot and the menu.
+*/
+ofPoint ofApp::randomBackgroundPoint()
+{
+	float x = ofRandom(0.03f, 0.17f);
+	if (ofRandom(1.0f) > 0.5f)
+	{
+		x = 1.0f - x;
+	}
+	return ofPoint(x, ofRandom(0.05f, 0.75f));
+}
+
+//--------------------------------------------------------------
+void ofApp::update(){
+	if (!m_bRunning)
+	{
+		return;
+	}
+
+	float fNow = ofGetElapsedTimef();
+	float fDeltaTime = max(fNow - m_fLastFrameTime, 0.001f);
+	m_fLastFrameTime = fNow;
+
+	for (int i = 0; i < m_nNumFingers; i++)
+	{
+		syntheticFinger& finger = m_fingers[i];
+		if (fNow < finger.fStartTime)
+		{
+			continue;
+		}
+		if (finger.sessionId == -1)
+		{
+			// Finger down
+			finger.sessionId = m_nNextSessionId++;
+		}
+
+		float t = (fNow - finger.fStartTime) / finger.fDuration;
+		if (t >= 1.0f)
+		{
+			// Finger up: it disappears from the alive list of this frame
+			startGesture(finger, fNow);
+			continue;
+		}
+
+		t = t * t * (3.0f - 2.0f * t); // ease in and out
+		ofPoint newPos = finger.from + (finger.to - finger.from) * t;
+		finger.vel = (newPos - finger.pos) / fDeltaTime;
+		finger.pos = newPos;
+	}
+
+	sendFrame();
+}
+
+void ofApp::sendFrame()
+{
+	ofxOscBundle bundle;
+
+	ofxOscMessage source;
+	source.setAddress("/tuio/2Dcur");
+	source.addStringArg("source");
+	source.addStringArg("tuioLoadGenerator@" + m_sHost);
+	bundle.addMessage(source);
+
+	ofxOscMessage alive;
+	alive.setAddress("/tuio/2Dcur");
+	alive.addStringArg("alive");
+	for (int i = 0; i < m_nNumFingers; i++)
+	{
+		if (m_bRunning && m_fingers[i].sessionId != -1)
+		{
+			alive.addIntArg(m_fingers[i].sessionId);
+		}
+	}
+	bundle.addMessage(alive);
+
+	for (int i = 0; i < m_nNumFingers && m_bRunning; i++)
+	{
+		const syntheticFinger& finger = m_fingers[i];
+		if (finger.sessionId == -1)
+		{
+			continue;
+		}
+		ofxOscMessage set;
+		set.setAddress("/tuio/2Dcur");
+		set.addStringArg("set");
+		set.addIntArg(finger.sessionId);
+		set.addFloatArg(finger.pos.x);
+		set.addFloatArg(finger.pos.y);
+		set.addFloatArg(finger.vel.x);
+		set.addFloatArg(finger.vel.y);
+		set.addFloatArg(0.0f); // motion acceleration
+		bundle.addMessage(set);
+	}
+
+	ofxOscMessage fseq;
+	fseq.setAddress("/tuio/2Dcur");
+	fseq.addStringArg("fseq");
+	fseq.addIntArg(m_nFrameSeq++);
+	bundle.addMessage(fseq);
+
+	m_sender.sendBundle(bundle);
+	m_nPacketsSent++;
+}
+
+//--------------------------------------------------------------
+void ofApp::draw(){
+	// Draw the layout of the kitchen
+	ofNoFill();
+	ofSetColor(80);
+	float fHeight = ofGetHeight();
+	float fWidth = fHeight * TARGET_ASPECT;
+	ofCircle(POT_CENTRE_X * fWidth, POT_CENTRE_Y * fHeight, POT_RADIUS_Y * fHeight);
+	ofCircle(0.5f * fWidth, fHeight, MENU_RADIUS_Y * fHeight);
+
+	// Draw the fingers
+	ofFill();
+	ofSetColor(0x5D, 0xB1, 0xDB);
+	for (int i = 0; i < m_nNumFingers; i++)
+	{
+		if (m_fingers[i].sessionId != -1)
+		{
+			ofCircle(m_fingers[i].pos.x * fWidth, m_fingers[i].pos.y * fHeight, 6);
+		}
+	}
+
+	ofSetColor(230);
+	string sInfo = "TUIO load generator -> " + m_sHost + ":" + ofToString(m_nPort) + (m_bRunning ? "" : " (paused)") + "\n"
+		+ "fingers: " + ofToString(m_nNumFingers) + "   rate: " + ofToString(m_nRate) + " Hz   scenario: " + scenarioNames[m_nScenario] + "\n"
+		+ "bundles sent: " + ofToString(m_nPacketsSent) + "\n\n"
+		+ "Up/Down: fingers, Left/Right: rate, 1-4: scenario, space: pause";
+	ofDrawBitmapString(sInfo, 10, 20);
+}
+
+//--------------------------------------------------------------
+void ofApp::keyPressed(int key){
+	if (key == OF_KEY_UP)
+	{
+		m_nNumFingers = min(m_nNumFingers + 4, LOADGEN_MAX_FINGERS);
+	}
+	if (key == OF_KEY_DOWN)
+	{
+		m_nNumFingers = max(m_nNumFingers - 4, 1);
+	}
+	if (key == OF_KEY_RIGHT)
+	{
+		m_nRate = min(m_nRate + 10, 240);
+		ofSetFrameRate(m_nRate);
+	}
+	if (key == OF_KEY_LEFT)
+	{
+		m_nRate = max(m_nRate - 10, 10);
+		ofSetFrameRate(m_nRate);
+	}
+	if (key >= '1' && key < '1' + LOADGEN_NUM_SCENARIOS)
+	{
+		m_nScenario = key - '1';
+		float fNow = ofGetElapsedTimef();
+		for (size_t i = 0; i < m_fingers.size(); i++)
+		{
+			m_fingers[i].bInPot = false;
+			startGesture(m_fingers[i], fNow);
+		}
+	}
+	if (key == ' ')
+	{
+		m_bRunning = !m_bRunning;
+		if (!m_bRunning)
+		{
+			// Lift all fingers
+			sendFrame();
+		}
+	}
+}
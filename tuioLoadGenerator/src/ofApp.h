@@ -0,0 +1,74 @@
+#pragma once
+
+/**
+ * \class ofApp
+ *
+ * \brief A standalone load generator that sends synthetic TUIO 1.1 cursor streams over OSC,
+ * to exercise TactoSonix (and its ofxTactoHandler) with dozens of simultaneous fingers.
+ *
+ * \version 1.0
+ *
+ * \date 2026/10/19
+ *
+ */
+
+#include "ofMain.h"
+#include "ofxOsc.h"
+
+#define LOADGEN_DEFAULT_HOST "localhost"
+#define LOADGEN_DEFAULT_PORT 3333 ///< The standard TUIO port, on which ofxTactoHandler listens.
+#define LOADGEN_DEFAULT_FINGERS 24
+#define LOADGEN_MAX_FINGERS 128
+#define LOADGEN_DEFAULT_RATE 60 ///< The number of TUIO frames sent per second.
+
+/// The gestures performed by the synthetic fingers.
+enum loadScenario
+{
+	LOADGEN_DRAG_NODES = 0, ///< Drag loops from the menu into the pot, then out of the pot.
+	LOADGEN_SWIPE_KITCHEN, ///< Swipe the background of the kitchen.
+	LOADGEN_HAMMER_MENU, ///< Tap the menu as fast as possible.
+	LOADGEN_MIXED, ///< Every finger picks one of the scenarios above.
+	LOADGEN_NUM_SCENARIOS
+};
+
+/// A synthetic finger, moving from one point to another during one gesture.
+struct syntheticFinger
+{
+	int								sessionId; ///< The TUIO session ID of the current gesture (-1 when the finger is up).
+	ofPoint							pos; ///< The current normalized position of the finger.
+	ofPoint							vel; ///< The current normalized velocity of the finger, per second.
+	ofPoint							from; ///< The normalized starting point of the gesture.
+	ofPoint							to; ///< The normalized end point of the gesture.
+	float							fStartTime; ///< The time in seconds at which the gesture starts.
+	float							fDuration; ///< The duration in seconds of the gesture.
+	bool							bInPot; ///< Whether the last drag ended inside the pot (the next one takes the node out).
+};
+
+class ofApp : public ofBaseApp
+{
+public:
+	void							setup();
+	void							update();
+	void							draw();
+	void							keyPressed(int key);
+
+private:
+	void							startGesture(syntheticFinger& finger, float fNow); ///< Plans the next gesture of a finger.
+	void							sendFrame(); ///< Sends the TUIO bundle describing all fingers.
+	ofPoint							randomMenuPoint(); ///< Returns a random normalized point in the menu.
+	ofPoint							randomPotPoint(); ///< Returns a random normalized point in the visible pot.
+	ofPoint							randomBackgroundPoint(); ///< Returns a random normalized point away from the pot and menu.
+
+	ofxOscSender					m_sender; ///< The OSC sender to the application.
+	string							m_sHost; ///< The host of the application.
+	int								m_nPort; ///< The TUIO port of the application.
+	int								m_nNumFingers; ///< The number of simultaneous fingers.
+	int								m_nRate; ///< The number of TUIO frames per second.
+	int								m_nScenario; ///< The current \link loadScenario.
+	bool							m_bRunning; ///< Whether or not the generator is sending.
+	vector<syntheticFinger>			m_fingers; ///< The synthetic fingers.
+	int								m_nNextSessionId; ///< The next TUIO session ID.
+	int								m_nFrameSeq; ///< The TUIO frame sequence number.
+	float							m_fLastFrameTime; ///< The time in seconds at which the last TUIO frame was sent.
+	uint64_t						m_nPacketsSent; ///< The number of bundles sent so far.
+};